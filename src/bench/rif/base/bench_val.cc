@@ -0,0 +1,373 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "../bench_internal.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+/*
+ * Builds a value of the benchmarked kind. The list and the map are small containers of ints, to measure recursive
+ * dispatch.
+ */
+typedef enum bench_val_kind_e {
+  BENCH_VAL_INT,
+  BENCH_VAL_INT_IMMEDIATE,
+  BENCH_VAL_DOUBLE,
+  BENCH_VAL_STRING,
+  BENCH_VAL_PAIR,
+  BENCH_VAL_LIST,
+  BENCH_VAL_BUFFER,
+} bench_val_kind_t;
+
+static
+rif_val_t * _new_val(bench_val_kind_t kind, int64_t seed) {
+  switch (kind) {
+    case BENCH_VAL_INT:
+      return rif_val(rif_int_new(seed));
+    case BENCH_VAL_INT_IMMEDIATE:
+      return rif_val(rif_int_new_immediate(seed));
+    case BENCH_VAL_DOUBLE:
+      return rif_val(rif_double_new(seed + 0.5));
+    case BENCH_VAL_STRING: {
+      char buf[48];
+      snprintf(buf, sizeof(buf), "a moderately long string value %016llx", (unsigned long long) seed);
+      return rif_val(rif_string_new_dup(buf));
+    }
+    case BENCH_VAL_PAIR: {
+      rif_val_t *first_ptr = rif_val(rif_int_new(seed));
+      rif_val_t *second_ptr = rif_val(rif_int_new(seed + 1));
+      rif_val_t *pair_ptr = rif_val(rif_pair_new(first_ptr, second_ptr));
+      rif_val_release(first_ptr);
+      rif_val_release(second_ptr);
+      return pair_ptr;
+    }
+    case BENCH_VAL_LIST: {
+      rif_arraylist_t *al_ptr = (rif_arraylist_t *) rif_malloc(sizeof(rif_arraylist_t), "BENCH");
+      rif_arraylist_init(al_ptr, 8, 8);
+      rif_val(al_ptr)->flags |= RIF_VAL_FLAG_FREE;
+      for (int64_t i = 0; i < 8; ++i) {
+        rif_val_t *int_ptr = rif_val(rif_int_new(seed + i));
+        rif_arraylist_append(al_ptr, int_ptr);
+        rif_val_release(int_ptr);
+      }
+      return rif_val(al_ptr);
+    }
+    case BENCH_VAL_BUFFER: {
+      char buf[48];
+      snprintf(buf, sizeof(buf), "a moderately long buffer value %016llx", (unsigned long long) seed);
+      return rif_val(rif_buffer_new_copy(buf, strlen(buf)));
+    }
+  }
+  return NULL;
+}
+
+#define BENCH_VAL(__op, __kind, __kind_name, ...) \
+    static void bench_val_##__op##_##__kind_name(BenchState &state) { _bench_##__op(state, __kind); } \
+    RIF_BENCH("val/" #__op "/" #__kind_name, bench_val_##__op##_##__kind_name, __VA_ARGS__)
+
+/******************************************************************************
+ * REFERENCE COUNTING BENCHMARKS
+ */
+
+static
+void _bench_retain_release(BenchState &state, bench_val_kind_t kind) {
+  rif_val_t *val_ptr = _new_val(kind, 42);
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_val_retain(val_ptr);
+    rif_val_release(val_ptr);
+  }
+  state.pause();
+  rif_val_release(val_ptr);
+}
+
+static
+void _bench_new_release(BenchState &state, bench_val_kind_t kind) {
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_val_release(_new_val(kind, (int64_t) i));
+  }
+  state.pause();
+}
+
+BENCH_VAL(retain_release, BENCH_VAL_INT, int, 1048576);
+BENCH_VAL(retain_release, BENCH_VAL_STRING, string, 1048576);
+BENCH_VAL(new_release, BENCH_VAL_INT, int, 1048576);
+BENCH_VAL(new_release, BENCH_VAL_INT_IMMEDIATE, int_immediate, 1048576);
+BENCH_VAL(new_release, BENCH_VAL_DOUBLE, double, 1048576);
+BENCH_VAL(new_release, BENCH_VAL_STRING, string, 1048576);
+BENCH_VAL(new_release, BENCH_VAL_PAIR, pair, 1048576);
+
+/*
+ * Retain and release of a value confined to the benchmark thread, compared to `retain_release/int`.
+ */
+static
+void bench_val_retain_release_int_local(BenchState &state) {
+  bool previous = rif_val_set_local_default(true);
+  rif_val_t *val_ptr = _new_val(BENCH_VAL_INT, 42);
+  rif_val_set_local_default(previous);
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_val_retain(val_ptr);
+    rif_val_release(val_ptr);
+  }
+  state.pause();
+  rif_val_release(val_ptr);
+}
+
+RIF_BENCH("val/retain_release/int_local", bench_val_retain_release_int_local, 1048576);
+
+/*
+ * Retain and release of an immortal singleton, which should not touch the reference count.
+ */
+static
+void bench_val_retain_release_null(BenchState &state) {
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_val_retain(rif_null);
+    rif_val_release(rif_null);
+  }
+  state.pause();
+}
+
+RIF_BENCH("val/retain_release/null", bench_val_retain_release_null, 1048576);
+
+/*
+ * Small integers from the shared immortal instances, compared to `new_release/int`.
+ */
+static
+void bench_val_new_release_int_cached(BenchState &state) {
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_val_release(rif_int_get_cached((int64_t) (i & 511)));
+  }
+  state.pause();
+}
+
+RIF_BENCH("val/new_release/int_cached", bench_val_new_release_int_cached, 1048576);
+
+/******************************************************************************
+ * ALLOCATOR BENCHMARKS
+ */
+
+/*
+ * Allocates a window of `arg` live values, then releases them all, with the slab caches either enabled or disabled.
+ */
+static
+void _bench_new_window(BenchState &state, bench_val_kind_t kind, bool slab) {
+  std::vector<rif_val_t *> vals(state.arg());
+  rif_slab_set_enabled(slab);
+  state.resume();
+  for (int round = 0; round < 16; ++round) {
+    for (uint64_t i = 0; i < state.arg(); ++i) {
+      vals[i] = _new_val(kind, (int64_t) i);
+    }
+    for (uint64_t i = 0; i < state.arg(); ++i) {
+      rif_val_release(vals[i]);
+    }
+  }
+  state.pause();
+  rif_slab_set_enabled(true);
+  state.set_items(state.arg() * 16);
+}
+
+static void _bench_new_window_slab(BenchState &state, bench_val_kind_t kind) { _bench_new_window(state, kind, true); }
+static void _bench_new_window_heap(BenchState &state, bench_val_kind_t kind) { _bench_new_window(state, kind, false); }
+
+BENCH_VAL(new_window_slab, BENCH_VAL_INT, int, 1024, 65536);
+BENCH_VAL(new_window_heap, BENCH_VAL_INT, int, 1024, 65536);
+BENCH_VAL(new_window_slab, BENCH_VAL_PAIR, pair, 1024, 65536);
+BENCH_VAL(new_window_heap, BENCH_VAL_PAIR, pair, 1024, 65536);
+
+/******************************************************************************
+ * HASHCODE BENCHMARKS
+ */
+
+#define VALUE_COUNT 1024
+
+static
+void _bench_hashcode(BenchState &state, bench_val_kind_t kind) {
+  std::vector<rif_val_t *> vals;
+  for (int64_t i = 0; i < VALUE_COUNT; ++i) {
+    vals.push_back(_new_val(kind, i));
+  }
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_bench_keep(rif_val_hashcode(vals[i % VALUE_COUNT]));
+  }
+  state.pause();
+  for (size_t i = 0; i < vals.size(); ++i) {
+    rif_val_release(vals[i]);
+  }
+}
+
+BENCH_VAL(hashcode, BENCH_VAL_INT, int, 1048576);
+BENCH_VAL(hashcode, BENCH_VAL_INT_IMMEDIATE, int_immediate, 1048576);
+BENCH_VAL(hashcode, BENCH_VAL_DOUBLE, double, 1048576);
+BENCH_VAL(hashcode, BENCH_VAL_STRING, string, 1048576);
+BENCH_VAL(hashcode, BENCH_VAL_PAIR, pair, 1048576);
+BENCH_VAL(hashcode, BENCH_VAL_LIST, list, 262144);
+BENCH_VAL(hashcode, BENCH_VAL_BUFFER, buffer, 1048576);
+
+/******************************************************************************
+ * EQUALS BENCHMARKS
+ */
+
+/*
+ * Compares distinct but equal values, which is the worst case for every type.
+ */
+static
+void _bench_equals(BenchState &state, bench_val_kind_t kind) {
+  std::vector<rif_val_t *> vals;
+  std::vector<rif_val_t *> others;
+  for (int64_t i = 0; i < VALUE_COUNT; ++i) {
+    vals.push_back(_new_val(kind, i));
+    others.push_back(_new_val(kind, i));
+  }
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_bench_keep(rif_val_equals(vals[i % VALUE_COUNT], others[i % VALUE_COUNT]));
+  }
+  state.pause();
+  for (size_t i = 0; i < vals.size(); ++i) {
+    rif_val_release(vals[i]);
+    rif_val_release(others[i]);
+  }
+}
+
+BENCH_VAL(equals, BENCH_VAL_INT, int, 1048576);
+BENCH_VAL(equals, BENCH_VAL_INT_IMMEDIATE, int_immediate, 1048576);
+BENCH_VAL(equals, BENCH_VAL_DOUBLE, double, 1048576);
+BENCH_VAL(equals, BENCH_VAL_STRING, string, 1048576);
+BENCH_VAL(equals, BENCH_VAL_PAIR, pair, 1048576);
+BENCH_VAL(equals, BENCH_VAL_LIST, list, 262144);
+BENCH_VAL(equals, BENCH_VAL_BUFFER, buffer, 1048576);
+
+/******************************************************************************
+ * TOSTRING BENCHMARKS
+ */
+
+static
+void _bench_tostring(BenchState &state, bench_val_kind_t kind) {
+  std::vector<rif_val_t *> vals;
+  for (int64_t i = 0; i < VALUE_COUNT; ++i) {
+    vals.push_back(_new_val(kind, i));
+  }
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    char *str = rif_val_tostring(vals[i % VALUE_COUNT]);
+    rif_bench_keep(str);
+    rif_free(str);
+  }
+  state.pause();
+  for (size_t i = 0; i < vals.size(); ++i) {
+    rif_val_release(vals[i]);
+  }
+}
+
+BENCH_VAL(tostring, BENCH_VAL_INT, int, 262144);
+BENCH_VAL(tostring, BENCH_VAL_DOUBLE, double, 262144);
+BENCH_VAL(tostring, BENCH_VAL_STRING, string, 262144);
+BENCH_VAL(tostring, BENCH_VAL_PAIR, pair, 262144);
+BENCH_VAL(tostring, BENCH_VAL_LIST, list, 65536);
+
+/*
+ * String representation of a single map of `arg` ints, reported per entry.
+ */
+static
+void bench_val_tostring_map_large(BenchState &state) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, state.arg());
+  rif_hashmap_t *hm_ptr = rif_hashmap_new(0, false);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    rif_hashmap_put(hm_ptr, keys[i], keys[i]);
+  }
+  state.resume();
+  char *str = rif_val_tostring(hm_ptr);
+  rif_bench_keep(str);
+  state.pause();
+  rif_free(str);
+  rif_val_release(hm_ptr);
+}
+
+RIF_BENCH("val/tostring/map_large", bench_val_tostring_map_large, 65536, 1048576);
+
+/******************************************************************************
+ * BUFFER BENCHMARKS
+ */
+
+#define BUFFER_PAYLOAD_SIZE 65536
+#define BUFFER_PART_SIZE 1024
+
+/*
+ * Extracts `arg` parts of a large payload, either as zero-copy slices or as copies.
+ */
+static
+void _bench_buffer_extract(BenchState &state, bool slice) {
+  std::vector<char> payload(BUFFER_PAYLOAD_SIZE, 'x');
+  rif_buffer_t *buf_ptr = rif_buffer_new_copy(payload.data(), payload.size());
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    size_t offset = (i * 64) % (BUFFER_PAYLOAD_SIZE - BUFFER_PART_SIZE);
+    rif_buffer_t *part_ptr = slice ?
+        rif_buffer_slice(buf_ptr, offset, BUFFER_PART_SIZE) :
+        rif_buffer_new_copy(rif_buffer_data(buf_ptr) + offset, BUFFER_PART_SIZE);
+    rif_bench_keep(part_ptr);
+    rif_buffer_release(part_ptr);
+  }
+  state.pause();
+  rif_buffer_release(buf_ptr);
+}
+
+static void bench_val_buffer_extract_slice(BenchState &state) { _bench_buffer_extract(state, true); }
+static void bench_val_buffer_extract_copy(BenchState &state) { _bench_buffer_extract(state, false); }
+
+RIF_BENCH("val/buffer_extract/slice", bench_val_buffer_extract_slice, 1048576);
+RIF_BENCH("val/buffer_extract/copy", bench_val_buffer_extract_copy, 1048576);
+
+/******************************************************************************
+ * RECLAIM BENCHMARKS
+ */
+
+/*
+ * Latency of dropping the last reference to a map of `arg` ints, with destruction either synchronous or deferred to the
+ * reclaim queue. The queue is drained outside of the measured section.
+ */
+static
+void _bench_reclaim_release_map(BenchState &state, bool deferred) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, state.arg());
+  rif_hashmap_t *hm_ptr = rif_hashmap_new(0, false);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    rif_hashmap_put(hm_ptr, keys[i], keys[i]);
+  }
+  bool previous = rif_reclaim_set_deferred(deferred);
+  state.resume();
+  rif_val_release(hm_ptr);
+  state.pause();
+  rif_reclaim_set_deferred(previous);
+  rif_reclaim_step(UINT32_MAX);
+  state.set_items(1);
+}
+
+static void bench_reclaim_release_map_sync(BenchState &state) { _bench_reclaim_release_map(state, false); }
+static void bench_reclaim_release_map_deferred(BenchState &state) { _bench_reclaim_release_map(state, true); }
+
+RIF_BENCH("reclaim/release_map/sync", bench_reclaim_release_map_sync, 65536, 1048576);
+RIF_BENCH("reclaim/release_map/deferred", bench_reclaim_release_map_deferred, 65536, 1048576);
@@ -0,0 +1,242 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#pragma once
+
+/*****************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rif/rif.h"
+#include "rif/rif_internal.h"
+
+/******************************************************************************
+ * BENCHMARK STATE
+ */
+
+/**
+ * State of a single benchmark run.
+ *
+ * A benchmark function receives its workload size through `arg()`, performs any setup it needs, and brackets the
+ * measured section with `resume()` and `pause()`. Only the time spent between those calls is reported. The
+ * function must declare how many items it processed through `set_items()`, so that results can be reported per
+ * operation.
+ */
+class BenchState {
+
+public:
+
+  explicit BenchState(uint64_t arg) : arg_(arg), items_(arg), elapsed_(0), running_(false) {}
+
+  uint64_t arg() const {
+    return arg_;
+  }
+
+  void resume() {
+    running_ = true;
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  void pause() {
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    if (running_) {
+      elapsed_ += std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start_).count();
+      running_ = false;
+    }
+  }
+
+  void set_items(uint64_t items) {
+    items_ = items;
+  }
+
+  void set_counter(const char *name, double value) {
+    for (size_t i = 0; i < counters_.size(); ++i) {
+      if (counters_[i].first == name) {
+        counters_[i].second = value;
+        return;
+      }
+    }
+    counters_.push_back(std::make_pair(std::string(name), value));
+  }
+
+  uint64_t items() const {
+    return items_;
+  }
+
+  uint64_t elapsed_ns() const {
+    return elapsed_;
+  }
+
+  const std::vector<std::pair<std::string, double> > & counters() const {
+    return counters_;
+  }
+
+private:
+
+  uint64_t arg_;
+  uint64_t items_;
+  uint64_t elapsed_;
+  bool running_;
+  std::chrono::steady_clock::time_point start_;
+  std::vector<std::pair<std::string, double> > counters_;
+
+};
+
+/******************************************************************************
+ * BENCHMARK REGISTRATION
+ */
+
+typedef void (*rif_bench_fn_t)(BenchState &state);
+
+/**
+ * Registers a benchmark to be run once per argument in `args`.
+ */
+class BenchRegistrar {
+
+public:
+
+  BenchRegistrar(const char *name, rif_bench_fn_t fn, std::initializer_list<uint64_t> args);
+
+};
+
+/**
+ * Declares a benchmark.
+ *
+ * @param __name the benchmark name, as `suite/operation/variant`
+ * @param __fn   the benchmark function
+ * @param ...    the workload sizes to run the benchmark with
+ */
+#define RIF_BENCH(__name, __fn, ...) \
+    static BenchRegistrar _rif_bench_registrar_##__fn(__name, __fn, {__VA_ARGS__})
+
+/******************************************************************************
+ * HELPERS
+ */
+
+/**
+ * Prevents the compiler from optimizing away a computed value.
+ */
+template <typename T>
+inline void rif_bench_keep(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Deterministic pseudo-random generator, so that every run operates on the same key sequence.
+ */
+class BenchRandom {
+
+public:
+
+  explicit BenchRandom(uint64_t seed = 0x9e3779b97f4a7c15ULL) : state_(seed) {}
+
+  uint64_t next() {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+private:
+
+  uint64_t state_;
+
+};
+
+/******************************************************************************
+ * KEY SETS
+ */
+
+typedef enum rif_bench_key_kind_e {
+  RIF_BENCH_KEY_INT,
+  RIF_BENCH_KEY_STRING,
+  RIF_BENCH_KEY_INTERNED_STRING,
+  RIF_BENCH_KEY_PAIR,
+} rif_bench_key_kind_t;
+
+/**
+ * A set of heap-allocated values usable as keys, released on destruction.
+ *
+ * Two key sets built with the same kind and offset hold distinct but equal values, which allows lookups to exercise
+ * the `equals` path rather than a pointer comparison. Interned strings are the exception: equal keys are the same
+ * canonical instance.
+ */
+class BenchKeys {
+
+public:
+
+  BenchKeys(rif_bench_key_kind_t kind, uint64_t count, uint64_t offset = 0) {
+    keys_.reserve(count);
+    char buf[32];
+    for (uint64_t i = 0; i < count; ++i) {
+      int64_t value = (int64_t) (i + offset);
+      rif_val_t *key_ptr = NULL;
+      switch (kind) {
+        case RIF_BENCH_KEY_INT:
+          key_ptr = rif_val(rif_int_new(value));
+          break;
+        case RIF_BENCH_KEY_STRING:
+          snprintf(buf, sizeof(buf), "key:%016llx", (unsigned long long) value);
+          key_ptr = rif_val(rif_string_new_dup(buf));
+          break;
+        case RIF_BENCH_KEY_INTERNED_STRING:
+          snprintf(buf, sizeof(buf), "key:%016llx", (unsigned long long) value);
+          key_ptr = rif_val(rif_string_intern(buf));
+          break;
+        case RIF_BENCH_KEY_PAIR: {
+          rif_int_t *first_ptr = rif_int_new(value);
+          rif_int_t *second_ptr = rif_int_new(value * 31);
+          key_ptr = rif_val(rif_pair_new(rif_val(first_ptr), rif_val(second_ptr)));
+          rif_int_release(first_ptr);
+          rif_int_release(second_ptr);
+          break;
+        }
+      }
+      keys_.push_back(key_ptr);
+    }
+  }
+
+  ~BenchKeys() {
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      rif_val_release(keys_[i]);
+    }
+  }
+
+  rif_val_t * operator[](size_t index) const {
+    return keys_[index];
+  }
+
+  size_t size() const {
+    return keys_.size();
+  }
+
+private:
+
+  BenchKeys(const BenchKeys &);
+  BenchKeys & operator=(const BenchKeys &);
+
+  std::vector<rif_val_t *> keys_;
+
+};
@@ -0,0 +1,303 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "../bench_internal.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+/*
+ * Capacity used by the load factor benchmarks. The map is presized to exactly this capacity, and then filled to the
+ * requested load factor without triggering a resize.
+ */
+#define LOAD_FACTOR_CAPACITY 65536
+
+static
+std::vector<uint32_t> _shuffled_indices(uint64_t count) {
+  std::vector<uint32_t> indices(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    indices[i] = i;
+  }
+  BenchRandom random;
+  for (uint64_t i = count; i > 1; --i) {
+    std::swap(indices[i - 1], indices[random.next() % i]);
+  }
+  return indices;
+}
+
+static
+void _fill(rif_hashmap_t *hm_ptr, const BenchKeys &keys) {
+  for (size_t i = 0; i < keys.size(); ++i) {
+    rif_hashmap_put(hm_ptr, keys[i], keys[i]);
+  }
+}
+
+static
+void _set_load_counters(BenchState &state, const rif_hashmap_t *hm_ptr) {
+  state.set_counter("capacity", rif_hashmap_capacity(hm_ptr));
+  state.set_counter("load_factor", (double) rif_hashmap_size(hm_ptr) / rif_hashmap_capacity(hm_ptr));
+}
+
+/******************************************************************************
+ * PUT BENCHMARKS
+ */
+
+static
+void _bench_put(BenchState &state, rif_bench_key_kind_t kind, bool presize) {
+  BenchKeys keys(kind, state.arg());
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, presize ? (uint32_t) state.arg() : 0, false);
+  state.resume();
+  _fill(&hm, keys);
+  state.pause();
+  _set_load_counters(state, &hm);
+  rif_hashmap_release(&hm);
+}
+
+static void bench_hashmap_put_int(BenchState &state) { _bench_put(state, RIF_BENCH_KEY_INT, false); }
+static void bench_hashmap_put_string(BenchState &state) { _bench_put(state, RIF_BENCH_KEY_STRING, false); }
+static void bench_hashmap_put_pair(BenchState &state) { _bench_put(state, RIF_BENCH_KEY_PAIR, false); }
+static void bench_hashmap_put_presized_int(BenchState &state) { _bench_put(state, RIF_BENCH_KEY_INT, true); }
+
+RIF_BENCH("hashmap/put/int", bench_hashmap_put_int, 1024, 65536, 1048576);
+RIF_BENCH("hashmap/put/string", bench_hashmap_put_string, 1024, 65536, 1048576);
+RIF_BENCH("hashmap/put/pair", bench_hashmap_put_pair, 1024, 65536, 1048576);
+RIF_BENCH("hashmap/put_presized/int", bench_hashmap_put_presized_int, 1024, 65536, 1048576);
+
+/*
+ * Times every put on its own, and reports the slowest one, which is the one growing the map unless it is grown
+ * incrementally.
+ */
+static
+void _bench_put_latency(BenchState &state, bool incremental) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, state.arg());
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, 0, false);
+  rif_hashmap_set_incremental(&hm, incremental);
+  uint64_t max_ns = 0;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    state.resume();
+    rif_hashmap_put(&hm, keys[i], keys[i]);
+    state.pause();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    max_ns = std::max(max_ns, ns);
+  }
+  state.set_counter("max_put_ns", (double) max_ns);
+  rif_hashmap_release(&hm);
+}
+
+static void bench_hashmap_put_latency(BenchState &state) { _bench_put_latency(state, false); }
+static void bench_hashmap_put_latency_incremental(BenchState &state) { _bench_put_latency(state, true); }
+
+RIF_BENCH("hashmap/put_latency/int", bench_hashmap_put_latency, 65536, 1048576, 4194304);
+RIF_BENCH("hashmap/put_latency_incremental/int", bench_hashmap_put_latency_incremental, 65536, 1048576, 4194304);
+
+/******************************************************************************
+ * GET BENCHMARKS
+ */
+
+static
+void _bench_get(BenchState &state, rif_bench_key_kind_t kind, bool hit) {
+  BenchKeys keys(kind, state.arg());
+  BenchKeys probes(kind, state.arg(), hit ? 0 : state.arg());
+  std::vector<uint32_t> order = _shuffled_indices(state.arg());
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, 0, false);
+  _fill(&hm, keys);
+  state.resume();
+  for (size_t i = 0; i < order.size(); ++i) {
+    rif_bench_keep(rif_hashmap_get(&hm, probes[order[i]]));
+  }
+  state.pause();
+  _set_load_counters(state, &hm);
+  rif_hashmap_release(&hm);
+}
+
+static void bench_hashmap_get_hit_int(BenchState &state) { _bench_get(state, RIF_BENCH_KEY_INT, true); }
+static void bench_hashmap_get_hit_string(BenchState &state) { _bench_get(state, RIF_BENCH_KEY_STRING, true); }
+static void bench_hashmap_get_hit_interned_string(BenchState &state) {
+  _bench_get(state, RIF_BENCH_KEY_INTERNED_STRING, true);
+}
+static void bench_hashmap_get_hit_pair(BenchState &state) { _bench_get(state, RIF_BENCH_KEY_PAIR, true); }
+static void bench_hashmap_get_miss_int(BenchState &state) { _bench_get(state, RIF_BENCH_KEY_INT, false); }
+static void bench_hashmap_get_miss_string(BenchState &state) { _bench_get(state, RIF_BENCH_KEY_STRING, false); }
+
+RIF_BENCH("hashmap/get_hit/int", bench_hashmap_get_hit_int, 1024, 65536, 1048576);
+RIF_BENCH("hashmap/get_hit/string", bench_hashmap_get_hit_string, 1024, 65536, 1048576);
+RIF_BENCH("hashmap/get_hit/interned_string", bench_hashmap_get_hit_interned_string, 1024, 65536, 1048576);
+RIF_BENCH("hashmap/get_hit/pair", bench_hashmap_get_hit_pair, 1024, 65536, 1048576);
+RIF_BENCH("hashmap/get_miss/int", bench_hashmap_get_miss_int, 1024, 65536, 1048576);
+RIF_BENCH("hashmap/get_miss/string", bench_hashmap_get_miss_string, 1024, 65536, 1048576);
+
+/*
+ * Request-style lookups: keys are looked up by batches of `GET_MANY_BATCH` random keys, either one at a time, or
+ * through `rif_hashmap_get_many`.
+ */
+#define GET_MANY_BATCH 256
+
+static
+void _bench_get_batch(BenchState &state, bool many) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, state.arg());
+  std::vector<uint32_t> order = _shuffled_indices(state.arg());
+  std::vector<rif_val_t *> batch(GET_MANY_BATCH);
+  std::vector<rif_val_t *> vals(GET_MANY_BATCH);
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, 0, false);
+  _fill(&hm, keys);
+  uint64_t lookups = order.size() - order.size() % GET_MANY_BATCH;
+  for (uint64_t base = 0; base < lookups; base += GET_MANY_BATCH) {
+    for (uint32_t i = 0; i < GET_MANY_BATCH; ++i) {
+      batch[i] = keys[order[base + i]];
+    }
+    state.resume();
+    if (many) {
+      rif_bench_keep(rif_hashmap_get_many(&hm, batch.data(), GET_MANY_BATCH, vals.data()));
+    } else {
+      for (uint32_t i = 0; i < GET_MANY_BATCH; ++i) {
+        rif_bench_keep(rif_hashmap_get(&hm, batch[i]));
+      }
+    }
+    state.pause();
+  }
+  state.set_items(lookups);
+  rif_hashmap_release(&hm);
+}
+
+static void bench_hashmap_get_batch_single(BenchState &state) { _bench_get_batch(state, false); }
+static void bench_hashmap_get_batch_many(BenchState &state) { _bench_get_batch(state, true); }
+
+RIF_BENCH("hashmap/get_batch/single", bench_hashmap_get_batch_single, 65536, 1048576, 4194304);
+RIF_BENCH("hashmap/get_batch/many", bench_hashmap_get_batch_many, 65536, 1048576, 4194304);
+
+/******************************************************************************
+ * LOAD FACTOR BENCHMARKS
+ */
+
+/*
+ * For these benchmarks, the argument is the load factor, in percent, at which the map is probed.
+ */
+static
+void _bench_get_load_factor(BenchState &state, bool hit) {
+  uint64_t count = LOAD_FACTOR_CAPACITY * state.arg() / 100;
+  BenchKeys keys(RIF_BENCH_KEY_INT, count);
+  BenchKeys probes(RIF_BENCH_KEY_INT, count, hit ? 0 : count);
+  std::vector<uint32_t> order = _shuffled_indices(count);
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, 0, false);
+  rif_hashmap_ensure_capacity(&hm, LOAD_FACTOR_CAPACITY * 9 / 10);
+  _fill(&hm, keys);
+  state.resume();
+  for (size_t i = 0; i < order.size(); ++i) {
+    rif_bench_keep(rif_hashmap_get(&hm, probes[order[i]]));
+  }
+  state.pause();
+  state.set_items(count);
+  _set_load_counters(state, &hm);
+  rif_hashmap_release(&hm);
+}
+
+static void bench_hashmap_load_factor_get_hit(BenchState &state) { _bench_get_load_factor(state, true); }
+static void bench_hashmap_load_factor_get_miss(BenchState &state) { _bench_get_load_factor(state, false); }
+
+RIF_BENCH("hashmap/load_factor/get_hit", bench_hashmap_load_factor_get_hit, 25, 50, 75, 90);
+RIF_BENCH("hashmap/load_factor/get_miss", bench_hashmap_load_factor_get_miss, 25, 50, 75, 90);
+
+/******************************************************************************
+ * REMOVE BENCHMARKS
+ */
+
+static
+void _bench_remove(BenchState &state, rif_bench_key_kind_t kind) {
+  BenchKeys keys(kind, state.arg());
+  std::vector<uint32_t> order = _shuffled_indices(state.arg());
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, 0, false);
+  _fill(&hm, keys);
+  state.resume();
+  for (size_t i = 0; i < order.size(); ++i) {
+    rif_hashmap_remove(&hm, keys[order[i]]);
+  }
+  state.pause();
+  rif_hashmap_release(&hm);
+}
+
+static void bench_hashmap_remove_int(BenchState &state) { _bench_remove(state, RIF_BENCH_KEY_INT); }
+static void bench_hashmap_remove_string(BenchState &state) { _bench_remove(state, RIF_BENCH_KEY_STRING); }
+
+RIF_BENCH("hashmap/remove/int", bench_hashmap_remove_int, 1024, 65536, 1048576);
+RIF_BENCH("hashmap/remove/string", bench_hashmap_remove_string, 1024, 65536, 1048576);
+
+/******************************************************************************
+ * MIXED WORKLOAD BENCHMARKS
+ */
+
+/*
+ * Sliding window: the map holds `arg` live keys, and every step removes the oldest key and inserts a new one, then
+ * looks a live key up. This is the typical cache / session table pattern, and the one most sensitive to the deletion
+ * strategy.
+ */
+static
+void bench_hashmap_churn_int(BenchState &state) {
+  uint64_t live = state.arg();
+  uint64_t steps = live * 4;
+  BenchKeys keys(RIF_BENCH_KEY_INT, live + steps);
+  BenchRandom random;
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, 0, false);
+  for (uint64_t i = 0; i < live; ++i) {
+    rif_hashmap_put(&hm, keys[i], keys[i]);
+  }
+  state.resume();
+  for (uint64_t i = 0; i < steps; ++i) {
+    rif_hashmap_remove(&hm, keys[i]);
+    rif_hashmap_put(&hm, keys[i + live], keys[i + live]);
+    rif_bench_keep(rif_hashmap_get(&hm, keys[i + 1 + random.next() % live]));
+  }
+  state.pause();
+  state.set_items(steps);
+  _set_load_counters(state, &hm);
+  rif_hashmap_release(&hm);
+}
+
+RIF_BENCH("hashmap/churn/int", bench_hashmap_churn_int, 1024, 65536);
+
+/*
+ * Iterate over every element of the map.
+ */
+static
+void bench_hashmap_iterate_int(BenchState &state) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, state.arg());
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, 0, false);
+  _fill(&hm, keys);
+  state.resume();
+  rif_hashmap_iterator_t it;
+  rif_pair_t pair;
+  rif_hashmap_iterator_init(&it, &hm, &pair);
+  while (rif_hashmap_iterator_hasnext(&it)) {
+    rif_bench_keep(rif_hashmap_iterator_next(&it));
+  }
+  rif_iterator_destroy((rif_iterator_t *) &it);
+  state.pause();
+  rif_hashmap_release(&hm);
+}
+
+RIF_BENCH("hashmap/iterate/int", bench_hashmap_iterate_int, 1024, 65536, 1048576);
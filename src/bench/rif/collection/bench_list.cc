@@ -0,0 +1,286 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "../bench_internal.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+/*
+ * Lists are benchmarked through the generic `rif_list_t` interface, as user code would.
+ */
+typedef union bench_list_u {
+  rif_arraydeque_t arraydeque;
+  rif_arraylist_t arraylist;
+  rif_linkedlist_t linkedlist;
+} bench_list_t;
+
+typedef enum bench_list_kind_e {
+  BENCH_ARRAYDEQUE,
+  BENCH_ARRAYLIST,
+  BENCH_LINKEDLIST,
+} bench_list_kind_t;
+
+static
+rif_list_t * _init(bench_list_t *storage, bench_list_kind_t kind) {
+  if (BENCH_ARRAYDEQUE == kind) {
+    return (rif_list_t *) rif_arraydeque_init(&storage->arraydeque, 0, false);
+  }
+  if (BENCH_ARRAYLIST == kind) {
+    return (rif_list_t *) rif_arraylist_init(&storage->arraylist, 0, 16);
+  }
+  return (rif_list_t *) rif_linkedlist_init(&storage->linkedlist);
+}
+
+static
+void _fill(rif_list_t *list_ptr, const BenchKeys &vals) {
+  for (size_t i = 0; i < vals.size(); ++i) {
+    rif_list_append(list_ptr, vals[i]);
+  }
+}
+
+#define BENCH_LIST(__op, ...) \
+    static void bench_arraydeque_##__op(BenchState &state) { _bench_##__op(state, BENCH_ARRAYDEQUE); } \
+    static void bench_arraylist_##__op(BenchState &state) { _bench_##__op(state, BENCH_ARRAYLIST); } \
+    static void bench_linkedlist_##__op(BenchState &state) { _bench_##__op(state, BENCH_LINKEDLIST); } \
+    RIF_BENCH("arraydeque/" #__op, bench_arraydeque_##__op, __VA_ARGS__); \
+    RIF_BENCH("arraylist/" #__op, bench_arraylist_##__op, __VA_ARGS__); \
+    RIF_BENCH("linkedlist/" #__op, bench_linkedlist_##__op, __VA_ARGS__)
+
+/******************************************************************************
+ * INSERT BENCHMARKS
+ */
+
+static
+void _bench_append(BenchState &state, bench_list_kind_t kind) {
+  BenchKeys vals(RIF_BENCH_KEY_INT, state.arg());
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  state.resume();
+  _fill(list_ptr, vals);
+  state.pause();
+  rif_val_release(list_ptr);
+}
+
+static
+void _bench_prepend(BenchState &state, bench_list_kind_t kind) {
+  BenchKeys vals(RIF_BENCH_KEY_INT, state.arg());
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  state.resume();
+  for (size_t i = 0; i < vals.size(); ++i) {
+    rif_list_prepend(list_ptr, vals[i]);
+  }
+  state.pause();
+  rif_val_release(list_ptr);
+}
+
+static
+void _bench_insert_middle(BenchState &state, bench_list_kind_t kind) {
+  BenchKeys vals(RIF_BENCH_KEY_INT, state.arg());
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  state.resume();
+  for (size_t i = 0; i < vals.size(); ++i) {
+    rif_list_insert(list_ptr, (uint32_t) (i / 2), vals[i]);
+  }
+  state.pause();
+  rif_val_release(list_ptr);
+}
+
+/*
+ * Builds a list of freshly allocated values, either retaining each one and releasing the caller reference, or handing
+ * the caller reference over to the list. Values are out of the cached integer range, so that each one is counted.
+ */
+static
+void _bench_build(BenchState &state, bench_list_kind_t kind, bool steal) {
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_int_t *int_ptr = rif_int_new((int64_t) (i + RIF_INT_CACHE_MAX + 1));
+    if (steal) {
+      rif_list_append_steal(list_ptr, rif_val(int_ptr));
+    } else {
+      rif_list_append(list_ptr, rif_val(int_ptr));
+      rif_val_release(int_ptr);
+    }
+  }
+  rif_val_release(list_ptr);
+  state.pause();
+}
+
+static void _bench_build_retain(BenchState &state, bench_list_kind_t kind) { _bench_build(state, kind, false); }
+static void _bench_build_steal(BenchState &state, bench_list_kind_t kind) { _bench_build(state, kind, true); }
+
+BENCH_LIST(append, 1024, 65536, 1048576);
+BENCH_LIST(build_retain, 65536, 1048576);
+BENCH_LIST(build_steal, 65536, 1048576);
+BENCH_LIST(prepend, 1024, 16384);
+BENCH_LIST(insert_middle, 1024, 16384);
+
+/******************************************************************************
+ * READ BENCHMARKS
+ */
+
+static
+void _bench_get_sequential(BenchState &state, bench_list_kind_t kind) {
+  BenchKeys vals(RIF_BENCH_KEY_INT, state.arg());
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  _fill(list_ptr, vals);
+  state.resume();
+  for (uint32_t i = 0; i < vals.size(); ++i) {
+    rif_bench_keep(rif_list_get(list_ptr, i));
+  }
+  state.pause();
+  rif_val_release(list_ptr);
+}
+
+static
+void _bench_get_random(BenchState &state, bench_list_kind_t kind) {
+  BenchKeys vals(RIF_BENCH_KEY_INT, state.arg());
+  BenchRandom random;
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  _fill(list_ptr, vals);
+  state.resume();
+  for (uint32_t i = 0; i < vals.size(); ++i) {
+    rif_bench_keep(rif_list_get(list_ptr, (uint32_t) (random.next() % vals.size())));
+  }
+  state.pause();
+  rif_val_release(list_ptr);
+}
+
+static
+void _bench_iterate(BenchState &state, bench_list_kind_t kind) {
+  BenchKeys vals(RIF_BENCH_KEY_INT, state.arg());
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  _fill(list_ptr, vals);
+  state.resume();
+  rif_list_iterator_t it;
+  rif_list_iterator_init(&it, list_ptr);
+  while (rif_iterator_hasnext((rif_iterator_t *) &it)) {
+    rif_bench_keep(rif_iterator_next((rif_iterator_t *) &it));
+  }
+  rif_iterator_destroy((rif_iterator_t *) &it);
+  state.pause();
+  rif_val_release(list_ptr);
+}
+
+BENCH_LIST(get_sequential, 1024, 16384);
+BENCH_LIST(get_random, 1024, 16384);
+BENCH_LIST(iterate, 1024, 65536, 1048576);
+
+/******************************************************************************
+ * REMOVE BENCHMARKS
+ */
+
+static
+void _bench_remove_front(BenchState &state, bench_list_kind_t kind) {
+  BenchKeys vals(RIF_BENCH_KEY_INT, state.arg());
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  _fill(list_ptr, vals);
+  state.resume();
+  for (size_t i = 0; i < vals.size(); ++i) {
+    rif_list_remove(list_ptr, 0);
+  }
+  state.pause();
+  rif_val_release(list_ptr);
+}
+
+static
+void _bench_remove_back(BenchState &state, bench_list_kind_t kind) {
+  BenchKeys vals(RIF_BENCH_KEY_INT, state.arg());
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  _fill(list_ptr, vals);
+  state.resume();
+  for (size_t i = vals.size(); i > 0; --i) {
+    rif_list_remove(list_ptr, (uint32_t) (i - 1));
+  }
+  state.pause();
+  rif_val_release(list_ptr);
+}
+
+BENCH_LIST(remove_front, 1024, 16384);
+BENCH_LIST(remove_back, 1024, 65536, 1048576);
+
+/******************************************************************************
+ * MIXED WORKLOAD BENCHMARKS
+ */
+
+/*
+ * FIFO usage: the list holds `arg` elements, and every step appends at the tail and removes from the head.
+ */
+static
+void _bench_fifo(BenchState &state, bench_list_kind_t kind) {
+  uint64_t live = state.arg();
+  uint64_t steps = live * 4;
+  BenchKeys vals(RIF_BENCH_KEY_INT, live);
+  bench_list_t storage;
+  rif_list_t *list_ptr = _init(&storage, kind);
+  _fill(list_ptr, vals);
+  state.resume();
+  for (uint64_t i = 0; i < steps; ++i) {
+    rif_list_append(list_ptr, vals[i % live]);
+    rif_list_remove(list_ptr, 0);
+  }
+  state.pause();
+  state.set_items(steps);
+  rif_val_release(list_ptr);
+}
+
+BENCH_LIST(fifo, 64, 4096);
+
+/******************************************************************************
+ * ARRAYLIST GROWTH BENCHMARKS
+ */
+
+static
+void _bench_arraylist_append_growth(BenchState &state, rif_arraylist_growth_t growth) {
+  BenchKeys vals(RIF_BENCH_KEY_INT, state.arg());
+  rif_arraylist_t al;
+  rif_arraylist_init(&al, 0, 16);
+  rif_arraylist_set_growth(&al, growth);
+  state.resume();
+  for (size_t i = 0; i < vals.size(); ++i) {
+    rif_arraylist_append(&al, vals[i]);
+  }
+  state.pause();
+  state.set_counter("capacity", rif_arraylist_capacity(&al));
+  rif_arraylist_release(&al);
+}
+
+static void bench_arraylist_append_linear(BenchState &state) {
+  _bench_arraylist_append_growth(state, RIF_ARRAYLIST_GROWTH_LINEAR);
+}
+static void bench_arraylist_append_geometric(BenchState &state) {
+  _bench_arraylist_append_growth(state, RIF_ARRAYLIST_GROWTH_GEOMETRIC);
+}
+static void bench_arraylist_append_double(BenchState &state) {
+  _bench_arraylist_append_growth(state, RIF_ARRAYLIST_GROWTH_DOUBLE);
+}
+
+RIF_BENCH("arraylist/append_growth/linear", bench_arraylist_append_linear, 1024, 65536, 1048576);
+RIF_BENCH("arraylist/append_growth/geometric", bench_arraylist_append_geometric, 1024, 65536, 1048576);
+RIF_BENCH("arraylist/append_growth/double", bench_arraylist_append_double, 1024, 65536, 1048576);
@@ -0,0 +1,181 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "../bench_internal.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+/*
+ * Head-to-head comparison of the map implementations, through the generic `rif_map_t` interface as user code would.
+ * Implementation specific benchmarks live in their own suite.
+ */
+typedef union bench_map_u {
+  rif_hashmap_t hashmap;
+  rif_swissmap_t swissmap;
+} bench_map_t;
+
+typedef enum bench_map_kind_e {
+  BENCH_HASHMAP,
+  BENCH_SWISSMAP,
+} bench_map_kind_t;
+
+static
+rif_map_t * _init(bench_map_t *storage, bench_map_kind_t kind) {
+  if (BENCH_HASHMAP == kind) {
+    return (rif_map_t *) rif_hashmap_init(&storage->hashmap, 0, false);
+  }
+  return (rif_map_t *) rif_swissmap_init(&storage->swissmap, 0, false);
+}
+
+static
+void _fill(rif_map_t *map_ptr, const BenchKeys &keys) {
+  for (size_t i = 0; i < keys.size(); ++i) {
+    rif_map_put(map_ptr, keys[i], keys[i]);
+  }
+}
+
+static
+std::vector<uint32_t> _shuffled_indices(uint64_t count) {
+  std::vector<uint32_t> indices(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    indices[i] = i;
+  }
+  BenchRandom random;
+  for (uint64_t i = count; i > 1; --i) {
+    std::swap(indices[i - 1], indices[random.next() % i]);
+  }
+  return indices;
+}
+
+#define BENCH_MAP(__op, ...) \
+    static void bench_map_hashmap_##__op(BenchState &state) { _bench_##__op(state, BENCH_HASHMAP); } \
+    static void bench_map_swissmap_##__op(BenchState &state) { _bench_##__op(state, BENCH_SWISSMAP); } \
+    RIF_BENCH("map/hashmap/" #__op, bench_map_hashmap_##__op, __VA_ARGS__); \
+    RIF_BENCH("map/swissmap/" #__op, bench_map_swissmap_##__op, __VA_ARGS__)
+
+/******************************************************************************
+ * PUT BENCHMARKS
+ */
+
+static
+void _bench_put(BenchState &state, bench_map_kind_t kind) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, state.arg());
+  bench_map_t storage;
+  rif_map_t *map_ptr = _init(&storage, kind);
+  state.resume();
+  _fill(map_ptr, keys);
+  state.pause();
+  rif_val_release(map_ptr);
+}
+
+BENCH_MAP(put, 1024, 65536, 1048576);
+
+/******************************************************************************
+ * GET BENCHMARKS
+ */
+
+/*
+ * Lookups in random order, so that large maps do not fit in cache.
+ */
+static
+void _bench_get(BenchState &state, bench_map_kind_t kind, bool hit) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, state.arg());
+  BenchKeys probes(RIF_BENCH_KEY_INT, hit ? 0 : state.arg(), state.arg());
+  std::vector<uint32_t> order = _shuffled_indices(state.arg());
+  bench_map_t storage;
+  rif_map_t *map_ptr = _init(&storage, kind);
+  _fill(map_ptr, keys);
+  const BenchKeys &lookups = hit ? keys : probes;
+  state.resume();
+  for (size_t i = 0; i < order.size(); ++i) {
+    rif_bench_keep(rif_map_get(map_ptr, lookups[order[i]]));
+  }
+  state.pause();
+  rif_val_release(map_ptr);
+}
+
+static void _bench_get_hit(BenchState &state, bench_map_kind_t kind) { _bench_get(state, kind, true); }
+static void _bench_get_miss(BenchState &state, bench_map_kind_t kind) { _bench_get(state, kind, false); }
+
+BENCH_MAP(get_hit, 1024, 65536, 1048576, 10485760);
+BENCH_MAP(get_miss, 1024, 65536, 1048576, 10485760);
+
+/******************************************************************************
+ * REMOVE BENCHMARKS
+ */
+
+static
+void _bench_remove(BenchState &state, bench_map_kind_t kind) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, state.arg());
+  std::vector<uint32_t> order = _shuffled_indices(state.arg());
+  bench_map_t storage;
+  rif_map_t *map_ptr = _init(&storage, kind);
+  _fill(map_ptr, keys);
+  state.resume();
+  for (size_t i = 0; i < order.size(); ++i) {
+    rif_map_remove(map_ptr, keys[order[i]]);
+  }
+  state.pause();
+  rif_val_release(map_ptr);
+}
+
+BENCH_MAP(remove, 1024, 65536, 1048576);
+
+/******************************************************************************
+ * MIXED WORKLOAD BENCHMARKS
+ */
+
+/*
+ * Sliding window of `live` keys: every step removes the oldest key, inserts a new one, and looks a live key up.
+ */
+static
+void _bench_churn_window(BenchState &state, bench_map_kind_t kind, uint64_t live) {
+  uint64_t steps = live * 4;
+  BenchKeys keys(RIF_BENCH_KEY_INT, live + steps);
+  BenchRandom random;
+  bench_map_t storage;
+  rif_map_t *map_ptr = _init(&storage, kind);
+  for (uint64_t i = 0; i < live; ++i) {
+    rif_map_put(map_ptr, keys[i], keys[i]);
+  }
+  state.resume();
+  for (uint64_t i = 0; i < steps; ++i) {
+    rif_map_remove(map_ptr, keys[i]);
+    rif_map_put(map_ptr, keys[i + live], keys[i + live]);
+    rif_bench_keep(rif_map_get(map_ptr, keys[i + 1 + random.next() % live]));
+  }
+  state.pause();
+  state.set_items(steps);
+  rif_val_release(map_ptr);
+}
+
+static void _bench_churn(BenchState &state, bench_map_kind_t kind) { _bench_churn_window(state, kind, state.arg()); }
+
+/*
+ * Same sliding window, sized so that the swissmap sits right at its maximum load of 7/8 of `arg` slots.
+ */
+static
+void _bench_churn_full(BenchState &state, bench_map_kind_t kind) {
+  _bench_churn_window(state, kind, state.arg() - state.arg() / 8);
+}
+
+BENCH_MAP(churn, 1024, 65536);
+BENCH_MAP(churn_full, 1024, 65536);
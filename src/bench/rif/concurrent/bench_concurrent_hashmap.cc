@@ -0,0 +1,143 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+
+#include "../bench_internal.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+#define BENCH_KEY_COUNT       65536
+#define BENCH_OPS_PER_THREAD  262144
+
+/*
+ * Baseline: a plain hashmap behind a single global lock, which is what user code would do without a concurrent map.
+ */
+typedef struct bench_locked_hashmap_s {
+  mtx_t lock;
+  rif_hashmap_t map;
+} bench_locked_hashmap_t;
+
+typedef struct bench_worker_s {
+  void *map_ptr;
+  const BenchKeys *keys;
+  uint64_t seed;
+} bench_worker_t;
+
+/*
+ * Read-mostly workload: 90% lookups, 10% replacements of existing keys, over random keys.
+ */
+#define BENCH_WORKER(__name, __get, __put) \
+    static int __name(void *arg) { \
+      bench_worker_t *worker = (bench_worker_t *) arg; \
+      const BenchKeys &keys = *worker->keys; \
+      uint64_t state = worker->seed; \
+      for (uint32_t i = 0; i < BENCH_OPS_PER_THREAD; ++i) { \
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL; \
+        rif_val_t *key_ptr = keys[(state >> 33) % BENCH_KEY_COUNT]; \
+        if ((state >> 20) % 10) { \
+          rif_bench_keep(__get); \
+        } else { \
+          __put; \
+        } \
+      } \
+      return 0; \
+    }
+
+static
+rif_val_t * _locked_get(bench_locked_hashmap_t *lhm_ptr, rif_val_t *key_ptr) {
+  mtx_lock(&lhm_ptr->lock);
+  rif_val_t *val_ptr = rif_hashmap_get(&lhm_ptr->map, key_ptr);
+  mtx_unlock(&lhm_ptr->lock);
+  return val_ptr;
+}
+
+static
+void _locked_put(bench_locked_hashmap_t *lhm_ptr, rif_val_t *key_ptr) {
+  mtx_lock(&lhm_ptr->lock);
+  rif_hashmap_put(&lhm_ptr->map, key_ptr, key_ptr);
+  mtx_unlock(&lhm_ptr->lock);
+}
+
+BENCH_WORKER(_bench_worker_concurrent,
+             rif_concurrent_hashmap_get((rif_concurrent_hashmap_t *) worker->map_ptr, key_ptr),
+             rif_concurrent_hashmap_put((rif_concurrent_hashmap_t *) worker->map_ptr, key_ptr, key_ptr))
+
+BENCH_WORKER(_bench_worker_locked,
+             _locked_get((bench_locked_hashmap_t *) worker->map_ptr, key_ptr),
+             _locked_put((bench_locked_hashmap_t *) worker->map_ptr, key_ptr))
+
+static
+void _run_workers(BenchState &state, thrd_start_t fn, void *map_ptr, const BenchKeys &keys) {
+  uint32_t thread_count = (uint32_t) state.arg();
+  std::vector<thrd_t> threads(thread_count);
+  std::vector<bench_worker_t> workers(thread_count);
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    workers[i].map_ptr = map_ptr;
+    workers[i].keys = &keys;
+    workers[i].seed = i + 1;
+  }
+  state.resume();
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    thrd_create(&threads[i], fn, &workers[i]);
+  }
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    thrd_join(threads[i], NULL);
+  }
+  state.pause();
+  state.set_items((uint64_t) thread_count * BENCH_OPS_PER_THREAD);
+}
+
+/******************************************************************************
+ * SCALING BENCHMARKS
+ */
+
+/*
+ * Aggregate ns/op across all threads: with perfect scaling, the figure divides by the thread count.
+ */
+static
+void bench_concurrent_hashmap_read_mostly(BenchState &state) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, BENCH_KEY_COUNT);
+  rif_concurrent_hashmap_t chm;
+  rif_concurrent_hashmap_init(&chm, BENCH_KEY_COUNT, 0);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    rif_concurrent_hashmap_put(&chm, keys[i], keys[i]);
+  }
+  _run_workers(state, _bench_worker_concurrent, &chm, keys);
+  rif_concurrent_hashmap_release(&chm);
+}
+
+RIF_BENCH("concurrent_hashmap/read_mostly", bench_concurrent_hashmap_read_mostly, 1, 2, 4, 8);
+
+static
+void bench_locked_hashmap_read_mostly(BenchState &state) {
+  BenchKeys keys(RIF_BENCH_KEY_INT, BENCH_KEY_COUNT);
+  bench_locked_hashmap_t lhm;
+  mtx_init(&lhm.lock, mtx_plain);
+  rif_hashmap_init(&lhm.map, BENCH_KEY_COUNT, false);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    rif_hashmap_put(&lhm.map, keys[i], keys[i]);
+  }
+  _run_workers(state, _bench_worker_locked, &lhm, keys);
+  rif_hashmap_release(&lhm.map);
+  mtx_destroy(&lhm.lock);
+}
+
+RIF_BENCH("concurrent_hashmap/locked_baseline/read_mostly", bench_locked_hashmap_read_mostly, 1, 2, 4, 8);
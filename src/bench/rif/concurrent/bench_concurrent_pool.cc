@@ -0,0 +1,89 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "../bench_internal.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+#define BENCH_OPS_PER_THREAD  262144
+#define BENCH_LIVE_PER_THREAD 16
+
+/*
+ * Every thread borrows a handful of elements and returns them, as the concurrent queue does on push / pop.
+ */
+static
+int _bench_worker(void *arg) {
+  rif_concurrent_pool_t *pool_ptr = (rif_concurrent_pool_t *) arg;
+  void *live[BENCH_LIVE_PER_THREAD];
+  for (uint32_t i = 0; i < BENCH_OPS_PER_THREAD / BENCH_LIVE_PER_THREAD; ++i) {
+    for (uint32_t j = 0; j < BENCH_LIVE_PER_THREAD; ++j) {
+      live[j] = rif_concurrent_pool_borrow(pool_ptr);
+    }
+    rif_bench_keep(live[0]);
+    for (uint32_t j = 0; j < BENCH_LIVE_PER_THREAD; ++j) {
+      rif_concurrent_pool_return(pool_ptr, live[j]);
+    }
+  }
+  return 0;
+}
+
+static
+void _bench_borrow_return(BenchState &state, bool magazines) {
+  uint32_t thread_count = (uint32_t) state.arg();
+  std::vector<thrd_t> threads(thread_count);
+  rif_concurrent_pool_t pool;
+  rif_concurrent_pool_init(&pool, sizeof(uint64_t));
+  pool.magazines = pool.magazines && magazines;
+  state.resume();
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    thrd_create(&threads[i], _bench_worker, &pool);
+  }
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    thrd_join(threads[i], NULL);
+  }
+  state.pause();
+  state.set_items((uint64_t) thread_count * BENCH_OPS_PER_THREAD);
+  rif_concurrent_pool_destroy(&pool);
+}
+
+/******************************************************************************
+ * SCALING BENCHMARKS
+ */
+
+/*
+ * Aggregate ns per borrow / return pair across all threads.
+ */
+static
+void bench_concurrent_pool_borrow_return(BenchState &state) {
+  _bench_borrow_return(state, true);
+}
+
+RIF_BENCH("concurrent_pool/borrow_return", bench_concurrent_pool_borrow_return, 1, 2, 4, 8);
+
+/*
+ * Baseline: the same workload with magazines disabled, every operation going through the shared free stack.
+ */
+static
+void bench_concurrent_pool_shared_borrow_return(BenchState &state) {
+  _bench_borrow_return(state, false);
+}
+
+RIF_BENCH("concurrent_pool/shared_baseline/borrow_return", bench_concurrent_pool_shared_borrow_return, 1, 2, 4, 8);
@@ -0,0 +1,111 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "../bench_internal.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+/*
+ * Request-scoped object graph: a list of `count` (int, string) pairs.
+ */
+static
+rif_arraylist_t * _build_graph(rif_arraylist_t *al_ptr, uint64_t count) {
+  rif_arraylist_init(al_ptr, 0, 0);
+  for (uint64_t i = 0; i < count; ++i) {
+    rif_int_t *int_ptr = rif_int_new((int64_t) i);
+    rif_string_t *str_ptr = rif_string_new_dup("request-scoped value");
+    rif_pair_t *pair_ptr = rif_pair_new(rif_val(int_ptr), rif_val(str_ptr));
+    rif_arraylist_append(al_ptr, rif_val(pair_ptr));
+    rif_val_release(pair_ptr);
+    rif_val_release(str_ptr);
+    rif_val_release(int_ptr);
+  }
+  return al_ptr;
+}
+
+/******************************************************************************
+ * GRAPH BENCHMARKS
+ */
+
+/*
+ * Build the graph with the heap allocators, then release it value by value.
+ */
+static
+void bench_arena_graph_heap(BenchState &state) {
+  rif_arraylist_t al;
+  state.resume();
+  _build_graph(&al, state.arg());
+  rif_arraylist_release(&al);
+  state.pause();
+  state.set_items(state.arg());
+}
+
+RIF_BENCH("arena/graph/heap", bench_arena_graph_heap, 1024, 65536);
+
+/*
+ * Build the same graph with an arena current, then drop it with a single reset.
+ */
+static
+void bench_arena_graph_arena(BenchState &state) {
+  rif_arena_t arena;
+  rif_arena_init(&arena, 0);
+  rif_arraylist_t al;
+  state.resume();
+  rif_arena_t *previous = rif_arena_set_current(&arena);
+  _build_graph(&al, state.arg());
+  rif_arena_set_current(previous);
+  rif_arena_reset(&arena);
+  state.pause();
+  state.set_items(state.arg());
+  rif_arena_destroy(&arena);
+}
+
+RIF_BENCH("arena/graph/arena", bench_arena_graph_arena, 1024, 65536);
+
+/******************************************************************************
+ * SCOPE BENCHMARKS
+ */
+
+/*
+ * Free `arg` heap blocks while an arena holding `arg` chunks is current: every free first checks arena ownership.
+ */
+static
+void bench_arena_scope_free_heap(BenchState &state) {
+  std::vector<void *> ptrs(state.arg());
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    ptrs[i] = rif_malloc(64);
+  }
+  rif_arena_t arena;
+  rif_arena_init(&arena, 4096);
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_arena_alloc(&arena, 4000);
+  }
+  rif_arena_t *previous = rif_arena_set_current(&arena);
+  state.resume();
+  for (uint64_t i = 0; i < state.arg(); ++i) {
+    rif_free(ptrs[i]);
+  }
+  state.pause();
+  rif_arena_set_current(previous);
+  rif_arena_destroy(&arena);
+}
+
+RIF_BENCH("arena/scope/free_heap", bench_arena_scope_free_heap, 1024, 16384);
@@ -0,0 +1,265 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "../rif/bench_internal.h"
+
+/******************************************************************************
+ * REGISTRY
+ */
+
+typedef struct rif_bench_case_s {
+  std::string name;
+  rif_bench_fn_t fn;
+  uint64_t arg;
+} rif_bench_case_t;
+
+typedef struct rif_bench_result_s {
+  std::string name;
+  uint64_t arg;
+  uint64_t items;
+  uint32_t repetitions;
+  double ns_min;
+  double ns_median;
+  double ns_mean;
+  std::vector<std::pair<std::string, double> > counters;
+} rif_bench_result_t;
+
+static
+std::vector<rif_bench_case_t> & _rif_bench_registry() {
+  static std::vector<rif_bench_case_t> registry;
+  return registry;
+}
+
+BenchRegistrar::BenchRegistrar(const char *name, rif_bench_fn_t fn, std::initializer_list<uint64_t> args) {
+  for (uint64_t arg : args) {
+    rif_bench_case_t bench_case = {name, fn, arg};
+    _rif_bench_registry().push_back(bench_case);
+  }
+}
+
+/******************************************************************************
+ * RUNNER
+ */
+
+static
+rif_bench_result_t _rif_bench_run(const rif_bench_case_t &bench_case, uint32_t repetitions) {
+
+  // Warm caches and allocator up
+  {
+    BenchState warmup(bench_case.arg);
+    bench_case.fn(warmup);
+  }
+
+  std::vector<double> samples;
+  rif_bench_result_t result;
+  result.name = bench_case.name;
+  result.arg = bench_case.arg;
+  result.repetitions = repetitions;
+  result.items = 0;
+
+  for (uint32_t rep = 0; rep < repetitions; ++rep) {
+    BenchState state(bench_case.arg);
+    bench_case.fn(state);
+    uint64_t items = std::max<uint64_t>(1, state.items());
+    samples.push_back((double) state.elapsed_ns() / (double) items);
+    result.items = items;
+    result.counters = state.counters();
+  }
+
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    sum += samples[i];
+  }
+  result.ns_min = samples.front();
+  result.ns_median = samples[samples.size() / 2];
+  result.ns_mean = sum / samples.size();
+  return result;
+}
+
+/******************************************************************************
+ * REPORTERS
+ */
+
+static
+std::string _rif_bench_fullname(const rif_bench_result_t &result) {
+  return result.name + "/" + std::to_string((unsigned long long) result.arg);
+}
+
+static
+double _rif_bench_throughput(const rif_bench_result_t &result) {
+  return result.ns_median > 0 ? 1e9 / result.ns_median : 0;
+}
+
+static
+void _rif_bench_report_text(FILE *out, const std::vector<rif_bench_result_t> &results) {
+  fprintf(out, "%-48s %12s %12s %12s %14s\n", "benchmark", "ns/op (min)", "ns/op (med)", "ns/op (mean)", "ops/s");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const rif_bench_result_t &result = results[i];
+    fprintf(out, "%-48s %12.2f %12.2f %12.2f %14.0f",
+            _rif_bench_fullname(result).c_str(), result.ns_min, result.ns_median, result.ns_mean,
+            _rif_bench_throughput(result));
+    for (size_t c = 0; c < result.counters.size(); ++c) {
+      fprintf(out, " %s=%.10g", result.counters[c].first.c_str(), result.counters[c].second);
+    }
+    fprintf(out, "\n");
+  }
+}
+
+static
+void _rif_bench_report_csv(FILE *out, const std::vector<rif_bench_result_t> &results) {
+  fprintf(out, "name,arg,items,repetitions,ns_per_op_min,ns_per_op_median,ns_per_op_mean,ops_per_second,counters\n");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const rif_bench_result_t &result = results[i];
+    fprintf(out, "%s,%llu,%llu,%u,%.3f,%.3f,%.3f,%.0f,",
+            result.name.c_str(), (unsigned long long) result.arg, (unsigned long long) result.items,
+            result.repetitions, result.ns_min, result.ns_median, result.ns_mean, _rif_bench_throughput(result));
+    for (size_t c = 0; c < result.counters.size(); ++c) {
+      fprintf(out, "%s%s=%.10g", c ? ";" : "", result.counters[c].first.c_str(), result.counters[c].second);
+    }
+    fprintf(out, "\n");
+  }
+}
+
+static
+void _rif_bench_report_json(FILE *out, const std::vector<rif_bench_result_t> &results) {
+  const rif_package_version_t *version = rif_get_package_version();
+  char date[32];
+  time_t now = time(NULL);
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"context\": {\n");
+  fprintf(out, "    \"library\": \"rif\",\n");
+  fprintf(out, "    \"version\": \"%u.%u\",\n", version->major, version->minor);
+  fprintf(out, "    \"date\": \"%s\"\n", date);
+  fprintf(out, "  },\n");
+  fprintf(out, "  \"benchmarks\": [");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const rif_bench_result_t &result = results[i];
+    fprintf(out, "%s\n    {\n", i ? "," : "");
+    fprintf(out, "      \"name\": \"%s\",\n", _rif_bench_fullname(result).c_str());
+    fprintf(out, "      \"benchmark\": \"%s\",\n", result.name.c_str());
+    fprintf(out, "      \"arg\": %llu,\n", (unsigned long long) result.arg);
+    fprintf(out, "      \"items\": %llu,\n", (unsigned long long) result.items);
+    fprintf(out, "      \"repetitions\": %u,\n", result.repetitions);
+    fprintf(out, "      \"ns_per_op_min\": %.3f,\n", result.ns_min);
+    fprintf(out, "      \"ns_per_op_median\": %.3f,\n", result.ns_median);
+    fprintf(out, "      \"ns_per_op_mean\": %.3f,\n", result.ns_mean);
+    fprintf(out, "      \"ops_per_second\": %.0f,\n", _rif_bench_throughput(result));
+    fprintf(out, "      \"counters\": {");
+    for (size_t c = 0; c < result.counters.size(); ++c) {
+      fprintf(out, "%s\"%s\": %.10g", c ? ", " : "", result.counters[c].first.c_str(), result.counters[c].second);
+    }
+    fprintf(out, "}\n    }");
+  }
+  fprintf(out, "\n  ]\n}\n");
+}
+
+/******************************************************************************
+ * BENCH MAIN
+ */
+
+static
+void _rif_bench_usage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  --format=text|csv|json  output format (default: text)\n"
+          "  --filter=SUBSTRING      only run benchmarks whose name contains SUBSTRING\n"
+          "  --repetitions=N         measured repetitions per benchmark (default: 5)\n"
+          "  --out=PATH              write results to PATH instead of stdout\n"
+          "  --list                  list benchmarks and exit\n",
+          program);
+}
+
+int main(int argc, char **argv) {
+
+  const char *format = "text";
+  const char *filter = NULL;
+  const char *out_path = NULL;
+  uint32_t repetitions = 5;
+  bool list = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (0 == strncmp(argv[i], "--format=", 9)) {
+      format = argv[i] + 9;
+    } else if (0 == strncmp(argv[i], "--filter=", 9)) {
+      filter = argv[i] + 9;
+    } else if (0 == strncmp(argv[i], "--repetitions=", 14)) {
+      repetitions = (uint32_t) std::max(1L, strtol(argv[i] + 14, NULL, 10));
+    } else if (0 == strncmp(argv[i], "--out=", 6)) {
+      out_path = argv[i] + 6;
+    } else if (0 == strcmp(argv[i], "--list")) {
+      list = true;
+    } else {
+      _rif_bench_usage(argv[0]);
+      return 0 == strcmp(argv[i], "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  if (strcmp(format, "text") && strcmp(format, "csv") && strcmp(format, "json")) {
+    _rif_bench_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  FILE *out = stdout;
+  if (out_path && NULL == (out = fopen(out_path, "w"))) {
+    perror(out_path);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<rif_bench_result_t> results;
+  const std::vector<rif_bench_case_t> &registry = _rif_bench_registry();
+  for (size_t i = 0; i < registry.size(); ++i) {
+    const rif_bench_case_t &bench_case = registry[i];
+    std::string fullname = bench_case.name + "/" + std::to_string((unsigned long long) bench_case.arg);
+    if (filter && std::string::npos == fullname.find(filter)) {
+      continue;
+    }
+    if (list) {
+      fprintf(out, "%s\n", fullname.c_str());
+      continue;
+    }
+    if (out != stdout || strcmp(format, "text")) {
+      fprintf(stderr, "running %s\n", fullname.c_str());
+    }
+    results.push_back(_rif_bench_run(bench_case, repetitions));
+  }
+
+  if (!list) {
+    if (0 == strcmp(format, "csv")) {
+      _rif_bench_report_csv(out, results);
+    } else if (0 == strcmp(format, "json")) {
+      _rif_bench_report_json(out, results);
+    } else {
+      _rif_bench_report_text(out, results);
+    }
+  }
+
+  if (out != stdout) {
+    fclose(out);
+  }
+  return EXIT_SUCCESS;
+}
@@ -161,11 +161,11 @@ uint32_t rif_bool_hashcode_callback(const rif_val_t *val_ptr);
 /**
  * @private
  *
- * Value tostring callback for @ref rif_bool_t.
+ * Value write callback for @ref rif_bool_t.
  *
  * @memberof rif_bool_t
  */
-char * rif_bool_tostring_callback(const rif_val_t *val_ptr);
+rif_status_t rif_bool_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /*****************************************************************************/
 
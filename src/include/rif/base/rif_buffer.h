@@ -0,0 +1,329 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+/**
+ * @file
+ * @brief Rif byte buffer type.
+ *
+ * A `rif_buffer_t` is an immutable sequence of bytes, which may contain zeros. Its storage is either heap memory owned
+ * by the buffer, external memory handed back to its owner through a release callback, or a read-only memory mapping
+ * of a file region.
+ *
+ * Slicing a buffer does not copy any byte: the slice points into the storage of the buffer, and keeps it alive by
+ * holding a reference to it. Slices of slices refer to the buffer holding the storage directly, so that chains of
+ * slices never grow.
+ */
+
+#pragma once
+
+#include "rif/base/rif_val.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ */
+
+/**
+ * Release callback of buffers wrapping external memory.
+ *
+ * @param data the wrapped memory
+ * @param len  the length of the wrapped memory, in bytes
+ * @param ctx  the context given when creating the buffer
+ */
+typedef void (*rif_buffer_release_t)(void *data, size_t len, void *ctx);
+
+/**
+ * Buffer storage kinds.
+ */
+typedef enum rif_buffer_storage_e {
+
+  RIF_BUFFER_STORAGE_BORROWED = 0, /**< Memory which outlives the buffer */
+  RIF_BUFFER_STORAGE_OWNED    = 1, /**< Heap memory freed with the buffer */
+  RIF_BUFFER_STORAGE_EXTERNAL = 2, /**< External memory released through a callback */
+  RIF_BUFFER_STORAGE_MAPPED   = 3, /**< Memory mapping of a file region */
+  RIF_BUFFER_STORAGE_SLICE    = 4  /**< Part of the storage of another buffer */
+
+} rif_buffer_storage_t;
+
+/**
+ * Rif byte buffer type.
+ *
+ * @note This structure internal members are private, and may change without notice. They should only be accessed
+ *       through the public `rif_buffer_t` methods.
+ *
+ * @extends rif_val_t
+ */
+typedef struct rif_buffer_s {
+
+  /**
+   * @private
+   *
+   * `rif_buffer_t` is a `rif_val_t` subtype.
+   */
+  rif_val_t _;
+
+  /**
+   * @private
+   *
+   * Buffer bytes.
+   */
+  uint8_t *data;
+
+  /**
+   * @private
+   *
+   * Buffer length, in bytes.
+   */
+  size_t len;
+
+  /**
+   * @private
+   *
+   * Memoized buffer hash, or `0` if not computed yet. Accessed with relaxed atomics, as buffers may be hashed
+   * concurrently.
+   */
+  atomic_uint32_t hash;
+
+  /**
+   * @private
+   *
+   * Storage kind, as a `rif_buffer_storage_t`.
+   */
+  uint8_t storage;
+
+  /**
+   * @private
+   *
+   * Storage specific members.
+   */
+  union {
+
+    /**
+     * @private
+     *
+     * Buffer holding the storage of a slice.
+     */
+    struct rif_buffer_s *parent;
+
+    /**
+     * @private
+     *
+     * Release callback and context of external memory.
+     */
+    struct {
+      rif_buffer_release_t release;
+      void *ctx;
+    } external;
+
+    /**
+     * @private
+     *
+     * Page-aligned address and length of a memory mapping.
+     */
+    struct {
+      void *addr;
+      size_t len;
+    } mapping;
+
+  } u;
+
+} rif_buffer_t;
+
+/******************************************************************************
+ * MACROS
+ */
+
+/**
+ * Cast a `rif_val_t` to `rif_buffer_t`.
+ *
+ * @param  __val The `rif_val_t`.
+ * @return       The casted `rif_buffer_t`.
+ */
+#define rif_buffer_fromval(__val_ptr) (rif_val_tosubtype(__val_ptr, RIF_BUFFER, rif_buffer_t))
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+/**
+ * Initializes a `rif_buffer_t` wrapping memory.
+ *
+ * @param buf_ptr the buffer to initialize
+ * @param data    the buffer bytes
+ * @param len     the buffer length, in bytes
+ * @param free    if `true`, `data` will be freed when the `rif_buffer_t` is destroyed
+ * @return        the initialized buffer
+ */
+RIF_API
+rif_buffer_t * rif_buffer_init(rif_buffer_t *buf_ptr, void *data, size_t len, bool free);
+
+/**
+ * Allocates and initializes a `rif_buffer_t` wrapping memory.
+ *
+ * @param data the buffer bytes
+ * @param len  the buffer length, in bytes
+ * @param free if `true`, `data` will be freed when the `rif_buffer_t` is destroyed
+ * @return     the new `rif_buffer_t`, or `NULL` if memory allocation failed
+ */
+RIF_API
+rif_buffer_t * rif_buffer_new(void *data, size_t len, bool free);
+
+/**
+ * Allocates and initializes a `rif_buffer_t` holding a copy of some bytes.
+ *
+ * @param data the bytes to copy
+ * @param len  the number of bytes to copy
+ * @return     the new `rif_buffer_t`, or `NULL` if memory allocation failed
+ */
+RIF_API
+rif_buffer_t * rif_buffer_new_copy(const void *data, size_t len);
+
+/**
+ * Allocates and initializes a `rif_buffer_t` wrapping external memory. When the buffer and all its slices are
+ * destroyed, the memory is handed back to its owner by calling `release`.
+ *
+ * @param data    the buffer bytes
+ * @param len     the buffer length, in bytes
+ * @param release the release callback, or `NULL` if the memory outlives the buffer
+ * @param ctx     the context passed to `release`
+ * @return        the new `rif_buffer_t`, or `NULL` if memory allocation failed, in which case `release` is not
+ *                called
+ */
+RIF_API
+rif_buffer_t * rif_buffer_new_external(void *data, size_t len, rif_buffer_release_t release, void *ctx);
+
+/**
+ * Allocates and initializes a `rif_buffer_t` mapping a region of a file, read-only. The mapping is private to the
+ * process, and is unmapped when the buffer and all its slices are destroyed. The file descriptor can be closed once the
+ * buffer is created.
+ *
+ * @param fd     the file descriptor of the file to map
+ * @param offset the offset of the region in the file, in bytes ; it does not need to be page-aligned
+ * @param len    the length of the region, in bytes
+ * @return       the new `rif_buffer_t`, or `NULL` if the region could not be mapped or memory allocation failed
+ */
+RIF_API
+rif_buffer_t * rif_buffer_new_mmap(int fd, off_t offset, size_t len);
+
+/**
+ * Releases a `rif_buffer_t`. If the reference count reaches 0, the value will be freed.
+ *
+ * @param buf_ptr the `rif_buffer_t` to release
+ */
+RIF_INLINE
+void rif_buffer_release(rif_buffer_t *buf_ptr) {
+  rif_val_release(buf_ptr);
+}
+
+/******************************************************************************
+ * SLICING FUNCTIONS
+ */
+
+/**
+ * Creates a `rif_buffer_t` viewing a part of a buffer, without copying its bytes. The slice keeps the storage of the
+ * buffer alive.
+ *
+ * @param buf_ptr the buffer to slice
+ * @param offset  the offset of the slice in the buffer, in bytes
+ * @param len     the length of the slice, in bytes
+ * @return        the new `rif_buffer_t`, or `NULL` if the slice is out of the bounds of the buffer or memory allocation
+ *                failed
+ */
+RIF_API
+rif_buffer_t * rif_buffer_slice(rif_buffer_t *buf_ptr, size_t offset, size_t len);
+
+/******************************************************************************
+ * ACCESSOR FUNCTIONS
+ */
+
+/**
+ * Get the bytes of a `rif_buffer_t`.
+ *
+ * @param buf_ptr the buffer
+ * @return        the buffer bytes, or `NULL` if `buf_ptr` is `NULL`
+ */
+RIF_INLINE
+const uint8_t * rif_buffer_data(const rif_buffer_t *buf_ptr) {
+  return buf_ptr ? buf_ptr->data : NULL;
+}
+
+/**
+ * Get the length of a `rif_buffer_t`.
+ *
+ * @param buf_ptr the buffer
+ * @return        the buffer length, in bytes, or `0` if `buf_ptr` is `NULL`
+ */
+RIF_INLINE
+size_t rif_buffer_len(const rif_buffer_t *buf_ptr) {
+  return buf_ptr ? buf_ptr->len : 0;
+}
+
+/**
+ * Get the storage kind of a `rif_buffer_t`.
+ *
+ * @param buf_ptr the buffer
+ * @return        the buffer storage kind
+ */
+RIF_INLINE
+rif_buffer_storage_t rif_buffer_storage(const rif_buffer_t *buf_ptr) {
+  return (rif_buffer_storage_t) buf_ptr->storage;
+}
+
+/******************************************************************************
+ * CALLBACK FUNCTIONS
+ */
+
+/**
+ * @private
+ *
+ * Callback function to destroy a `rif_buffer_t`.
+ */
+void rif_buffer_destroy_callback(rif_val_t *val_ptr);
+
+/**
+ * @private
+ *
+ * Callback function get the hashcode of a `rif_buffer_t`.
+ */
+uint32_t rif_buffer_hashcode_callback(const rif_val_t *val_ptr);
+
+/**
+ * @private
+ *
+ * Callback function to compare equality of two values.
+ */
+bool rif_buffer_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_ptr);
+
+/**
+ * @private
+ *
+ * Callback function to append the string representation of a `rif_buffer_t` to a string buffer.
+ */
+rif_status_t rif_buffer_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
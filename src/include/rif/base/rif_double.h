@@ -106,6 +106,22 @@ rif_double_t * rif_double_init(rif_double_t *dbl_ptr, double value);
 RIF_API
 rif_double_t * rif_double_new(double value);
 
+/**
+ * Get a @ref rif_double_t for a double value, sharing an immortal instance for `0.0`, `1.0` and NaN values.
+ *
+ * Shared instances are never freed, and retaining or releasing them does nothing. Every NaN value maps to the same
+ * shared quiet NaN. Other values, including `-0.0`, are allocated as with @ref rif_double_new. In both cases, the
+ * returned value should be released as usual.
+ *
+ * @param value The double value.
+ * @return      The shared or newly allocated @ref rif_double_t,
+ *              or null if allocation or initialization failed.
+ *
+ * @public @memberof rif_double_t
+ */
+RIF_API
+rif_double_t * rif_double_get_cached(double value);
+
 /**
  * Release a @ref rif_double_t.
  *
@@ -122,6 +138,27 @@ void rif_double_release(rif_double_t *dbl_ptr) {
   rif_val_release(dbl_ptr);
 }
 
+/******************************************************************************
+ * CACHE SETTINGS
+ */
+
+/**
+ * Enable or disable shared instances in @ref rif_double_new. When enabled, @ref rif_double_new behaves as
+ * @ref rif_double_get_cached. Disabled by default.
+ *
+ * @param enabled whether @ref rif_double_new should return shared instances.
+ */
+RIF_API
+void rif_double_set_cache_enabled(bool enabled);
+
+/**
+ * Check whether @ref rif_double_new returns shared instances.
+ *
+ * @return `true` if shared instances are enabled, or `false` otherwise.
+ */
+RIF_API
+bool rif_double_cache_enabled(void);
+
 /******************************************************************************
  * API
  */
@@ -188,11 +225,11 @@ bool rif_double_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other
 /**
  * @private
  *
- * Value tostring callback for @ref rif_bool_t.
+ * Value write callback for @ref rif_bool_t.
  *
  * @memberof rif_double_t
  */
-char * rif_double_tostring_callback(const rif_val_t *val_ptr);
+rif_status_t rif_double_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /*****************************************************************************/
 
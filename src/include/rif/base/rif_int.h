@@ -32,6 +32,34 @@
 extern "C" {
 #endif
 
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Smallest integer value with a shared immortal instance.
+ */
+#ifndef RIF_INT_CACHE_MIN
+#define RIF_INT_CACHE_MIN (-128)
+#endif
+
+/**
+ * Largest integer value with a shared immortal instance.
+ */
+#ifndef RIF_INT_CACHE_MAX
+#define RIF_INT_CACHE_MAX 1023
+#endif
+
+/**
+ * Smallest integer value which can be encoded as an immediate value.
+ */
+#define RIF_INT_IMMEDIATE_MIN ((int64_t) (INTPTR_MIN >> 2))
+
+/**
+ * Largest integer value which can be encoded as an immediate value.
+ */
+#define RIF_INT_IMMEDIATE_MAX ((int64_t) (INTPTR_MAX >> 2))
+
 /******************************************************************************
  * TYPES
  */
@@ -106,6 +134,44 @@ rif_int_t * rif_int_init(rif_int_t *int_ptr, int64_t value);
 RIF_API
 rif_int_t * rif_int_new(int64_t value);
 
+/**
+ * Get a @ref rif_int_t for an integer value, sharing an immortal instance if the value is between
+ * @ref RIF_INT_CACHE_MIN and @ref RIF_INT_CACHE_MAX.
+ *
+ * Shared instances are never freed, and retaining or releasing them does nothing. Other values are allocated as with
+ * @ref rif_int_new. In both cases, the returned value should be released as usual.
+ *
+ * @param value The integer value.
+ * @return      The shared or newly allocated @ref rif_int_t,
+ *              or null if allocation or initialization failed.
+ *
+ * @public @memberof rif_int_t
+ */
+RIF_API
+rif_int_t * rif_int_get_cached(int64_t value);
+
+/**
+ * Get a @ref rif_int_t for an integer value, encoded as an immediate value if it is between
+ * @ref RIF_INT_IMMEDIATE_MIN and @ref RIF_INT_IMMEDIATE_MAX.
+ *
+ * Immediate values are not allocated, and retaining or releasing them does nothing. They can be used anywhere a
+ * @ref rif_int_t is expected, but @b MUST NOT be dereferenced: see @ref rif_val_isimmediate. Other values are allocated
+ * as with @ref rif_int_new. In both cases, the returned value should be released as usual.
+ *
+ * @param value The integer value.
+ * @return      The immediate or newly allocated @ref rif_int_t,
+ *              or null if allocation or initialization failed.
+ *
+ * @public @memberof rif_int_t
+ */
+RIF_INLINE
+rif_int_t * rif_int_new_immediate(int64_t value) {
+  if (value < RIF_INT_IMMEDIATE_MIN || value > RIF_INT_IMMEDIATE_MAX) {
+    return rif_int_new(value);
+  }
+  return (rif_int_t *) (((uintptr_t) value << 2) | RIF_VAL_IMMEDIATE_INT_TAG);
+}
+
 /**
  * Release a @ref rif_int_t.
  *
@@ -122,6 +188,27 @@ void rif_int_release(rif_int_t *int_ptr) {
   rif_val_release(int_ptr);
 }
 
+/******************************************************************************
+ * CACHE SETTINGS
+ */
+
+/**
+ * Enable or disable shared instances in @ref rif_int_new. When enabled, @ref rif_int_new behaves as
+ * @ref rif_int_get_cached. Disabled by default.
+ *
+ * @param enabled whether @ref rif_int_new should return shared instances.
+ */
+RIF_API
+void rif_int_set_cache_enabled(bool enabled);
+
+/**
+ * Check whether @ref rif_int_new returns shared instances.
+ *
+ * @return `true` if shared instances are enabled, or `false` otherwise.
+ */
+RIF_API
+bool rif_int_cache_enabled(void);
+
 /******************************************************************************
  * API
  */
@@ -137,6 +224,9 @@ void rif_int_release(rif_int_t *int_ptr) {
  */
 RIF_INLINE
 int64_t rif_int_getorelse(rif_int_t *int_ptr, int64_t fallback) {
+  if (rif_val_isimmediate(int_ptr)) {
+    return (int64_t) ((intptr_t) int_ptr >> 2);
+  }
   return int_ptr ? int_ptr->value : fallback;
 }
 
@@ -188,11 +278,11 @@ bool rif_int_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_pt
 /**
  * @private
  *
- * Value tostring callback for @ref rif_bool_t.
+ * Value write callback for @ref rif_bool_t.
  *
  * @memberof rif_int_t
  */
-char * rif_int_tostring_callback(const rif_val_t *val_ptr);
+rif_status_t rif_int_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /*****************************************************************************/
 
@@ -92,11 +92,11 @@ extern const rif_null_t *rif_null;
 /**
  * @private
  *
- * Value tostring callback for @ref rif_null_t.
+ * Value write callback for @ref rif_null_t.
  *
  * @memberof rif_null_t
  */
-char * rif_null_tostring_callback(const rif_val_t *val_ptr);
+rif_status_t rif_null_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /*****************************************************************************/
 
@@ -39,7 +39,10 @@ extern "C" {
 /**
  * @private
  *
- * Rif pool block.
+ * Rif pool block, or page.
+ *
+ * Blocks are aligned on their own size, which is a power of two, so that the block of an element is found by masking
+ * its address.
  */
 typedef struct rif_paged_pool_block_s {
 
@@ -50,6 +53,48 @@ typedef struct rif_paged_pool_block_s {
    */
   struct rif_paged_pool_block_s *next;
 
+  /**
+   * @private
+   *
+   * Previous block.
+   */
+  struct rif_paged_pool_block_s *prev;
+
+  /**
+   * @private
+   *
+   * Next block with available elements.
+   */
+  struct rif_paged_pool_block_s *next_available;
+
+  /**
+   * @private
+   *
+   * Previous block with available elements.
+   */
+  struct rif_paged_pool_block_s *prev_available;
+
+  /**
+   * @private
+   *
+   * First available element of the block.
+   */
+  void *first_available;
+
+  /**
+   * @private
+   *
+   * Number of borrowed elements of the block.
+   */
+  uint32_t live_count;
+
+  /**
+   * @private
+   *
+   * Keeps elements aligned on 16 bytes.
+   */
+  uint32_t padding;
+
   /**
    * @private
    *
@@ -62,6 +107,10 @@ typedef struct rif_paged_pool_block_s {
 /**
  * Rif pool.
  *
+ * Each block tracks its own available elements and live count. Blocks with available elements are kept in a list where
+ * partially used blocks come before empty ones, so that borrowing fills the fullest blocks first, and empty blocks can
+ * be released from the tail of the list.
+ *
  * @note This structure internal members are private, and may change without notice. They should only be accessed
  *       through the public `rif_paged_pool_t` methods.
  *
@@ -86,23 +135,58 @@ typedef struct rif_paged_pool_s {
   /**
    * @private
    *
-   * Block size of the pool.
+   * Number of elements per block.
    */
   uint32_t block_size;
 
   /**
    * @private
    *
-   * Pointer to the first available element of the pool.
+   * Size of a block in bytes, which is also its alignment.
    */
-  void *first_available;
+  uint32_t block_bytes;
+
+  /**
+   * @private
+   *
+   * Number of allocated blocks.
+   */
+  uint32_t block_count;
+
+  /**
+   * @private
+   *
+   * Number of allocated blocks without any borrowed element.
+   */
+  uint32_t free_block_count;
+
+  /**
+   * @private
+   *
+   * Maximum number of free blocks to keep ; blocks freed beyond it are released immediately.
+   */
+  uint32_t max_free_blocks;
+
+  /**
+   * @private
+   *
+   * Number of borrowed elements.
+   */
+  uint32_t live_count;
 
   /**
    * @private
    *
-   * Pointer to the last available element of the pool.
+   * First block with available elements, which elements are borrowed from.
    */
-  void *last_available;
+  rif_paged_pool_block_t *first_available;
+
+  /**
+   * @private
+   *
+   * Last block with available elements.
+   */
+  rif_paged_pool_block_t *last_available;
 
   /**
    * @private
@@ -131,8 +215,12 @@ extern const rif_pool_hooks_t rif_paged_pool_hooks;
 /**
  * Initialize a pool
  *
+ * Blocks are rounded up to a power of two bytes, and filled with as many elements as fit, so they may hold more than
+ * `block_size` elements. Free blocks are kept until `rif_paged_pool_trim` is called, unless a limit is set with
+ * `rif_paged_pool_set_max_free_blocks`.
+ *
  * @param pool_ptr pool to initialize
- * @param block_size block size
+ * @param block_size minimum number of elements per block
  * @param element_size element size
  * @param lazy if `true`, the first block will be initialized lazily
  *
@@ -150,6 +238,62 @@ rif_paged_pool_t * rif_paged_pool_init(rif_paged_pool_t *pool_ptr, uint32_t elem
 RIF_API
 void rif_paged_pool_destroy(rif_paged_pool_t *pool_ptr);
 
+/******************************************************************************
+ * SIZING FUNCTIONS
+ */
+
+/**
+ * Release blocks which have no borrowed element, keeping at most `keep` of them.
+ *
+ * @param pool_ptr the pool
+ * @param keep number of free blocks to keep for future borrows
+ *
+ * @return the number of released blocks
+ */
+RIF_API
+uint32_t rif_paged_pool_trim(rif_paged_pool_t *pool_ptr, uint32_t keep);
+
+/**
+ * Set how many free blocks the pool keeps. When returning an element frees a block beyond this limit, the block is
+ * released immediately, which bounds the memory held by the pool after a usage spike. The default, `UINT32_MAX`, keeps
+ * every block.
+ *
+ * Blocks already free beyond the new limit are released.
+ *
+ * @param pool_ptr the pool
+ * @param max_free_blocks the maximum number of free blocks to keep
+ */
+RIF_API
+void rif_paged_pool_set_max_free_blocks(rif_paged_pool_t *pool_ptr, uint32_t max_free_blocks);
+
+/******************************************************************************
+ * INFO FUNCTIONS
+ */
+
+/**
+ * Get the number of borrowed elements.
+ *
+ * @param pool_ptr the pool
+ *
+ * @return the number of elements borrowed and not yet returned
+ */
+RIF_INLINE
+uint32_t rif_paged_pool_live_count(const rif_paged_pool_t *pool_ptr) {
+  return pool_ptr->live_count;
+}
+
+/**
+ * Get the number of allocated blocks.
+ *
+ * @param pool_ptr the pool
+ *
+ * @return the number of blocks currently allocated by the pool
+ */
+RIF_INLINE
+uint32_t rif_paged_pool_block_count(const rif_paged_pool_t *pool_ptr) {
+  return pool_ptr->block_count;
+}
+
 /******************************************************************************
  * ACCESSOR FUNCTIONS
  */
@@ -103,6 +103,18 @@ rif_pair_t * rif_pair_init(rif_pair_t *pair_ptr, rif_val_t *val_ptr_1, rif_val_t
 RIF_API
 rif_pair_t * rif_pair_new(rif_val_t *val_ptr_1, rif_val_t *val_ptr_2);
 
+/**
+ * Allocates a new `rif_pair_t`, taking over the caller references to both values.
+ *
+ * The values are not retained by the pair. The caller references are consumed whatever the outcome, so the caller
+ * must not release the values afterwards.
+ *
+ * @param value The pair value for the new `rif_pair_t`.
+ * @return      The corresponding new `rif_pair_t`, or `NULL` if memory allocation failed.
+ */
+RIF_API
+rif_pair_t * rif_pair_new_steal(rif_val_t *val_ptr_1, rif_val_t *val_ptr_2);
+
 /**
  * Releases a `rif_pair_t`. If the reference count reaches 0, the value will be freed.
  *
@@ -167,9 +179,9 @@ bool rif_pair_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_p
 /**
  * @private
  *
- * Callback function get the string representation of a `rif_pair_t`.
+ * Callback function to append the string representation of a `rif_pair_t` to a string buffer.
  */
-char * rif_pair_tostring_callback(const rif_val_t *val_ptr);
+rif_status_t rif_pair_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /*****************************************************************************/
 
@@ -0,0 +1,128 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+/**
+ * @file
+ * @brief Rif deferred destruction.
+ *
+ * Releasing the last reference to a value destroys it right away, which in turn releases every value it holds: dropping
+ * a large collection can stall the calling thread for a long time, and destroying nested collections recurses once per
+ * nesting level.
+ *
+ * A thread can opt into deferred destruction instead. While it is enabled, heap-allocated collections and pairs (those
+ * created by a `rif_*_new` constructor) whose last reference is released by the thread are pushed to a global reclaim
+ * queue rather than destroyed. Queued values are destroyed later, either in bounded steps with `rif_reclaim_step`, or
+ * by the reclaim thread started with `rif_reclaim_start`. Collections which die while a queued value is destroyed are
+ * queued in turn, so destroying a deeply nested value no longer recurses.
+ *
+ * Queued values may be destroyed on another thread, so the values they hold must not be thread-confined (see
+ * `rif_val_share`). Thread-local values, values allocated from an arena, and values which are not heap-allocated, are
+ * always destroyed right away.
+ */
+
+#pragma once
+
+#include "rif/base/rif_val.h"
+#include "rif/common/rif_status.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Number of queued values the reclaim thread destroys before checking for new ones.
+ */
+#define RIF_RECLAIM_THREAD_BATCH 64
+
+/******************************************************************************
+ * SETTINGS FUNCTIONS
+ */
+
+/**
+ * Enable or disable deferred destruction for the calling thread.
+ *
+ * @param deferred `true` to queue dead collections and pairs instead of destroying them
+ * @return         the previous setting of the calling thread
+ */
+RIF_API
+bool rif_reclaim_set_deferred(bool deferred);
+
+/**
+ * Checks whether deferred destruction is enabled for the calling thread.
+ *
+ * @return `true` if deferred destruction is enabled, or `false` otherwise
+ */
+RIF_API
+bool rif_reclaim_deferred(void);
+
+/******************************************************************************
+ * RECLAIM FUNCTIONS
+ */
+
+/**
+ * Destroy queued values.
+ *
+ * Each queued value is destroyed in one go, releasing the values it holds; the collections and pairs among them which
+ * die are queued rather than destroyed, and count against the budget when they are destroyed in turn.
+ *
+ * @param budget the maximum number of queued values to destroy
+ * @return       the number of queued values destroyed
+ */
+RIF_API
+uint32_t rif_reclaim_step(uint32_t budget);
+
+/**
+ * Get the number of values waiting in the reclaim queue.
+ *
+ * @return the number of queued values
+ */
+RIF_API
+uint32_t rif_reclaim_pending(void);
+
+/******************************************************************************
+ * RECLAIM THREAD FUNCTIONS
+ */
+
+/**
+ * Start a background thread destroying queued values as they arrive. Does nothing if it is already running.
+ *
+ * @return
+ *   - `RIF_OK`         if the thread is running
+ *   - `RIF_ERR_MEMORY` if the thread could not be started
+ */
+RIF_API
+rif_status_t rif_reclaim_start(void);
+
+/**
+ * Stop the reclaim thread, after it has destroyed every queued value. Does nothing if it is not running.
+ */
+RIF_API
+void rif_reclaim_stop(void);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
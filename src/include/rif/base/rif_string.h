@@ -32,6 +32,15 @@
 extern "C" {
 #endif
 
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Maximum length of a string which can be encoded as an immediate value.
+ */
+#define RIF_STRING_IMMEDIATE_MAX_LEN (sizeof(uintptr_t) - 1)
+
 /******************************************************************************
  * TYPES
  */
@@ -67,6 +76,14 @@ typedef struct rif_string_s {
    */
   size_t len;
 
+  /**
+   * @private
+   *
+   * Memoized string hash, or `0` if not computed yet. Strings may be hashed concurrently by several threads, which all
+   * compute the same value, so relaxed atomic accesses are enough.
+   */
+  atomic_uint32_t hash;
+
   /**
    * @private
    *
@@ -145,6 +162,20 @@ rif_string_t * rif_string_new(char *value, bool free) {
 RIF_API
 rif_string_t * rif_string_new_dup(const char *value);
 
+/**
+ * Gets a `rif_string_t` for a string, encoded as an immediate value if it is at most
+ * `RIF_STRING_IMMEDIATE_MAX_LEN` characters long.
+ *
+ * Immediate values are not allocated, and retaining or releasing them does nothing. Their characters can only be read
+ * with `rif_string_get_wbuf`: see `rif_val_isimmediate`. Longer strings are duplicated as with `rif_string_new_dup`.
+ * In both cases, the returned value should be released as usual.
+ *
+ * @param value The string value.
+ * @return      The immediate or new `rif_string_t`, or `NULL` if `value` is `NULL` or memory allocation failed.
+ */
+RIF_API
+rif_string_t * rif_string_new_immediate(const char *value);
+
 /**
  * Releases a `rif_string_t`. If the reference count reaches 0, the value will be freed.
  *
@@ -155,6 +186,43 @@ void rif_string_release(rif_string_t *str_ptr) {
   rif_val_release(str_ptr);
 }
 
+/******************************************************************************
+ * INTERNING FUNCTIONS
+ */
+
+/**
+ * Gets the canonical `rif_string_t` for a string content, from the global intern table.
+ *
+ * Every call with the same content returns the same instance, which is shared by every thread. Interned strings are
+ * compared by address with each other, and are matched by address by the map lookups, without comparing characters.
+ * The table keeps a reference on every interned string, so that they are never freed.
+ *
+ * @param value The string value.
+ * @return      The canonical `rif_string_t`, retained, or `NULL` if `value` is `NULL` or memory allocation failed.
+ *              It should be released as usual.
+ */
+RIF_API
+rif_string_t * rif_string_intern(const char *value);
+
+/**
+ * Checks whether a `rif_string_t` is an interned string.
+ *
+ * @param str_ptr The `rif_string_t`.
+ * @return        `true` if `str_ptr` was returned by `rif_string_intern`, or `false` otherwise.
+ */
+RIF_INLINE
+bool rif_string_isinterned(const rif_string_t *str_ptr) {
+  return str_ptr && !rif_val_isimmediate(str_ptr) && (rif_val(str_ptr)->flags & RIF_VAL_FLAG_INTERNED);
+}
+
+/**
+ * Get the number of interned strings.
+ *
+ * @return the number of strings in the global intern table.
+ */
+RIF_API
+uint32_t rif_string_intern_count(void);
+
 /******************************************************************************
  * ACCESSOR FUNCTIONS
  */
@@ -167,6 +235,7 @@ void rif_string_release(rif_string_t *str_ptr) {
  */
 RIF_INLINE
 char * rif_string_getorelse(rif_string_t *str_ptr, char *fallback) {
+  assert(!rif_val_isimmediate(str_ptr));
   return str_ptr ? str_ptr->value : fallback;
 }
 
@@ -181,6 +250,17 @@ char * rif_string_get(rif_string_t *str_ptr) {
   return rif_string_getorelse(str_ptr, NULL);
 }
 
+/**
+ * Get the string value of a `rif_string_t`, which may be an immediate value.
+ *
+ * @param str_ptr The `rif_string_t` to get the corresponding string value for.
+ * @param buf     A buffer of at least `RIF_STRING_IMMEDIATE_MAX_LEN + 1` characters, only written to if `str_ptr` is
+ *                an immediate value.
+ * @return        The string value, which is `buf` if `str_ptr` is an immediate value, or `NULL` if `str_ptr` is `NULL`.
+ */
+RIF_API
+const char * rif_string_get_wbuf(rif_string_t *str_ptr, char *buf);
+
 /**
  * Get the string value of a `rif_string_t`.
  *
@@ -218,9 +298,9 @@ bool rif_string_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other
 /**
  * @private
  *
- * Callback function get the string representation of a `rif_string_t`.
+ * Callback function to append the string representation of a `rif_string_t` to a string buffer.
  */
-char * rif_string_tostring_callback(const rif_val_t *val_ptr);
+rif_status_t rif_string_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /*****************************************************************************/
 
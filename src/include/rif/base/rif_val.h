@@ -26,6 +26,7 @@
 
 #include "rif/rif_common.h"
 #include "rif/concurrent/rif_atomic.h"
+#include "rif/util/rif_strbuf.h"
 
 /*****************************************************************************/
 
@@ -71,6 +72,9 @@ typedef enum rif_val_type_t {
  * values to the collection structure, ensuring that the value is freed automatically when the value is not referenced
  * anymore. The reference counter is manipulated using the @ref rif_val_retain and @rif_val_release functions.
  *
+ * Small integers and short strings may also be encoded as immediate values, without any allocation: see
+ * @ref rif_val_isimmediate.
+ *
  * Unless mentioned otherwise, all the value-level functions accept as parameter any @ref rif_val_t subtype without
  * requiring explicit type casting.
  *
@@ -89,19 +93,85 @@ typedef struct rif_val_t {
   /**
    * @private
    *
-   * The value subtype type.
+   * The value subtype type, a @ref rif_val_type_t.
+   */
+  uint8_t type;
+
+  /**
+   * @private
+   *
+   * Small value cache the value was allocated from, plus one, or `0` if it was allocated with the heap allocators.
    */
-  rif_val_type_t type;
+  uint8_t size_class;
 
   /**
    * @private
    *
-   * Whether or not to free the variable when the reference count reaches `0`.
+   * Value flags, a combination of the `RIF_VAL_FLAG_*` bits.
    */
-  bool free;
+  uint8_t flags;
 
 } rif_val_t;
 
+/******************************************************************************
+ * VALUE FLAGS
+ */
+
+/**
+ * @private
+ *
+ * Free the value when the reference count reaches `0`.
+ */
+#define RIF_VAL_FLAG_FREE ((uint8_t) 0x01)
+
+/**
+ * @private
+ *
+ * The value is never retained, released nor freed: static singletons, shared instances, and values of types without
+ * reference counting.
+ */
+#define RIF_VAL_FLAG_IMMORTAL ((uint8_t) 0x02)
+
+/**
+ * @private
+ *
+ * The value is the canonical instance for its content, which can only be equal to itself.
+ */
+#define RIF_VAL_FLAG_INTERNED ((uint8_t) 0x04)
+
+/**
+ * @private
+ *
+ * The value is confined to the thread which created it, and its reference count is updated without atomic
+ * read-modify-write instructions.
+ */
+#define RIF_VAL_FLAG_LOCAL ((uint8_t) 0x08)
+
+/******************************************************************************
+ * IMMEDIATE VALUES
+ */
+
+/**
+ * @private
+ *
+ * Mask of the immediate value tag bits in a value pointer.
+ */
+#define RIF_VAL_IMMEDIATE_TAG_MASK ((uintptr_t) 3)
+
+/**
+ * @private
+ *
+ * Tag of immediate @ref rif_int_t values.
+ */
+#define RIF_VAL_IMMEDIATE_INT_TAG ((uintptr_t) 1)
+
+/**
+ * @private
+ *
+ * Tag of immediate @ref rif_string_t values.
+ */
+#define RIF_VAL_IMMEDIATE_STRING_TAG ((uintptr_t) 2)
+
 /******************************************************************************
  * GLOBALS
  */
@@ -136,7 +206,28 @@ extern const char *rif_undef_str;
  *
  * @relates rif_val_t
  */
-#define rif_val_type(__val_ptr) (__val_ptr ? (rif_val(__val_ptr)->type) : RIF_UNDEF)
+#define rif_val_type(__val_ptr) (rif_val_type_helper(rif_val(__val_ptr)))
+
+/**
+ * Check whether a value is an immediate value.
+ *
+ * Immediate values are encoded in the pointer itself rather than allocated: a non-zero tag in the low bits of the
+ * pointer, which can never be set for a heap or static value, tells the value type and the rest of the word holds the
+ * value. They are never allocated nor freed, and retaining or releasing them does nothing.
+ *
+ * Only small integers and short strings can be immediate values, and only when explicitly created as such with
+ * @ref rif_int_new_immediate or @ref rif_string_new_immediate.
+ *
+ * @warning Immediate values have no @ref rif_val_t header: they must only be accessed through the value and subtype
+ *          functions, never by dereferencing the pointer.
+ *
+ * @param __val_ptr the value to check.
+ * @return          `true` if @a __val_ptr is an immediate value,
+ *                  or `false` otherwise.
+ *
+ * @relates rif_val_t
+ */
+#define rif_val_isimmediate(__val_ptr) (((uintptr_t) (__val_ptr) & RIF_VAL_IMMEDIATE_TAG_MASK) != 0)
 
 /**
  * Retain a value.
@@ -202,12 +293,41 @@ extern const char *rif_undef_str;
  */
 #define rif_val_tostring(__val_ptr) (rif_val_tostring_helper(rif_val(__val_ptr)))
 
+/**
+ * Append the string representation of a value to a string buffer.
+ *
+ * The representation is the one returned by @ref rif_val_tostring, but collections write their elements straight to
+ * the buffer instead of building an intermediate string for each of them. A `NULL` value is written as
+ * @ref rif_undef_str.
+ *
+ * @param __val_ptr the value to write.
+ * @param __sb_ptr  the string buffer to append to.
+ * @return          the status of @a __sb_ptr.
+ *
+ * @relates rif_val_t
+ */
+#define rif_val_write(__val_ptr, __sb_ptr) (rif_val_write_helper(rif_val(__val_ptr), __sb_ptr))
+
+/**
+ * Write the string representation of a value to a file descriptor, in chunks, without building it in memory.
+ *
+ * @param __val_ptr the value to write.
+ * @param __fd      the file descriptor to write to.
+ * @return          `RIF_OK` if successful, `RIF_ERR_MEMORY` if memory allocation failed, `RIF_ERR_IO` if writing
+ *                  failed, or `RIF_ERR_UNSUPPORTED` if the value has no string representation.
+ *
+ * @relates rif_val_t
+ */
+#define rif_val_write_fd(__val_ptr, __fd) (rif_val_write_fd_helper(rif_val(__val_ptr), __fd))
+
 /**
  * Return the reference count of a value.
  *
  * @param __val_ptr the value to get the reference count of.
  * @return          the reference count of @a __val_ptr.
  *
+ * @pre @a __val_ptr @b MUST NOT be an immediate value.
+ *
  * @relates rif_val_t
  */
 #define rif_val_reference_count(__val_ptr) (atomic_load(&(rif_val(__val_ptr))->reference_count))
@@ -233,6 +353,57 @@ extern const char *rif_undef_str;
  */
 rif_val_t * rif_val_init(rif_val_t *val_ptr, rif_val_type_t type, bool free);
 
+/******************************************************************************
+ * THREAD CONFINEMENT
+ */
+
+/**
+ * Set whether the values created by the calling thread are thread-local.
+ *
+ * The reference count of a thread-local value is updated with plain loads and stores rather than atomic
+ * read-modify-write instructions, which makes retaining and releasing it much cheaper. A thread-local value @b MUST only
+ * be retained and released by the thread which created it, until it is shared with @ref rif_val_share.
+ *
+ * This setting only applies to the calling thread, and is disabled by default.
+ *
+ * @param local whether values created by the calling thread should be thread-local.
+ * @return      the previous setting.
+ */
+RIF_API
+bool rif_val_set_local_default(bool local);
+
+/**
+ * Check whether values created by the calling thread are thread-local.
+ *
+ * @return `true` if values created by the calling thread are thread-local, or `false` otherwise.
+ */
+RIF_API
+bool rif_val_local_default(void);
+
+/**
+ * Check whether a value is thread-local.
+ *
+ * @param val_ptr the value to check.
+ * @return        `true` if @a val_ptr is thread-local, or `false` otherwise.
+ *
+ * @relates rif_val_t
+ */
+#define rif_val_islocal(__val_ptr) (rif_val_islocal_helper(rif_val(__val_ptr)))
+
+/**
+ * Make a thread-local value safe to retain and release from any thread.
+ *
+ * This function @b MUST be called by the thread which created the value, before the value is made visible to other
+ * threads. Sharing is shallow: values referenced by @a __val_ptr, such as collection elements, are not shared. The
+ * concurrent collections share the keys and elements inserted into them.
+ *
+ * @param __val_ptr the value to share.
+ * @return          the value @a __val_ptr.
+ *
+ * @relates rif_val_t
+ */
+#define rif_val_share(__val_ptr) (rif_val_share_helper(rif_val(__val_ptr)))
+
 /******************************************************************************
  * INTERNAL
  */
@@ -255,50 +426,163 @@ rif_val_t * rif_val_init(rif_val_t *val_ptr, rif_val_type_t type, bool free);
 #define rif_val_tosubtype(__val_ptr, __val_type_token, __val_type) \
     ((__val_type *) rif_val_tosubtype_helper((rif_val_t *) (__val_ptr), (__val_type_token)))
 
+
 /**
  * @private
  *
- * Helper function to retain a value.
+ * Helper function get the hashcode of a value.
  *
  * @memberof rif_val_t
  */
-rif_val_t * rif_val_retain_helper(rif_val_t *val_ptr);
+uint32_t rif_val_hashcode_helper(const rif_val_t *val_ptr);
 
 /**
  * @private
  *
- * Helper function to release a value.
+ * Helper function check for the equality of two values.
  *
  * @memberof rif_val_t
  */
-rif_val_t * rif_val_release_helper(rif_val_t *val_ptr);
+bool rif_val_equals_helper(const rif_val_t *val_ptr, const rif_val_t *other_ptr);
 
 /**
  * @private
  *
- * Helper function get the hashcode of a value.
+ * Helper function get the string representation of a value.
  *
  * @memberof rif_val_t
  */
-uint32_t rif_val_hashcode_helper(const rif_val_t *val_ptr);
+char * rif_val_tostring_helper(const rif_val_t *val_ptr);
 
 /**
  * @private
  *
- * Helper function check for the equality of two values.
+ * Helper function to append the string representation of a value to a string buffer.
  *
  * @memberof rif_val_t
  */
-bool rif_val_equals_helper(const rif_val_t *val_ptr, const rif_val_t *other_ptr);
+rif_status_t rif_val_write_helper(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /**
  * @private
  *
- * Helper function get the string representation of a value.
+ * Helper function to write the string representation of a value to a file descriptor.
  *
  * @memberof rif_val_t
  */
-char * rif_val_tostring_helper(const rif_val_t *val_ptr);
+rif_status_t rif_val_write_fd_helper(const rif_val_t *val_ptr, int fd);
+
+/**
+ * @private
+ *
+ * Helper function to check whether a value is thread-local.
+ *
+ * @memberof rif_val_t
+ */
+RIF_INLINE
+bool rif_val_islocal_helper(const rif_val_t *val_ptr) {
+  return val_ptr && !rif_val_isimmediate(val_ptr) && (val_ptr->flags & RIF_VAL_FLAG_LOCAL);
+}
+
+/**
+ * @private
+ *
+ * Helper function to share a value.
+ *
+ * @memberof rif_val_t
+ */
+RIF_INLINE
+rif_val_t * rif_val_share_helper(rif_val_t *val_ptr) {
+  // Static values are never thread-local, and may live in read-only memory: only write to thread-local values
+  if (rif_val_islocal_helper(val_ptr)) {
+    val_ptr->flags &= (uint8_t) ~RIF_VAL_FLAG_LOCAL;
+  }
+  return val_ptr;
+}
+
+/**
+ * @private
+ *
+ * Helper function to get the type of a value.
+ *
+ * @memberof rif_val_t
+ */
+RIF_INLINE
+rif_val_type_t rif_val_type_helper(const rif_val_t *val_ptr) {
+  uintptr_t tag = (uintptr_t) val_ptr & RIF_VAL_IMMEDIATE_TAG_MASK;
+  if (tag) {
+    return tag == RIF_VAL_IMMEDIATE_INT_TAG ? RIF_INT : RIF_STRING;
+  }
+  return val_ptr ? (rif_val_type_t) val_ptr->type : RIF_UNDEF;
+}
+
+/**
+ * @private
+ *
+ * Destroys a value whose reference count reached `0`, and frees it if needed. With deferred destruction enabled, the
+ * value may be queued instead (see `rif_reclaim_set_deferred`).
+ *
+ * @memberof rif_val_t
+ */
+void rif_val_destroy_helper(rif_val_t *val_ptr);
+
+/**
+ * @private
+ *
+ * Helper function to retain a value.
+ *
+ * Taking a new reference requires holding one already, so the increment does not need to be ordered with anything.
+ *
+ * @memberof rif_val_t
+ */
+RIF_INLINE
+rif_val_t * rif_val_retain_helper(rif_val_t *val_ptr) {
+  if (!val_ptr || rif_val_isimmediate(val_ptr) || (val_ptr->flags & RIF_VAL_FLAG_IMMORTAL)) {
+    return val_ptr;
+  }
+  if (val_ptr->flags & RIF_VAL_FLAG_LOCAL) {
+    atomic_store_explicit(&val_ptr->reference_count,
+                          atomic_load_explicit(&val_ptr->reference_count, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+  } else {
+    atomic_fetch_add_explicit(&val_ptr->reference_count, 1, memory_order_relaxed);
+  }
+  return val_ptr;
+}
+
+/**
+ * @private
+ *
+ * Helper function to release a value.
+ *
+ * Dropping a reference is a release operation, and the thread dropping the last one acquires every other release
+ * before destroying the value, so that all accesses made through other references happen before the destruction.
+ *
+ * @memberof rif_val_t
+ */
+RIF_INLINE
+rif_val_t * rif_val_release_helper(rif_val_t *val_ptr) {
+  if (!val_ptr || rif_val_isimmediate(val_ptr) || (val_ptr->flags & RIF_VAL_FLAG_IMMORTAL)) {
+    return val_ptr;
+  }
+  uint32_t reference_count = atomic_load_explicit(&val_ptr->reference_count, memory_order_relaxed);
+  if (reference_count == 0) {
+    return val_ptr;
+  }
+  if (val_ptr->flags & RIF_VAL_FLAG_LOCAL) {
+    atomic_store_explicit(&val_ptr->reference_count, reference_count - 1, memory_order_relaxed);
+    if (reference_count != 1) {
+      return val_ptr;
+    }
+  } else {
+    if (atomic_fetch_sub_explicit(&val_ptr->reference_count, 1, memory_order_release) != 1) {
+      return val_ptr;
+    }
+    atomic_thread_fence(memory_order_acquire);
+  }
+  rif_val_destroy_helper(val_ptr);
+  return NULL;
+}
 
 /**
  * @private
@@ -317,7 +601,7 @@ rif_val_t * rif_val_tosubtype_helper(rif_val_t *val_ptr, rif_val_type_t expected
   if (!val_ptr) {
     return val_ptr;
   }
-  assert(val_ptr->type == expected_val_type);
+  assert(rif_val_type_helper(val_ptr) == expected_val_type);
   return val_ptr;
 }
 
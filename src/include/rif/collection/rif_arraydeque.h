@@ -0,0 +1,393 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+
+/**
+ * @file
+ * @brief Rif arraydeque.
+ *
+ * A list backed by a circular buffer. Elements are stored contiguously, wrapping around the end of the buffer, so that
+ * reads and writes by index are O(1), and insertions and removals at either end are O(1) as well. Insertions and
+ * removals elsewhere only shift the elements on the shorter side of the index.
+ *
+ * The deque is a `rif_list_t`, and also exposes a `rif_queue_t` view of itself through `rif_arraydeque_asqueue`,
+ * which pushes at the back and pops from the front.
+ */
+
+#pragma once
+
+#include "rif/collection/rif_list.h"
+#include "rif/collection/rif_queue.h"
+#include "rif/common/rif_status.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Smallest capacity allocated by a growing deque.
+ */
+#define RIF_ARRAYDEQUE_MIN_CAPACITY 8
+
+/******************************************************************************
+ * TYPES
+ */
+
+/**
+ * Rif arraydeque type.
+ *
+ * @note This structure internal members are private, and may change without notice. They should only be accessed
+ *       through the public `rif_arraydeque_t` methods.
+ *
+ * @extends rif_list_t
+ */
+typedef struct rif_arraydeque_s {
+
+  /**
+   * @private
+   *
+   * `rif_arraydeque_t` is a `rif_list_t` subtype.
+   */
+  rif_list_t _;
+
+  /**
+   * @private
+   *
+   * Queue view of the deque.
+   */
+  rif_queue_t queue;
+
+  /**
+   * @private
+   *
+   * Current size of the deque.
+   */
+  uint32_t size;
+
+  /**
+   * @private
+   *
+   * Current allocated capacity of the deque. Always `0` or a power of two.
+   */
+  uint32_t capacity;
+
+  /**
+   * @private
+   *
+   * Position of the first element in the element array.
+   */
+  uint32_t head;
+
+  /**
+   * @private
+   *
+   * Has the deque a fixed capacity?
+   */
+  bool fixed;
+
+  /**
+   * @private
+   *
+   * Current element array.
+   */
+  rif_val_t **elements;
+
+} rif_arraydeque_t;
+
+/******************************************************************************
+ * HOOKS
+ */
+
+/**
+ * @private
+ *
+ * Arraydeque list hooks.
+ */
+extern const rif_list_hooks_t rif_arraydeque_hooks;
+
+/**
+ * @private
+ *
+ * Arraydeque queue view hooks.
+ */
+extern const rif_queue_hooks_t rif_arraydeque_queue_hooks;
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+/**
+ * Initialize a heap-allocated arraydeque.
+ *
+ * @param dq_ptr   the deque to initialize
+ * @param capacity the number of elements to allocate room for ; if `0`, the storage will be allocated lazily
+ * @param fixed    if `true`, the deque will have a fixed capacity, able to hold at least `capacity` elements
+ * @return         the initialized deque if successful, or `NULL` otherwise
+ */
+RIF_API
+rif_arraydeque_t * rif_arraydeque_init(rif_arraydeque_t *dq_ptr, uint32_t capacity, bool fixed);
+
+/**
+ * Create and initialize a heap-allocated arraydeque. The arraydeque is freed when its reference count reaches 0.
+ *
+ * @param capacity the number of elements to allocate room for ; if `0`, the storage will be allocated lazily
+ * @param fixed    if `true`, the deque will have a fixed capacity, able to hold at least `capacity` elements
+ * @return         the initialized deque if successful, or `NULL` otherwise
+ */
+RIF_API
+rif_arraydeque_t * rif_arraydeque_new(uint32_t capacity, bool fixed);
+
+/**
+ * Releases a `rif_arraydeque_t`. If the reference count reaches 0, the value will be freed.
+ *
+ * @param dq_ptr the `rif_arraydeque_t` to release
+ */
+RIF_INLINE
+void rif_arraydeque_release(rif_arraydeque_t *dq_ptr) {
+  rif_val_release(dq_ptr);
+}
+
+/**
+ * Returns a `rif_queue_t` view of the deque. Pushing to the queue appends to the deque, and popping from the queue
+ * removes the first element of the deque.
+ *
+ * The view is owned by the deque: retaining it does not retain the deque, and it must not be used once the deque has
+ * been destroyed.
+ *
+ * @param dq_ptr the deque
+ * @return       the queue view of the deque
+ */
+RIF_INLINE
+rif_queue_t * rif_arraydeque_asqueue(rif_arraydeque_t *dq_ptr) {
+  return &dq_ptr->queue;
+}
+
+/******************************************************************************
+ * SIZING FUNCTIONS
+ */
+
+/**
+ * Ensures the deque has enough allocated capacity to store at least `capacity` elements without reallocation.
+ *
+ * @param dq_ptr   the deque
+ * @param capacity the desired minimum capacity
+ * @return
+ *   - `RIF_OK`           if the operation is successful
+ *   - `RIF_ERR_MEMORY`   if memory allocation failed
+ *   - `RIF_ERR_CAPACITY` if the deque has a fixed capacity, and `capacity` is greater than the fixed capacity
+ */
+RIF_API
+rif_status_t rif_arraydeque_ensure_capacity(rif_arraydeque_t *dq_ptr, uint32_t capacity);
+
+/******************************************************************************
+ * INFO FUNCTIONS
+ */
+
+/**
+ * Get the size of the deque.
+ *
+ * @param dq_ptr the deque
+ * @return       the number of elements currently in the deque
+ */
+RIF_INLINE
+uint32_t rif_arraydeque_size(const rif_arraydeque_t *dq_ptr) {
+  return dq_ptr->size;
+}
+
+/**
+ * Returns the deque allocated capacity.
+ *
+ * @param dq_ptr the deque
+ * @return       the allocated element capacity of the deque
+ */
+RIF_INLINE
+uint32_t rif_arraydeque_capacity(const rif_arraydeque_t *dq_ptr) {
+  return dq_ptr->capacity;
+}
+
+/******************************************************************************
+ * ELEMENT READ FUNCTIONS
+ */
+
+/**
+ * @private
+ *
+ * Returns the address of the slot holding the element at the specified position. The position must be lower than the
+ * deque capacity.
+ *
+ * This function is part of the internal API, and may change at any time.
+ *
+ * @param dq_ptr the deque
+ * @param index  the position of the element
+ * @return       the slot address
+ */
+RIF_INLINE
+rif_val_t ** rif_arraydeque_slot(const rif_arraydeque_t *dq_ptr, uint32_t index) {
+  return dq_ptr->elements + ((dq_ptr->head + index) & (dq_ptr->capacity - 1));
+}
+
+/**
+ * Returns the element at the specified position in this deque.
+ *
+ * @param dq_ptr the deque
+ * @param index  index of the element to return
+ * @return       the element at the specified position in the deque if it exists, or `NULL` otherwise
+ */
+RIF_INLINE
+rif_val_t * rif_arraydeque_get(const rif_arraydeque_t *dq_ptr, uint32_t index) {
+  if (index >= dq_ptr->size) {
+    return NULL;
+  }
+  return *rif_arraydeque_slot(dq_ptr, index);
+}
+
+/******************************************************************************
+ * ELEMENT WRITE FUNCTIONS
+ */
+
+/**
+ * Inserts the specified element at the specified position in this deque. Elements are shifted on the shorter side of
+ * `index`, so that inserting at either end is O(1).
+ *
+ * @param dq_ptr  the deque
+ * @param index   index at which the specified element is to be inserted
+ * @param val_ptr element to be inserted at the specified position
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ *   - `RIF_ERR_CAPACITY`      if the deque has a fixed capacity, and is full
+ *   - `RIF_ERR_OUT_OF_BOUNDS` if `index` is greater than the size of the deque
+ */
+RIF_API
+rif_status_t rif_arraydeque_insert(rif_arraydeque_t *dq_ptr, uint32_t index, rif_val_t *val_ptr);
+
+/**
+ * Appends the specified element to the end of the deque.
+ *
+ * @param dq_ptr  the deque
+ * @param val_ptr element to be appended
+ * @return
+ *   - `RIF_OK`           if the operation is successful
+ *   - `RIF_ERR_MEMORY`   if memory allocation failed
+ *   - `RIF_ERR_CAPACITY` if the deque has a fixed capacity, and is full
+ */
+RIF_API
+rif_status_t rif_arraydeque_push_back(rif_arraydeque_t *dq_ptr, rif_val_t *val_ptr);
+
+/**
+ * Appends the specified element to the end of the deque, taking over the caller reference to it.
+ *
+ * Behaves like `rif_arraydeque_push_back`, except that the element is not retained. The caller reference is consumed
+ * whatever the outcome, so the caller must not release the element afterwards.
+ *
+ * @param dq_ptr  the deque
+ * @param val_ptr element to be appended
+ * @return
+ *   - `RIF_OK`           if the operation is successful
+ *   - `RIF_ERR_MEMORY`   if memory allocation failed
+ *   - `RIF_ERR_CAPACITY` if the deque has a fixed capacity, and is full
+ */
+RIF_API
+rif_status_t rif_arraydeque_push_back_steal(rif_arraydeque_t *dq_ptr, rif_val_t *val_ptr);
+
+/**
+ * Prepends the specified element to the beginning of the deque.
+ *
+ * @param dq_ptr  the deque
+ * @param val_ptr element to be prepended
+ * @return
+ *   - `RIF_OK`           if the operation is successful
+ *   - `RIF_ERR_MEMORY`   if memory allocation failed
+ *   - `RIF_ERR_CAPACITY` if the deque has a fixed capacity, and is full
+ */
+RIF_API
+rif_status_t rif_arraydeque_push_front(rif_arraydeque_t *dq_ptr, rif_val_t *val_ptr);
+
+/**
+ * Replaces the element at the specified position in the deque with the specified element.
+ *
+ * @param dq_ptr  the deque
+ * @param index   index of the element to replace
+ * @param val_ptr element to be stored at the specified position
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_OUT_OF_BOUNDS` if `index` is equal or greater than the size of the deque
+ */
+RIF_API
+rif_status_t rif_arraydeque_set(rif_arraydeque_t *dq_ptr, uint32_t index, rif_val_t *val_ptr);
+
+/******************************************************************************
+ * ELEMENT DELETE FUNCTIONS
+ */
+
+/**
+ * Removes the element at the specified position in this deque. Elements are shifted on the shorter side of `index`,
+ * so that removing at either end is O(1).
+ *
+ * @param dq_ptr the deque
+ * @param index  the index of the element to be removed
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_OUT_OF_BOUNDS` if `index` is equal or greater than the size of the deque
+ */
+RIF_API
+rif_status_t rif_arraydeque_remove(rif_arraydeque_t *dq_ptr, uint32_t index);
+
+/**
+ * Removes and returns the last element of the deque. The reference held by the deque is transferred to the caller,
+ * who must release it.
+ *
+ * @param dq_ptr the deque
+ * @return       the last element, or `NULL` if the deque is empty
+ */
+RIF_API
+rif_val_t * rif_arraydeque_pop_back(rif_arraydeque_t *dq_ptr);
+
+/**
+ * Removes and returns the first element of the deque. The reference held by the deque is transferred to the caller,
+ * who must release it.
+ *
+ * @param dq_ptr the deque
+ * @return       the first element, or `NULL` if the deque is empty
+ */
+RIF_API
+rif_val_t * rif_arraydeque_pop_front(rif_arraydeque_t *dq_ptr);
+
+/******************************************************************************
+ * CALLBACK FUNCTIONS
+ */
+
+/**
+ * @private
+ *
+ * Callback function to destroy a `rif_arraydeque_t`.
+ */
+void rif_arraydeque_destroy_callback(rif_arraydeque_t *dq_ptr);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -0,0 +1,132 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+/**
+ * @file
+ * @brief Rif arraydeque iterator.
+ */
+
+#pragma once
+
+#include "rif/collection/rif_arraydeque.h"
+#include "rif/collection/rif_iterator.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ */
+
+/**
+ * The `rif_list_t` interface.
+ * All rif list implementations inherit from this structure.
+ */
+typedef struct rif_arraydeque_iterator_s {
+
+  /**
+   * @private
+   *
+   * `rif_arraydeque_iterator_t` is a `rif_iterator_t` subtype.
+   */
+  rif_iterator_t _;
+
+  /**
+   * @private
+   *
+   * The deque to iterate.
+   */
+  const rif_arraydeque_t *dq_ptr;
+
+  /**
+   * @private
+   *
+   * The current index.
+   */
+  uint32_t index;
+
+} rif_arraydeque_iterator_t;
+
+/******************************************************************************
+ * HOOKS
+ */
+
+/**
+ * @private
+ *
+ * Arraydeque iterator hooks.
+ */
+extern const rif_iterator_hooks_t rif_arraydeque_iterator_hooks;
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+/**
+ * Initializes a heap-allocated arraydeque iterator.
+ *
+ * @param it_ptr the iterator to initialize
+ * @param dq_ptr the arraydeque to iterate
+ * @return       the initialized arraydeque iterator if successful, or `NULL` otherwise.
+ */
+RIF_API
+rif_arraydeque_iterator_t * rif_arraydeque_iterator_init(
+    rif_arraydeque_iterator_t *it_ptr, const rif_arraydeque_t *dq_ptr);
+
+/**
+ * Creates a stack-allocated arraydeque iterator.
+ *
+ * @param dq_ptr the arraydeque to iterate
+ * @return       the initialized arraydeque iterator if successful, or `NULL` otherwise.
+ */
+RIF_API
+rif_arraydeque_iterator_t * rif_arraydeque_iterator_new(const rif_arraydeque_t *dq_ptr);
+
+/******************************************************************************
+ * ITERATOR FUNCTIONS
+ */
+
+/**
+ * Returns the next element in the iteration.
+ *
+ * @param it_ptr the iterator
+ * @return       the next element in the iteration.
+ */
+RIF_API
+rif_val_t * rif_arraydeque_iterator_next(rif_arraydeque_iterator_t *it_ptr);
+
+/**
+ * Returns `true` if the iteration has more elements.
+ *
+ * @param it_ptr the iterator
+ * @return       `true` if the iteration has more elements.
+ */
+RIF_INLINE
+bool rif_arraydeque_iterator_hasnext(rif_arraydeque_iterator_t *it_ptr) {
+  return it_ptr->index < rif_arraydeque_size(it_ptr->dq_ptr);
+}
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -33,10 +33,47 @@
 extern "C" {
 #endif
 
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Smallest capacity allocated by a growing list, and below which it is never shrunk automatically.
+ */
+#define RIF_ARRAYLIST_MIN_CAPACITY 8
+
 /******************************************************************************
  * TYPES
  */
 
+/**
+ * Strategy used to grow an arraylist when an insertion needs more capacity.
+ */
+typedef enum rif_arraylist_growth_e {
+
+  /**
+   * The list keeps its initial capacity.
+   */
+  RIF_ARRAYLIST_GROWTH_FIXED,
+
+  /**
+   * The list grows to the next multiple of its block size. Appending `n` elements copies O(n^2 / block size) elements.
+   */
+  RIF_ARRAYLIST_GROWTH_LINEAR,
+
+  /**
+   * The list grows by half of its capacity. Appending is amortized O(1).
+   */
+  RIF_ARRAYLIST_GROWTH_GEOMETRIC,
+
+  /**
+   * The list doubles its capacity. Appending is amortized O(1), with fewer reallocations but more slack than
+   * `RIF_ARRAYLIST_GROWTH_GEOMETRIC`.
+   */
+  RIF_ARRAYLIST_GROWTH_DOUBLE
+
+} rif_arraylist_growth_t;
+
 /**
  * Rif arraylist type.
  *
@@ -75,6 +112,20 @@ typedef struct rif_arraylist_s {
    */
   uint32_t block_size;
 
+  /**
+   * @private
+   *
+   * Growth strategy of the list.
+   */
+  rif_arraylist_growth_t growth;
+
+  /**
+   * @private
+   *
+   * Whether or not to shrink the element array when the list is drained.
+   */
+  bool autoshrink;
+
   /**
    * @private
    *
@@ -112,12 +163,24 @@ extern const rif_list_hooks_t rif_arraylist_hooks;
  * @param list         The list to initialize.
  * @param capacity     The initial capacity to allocate. If `0`, the storage will be allocated lazily.
  * @param block_size   The block size of the list, i.e. by how much elements the list will be extended when additional
- *                     capacity is needed. If `0`, the list will have a fixed-size of `capacity`.
+ *                     capacity is needed. If `0`, the list will have a fixed-size of `capacity`, or grow with
+ *                     `RIF_ARRAYLIST_GROWTH_GEOMETRIC` if `capacity` is `0` as well. The growth strategy can be changed
+ *                     later with `rif_arraylist_set_growth`.
  * @return             the initialized arraylist if successful, or `NULL` otherwise.
  */
 RIF_API
 rif_arraylist_t * rif_arraylist_init(rif_arraylist_t *al_ptr, uint32_t capacity, uint32_t block_size);
 
+/**
+ * Create and initialize a heap-allocated arraylist. The arraylist is freed when its reference count reaches 0.
+ *
+ * @param capacity     The initial capacity to allocate. If `0`, the storage will be allocated lazily.
+ * @param block_size   The block size of the list, as for `rif_arraylist_init`.
+ * @return             the initialized arraylist if successful, or `NULL` otherwise.
+ */
+RIF_API
+rif_arraylist_t * rif_arraylist_new(uint32_t capacity, uint32_t block_size);
+
 /**
  * Initialize a stack-allocated list.
  *
@@ -130,6 +193,7 @@ rif_arraylist_t * rif_arraylist_init(rif_arraylist_t *al_ptr, uint32_t capacity,
 #define rif_arraylist_inita(__al_ptr, __capacity) \
   rif_arraylist_init((__al_ptr), 0, 0); \
   (__al_ptr)->free_elements = false; \
+  (__al_ptr)->growth = RIF_ARRAYLIST_GROWTH_FIXED; \
   (__al_ptr)->capacity = __capacity; \
   (__al_ptr)->elements = ((rif_val_t **) rif_alloca((__capacity) * sizeof(rif_val_t *))); \
   memset((__al_ptr)->elements, 0, (__capacity) * sizeof(rif_val_t *));
@@ -164,6 +228,49 @@ void rif_arraylist_release(rif_arraylist_t *al_ptr) {
 RIF_API
 rif_status_t rif_arraylist_ensure_capacity(rif_arraylist_t *al_ptr, uint32_t capacity);
 
+/**
+ * Reduces the allocated capacity of the list to its size. The element array is freed if the list is empty.
+ *
+ * @param al_ptr The list.
+ *
+ * @return
+ *   - `RIF_OK`           if the operation is successful.
+ *   - `RIF_ERR_MEMORY`   if memory reallocation failed ; the list is left unchanged.
+ *   - `RIF_ERR_CAPACITY` if the list has a fixed capacity.
+ */
+RIF_API
+rif_status_t rif_arraylist_shrink_to_fit(rif_arraylist_t *al_ptr);
+
+/**
+ * Sets the strategy used to grow the list when an insertion needs more capacity.
+ *
+ * Explicit calls to `rif_arraylist_ensure_capacity` are not affected, and allocate the requested capacity only (rounded
+ * to the block size for `RIF_ARRAYLIST_GROWTH_LINEAR`). Switching to `RIF_ARRAYLIST_GROWTH_FIXED` disables automatic
+ * shrinking, as a fixed list could not grow back.
+ *
+ * @param al_ptr The list.
+ * @param growth The growth strategy.
+ *
+ * @return
+ *   - `RIF_OK`           if the operation is successful.
+ *   - `RIF_ERR_CAPACITY` if the list element array is not owned by the list (see `rif_arraylist_inita`), and `growth`
+ *                        is not `RIF_ARRAYLIST_GROWTH_FIXED`.
+ */
+RIF_API
+rif_status_t rif_arraylist_set_growth(rif_arraylist_t *al_ptr, rif_arraylist_growth_t growth);
+
+/**
+ * Enables or disables automatic shrinking.
+ *
+ * When enabled, removing an element which leaves the list at a quarter of its capacity or less halves the capacity,
+ * down to `RIF_ARRAYLIST_MIN_CAPACITY` or the block size. Lists with a fixed capacity are never shrunk.
+ *
+ * @param al_ptr     The list.
+ * @param autoshrink `true` to enable automatic shrinking, `false` to disable it.
+ */
+RIF_API
+void rif_arraylist_set_autoshrink(rif_arraylist_t *al_ptr, bool autoshrink);
+
 /******************************************************************************
  * INFO FUNCTIONS
  */
@@ -231,6 +338,25 @@ rif_val_t * rif_arraylist_get(const rif_arraylist_t *al_ptr, uint32_t index) {
 RIF_API
 rif_status_t rif_arraylist_insert(rif_arraylist_t *al_ptr, uint32_t index, rif_val_t *val_ptr);
 
+/**
+ * Inserts the specified element at the specified position in this list, taking over the caller reference to it.
+ *
+ * Behaves like `rif_arraylist_insert`, except that the element is not retained. The caller reference is consumed
+ * whatever the outcome, so the caller must not release the element afterwards.
+ *
+ * @param al_ptr  the list
+ * @param index   index at which the specified element is to be inserted
+ * @param val_ptr element to be inserted at the specified position
+ *
+ * @return
+ *   - `RIF_OK`                if the operation is successful.
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed.
+ *   - `RIF_ERR_CAPACITY`      if the list has a fixed capacity, and `index` is greater than the fixed capacity.
+ *   - `RIF_ERR_OUT_OF_BOUNDS` if `index` is greater than the size of the list.
+ */
+RIF_API
+rif_status_t rif_arraylist_insert_steal(rif_arraylist_t *al_ptr, uint32_t index, rif_val_t *val_ptr);
+
 /**
  * Appends the specified element to the end of the list.
  *
@@ -247,6 +373,24 @@ rif_status_t rif_arraylist_append(rif_arraylist_t *al_ptr, rif_val_t *val_ptr) {
   return rif_arraylist_insert(al_ptr, al_ptr->size, val_ptr);
 }
 
+/**
+ * Appends the specified element to the end of the list, taking over the caller reference to it.
+ *
+ * @param al_ptr  the list
+ * @param val_ptr element to be appended to the end of the list
+ *
+ * @return
+ *   - `RIF_OK`                if the operation is successful.
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed.
+ *   - `RIF_ERR_CAPACITY`      if the list has a fixed capacity, and `index` is greater than the fixed capacity.
+ *
+ * @see rif_arraylist_insert_steal
+ */
+RIF_INLINE
+rif_status_t rif_arraylist_append_steal(rif_arraylist_t *al_ptr, rif_val_t *val_ptr) {
+  return rif_arraylist_insert_steal(al_ptr, al_ptr->size, val_ptr);
+}
+
 /**
  * Prepends the specified element to the beginning of the list. Shifts any subsequent elements to the right (adds one to
  * their indices).
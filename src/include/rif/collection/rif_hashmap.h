@@ -26,6 +26,7 @@
 
 #include "rif/collection/rif_map.h"
 #include "rif/common/rif_status.h"
+#include "rif/util/rif_math.h"
 
 /*****************************************************************************/
 
@@ -33,6 +34,21 @@
 extern "C" {
 #endif
 
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Default maximum load factor of a hashmap.
+ */
+#define RIF_HASHMAP_DEFAULT_MAX_LOAD_FACTOR 0.9f
+
+/**
+ * Number of slots of the previous element array migrated by each write operation, while an incremental resize is in
+ * progress.
+ */
+#define RIF_HASHMAP_REHASH_STEP 16
+
 /******************************************************************************
  * TYPES
  */
@@ -47,14 +63,14 @@ typedef struct rif_hashmap_element_s {
   /**
    * @private
    *
-   * Element key hash
+   * Element key hash, mixed with the map seed, or `0` if the slot is free
    */
   uint32_t hash;
 
   /**
    * @private
    *
-   * Element distance to ideal position
+   * Element key
    */
   rif_val_t *key_ptr;
 
@@ -98,6 +114,21 @@ typedef struct rif_hashmap_s {
    */
   uint32_t capacity;
 
+  /**
+   * @private
+   *
+   * Maximum ratio of size to capacity before the map is grown.
+   */
+  float max_load_factor;
+
+  /**
+   * @private
+   *
+   * Seed mixed into key hashes. It is stable for the lifetime of the map, so elements keep their hash when the map is
+   * resized.
+   */
+  uint32_t seed;
+
   /**
    * @private
    *
@@ -112,6 +143,13 @@ typedef struct rif_hashmap_s {
    */
   bool free_elements;
 
+  /**
+   * @private
+   *
+   * Is the map grown incrementally?
+   */
+  bool incremental;
+
   /**
    * @private
    *
@@ -119,6 +157,34 @@ typedef struct rif_hashmap_s {
    */
   rif_hashmap_element_t *elements;
 
+  /**
+   * @private
+   *
+   * Previous element array, still being migrated to `elements` during an incremental resize, or `NULL`.
+   */
+  rif_hashmap_element_t *old_elements;
+
+  /**
+   * @private
+   *
+   * Capacity of the previous element array.
+   */
+  uint32_t old_capacity;
+
+  /**
+   * @private
+   *
+   * Number of elements left in the previous element array.
+   */
+  uint32_t old_size;
+
+  /**
+   * @private
+   *
+   * Next slot of the previous element array to migrate.
+   */
+  uint32_t rehash_pos;
+
 } rif_hashmap_t;
 
 /******************************************************************************
@@ -147,6 +213,16 @@ extern const rif_map_hooks_t rif_hashmap_hooks;
 RIF_API
 rif_hashmap_t * rif_hashmap_init(rif_hashmap_t *hm_ptr, uint32_t capacity, bool fixed);
 
+/**
+ * Create and initialize a heap-allocated hashmap. The hashmap is freed when its reference count reaches 0.
+ *
+ * @param capacity the initial capacity to allocate ; if `0`, the storage will be allocated lazily
+ * @param fixed    if `true`, the map will have a fixed-size of `capacity`
+ * @return         the initialized hashmap if successful, or `NULL` otherwise
+ */
+RIF_API
+rif_hashmap_t * rif_hashmap_new(uint32_t capacity, bool fixed);
+
 /**
  * Initialize a stack-allocated map.
  *
@@ -158,7 +234,7 @@ rif_hashmap_t * rif_hashmap_init(rif_hashmap_t *hm_ptr, uint32_t capacity, bool
 #define rif_hashmap_inita(__hm_ptr, __capacity) \
   rif_hashmap_init((__hm_ptr), 0, true); \
   (__hm_ptr)->free_elements = false; \
-  (__hm_ptr)->capacity = rif_next_pow2(__capacity + __capacity / 10); \
+  (__hm_ptr)->capacity = rif_hashmap_capacity_helper(__capacity, RIF_HASHMAP_DEFAULT_MAX_LOAD_FACTOR); \
   (__hm_ptr)->elements = ((rif_hashmap_element_t *) rif_alloca((__hm_ptr)->capacity * sizeof(rif_hashmap_element_t))); \
   memset((__hm_ptr)->elements, 0, (__hm_ptr)->capacity * sizeof(rif_hashmap_element_t));
 
@@ -176,6 +252,26 @@ void rif_hashmap_release(rif_hashmap_t *hm_ptr) {
  * SIZING FUNCTIONS
  */
 
+/**
+ * @private
+ *
+ * Computes the capacity to allocate to hold `size` elements without exceeding `max_load_factor`.
+ *
+ * @param size            the number of elements to hold
+ * @param max_load_factor the maximum load factor
+ * @return                the capacity to allocate
+ */
+RIF_INLINE
+uint32_t rif_hashmap_capacity_helper(uint32_t size, float max_load_factor) {
+  // Round up, so that the load factor is never exceeded, and clamp to the largest power of two a `uint32_t` can hold
+  double needed = size / (double) max_load_factor;
+  if (needed >= (double) (UINT32_C(1) << 31)) {
+    return UINT32_C(1) << 31;
+  }
+  uint32_t capacity = (uint32_t) needed;
+  return rif_next_pow2(capacity + (capacity < needed));
+}
+
 /**
  * Ensures the map has enough allocated capacity to store at least `capacity` elements without reallocation.
  *
@@ -191,6 +287,66 @@ void rif_hashmap_release(rif_hashmap_t *hm_ptr) {
 RIF_API
 rif_status_t rif_hashmap_ensure_capacity(rif_hashmap_t *hm_ptr, uint32_t capacity);
 
+/**
+ * Reduces the allocated capacity of the map to the smallest one able to hold its current elements.
+ *
+ * If the map is empty, its storage is released, and will be allocated again lazily.
+ *
+ * @param hm_ptr the map
+ * @return
+ *   - `RIF_OK`           if the operation is successful
+ *   - `RIF_ERR_MEMORY`   if memory allocation failed ; the map is left unchanged
+ *   - `RIF_ERR_CAPACITY` if the map has a fixed capacity
+ */
+RIF_API
+rif_status_t rif_hashmap_shrink_to_fit(rif_hashmap_t *hm_ptr);
+
+/**
+ * Sets the maximum load factor of the map, that is the maximum ratio of its size to its allocated capacity. The map
+ * is grown when inserting an element would exceed it.
+ *
+ * Lower values shorten probe sequences at the expense of memory. The default is
+ * `RIF_HASHMAP_DEFAULT_MAX_LOAD_FACTOR`.
+ *
+ * @param hm_ptr          the map
+ * @param max_load_factor the maximum load factor, in `]0, 1]`
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_OUT_OF_BOUNDS` if `max_load_factor` is not in `]0, 1]`
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ *   - `RIF_ERR_CAPACITY`      if the map has a fixed capacity, and its elements do not fit with the new load factor
+ */
+RIF_API
+rif_status_t rif_hashmap_set_max_load_factor(rif_hashmap_t *hm_ptr, float max_load_factor);
+
+/**
+ * Enables or disables incremental resizing.
+ *
+ * When enabled, a put which needs to grow the map only allocates the new element array. The elements of the previous
+ * array are then migrated `RIF_HASHMAP_REHASH_STEP` slots at a time by each following put or remove, until it is
+ * drained. This bounds the latency of every operation, at the expense of lookups probing both arrays during the
+ * migration. Explicit resizes, such as `rif_hashmap_ensure_capacity`, are always done at once.
+ *
+ * Disabling incremental resizing completes any migration in progress.
+ *
+ * @param hm_ptr      the map
+ * @param incremental `true` to enable incremental resizing, `false` to disable it
+ */
+RIF_API
+void rif_hashmap_set_incremental(rif_hashmap_t *hm_ptr, bool incremental);
+
+/**
+ * Migrates up to `steps` slots of the previous element array, if an incremental resize is in progress.
+ *
+ * Lookups never migrate elements, so read-mostly users may call this function when idle to finish a migration.
+ *
+ * @param hm_ptr the map
+ * @param steps  the maximum number of slots to migrate
+ * @return       `true` if a migration is still in progress, or `false` otherwise
+ */
+RIF_API
+bool rif_hashmap_rehash_step(rif_hashmap_t *hm_ptr, uint32_t steps);
+
 /******************************************************************************
  * INFO FUNCTIONS
  */
@@ -217,6 +373,28 @@ uint32_t rif_hashmap_capacity(const rif_hashmap_t *hm_ptr) {
   return hm_ptr->capacity;
 }
 
+/**
+ * Get the maximum load factor of the map.
+ *
+ * @param hm_ptr the map
+ * @return       the maximum load factor of the hashmap
+ */
+RIF_INLINE
+float rif_hashmap_max_load_factor(const rif_hashmap_t *hm_ptr) {
+  return hm_ptr->max_load_factor;
+}
+
+/**
+ * Checks whether an incremental resize is in progress.
+ *
+ * @param hm_ptr the map
+ * @return       `true` if elements are still being migrated from the previous element array, or `false` otherwise
+ */
+RIF_INLINE
+bool rif_hashmap_isrehashing(const rif_hashmap_t *hm_ptr) {
+  return NULL != hm_ptr->old_elements;
+}
+
 /******************************************************************************
  * ELEMENT READ FUNCTIONS
  */
@@ -241,11 +419,44 @@ bool rif_hashmap_exists(const rif_hashmap_t *hm_ptr, const rif_val_t *key_ptr);
 RIF_API
 rif_val_t * rif_hashmap_get(const rif_hashmap_t *hm_ptr, const rif_val_t *key_ptr);
 
+/**
+ * Returns the elements with the specified keys in this map.
+ *
+ * Keys are looked up in small batches, whose slots are prefetched before any probe sequence is resolved, so that the
+ * cache misses of a batch overlap. This is faster than separate calls to `rif_hashmap_get` for large maps.
+ *
+ * @param hm_ptr   the map
+ * @param key_ptrs the keys of the elements to return
+ * @param count    the number of keys
+ * @param val_ptrs an array of at least `count` elements, receiving the element with each key if it exists, or `NULL`
+ *                 otherwise
+ * @return         the number of keys found in the map
+ */
+RIF_API
+uint32_t rif_hashmap_get_many(
+    const rif_hashmap_t *hm_ptr, rif_val_t * const *key_ptrs, uint32_t count, rif_val_t **val_ptrs);
+
+/**
+ * Checks whether elements exist in the map with the specified keys, in the same way as `rif_hashmap_get_many`.
+ *
+ * @param hm_ptr   the map
+ * @param key_ptrs the keys of the elements to check for existence
+ * @param count    the number of keys
+ * @param exists   an array of at least `count` elements, receiving `true` for each key found in the map, or `false`
+ *                 otherwise
+ * @return         the number of keys found in the map
+ */
+RIF_API
+uint32_t rif_hashmap_exists_many(const rif_hashmap_t *hm_ptr, rif_val_t * const *key_ptrs, uint32_t count, bool *exists);
+
 /**
  * @private
  *
  * Returns the element at a specified index.
  *
+ * During an incremental resize, indexes from `rif_hashmap_capacity(hm_ptr)` address the previous element array, so
+ * that scanning every index up to the sum of both capacities visits every element once.
+ *
  * This function is part of the internal API, and may change at any time.
  *
  * @param hm_ptr the map
@@ -274,6 +485,43 @@ rif_hashmap_element_t * rif_hashmap_atindex(const rif_hashmap_t *hm_ptr, uint32_
 RIF_API
 rif_status_t rif_hashmap_put(rif_hashmap_t *hm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr);
 
+/**
+ * Inserts the specified element with the specified key in this map, taking over the caller references to both the key
+ * and the element.
+ *
+ * Behaves like `rif_hashmap_put`, except that neither the key nor the element are retained. The caller references are
+ * consumed whatever the outcome, so the caller must not release them afterwards.
+ *
+ * @param hm_ptr  the map
+ * @param key_ptr the key of the element is to be inserted
+ * @param val_ptr element to be inserted
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ *   - `RIF_ERR_CAPACITY`      if the map has a fixed capacity, and the new element does not fit in the map
+ */
+RIF_API
+rif_status_t rif_hashmap_put_steal(rif_hashmap_t *hm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr);
+
+/**
+ * Inserts the specified elements with the specified keys in this map, as if by successive calls to
+ * `rif_hashmap_put`.
+ *
+ * The map is grown once, to hold all the new elements, before any is inserted. If it cannot be, no element is inserted.
+ *
+ * @param hm_ptr   the map
+ * @param key_ptrs the keys of the elements to be inserted
+ * @param val_ptrs the elements to be inserted
+ * @param count    the number of elements
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ *   - `RIF_ERR_CAPACITY`      if the map has a fixed capacity, and the new elements do not fit in the map
+ */
+RIF_API
+rif_status_t rif_hashmap_put_many(
+    rif_hashmap_t *hm_ptr, rif_val_t * const *key_ptrs, rif_val_t * const *val_ptrs, uint32_t count);
+
 /******************************************************************************
  * ELEMENT DELETE FUNCTIONS
  */
@@ -281,6 +529,9 @@ rif_status_t rif_hashmap_put(rif_hashmap_t *hm_ptr, rif_val_t *key_ptr, rif_val_
 /**
  * Removes the element with the specified key in this map.
  *
+ * The following elements of the probe sequence are shifted back into the freed slot, so removals leave no tombstones
+ * behind.
+ *
  * @param hm_ptr  the map
  * @param key_ptr the key of the element to be removed
  * @return        `RIF_OK`
@@ -106,6 +106,21 @@ typedef struct rif_linkedlist_s {
    */
   rif_linkedlist_node_t *last;
 
+  /**
+   * @private
+   *
+   * Last node accessed by index, or `NULL`. Indexed accesses walk from whichever of `first`, `last` or `cursor` is
+   * nearest, so that sequential accesses are O(1). It is updated by reads as well, even through a `const` list.
+   */
+  rif_linkedlist_node_t *cursor;
+
+  /**
+   * @private
+   *
+   * Index of `cursor` in the list.
+   */
+  uint32_t cursor_index;
+
   /**
    * @private
    *
@@ -240,6 +255,24 @@ rif_val_t * rif_linkedlist_get(const rif_linkedlist_t *ll_ptr, uint32_t index);
 RIF_API
 rif_status_t rif_linkedlist_insert(rif_linkedlist_t *ll_ptr, uint32_t index, rif_val_t *val_ptr);
 
+/**
+ * Inserts the specified element at the specified position in this list, taking over the caller reference to it.
+ *
+ * Behaves like `rif_linkedlist_insert`, except that the element is not retained. The caller reference is consumed
+ * whatever the outcome, so the caller must not release the element afterwards.
+ *
+ * @param ll_ptr  the list
+ * @param index   index at which the specified element is to be inserted
+ * @param val_ptr element to be inserted at the specified position
+ *
+ * @return
+ *   - `RIF_OK`                if the operation is successful.
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed.
+ *   - `RIF_ERR_OUT_OF_BOUNDS` if `index` is greater than the size of the list.
+ */
+RIF_API
+rif_status_t rif_linkedlist_insert_steal(rif_linkedlist_t *ll_ptr, uint32_t index, rif_val_t *val_ptr);
+
 /**
  * Appends the specified element to the end of the list.
  *
@@ -256,6 +289,23 @@ rif_status_t rif_linkedlist_append(rif_linkedlist_t *ll_ptr, rif_val_t *val_ptr)
   return rif_linkedlist_insert(ll_ptr, ll_ptr->size, val_ptr);
 }
 
+/**
+ * Appends the specified element to the end of the list, taking over the caller reference to it.
+ *
+ * @param ll_ptr  the list
+ * @param val_ptr element to be appended to the end of the list
+ *
+ * @return
+ *   - `RIF_OK`                if the operation is successful.
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed.
+ *
+ * @see rif_linkedlist_insert_steal
+ */
+RIF_INLINE
+rif_status_t rif_linkedlist_append_steal(rif_linkedlist_t *ll_ptr, rif_val_t *val_ptr) {
+  return rif_linkedlist_insert_steal(ll_ptr, ll_ptr->size, val_ptr);
+}
+
 /**
  * Prepends the specified element to the beginning of the list. Shifts any subsequent elements to the right (adds one to
  * their indices).
@@ -113,6 +113,11 @@ struct rif_list_hooks_s {
    */
   rif_status_t (*append)(rif_list_t *list_ptr, rif_val_t *val_ptr);
 
+  /**
+   * @see rif_list_append_steal
+   */
+  rif_status_t (*append_steal)(rif_list_t *list_ptr, rif_val_t *val_ptr);
+
   /**
    * @see rif_list_prepend
    */
@@ -246,6 +251,31 @@ rif_status_t rif_list_append(rif_list_t *list_ptr, rif_val_t *val_ptr) {
   return rif_hook(append, RIF_ERR_UNSUPPORTED, list_ptr, val_ptr);
 }
 
+/**
+ * Appends the specified element to the end of the list, taking over the caller reference to it.
+ *
+ * The element is not retained by the list. The caller reference is consumed whatever the outcome, so the caller must
+ * not release the element afterwards.
+ *
+ * @param list_ptr the list
+ * @param val_ptr  element to be appended to the end of the list
+ *
+ * @return
+ *   - `RIF_OK`                if the operation is successful.
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed.
+ *   - `RIF_ERR_CAPACITY`      if the list has a fixed capacity, and `index` is greater than the fixed capacity.
+ *   - `RIF_ERR_UNSUPPORTED`   if this operation is not supported by the list implementation.
+ */
+RIF_INLINE
+rif_status_t rif_list_append_steal(rif_list_t *list_ptr, rif_val_t *val_ptr) {
+  if (list_ptr && list_ptr->hooks && list_ptr->hooks->append_steal) {
+    return list_ptr->hooks->append_steal(list_ptr, val_ptr);
+  }
+  rif_status_t status = rif_list_append(list_ptr, val_ptr);
+  rif_val_release(val_ptr);
+  return status;
+}
+
 /**
  * Prepends the specified element to the beginning of the list. Shifts any subsequent elements to the right (adds one to
  * their indices).
@@ -357,9 +387,9 @@ bool rif_list_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_p
 /**
  * @private
  *
- * Callback function get the string representation of a `rif_list_t`.
+ * Callback function to append the string representation of a `rif_list_t` to a string buffer.
  */
-char * rif_list_tostring_callback(const rif_val_t *val_ptr);
+rif_status_t rif_list_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /*****************************************************************************/
 
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "rif/collection/rif_arraydeque_iterator.h"
 #include "rif/collection/rif_arraylist_iterator.h"
 #include "rif/collection/rif_linkedlist_iterator.h"
 
@@ -42,6 +43,7 @@ extern "C" {
  */
 union rif_list_iterator_u {
 
+  rif_arraydeque_iterator_t arraydeque_iterator;
   rif_arraylist_iterator_t arraylist_iterator;
   rif_linkedlist_iterator_t linkedlist_iterator;
 
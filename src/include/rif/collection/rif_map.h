@@ -104,6 +104,11 @@ struct rif_map_hooks_s {
    */
   rif_status_t (*put)(rif_map_t *map_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr);
 
+  /**
+   * @see rif_map_put_steal
+   */
+  rif_status_t (*put_steal)(rif_map_t *map_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr);
+
   /**
    * @see rif_map_remove
    */
@@ -219,6 +224,33 @@ rif_status_t rif_map_put(rif_map_t *map_ptr, rif_val_t *key_ptr, rif_val_t *val_
   return rif_hook(put, RIF_ERR_UNSUPPORTED, map_ptr, key_ptr, val_ptr);
 }
 
+/**
+ * Inserts the specified element with the specified key in this map, taking over the caller references to both the key
+ * and the element.
+ *
+ * Neither the key nor the element are retained by the map. The caller references are consumed whatever the outcome,
+ * so the caller must not release them afterwards.
+ *
+ * @param map_ptr the map
+ * @param key_ptr the key of the element is to be inserted
+ * @param val_ptr element to be inserted
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ *   - `RIF_ERR_CAPACITY`      if the map has a fixed capacity, and the new element does not fit in the map
+ *   - `RIF_ERR_UNSUPPORTED`   if this operation is not supported by the map implementation
+ */
+RIF_INLINE
+rif_status_t rif_map_put_steal(rif_map_t *map_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+  if (map_ptr && map_ptr->hooks && map_ptr->hooks->put_steal) {
+    return map_ptr->hooks->put_steal(map_ptr, key_ptr, val_ptr);
+  }
+  rif_status_t status = rif_map_put(map_ptr, key_ptr, val_ptr);
+  rif_val_release(key_ptr);
+  rif_val_release(val_ptr);
+  return status;
+}
+
 /******************************************************************************
  * ELEMENT DELETE FUNCTIONS
  */
@@ -292,9 +324,9 @@ bool rif_map_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_pt
 /**
  * @private
  *
- * Callback function get the string representation of a `rif_map_t`.
+ * Callback function to append the string representation of a `rif_map_t` to a string buffer.
  */
-char * rif_map_tostring_callback(const rif_val_t *val_ptr);
+rif_status_t rif_map_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /*****************************************************************************/
 
@@ -25,6 +25,8 @@
 #pragma once
 
 #include "rif/collection/rif_hashmap_iterator.h"
+#include "rif/collection/rif_swissmap_iterator.h"
+#include "rif/concurrent/collection/rif_concurrent_hashmap_iterator.h"
 
 /*****************************************************************************/
 
@@ -42,6 +44,8 @@ extern "C" {
 union rif_map_iterator_u {
 
   rif_hashmap_iterator_t hashmap_iterator;
+  rif_swissmap_iterator_t swissmap_iterator;
+  rif_concurrent_hashmap_iterator_t concurrent_hashmap_iterator;
 
 };
 
@@ -87,6 +87,11 @@ struct rif_queue_hooks_s {
    */
   rif_status_t (*push)(rif_queue_t *queue_ptr, rif_val_t *val_ptr);
 
+  /**
+   * @see rif_queue_push_steal
+   */
+  rif_status_t (*push_steal)(rif_queue_t *queue_ptr, rif_val_t *val_ptr);
+
   /**
    * @see rif_queue_pop
    */
@@ -149,6 +154,30 @@ rif_status_t rif_queue_push(rif_queue_t *queue_ptr, rif_val_t *val_ptr) {
   return rif_hook(push, RIF_ERR_UNSUPPORTED, queue_ptr, val_ptr);
 }
 
+/**
+ * Pushes the specified element in this queue, taking over the caller reference to it.
+ *
+ * The element is not retained by the queue. The caller reference is consumed whatever the outcome, so the caller must
+ * not release the element afterwards.
+ *
+ * @param queue_ptr the queue
+ * @param val_ptr   element to be pushed
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ *   - `RIF_ERR_CAPACITY`      if the queue has a fixed capacity, and the new element does not fit in the queue
+ *   - `RIF_ERR_UNSUPPORTED`   if this operation is not supported by the queue implementation
+ */
+RIF_INLINE
+rif_status_t rif_queue_push_steal(rif_queue_t *queue_ptr, rif_val_t *val_ptr) {
+  if (queue_ptr && queue_ptr->hooks && queue_ptr->hooks->push_steal) {
+    return queue_ptr->hooks->push_steal(queue_ptr, val_ptr);
+  }
+  rif_status_t status = rif_queue_push(queue_ptr, val_ptr);
+  rif_val_release(val_ptr);
+  return status;
+}
+
 /**
  * Inserts the specified element with the specified key in this queue. If an element with the same key already exists in
  * the queue, it will be replaced.
@@ -188,9 +217,9 @@ uint32_t rif_queue_hashcode_callback(const rif_val_t *val_ptr);
 /**
  * @private
  *
- * Callback function get the string representation of a `rif_queue_t`.
+ * Callback function to append the string representation of a `rif_queue_t` to a string buffer.
  */
-char * rif_queue_tostring_callback(const rif_val_t *val_ptr);
+rif_status_t rif_queue_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /*****************************************************************************/
 
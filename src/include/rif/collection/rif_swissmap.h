@@ -0,0 +1,332 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+/**
+ * @file
+ * @brief Rif swissmap.
+ *
+ * An open-addressing hash map which keeps one control byte per slot, holding either a 7-bit fingerprint of the key
+ * hash or a free / deleted marker. Lookups compare a whole group of 16 control bytes at once (with SSE2 when
+ * available), and only touch the key array for slots whose fingerprint matches. Keys and values are stored in
+ * separate arrays.
+ */
+
+#pragma once
+
+#include "rif/collection/rif_map.h"
+#include "rif/common/rif_status.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Number of slots probed at once.
+ */
+#define RIF_SWISSMAP_GROUP_WIDTH 16
+
+/******************************************************************************
+ * TYPES
+ */
+
+/**
+ * Rif swissmap type.
+ *
+ * @note This structure internal members are private, and may change without notice. They should only be accessed
+ *       through the public `rif_swissmap_t` methods.
+ *
+ * @extends rif_map_t
+ */
+typedef struct rif_swissmap_s {
+
+  /**
+   * @private
+   *
+   * `rif_swissmap_t` is a `rif_map_t` subtype.
+   */
+  rif_map_t _;
+
+  /**
+   * @private
+   *
+   * Current size of the map.
+   */
+  uint32_t size;
+
+  /**
+   * @private
+   *
+   * Current allocated capacity of the map, in slots.
+   */
+  uint32_t capacity;
+
+  /**
+   * @private
+   *
+   * Number of free slots which can still be used before the map has to be rebuilt.
+   */
+  uint32_t growth_left;
+
+  /**
+   * @private
+   *
+   * Seed mixed into key hashes.
+   */
+  uint32_t seed;
+
+  /**
+   * @private
+   *
+   * Has the map a fixed capacity?
+   */
+  bool fixed;
+
+  /**
+   * @private
+   *
+   * Control bytes, one per slot, followed by a copy of the first `RIF_SWISSMAP_GROUP_WIDTH` ones so that groups
+   * can be loaded past the end of the table.
+   */
+  int8_t *ctrl;
+
+  /**
+   * @private
+   *
+   * Full key hashes, used to rebuild the map without hashing keys again.
+   */
+  uint32_t *hashes;
+
+  /**
+   * @private
+   *
+   * Key array. It is also the start of the single allocation holding every array.
+   */
+  rif_val_t **keys;
+
+  /**
+   * @private
+   *
+   * Value array.
+   */
+  rif_val_t **vals;
+
+} rif_swissmap_t;
+
+/******************************************************************************
+ * HOOKS
+ */
+
+/**
+ * @private
+ *
+ * Swissmap hooks.
+ */
+extern const rif_map_hooks_t rif_swissmap_hooks;
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+/**
+ * Initialize a heap-allocated swissmap.
+ *
+ * @param sm_ptr   the swissmap to initialize
+ * @param capacity the number of elements to allocate room for ; if `0`, the storage will be allocated lazily
+ * @param fixed    if `true`, the map will have a fixed capacity, able to hold at least `capacity` elements
+ * @return         the initialized swissmap if successful, or `NULL` otherwise
+ */
+RIF_API
+rif_swissmap_t * rif_swissmap_init(rif_swissmap_t *sm_ptr, uint32_t capacity, bool fixed);
+
+/**
+ * Create and initialize a heap-allocated swissmap. The swissmap is freed when its reference count reaches 0.
+ *
+ * @param capacity the number of elements to allocate room for ; if `0`, the storage will be allocated lazily
+ * @param fixed    if `true`, the map will have a fixed capacity, able to hold at least `capacity` elements
+ * @return         the initialized swissmap if successful, or `NULL` otherwise
+ */
+RIF_API
+rif_swissmap_t * rif_swissmap_new(uint32_t capacity, bool fixed);
+
+/**
+ * Releases a `rif_swissmap_t`. If the reference count reaches 0, the value will be freed.
+ *
+ * @param sm_ptr the `rif_swissmap_t` to release
+ */
+RIF_INLINE
+void rif_swissmap_release(rif_swissmap_t *sm_ptr) {
+  rif_val_release(sm_ptr);
+}
+
+/******************************************************************************
+ * SIZING FUNCTIONS
+ */
+
+/**
+ * Ensures the map has enough allocated capacity to store at least `capacity` elements without reallocation.
+ *
+ * @param sm_ptr   the map
+ * @param capacity the desired minimum capacity, in elements
+ * @return
+ *   - `RIF_OK`           if the operation is successful
+ *   - `RIF_ERR_MEMORY`   if memory allocation failed
+ *   - `RIF_ERR_CAPACITY` if the map has a fixed capacity, and `capacity` is greater than the fixed capacity
+ */
+RIF_API
+rif_status_t rif_swissmap_ensure_capacity(rif_swissmap_t *sm_ptr, uint32_t capacity);
+
+/******************************************************************************
+ * INFO FUNCTIONS
+ */
+
+/**
+ * Get the size of the map.
+ *
+ * @param sm_ptr the map
+ * @return       the number of elements currently in the map
+ */
+RIF_INLINE
+uint32_t rif_swissmap_size(const rif_swissmap_t *sm_ptr) {
+  return sm_ptr->size;
+}
+
+/**
+ * Get the allocated capacity of the map.
+ *
+ * @param sm_ptr the map
+ * @return       the number of slots allocated by the map
+ */
+RIF_INLINE
+uint32_t rif_swissmap_capacity(const rif_swissmap_t *sm_ptr) {
+  return sm_ptr->capacity;
+}
+
+/******************************************************************************
+ * ELEMENT READ FUNCTIONS
+ */
+
+/**
+ * Checks whether an element exists in the map with the specified key.
+ *
+ * @param sm_ptr  the map
+ * @param key_ptr the key of the element to check for existence
+ * @return        `true` if an element with the specified key exists in the map, or `false` otherwise
+ */
+RIF_API
+bool rif_swissmap_exists(const rif_swissmap_t *sm_ptr, const rif_val_t *key_ptr);
+
+/**
+ * Returns the element with the specified key in this map.
+ *
+ * @param sm_ptr  the map
+ * @param key_ptr the key of the element to return
+ * @return        the element with the specified key in the map if it exists, or `NULL` otherwise
+ */
+RIF_API
+rif_val_t * rif_swissmap_get(const rif_swissmap_t *sm_ptr, const rif_val_t *key_ptr);
+
+/**
+ * @private
+ *
+ * Checks whether the slot at a specified index holds an element.
+ *
+ * This function is part of the internal API, and may change at any time.
+ *
+ * @param sm_ptr the map
+ * @param index  the slot index
+ * @return       `true` if the slot holds an element, or `false` otherwise
+ */
+RIF_INLINE
+bool rif_swissmap_isfull(const rif_swissmap_t *sm_ptr, uint32_t index) {
+  return sm_ptr->ctrl[index] >= 0;
+}
+
+/******************************************************************************
+ * ELEMENT WRITE FUNCTIONS
+ */
+
+/**
+ * Inserts the specified element with the specified key in this map. If an element with the same key already exists in
+ * the map, it will be replaced.
+ *
+ * @param sm_ptr  the map
+ * @param key_ptr the key of the element is to be inserted
+ * @param val_ptr element to be inserted
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ *   - `RIF_ERR_CAPACITY`      if the map has a fixed capacity, and the new element does not fit in the map
+ */
+RIF_API
+rif_status_t rif_swissmap_put(rif_swissmap_t *sm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr);
+
+/**
+ * Inserts the specified element with the specified key in this map, taking over the caller references to both the key
+ * and the element.
+ *
+ * Behaves like `rif_swissmap_put`, except that neither the key nor the element are retained. The caller references
+ * are consumed whatever the outcome, so the caller must not release them afterwards.
+ *
+ * @param sm_ptr  the map
+ * @param key_ptr the key of the element is to be inserted
+ * @param val_ptr element to be inserted
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ *   - `RIF_ERR_CAPACITY`      if the map has a fixed capacity, and the new element does not fit in the map
+ */
+RIF_API
+rif_status_t rif_swissmap_put_steal(rif_swissmap_t *sm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr);
+
+/******************************************************************************
+ * ELEMENT DELETE FUNCTIONS
+ */
+
+/**
+ * Removes the element with the specified key in this map.
+ *
+ * @param sm_ptr  the map
+ * @param key_ptr the key of the element to be removed
+ * @return        `RIF_OK`
+ */
+RIF_API
+rif_status_t rif_swissmap_remove(rif_swissmap_t *sm_ptr, rif_val_t *key_ptr);
+
+/******************************************************************************
+ * CALLBACK FUNCTIONS
+ */
+
+/**
+ * @private
+ *
+ * Callback function to destroy a `rif_swissmap_t`.
+ */
+void rif_swissmap_destroy_callback(rif_swissmap_t *sm_ptr);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
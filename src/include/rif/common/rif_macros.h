@@ -45,6 +45,16 @@
 
 #define RIF_INLINE static inline
 
+/******************************************************************************
+ * THREAD LOCAL STORAGE
+ */
+
+#ifdef _MSC_VER
+  #define RIF_THREAD_LOCAL __declspec(thread)
+#else
+  #define RIF_THREAD_LOCAL __thread
+#endif
+
 /******************************************************************************
  * STATIC ASSERT
  */
@@ -24,9 +24,6 @@
 
 #pragma once
 
-#include "rif/base/rif_val.h"
-#include "rif/common/rif_status.h"
-
 /*****************************************************************************/
 
 #ifdef __cplusplus
@@ -45,7 +42,8 @@ typedef enum rif_status_t {
   RIF_ERR_CAPACITY,
   RIF_ERR_MEMORY,
   RIF_ERR_OUT_OF_BOUNDS,
-  RIF_ERR_UNSUPPORTED
+  RIF_ERR_UNSUPPORTED,
+  RIF_ERR_IO
 } rif_status_t;
 
 /*****************************************************************************/
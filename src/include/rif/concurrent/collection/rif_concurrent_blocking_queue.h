@@ -133,6 +133,16 @@ rif_status_t rif_concurrent_blocking_queue_push(rif_concurrent_blocking_queue_t
   return rif_concurrent_queue_push((rif_concurrent_queue_t *) queue_ptr, val_ptr);
 }
 
+/**
+ * Push a new node to the queue, taking over the caller reference to the value
+ *
+ * @see rif_concurrent_queue_push_steal
+ */
+RIF_INLINE
+rif_status_t rif_concurrent_blocking_queue_push_steal(rif_concurrent_blocking_queue_t *queue_ptr, rif_val_t *val_ptr) {
+  return rif_concurrent_queue_push_steal((rif_concurrent_queue_t *) queue_ptr, val_ptr);
+}
+
 /**
  * Pop the first node of the queue
  */
@@ -0,0 +1,314 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+/**
+ * @file
+ * @brief Rif concurrent hashmap.
+ *
+ * A hashmap safe to share between threads. Elements are spread over a power of two number of segments, each being a
+ * `rif_hashmap_t` guarded by its own lock, so that operations on keys of different segments do not contend.
+ */
+
+#pragma once
+
+#include "rif/collection/rif_hashmap.h"
+#include "rif/concurrent/rif_atomic.h"
+#include "rif/concurrent/rif_threads.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Default number of segments of a concurrent hashmap.
+ */
+#define RIF_CONCURRENT_HASHMAP_DEFAULT_CONCURRENCY 16
+
+/******************************************************************************
+ * TYPES
+ */
+
+/**
+ * @private
+ *
+ * Rif internal concurrent hashmap segment.
+ */
+typedef struct rif_concurrent_hashmap_segment_s {
+
+  /**
+   * @private
+   *
+   * Lock guarding the segment.
+   */
+  mtx_t lock;
+
+  /**
+   * @private
+   *
+   * Segment elements.
+   */
+  rif_hashmap_t map;
+
+} rif_concurrent_hashmap_segment_t;
+
+/**
+ * Rif concurrent hashmap type.
+ *
+ * @note This structure internal members are private, and may change without notice. They should only be accessed
+ *       through the public `rif_concurrent_hashmap_t` methods.
+ *
+ * @extends rif_map_t
+ */
+typedef struct rif_concurrent_hashmap_s {
+
+  /**
+   * @private
+   *
+   * `rif_concurrent_hashmap_t` is a `rif_map_t` subtype.
+   */
+  rif_map_t _;
+
+  /**
+   * @private
+   *
+   * Current size of the map.
+   */
+  atomic_uint32_t size;
+
+  /**
+   * @private
+   *
+   * Number of segments, a power of two.
+   */
+  uint32_t segment_count;
+
+  /**
+   * @private
+   *
+   * Seed mixed into key hashes to select segments.
+   */
+  uint32_t seed;
+
+  /**
+   * @private
+   *
+   * Segment array.
+   */
+  rif_concurrent_hashmap_segment_t *segments;
+
+} rif_concurrent_hashmap_t;
+
+/******************************************************************************
+ * HOOKS
+ */
+
+/**
+ * @private
+ *
+ * Concurrent hashmap hooks.
+ */
+extern const rif_map_hooks_t rif_concurrent_hashmap_hooks;
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+/**
+ * Initialize a heap-allocated concurrent hashmap.
+ *
+ * @param chm_ptr     the concurrent hashmap to initialize
+ * @param capacity    the number of elements to allocate room for, spread over all segments ; if `0`, the storage
+ *                    will be allocated lazily
+ * @param concurrency the number of segments, rounded up to a power of two ; if `0`,
+ *                    `RIF_CONCURRENT_HASHMAP_DEFAULT_CONCURRENCY` is used
+ * @return            the initialized concurrent hashmap if successful, or `NULL` otherwise
+ */
+RIF_API
+rif_concurrent_hashmap_t * rif_concurrent_hashmap_init(
+    rif_concurrent_hashmap_t *chm_ptr, uint32_t capacity, uint32_t concurrency);
+
+/**
+ * Releases a `rif_concurrent_hashmap_t`. If the reference count reaches 0, the value will be freed.
+ *
+ * @param chm_ptr the `rif_concurrent_hashmap_t` to release
+ */
+RIF_INLINE
+void rif_concurrent_hashmap_release(rif_concurrent_hashmap_t *chm_ptr) {
+  rif_val_release(chm_ptr);
+}
+
+/******************************************************************************
+ * INFO FUNCTIONS
+ */
+
+/**
+ * Get the size of the map.
+ *
+ * @param chm_ptr the map
+ * @return        the number of elements currently in the map
+ */
+RIF_INLINE
+uint32_t rif_concurrent_hashmap_size(const rif_concurrent_hashmap_t *chm_ptr) {
+  return atomic_load_explicit((atomic_uint32_t *) &chm_ptr->size, memory_order_relaxed);
+}
+
+/******************************************************************************
+ * ELEMENT READ FUNCTIONS
+ */
+
+/**
+ * Checks whether an element exists in the map with the specified key.
+ *
+ * @param chm_ptr the map
+ * @param key_ptr the key of the element to check for existence
+ * @return        `true` if an element with the specified key exists in the map, or `false` otherwise
+ */
+RIF_API
+bool rif_concurrent_hashmap_exists(rif_concurrent_hashmap_t *chm_ptr, const rif_val_t *key_ptr);
+
+/**
+ * Returns the element with the specified key in this map.
+ *
+ * The element is not retained, so it may be released by another thread replacing or removing it at any time. Use
+ * `rif_concurrent_hashmap_get_retained` unless other threads are known not to do so.
+ *
+ * @param chm_ptr the map
+ * @param key_ptr the key of the element to return
+ * @return        the element with the specified key in the map if it exists, or `NULL` otherwise
+ */
+RIF_API
+rif_val_t * rif_concurrent_hashmap_get(rif_concurrent_hashmap_t *chm_ptr, const rif_val_t *key_ptr);
+
+/**
+ * Returns the element with the specified key in this map, retained on behalf of the caller, who must release it.
+ *
+ * @param chm_ptr the map
+ * @param key_ptr the key of the element to return
+ * @return        the element with the specified key in the map if it exists, or `NULL` otherwise
+ */
+RIF_API
+rif_val_t * rif_concurrent_hashmap_get_retained(rif_concurrent_hashmap_t *chm_ptr, const rif_val_t *key_ptr);
+
+/******************************************************************************
+ * ELEMENT WRITE FUNCTIONS
+ */
+
+/**
+ * Inserts the specified element with the specified key in this map. If an element with the same key already exists in
+ * the map, it will be replaced.
+ *
+ * @param chm_ptr the map
+ * @param key_ptr the key of the element is to be inserted
+ * @param val_ptr element to be inserted
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ */
+RIF_API
+rif_status_t rif_concurrent_hashmap_put(rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr);
+
+/**
+ * Inserts the specified element with the specified key in this map, taking over the caller references to both the key
+ * and the element.
+ *
+ * Behaves like `rif_concurrent_hashmap_put`, except that neither the key nor the element are retained. The caller
+ * references are consumed whatever the outcome, so the caller must not release them afterwards.
+ *
+ * @param chm_ptr the map
+ * @param key_ptr the key of the element is to be inserted
+ * @param val_ptr element to be inserted
+ * @return
+ *   - `RIF_OK`                if the operation is successful
+ *   - `RIF_ERR_MEMORY`        if memory allocation failed
+ */
+RIF_API
+rif_status_t rif_concurrent_hashmap_put_steal(
+    rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr);
+
+/**
+ * Inserts the specified element with the specified key in this map, unless an element with the same key already
+ * exists in the map. The element now associated with the key is retained before the segment lock is released, so
+ * that it remains valid even if it is concurrently removed. It must be released by the caller.
+ *
+ * @param chm_ptr the map
+ * @param key_ptr the key of the element is to be inserted
+ * @param val_ptr element to be inserted
+ * @return        the existing element with the specified key if any, or `val_ptr` if it was inserted, or `NULL` if
+ *                memory allocation failed
+ */
+RIF_API
+rif_val_t * rif_concurrent_hashmap_putifabsent(
+    rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr);
+
+/**
+ * @private
+ *
+ * Behaves like `rif_concurrent_hashmap_putifabsent`, and sets the specified `RIF_VAL_FLAG_*` bits on `val_ptr` under
+ * the segment lock if, and only if, it was inserted. `val_ptr` is never written to when `flags` is `0`, or when it is
+ * an immediate value.
+ *
+ * This function is part of the internal API, and may change at any time.
+ *
+ * @param chm_ptr the map
+ * @param key_ptr the key of the element is to be inserted
+ * @param val_ptr element to be inserted
+ * @param flags   the flags to set on the element once inserted
+ * @return        the existing element with the specified key if any, or `val_ptr` if it was inserted, or `NULL` if
+ *                memory allocation failed
+ */
+RIF_API
+rif_val_t * rif_concurrent_hashmap_putifabsent_helper(
+    rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr, uint8_t flags);
+
+/******************************************************************************
+ * ELEMENT DELETE FUNCTIONS
+ */
+
+/**
+ * Removes the element with the specified key in this map.
+ *
+ * @param chm_ptr the map
+ * @param key_ptr the key of the element to be removed
+ * @return        `RIF_OK`
+ */
+RIF_API
+rif_status_t rif_concurrent_hashmap_remove(rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr);
+
+/******************************************************************************
+ * CALLBACK FUNCTIONS
+ */
+
+/**
+ * @private
+ *
+ * Callback function to destroy a `rif_concurrent_hashmap_t`.
+ */
+void rif_concurrent_hashmap_destroy_callback(rif_concurrent_hashmap_t *chm_ptr);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -145,6 +145,13 @@ uint32_t rif_concurrent_queue_size(const rif_concurrent_queue_t *queue_ptr) {
 RIF_API
 rif_status_t rif_concurrent_queue_push(rif_concurrent_queue_t *queue_ptr, rif_val_t *val_ptr);
 
+/**
+ * Push a new node to the queue, taking over the caller reference to the value. The reference is consumed whatever the
+ * outcome, so the caller must not release the value afterwards.
+ */
+RIF_API
+rif_status_t rif_concurrent_queue_push_steal(rif_concurrent_queue_t *queue_ptr, rif_val_t *val_ptr);
+
 /**
  * Pop the first node of the queue
  */
@@ -20,11 +20,23 @@
 /**
  * @file
  * @brief Rif concurrent memory pool.
+ *
+ * Free elements are kept in a shared lock-free stack, in front of which every thread keeps a private magazine. Most
+ * borrow / return pairs only touch the calling thread magazine, and the shared stack is only accessed to exchange whole
+ * batches of `RIF_CONCURRENT_POOL_MAGAZINE_SIZE` elements when a magazine runs empty or full.
+ *
+ * Elements may be returned by any thread: they simply go to the returning thread magazine, and flow back to the other
+ * threads through the shared stack.
+ *
+ * Elements are carved from cache-aligned slabs, which are only released when the pool is destroyed. Slabs can be
+ * preallocated with `rif_concurrent_pool_reserve`, and the total number of elements can be capped with
+ * `rif_concurrent_pool_set_max_nodes`.
  */
 
 #pragma once
 
 #include "rif/base/rif_pool.h"
+#include "rif/common/rif_status.h"
 #include "rif/concurrent/rif_threads.h"
 #include "rif/concurrent/collection/rif_concurrent_queue_base.h"
 
@@ -34,6 +46,26 @@
 extern "C" {
 #endif
 
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Number of elements exchanged at once between a thread magazine and the shared free stack.
+ */
+#define RIF_CONCURRENT_POOL_MAGAZINE_SIZE 64
+
+/**
+ * Alignment of slabs, and size of their header.
+ */
+#define RIF_CONCURRENT_POOL_SLAB_ALIGNMENT 64
+
+/**
+ * Maximum size of a slab, in bytes. Slabs start with `RIF_CONCURRENT_POOL_MAGAZINE_SIZE` nodes, and double in size
+ * until they reach this size, unless a single node is larger.
+ */
+#define RIF_CONCURRENT_POOL_SLAB_MAX_BYTES 65536
+
 /******************************************************************************
  * TYPES
  */
@@ -61,6 +93,110 @@ typedef struct rif_concurrent_pool_node_s {
 
 } rif_concurrent_pool_node_t;
 
+/**
+ * @private
+ *
+ * Rif concurrent pool slab header.
+ */
+typedef struct rif_concurrent_pool_slab_s {
+
+  /**
+   * @private
+   *
+   * Next slab.
+   */
+  struct rif_concurrent_pool_slab_s *next;
+
+  /**
+   * @private
+   *
+   * Padding, keeping the first node on its own cache line.
+   */
+  char padding[RIF_CONCURRENT_POOL_SLAB_ALIGNMENT - sizeof(void *)];
+
+  /**
+   * @private
+   *
+   * Nodes.
+   */
+  char nodes[];
+
+} rif_concurrent_pool_slab_t;
+
+/**
+ * @private
+ *
+ * Chain of free nodes, linked through their element memory.
+ */
+typedef struct rif_concurrent_pool_chain_s {
+
+  /**
+   * @private
+   *
+   * First node of the chain.
+   */
+  rif_concurrent_pool_node_t *first;
+
+  /**
+   * @private
+   *
+   * Number of nodes in the chain.
+   */
+  uint32_t count;
+
+} rif_concurrent_pool_chain_t;
+
+/**
+ * @private
+ *
+ * Rif concurrent pool per-thread magazine.
+ */
+typedef struct rif_concurrent_pool_magazine_s {
+
+  /**
+   * @private
+   *
+   * Owning pool.
+   */
+  struct rif_concurrent_pool_t *pool;
+
+  /**
+   * @private
+   *
+   * Previous magazine in the pool magazine list.
+   */
+  struct rif_concurrent_pool_magazine_s *prev;
+
+  /**
+   * @private
+   *
+   * Next magazine in the pool magazine list.
+   */
+  struct rif_concurrent_pool_magazine_s *next;
+
+  /**
+   * @private
+   *
+   * Chain elements are borrowed from and returned to.
+   */
+  rif_concurrent_pool_chain_t loaded;
+
+  /**
+   * @private
+   *
+   * Full chain kept aside, so that alternating borrows and returns at a batch boundary do not hit the shared stack.
+   */
+  rif_concurrent_pool_chain_t previous;
+
+  /**
+   * @private
+   *
+   * Number of free nodes held by the magazine, published for statistics.
+   */
+  atomic_uint32_t free_count;
+
+} rif_concurrent_pool_magazine_t;
+
 /**
  * Rif concurrent pool.
  *
@@ -78,7 +214,7 @@ typedef struct rif_concurrent_pool_t {
   /**
    * @private
    *
-   * Element free queue.
+   * Shared free stack. Each of its nodes is the head of a chain of free nodes.
    */
   rif_concurrent_queue_base_t free_queue;
 
@@ -89,6 +225,77 @@ typedef struct rif_concurrent_pool_t {
    */
   uint32_t element_size;
 
+  /**
+   * @private
+   *
+   * Distance between two nodes in a slab.
+   */
+  uint32_t node_stride;
+
+  /**
+   * @private
+   *
+   * Maximum number of nodes, or `0` if unbounded.
+   */
+  uint32_t max_nodes;
+
+  /**
+   * @private
+   *
+   * Number of nodes carved from slabs so far.
+   */
+  atomic_uint32_t node_count;
+
+  /**
+   * @private
+   *
+   * Number of free nodes in the shared free stack.
+   */
+  atomic_uint32_t shared_free_count;
+
+  /**
+   * @private
+   *
+   * Number of allocated slabs.
+   */
+  atomic_uint32_t slab_count;
+
+  /**
+   * @private
+   *
+   * List of allocated slabs.
+   */
+  atomic_uintptr_t first_slab;
+
+  /**
+   * @private
+   *
+   * Thread-specific storage key of the calling thread magazine.
+   */
+  tss_t magazine_key;
+
+  /**
+   * @private
+   *
+   * Have per-thread magazines been enabled? If the thread-specific storage key could not be created, every operation
+   * goes through the shared free stack.
+   */
+  bool magazines;
+
+  /**
+   * @private
+   *
+   * Lock protecting the magazine list.
+   */
+  mtx_t magazines_lock;
+
+  /**
+   * @private
+   *
+   * List of the magazines of every thread which used the pool, released along with the pool.
+   */
+  rif_concurrent_pool_magazine_t *first_magazine;
+
 } rif_concurrent_pool_t;
 
 /******************************************************************************
@@ -110,9 +317,7 @@ extern const rif_pool_hooks_t rif_concurrent_pool_hooks;
  * Initialize a pool
  *
  * @param pool_ptr pool to initialize
- * @param block_size block size
  * @param element_size element size
- * @param lazy if `true`, the first block will be initialized lazily
  *
  * @return the initialized pool, or `NULL` in case of failure
  */
@@ -122,11 +327,85 @@ rif_concurrent_pool_t * rif_concurrent_pool_init(rif_concurrent_pool_t *pool_ptr
 /**
  * Destroy a pool
  *
+ * Every element, including those still held in other threads magazines, is released. No other thread may use the pool
+ * concurrently.
+ *
  * @param pool_ptr pool to destroy
  */
 RIF_API
 void rif_concurrent_pool_destroy(rif_concurrent_pool_t *pool_ptr);
 
+/******************************************************************************
+ * SIZING FUNCTIONS
+ */
+
+/**
+ * Preallocate slabs so that at least `count` nodes have been carved, within the limit set by
+ * `rif_concurrent_pool_set_max_nodes`.
+ *
+ * @param pool_ptr the pool
+ * @param count the number of nodes to preallocate
+ *
+ * @return
+ *   - `RIF_OK`           if the operation is successful
+ *   - `RIF_ERR_MEMORY`   if memory allocation failed
+ *   - `RIF_ERR_CAPACITY` if `count` is greater than the maximum number of nodes
+ */
+RIF_API
+rif_status_t rif_concurrent_pool_reserve(rif_concurrent_pool_t *pool_ptr, uint32_t count);
+
+/**
+ * Set a hard limit on the number of nodes the pool carves. Once it is reached, borrowing fails fast when the calling
+ * thread magazine and the shared free stack are empty, even if other threads hold free nodes in their magazines.
+ *
+ * Nodes already carved beyond a lower limit are kept. This function must not be called concurrently with a borrow.
+ *
+ * @param pool_ptr the pool
+ * @param max_nodes the maximum number of nodes, or `0` for no limit
+ */
+RIF_API
+void rif_concurrent_pool_set_max_nodes(rif_concurrent_pool_t *pool_ptr, uint32_t max_nodes);
+
+/******************************************************************************
+ * STATISTICS FUNCTIONS
+ */
+
+/**
+ * Get the number of free nodes, in the shared free stack and in every thread magazine.
+ *
+ * Under concurrent use, this is a snapshot which may be slightly stale.
+ *
+ * @param pool_ptr the pool
+ *
+ * @return the number of free nodes
+ */
+RIF_API
+uint32_t rif_concurrent_pool_free_count(rif_concurrent_pool_t *pool_ptr);
+
+/**
+ * Get the number of borrowed nodes.
+ *
+ * Under concurrent use, this is a snapshot which may be slightly stale.
+ *
+ * @param pool_ptr the pool
+ *
+ * @return the number of borrowed nodes
+ */
+RIF_API
+uint32_t rif_concurrent_pool_live_count(rif_concurrent_pool_t *pool_ptr);
+
+/**
+ * Get the number of slabs allocated by the pool.
+ *
+ * @param pool_ptr the pool
+ *
+ * @return the number of slabs
+ */
+RIF_INLINE
+uint32_t rif_concurrent_pool_slab_count(rif_concurrent_pool_t *pool_ptr) {
+  return atomic_load_explicit(&pool_ptr->slab_count, memory_order_relaxed);
+}
+
 /******************************************************************************
  * ACCESSOR FUNCTIONS
  */
@@ -134,11 +413,12 @@ void rif_concurrent_pool_destroy(rif_concurrent_pool_t *pool_ptr);
 /**
  * Borrow an element from the pool
  *
- * If the pool doesn't have available elements, a new memory block is allocated.
+ * If the pool doesn't have available elements, a new slab is allocated.
  *
  * @param pool_ptr the pool
  *
- * @return an element from the pool, or `NULL` in case of allocation failure
+ * @return an element from the pool, or `NULL` in case of allocation failure or if the maximum number of nodes is
+ *         reached
  */
 RIF_API
 void * rif_concurrent_pool_borrow(rif_concurrent_pool_t *pool_ptr);
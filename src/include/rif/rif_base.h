@@ -27,10 +27,12 @@
 #include "base/rif_val.h"
 
 #include "base/rif_bool.h"
+#include "base/rif_buffer.h"
 #include "base/rif_double.h"
 #include "base/rif_int.h"
 #include "base/rif_null.h"
 #include "base/rif_pair.h"
+#include "base/rif_reclaim.h"
 #include "base/rif_string.h"
 
 #include "base/rif_pool.h"
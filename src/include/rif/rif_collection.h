@@ -30,9 +30,13 @@
 #include "collection/rif_map.h"
 #include "collection/rif_map_iterator.h"
 
+#include "collection/rif_arraydeque.h"
+#include "collection/rif_arraydeque_iterator.h"
 #include "collection/rif_arraylist.h"
 #include "collection/rif_arraylist_iterator.h"
 #include "collection/rif_hashmap.h"
 #include "collection/rif_hashmap_iterator.h"
 #include "collection/rif_linkedlist.h"
-#include "collection/rif_linkedlist_iterator.h"
\ No newline at end of file
+#include "collection/rif_linkedlist_iterator.h"
+#include "collection/rif_swissmap.h"
+#include "collection/rif_swissmap_iterator.h"
\ No newline at end of file
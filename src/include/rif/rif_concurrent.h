@@ -30,5 +30,7 @@
 #include "concurrent/rif_concurrent_pool.h"
 
 #include "concurrent/collection/rif_concurrent_blocking_queue.h"
+#include "concurrent/collection/rif_concurrent_hashmap.h"
+#include "concurrent/collection/rif_concurrent_hashmap_iterator.h"
 #include "concurrent/collection/rif_concurrent_queue.h"
 #include "concurrent/collection/rif_concurrent_queue_base.h"
\ No newline at end of file
@@ -25,8 +25,11 @@
 #pragma once
 
 #include "util/rif_alloc.h"
+#include "util/rif_arena.h"
 #include "util/rif_hash.h"
 #include "util/rif_hook.h"
 #include "util/rif_math.h"
 #include "util/rif_misc.h"
+#include "util/rif_slab.h"
+#include "util/rif_strbuf.h"
 #include "util/rif_version.h"
\ No newline at end of file
@@ -0,0 +1,298 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+/**
+ * @file
+ * @brief Rif arena allocator.
+ *
+ * An arena hands out memory by bumping a pointer in large chunks, and releases all of it at once with
+ * `rif_arena_reset` or `rif_arena_destroy`.
+ *
+ * Values can be built into an arena explicitly, with the in-place constructors:
+ *
+ *     rif_int_t *int_ptr = rif_int_init(rif_arena_new(&arena, rif_int_t), 42);
+ *
+ * Such values are not freed when released. Alternatively, an arena can be made current for the calling thread with
+ * `rif_arena_set_current`: every Rif allocation made by the thread then comes from the arena, including the storage of
+ * `rif_*_new` values, duplicated strings and collection growth. Freeing arena memory is a no-op, so a whole object graph
+ * built while the arena is current can be dropped with a single `rif_arena_reset`, without releasing its values.
+ *
+ * Memory obtained while an arena is current must not be freed once another arena or the heap allocator is current, nor
+ * after the arena is reset. In particular, values which outlive the arena must not allocate while it is current.
+ * Resetting an arena does not run value destructors: references that arena values hold to heap values are not released.
+ */
+
+#pragma once
+
+#include "rif/rif_common.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Default size of arena chunks, in bytes.
+ */
+#define RIF_ARENA_DEFAULT_CHUNK_SIZE 65536
+
+/**
+ * Alignment of the memory returned by an arena.
+ */
+#define RIF_ARENA_ALIGNMENT 16
+
+/******************************************************************************
+ * TYPES
+ */
+
+/**
+ * @private
+ *
+ * Rif arena chunk.
+ */
+typedef struct rif_arena_chunk_s {
+
+  /**
+   * @private
+   *
+   * Previously allocated chunk.
+   */
+  struct rif_arena_chunk_s *prev;
+
+  /**
+   * @private
+   *
+   * End of the chunk memory.
+   */
+  char *end;
+
+  /**
+   * @private
+   *
+   * Chunks at lower addresses, in the arena chunk tree.
+   */
+  struct rif_arena_chunk_s *left;
+
+  /**
+   * @private
+   *
+   * Chunks at higher addresses, in the arena chunk tree.
+   */
+  struct rif_arena_chunk_s *right;
+
+  /**
+   * @private
+   *
+   * Heap priority of the chunk in the arena chunk tree.
+   */
+  uint32_t priority;
+
+  /**
+   * @private
+   *
+   * Chunk memory.
+   */
+  char data[];
+
+} rif_arena_chunk_t;
+
+/**
+ * Rif arena.
+ *
+ * @note This structure internal members are private, and may change without notice.
+ */
+typedef struct rif_arena_s {
+
+  /**
+   * @private
+   *
+   * Size of regular chunks.
+   */
+  size_t chunk_size;
+
+  /**
+   * @private
+   *
+   * Current chunk, head of the chunk list.
+   */
+  rif_arena_chunk_t *chunk;
+
+  /**
+   * @private
+   *
+   * Root of the chunk tree: a treap ordered by chunk address, so that ownership checks do not walk the chunk list.
+   */
+  rif_arena_chunk_t *root;
+
+  /**
+   * @private
+   *
+   * Next free byte in the current chunk.
+   */
+  char *position;
+
+  /**
+   * @private
+   *
+   * Start of the last allocation, which can be grown or freed in place.
+   */
+  char *last;
+
+} rif_arena_t;
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+/**
+ * Initialize an arena. No memory is allocated until the first allocation.
+ *
+ * @param arena_ptr  the arena to initialize
+ * @param chunk_size the size of chunks, in bytes, or `0` for `RIF_ARENA_DEFAULT_CHUNK_SIZE`
+ * @return           the initialized arena, or `NULL` if `arena_ptr` is `NULL`
+ */
+RIF_API
+rif_arena_t * rif_arena_init(rif_arena_t *arena_ptr, size_t chunk_size);
+
+/**
+ * Release all the memory held by an arena.
+ *
+ * @param arena_ptr the arena
+ */
+RIF_API
+void rif_arena_destroy(rif_arena_t *arena_ptr);
+
+/**
+ * Release every allocation at once. The first regular chunk is kept for reuse, and every other chunk is freed.
+ *
+ * @param arena_ptr the arena
+ */
+RIF_API
+void rif_arena_reset(rif_arena_t *arena_ptr);
+
+/******************************************************************************
+ * ALLOCATION FUNCTIONS
+ */
+
+/**
+ * Allocate memory from an arena, aligned on `RIF_ARENA_ALIGNMENT`.
+ *
+ * @param arena_ptr the arena
+ * @param size      the number of bytes to allocate
+ * @return          the allocated memory, or `NULL` in case of allocation failure
+ */
+RIF_API
+void * rif_arena_alloc(rif_arena_t *arena_ptr, size_t size);
+
+/**
+ * Allocate memory from an arena, with a specific alignment.
+ *
+ * @param arena_ptr the arena
+ * @param alignment the alignment, which must be a power of two
+ * @param size      the number of bytes to allocate
+ * @return          the allocated memory, or `NULL` in case of allocation failure
+ */
+RIF_API
+void * rif_arena_aligned_alloc(rif_arena_t *arena_ptr, size_t alignment, size_t size);
+
+/**
+ * Resize memory allocated from an arena. The last allocation is resized in place when the current chunk has room;
+ * other allocations are moved.
+ *
+ * @param arena_ptr the arena
+ * @param ptr       memory previously allocated from the arena, or `NULL`
+ * @param size      the new size, in bytes
+ * @return          the resized memory, or `NULL` in case of allocation failure
+ */
+RIF_API
+void * rif_arena_realloc(rif_arena_t *arena_ptr, void *ptr, size_t size);
+
+/**
+ * Free memory allocated from an arena. Only the last allocation is actually reclaimed; any other call has no effect.
+ *
+ * @param arena_ptr the arena
+ * @param ptr       memory previously allocated from the arena
+ */
+RIF_API
+void rif_arena_free(rif_arena_t *arena_ptr, void *ptr);
+
+/**
+ * Allocate room for a value of the given type from an arena.
+ *
+ * @param __arena_ptr the arena
+ * @param __type      the type
+ */
+#define rif_arena_new(__arena_ptr, __type) ((__type *) rif_arena_alloc(__arena_ptr, sizeof(__type)))
+
+/******************************************************************************
+ * INFO FUNCTIONS
+ */
+
+/**
+ * Checks whether memory was allocated from an arena. This takes logarithmic time in the number of chunks, so that
+ * freeing heap memory while an arena is current stays cheap.
+ *
+ * @param arena_ptr the arena
+ * @param ptr       the memory to check
+ * @return          `true` if `ptr` lies in one of the arena chunks, or `false` otherwise
+ */
+RIF_API
+bool rif_arena_owns(const rif_arena_t *arena_ptr, const void *ptr);
+
+/**
+ * Get the number of chunks allocated by an arena.
+ *
+ * @param arena_ptr the arena
+ * @return          the number of chunks
+ */
+RIF_API
+uint32_t rif_arena_chunk_count(const rif_arena_t *arena_ptr);
+
+/******************************************************************************
+ * SCOPE FUNCTIONS
+ */
+
+/**
+ * Make an arena current for the calling thread: until another arena is made current, every Rif allocation made by
+ * the thread comes from it. Scopes can be nested by restoring the returned arena.
+ *
+ * @param arena_ptr the arena, or `NULL` to go back to the heap allocators
+ * @return          the previously current arena, or `NULL` if there was none
+ */
+RIF_API
+rif_arena_t * rif_arena_set_current(rif_arena_t *arena_ptr);
+
+/**
+ * Get the arena current for the calling thread.
+ *
+ * @return the current arena, or `NULL` if allocations go to the heap allocators
+ */
+RIF_API
+rif_arena_t * rif_arena_current(void);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -53,6 +53,15 @@ uint32_t rif_hash_64(uint64_t key);
  */
 uint32_t rif_hash_mix_32(uint32_t first, uint32_t second);
 
+/**
+ * Hash a buffer to a 32-bit integer in a single pass.
+ *
+ * @param data The buffer.
+ * @param len  The buffer length, in bytes.
+ * @return     The buffer hash.
+ */
+uint32_t rif_hash_bytes(const void *data, size_t len);
+
 /*****************************************************************************/
 
 #ifdef __cplusplus
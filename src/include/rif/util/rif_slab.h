@@ -0,0 +1,123 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+/**
+ * @file
+ * @brief Rif small value allocator.
+ *
+ * The `rif_*_new` constructors of small values (`rif_int_t`, `rif_double_t`, `rif_pair_t`, `rif_string_t`) allocate
+ * from size-class slab caches rather than from the heap allocators. Every thread keeps a private cache of free objects
+ * per size class, which exchanges whole batches with a shared depot when it runs empty or full, so allocating and
+ * releasing a value usually costs a couple of pointer operations.
+ *
+ * Slabs are carved with the heap allocators, and are kept for the lifetime of the process: the memory they hold is
+ * bounded by the peak number of live small values. The caches can be switched off at runtime, in which case new values
+ * go to the heap allocators again; values allocated from the caches are still returned to them.
+ */
+
+#pragma once
+
+#include "rif/rif_common.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Size classes are multiples of this granularity, in bytes.
+ */
+#define RIF_SLAB_GRANULARITY 8
+
+/**
+ * Smallest size class, in bytes.
+ */
+#define RIF_SLAB_MIN_SIZE 16
+
+/**
+ * Largest size class, in bytes. Larger objects always go to the heap allocators.
+ */
+#define RIF_SLAB_MAX_SIZE 64
+
+/**
+ * Number of size classes.
+ */
+#define RIF_SLAB_CLASS_COUNT ((RIF_SLAB_MAX_SIZE - RIF_SLAB_MIN_SIZE) / RIF_SLAB_GRANULARITY + 1)
+
+/**
+ * Size of a slab, in bytes.
+ */
+#define RIF_SLAB_BYTES 16384
+
+/**
+ * Default number of objects exchanged at once between a thread cache and the shared depot.
+ */
+#define RIF_SLAB_DEFAULT_BATCH_SIZE 64
+
+/******************************************************************************
+ * SETTINGS FUNCTIONS
+ */
+
+/**
+ * Enable or disable the small value caches. They are enabled by default.
+ *
+ * @param enabled `true` to allocate small values from the caches, `false` to use the heap allocators
+ */
+RIF_API
+void rif_slab_set_enabled(bool enabled);
+
+/**
+ * Check whether the small value caches are enabled.
+ *
+ * @return `true` if small values are allocated from the caches, or `false` otherwise
+ */
+RIF_API
+bool rif_slab_enabled(void);
+
+/**
+ * Set the number of objects exchanged at once between a thread cache and the shared depot. A thread cache holds at
+ * most twice this number of free objects per size class.
+ *
+ * @param batch_size the batch size, or `0` for `RIF_SLAB_DEFAULT_BATCH_SIZE`
+ */
+RIF_API
+void rif_slab_set_batch_size(uint32_t batch_size);
+
+/******************************************************************************
+ * STATISTICS FUNCTIONS
+ */
+
+/**
+ * Get the number of slabs allocated so far, for every size class.
+ *
+ * @return the number of slabs
+ */
+RIF_API
+uint32_t rif_slab_count(void);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
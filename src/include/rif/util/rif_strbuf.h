@@ -0,0 +1,286 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+/**
+ * @file
+ * @brief Rif string buffer.
+ *
+ * A string buffer accumulates text appended piece by piece, growing its storage geometrically. It either keeps the
+ * whole text in memory, to be taken over as a C string with `rif_strbuf_detach`, or streams it to a file descriptor
+ * through a fixed-size chunk, so that arbitrarily large outputs are written in a single pass with bounded memory.
+ *
+ * Errors are sticky: once an append fails, the buffer keeps its status and ignores further appends, so a sequence of
+ * appends can be checked once at the end.
+ */
+
+#pragma once
+
+#include "rif/rif_common.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * CONSTANTS
+ */
+
+/**
+ * Initial capacity of in-memory string buffers, in bytes, when none is specified.
+ */
+#define RIF_STRBUF_DEFAULT_CAPACITY 64
+
+/**
+ * Size of the chunk of string buffers streaming to a file descriptor, in bytes, when none is specified.
+ */
+#define RIF_STRBUF_DEFAULT_CHUNK_SIZE 65536
+
+/******************************************************************************
+ * TYPES
+ */
+
+/**
+ * Rif string buffer.
+ *
+ * @note This structure internal members are private, and may change without notice.
+ */
+typedef struct rif_strbuf_s {
+
+  /**
+   * @private
+   *
+   * Buffered text, not NUL-terminated.
+   */
+  char *data;
+
+  /**
+   * @private
+   *
+   * Number of buffered bytes.
+   */
+  size_t size;
+
+  /**
+   * @private
+   *
+   * Allocated size of `data`, in bytes.
+   */
+  size_t capacity;
+
+  /**
+   * @private
+   *
+   * Number of bytes already written to `fd`.
+   */
+  size_t written;
+
+  /**
+   * @private
+   *
+   * File descriptor the text is streamed to, or `-1` if it is kept in memory.
+   */
+  int fd;
+
+  /**
+   * @private
+   *
+   * Status of the first failed operation, or `RIF_OK`.
+   */
+  rif_status_t status;
+
+} rif_strbuf_t;
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+/**
+ * Initialize an in-memory string buffer.
+ *
+ * @param sb_ptr   the string buffer to initialize
+ * @param capacity the number of bytes to allocate room for ; if `0`, the storage will be allocated lazily
+ * @return         the initialized string buffer if successful, or `NULL` otherwise
+ */
+RIF_API
+rif_strbuf_t * rif_strbuf_init(rif_strbuf_t *sb_ptr, size_t capacity);
+
+/**
+ * Initialize a string buffer streaming to a file descriptor. Text is written each time the chunk is full, and when the
+ * buffer is flushed.
+ *
+ * @param sb_ptr     the string buffer to initialize
+ * @param fd         the file descriptor to write to ; it is not closed by the buffer
+ * @param chunk_size the size of the chunk, in bytes, or `0` for `RIF_STRBUF_DEFAULT_CHUNK_SIZE`
+ * @return           the initialized string buffer if successful, or `NULL` otherwise
+ */
+RIF_API
+rif_strbuf_t * rif_strbuf_init_fd(rif_strbuf_t *sb_ptr, int fd, size_t chunk_size);
+
+/**
+ * Release the storage of a string buffer. Text which has not been flushed yet is discarded.
+ *
+ * @param sb_ptr the string buffer
+ */
+RIF_API
+void rif_strbuf_destroy(rif_strbuf_t *sb_ptr);
+
+/******************************************************************************
+ * INFO FUNCTIONS
+ */
+
+/**
+ * Get the status of a string buffer.
+ *
+ * @param sb_ptr the string buffer
+ * @return
+ *   - `RIF_OK`          if every operation so far succeeded
+ *   - `RIF_ERR_MEMORY`  if memory allocation failed
+ *   - `RIF_ERR_IO`      if writing to the file descriptor failed
+ */
+RIF_INLINE
+rif_status_t rif_strbuf_status(const rif_strbuf_t *sb_ptr) {
+  return sb_ptr->status;
+}
+
+/**
+ * Get the length of the text appended to a string buffer, including the text already written to its file descriptor.
+ *
+ * @param sb_ptr the string buffer
+ * @return       the length of the text, in bytes
+ */
+RIF_INLINE
+size_t rif_strbuf_length(const rif_strbuf_t *sb_ptr) {
+  return sb_ptr->written + sb_ptr->size;
+}
+
+/**
+ * Mark a string buffer as failed, for instance when a value has no text representation. Does nothing if the buffer has
+ * already failed.
+ *
+ * @param sb_ptr the string buffer
+ * @param status the error status
+ * @return       the status of the string buffer
+ */
+RIF_INLINE
+rif_status_t rif_strbuf_set_error(rif_strbuf_t *sb_ptr, rif_status_t status) {
+  if (sb_ptr->status == RIF_OK) {
+    sb_ptr->status = status;
+  }
+  return sb_ptr->status;
+}
+
+/******************************************************************************
+ * APPEND FUNCTIONS
+ */
+
+/**
+ * @private
+ *
+ * Helper function to append bytes to a string buffer which has no room left for them.
+ */
+RIF_API
+rif_status_t rif_strbuf_append_helper(rif_strbuf_t *sb_ptr, const char *str, size_t len);
+
+/**
+ * Append bytes to a string buffer.
+ *
+ * @param sb_ptr the string buffer
+ * @param str    the bytes to append
+ * @param len    the number of bytes to append
+ * @return       the status of the string buffer
+ */
+RIF_INLINE
+rif_status_t rif_strbuf_append(rif_strbuf_t *sb_ptr, const char *str, size_t len) {
+  if (sb_ptr->capacity - sb_ptr->size >= len && sb_ptr->status == RIF_OK) {
+    memcpy(sb_ptr->data + sb_ptr->size, str, len);
+    sb_ptr->size += len;
+    return RIF_OK;
+  }
+  return rif_strbuf_append_helper(sb_ptr, str, len);
+}
+
+/**
+ * Append a NUL-terminated string to a string buffer.
+ *
+ * @param sb_ptr the string buffer
+ * @param str    the string to append
+ * @return       the status of the string buffer
+ */
+RIF_INLINE
+rif_status_t rif_strbuf_append_str(rif_strbuf_t *sb_ptr, const char *str) {
+  return rif_strbuf_append(sb_ptr, str, strlen(str));
+}
+
+/**
+ * Append a single character to a string buffer.
+ *
+ * @param sb_ptr the string buffer
+ * @param c      the character to append
+ * @return       the status of the string buffer
+ */
+RIF_INLINE
+rif_status_t rif_strbuf_append_char(rif_strbuf_t *sb_ptr, char c) {
+  if (sb_ptr->size < sb_ptr->capacity && sb_ptr->status == RIF_OK) {
+    sb_ptr->data[sb_ptr->size++] = c;
+    return RIF_OK;
+  }
+  return rif_strbuf_append_helper(sb_ptr, &c, 1);
+}
+
+/**
+ * Append formatted text to a string buffer, as `printf` would output it.
+ *
+ * @param sb_ptr the string buffer
+ * @param format the `printf` format string
+ * @return       the status of the string buffer
+ */
+RIF_API
+rif_status_t rif_strbuf_appendf(rif_strbuf_t *sb_ptr, const char *format, ...);
+
+/******************************************************************************
+ * OUTPUT FUNCTIONS
+ */
+
+/**
+ * Write the buffered text to the file descriptor of a string buffer. Does nothing for in-memory buffers.
+ *
+ * @param sb_ptr the string buffer
+ * @return       the status of the string buffer
+ */
+RIF_API
+rif_status_t rif_strbuf_flush(rif_strbuf_t *sb_ptr);
+
+/**
+ * Take over the text of an in-memory string buffer, as a NUL-terminated string. The buffer is left empty, and can be
+ * reused or destroyed.
+ *
+ * @param sb_ptr the string buffer
+ * @return       the text, to be freed by the caller, or `NULL` if the buffer status is not `RIF_OK` or in case of
+ *               allocation failure
+ */
+RIF_API
+char * rif_strbuf_detach(rif_strbuf_t *sb_ptr);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -29,7 +29,7 @@ static const rif_bool_t _rif_false = {
     ._ = {
         .reference_count = ATOMIC_VAR_INIT(0),
         .type = RIF_BOOL,
-        .free = false
+        .flags = RIF_VAL_FLAG_IMMORTAL
     },
     .value = false,
     .string = "FALSE",
@@ -42,7 +42,7 @@ static const rif_bool_t _rif_true = {
     ._ = {
         .reference_count = ATOMIC_VAR_INIT(0),
         .type = RIF_BOOL,
-        .free = false
+        .flags = RIF_VAL_FLAG_IMMORTAL
     },
     .value = true,
     .string = "TRUE",
@@ -59,6 +59,6 @@ uint32_t rif_bool_hashcode_callback(const rif_val_t *val_ptr) {
   return rif_bool_fromval(val_ptr)->hashcode;
 }
 
-char * rif_bool_tostring_callback(const rif_val_t *val_ptr) {
-  return strdup(rif_bool_fromval(val_ptr)->string);
+rif_status_t rif_bool_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
+  return rif_strbuf_append_str(sb_ptr, rif_bool_fromval(val_ptr)->string);
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "rif/rif_internal.h"
+
+#include "rif/base/rif_buffer.h"
+#include "rif/util/rif_hash.h"
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+static
+rif_buffer_t * _rif_buffer_build(
+    rif_buffer_t *buf_ptr, bool free, void *data, size_t len, rif_buffer_storage_t storage) {
+  if (!buf_ptr) {
+    return NULL;
+  }
+  rif_val_init(rif_val(buf_ptr), RIF_BUFFER, free);
+  buf_ptr->data = (uint8_t *) data;
+  buf_ptr->len = len;
+  atomic_init(&buf_ptr->hash, 0);
+  buf_ptr->storage = (uint8_t) storage;
+  return buf_ptr;
+}
+
+static
+rif_buffer_t * _rif_buffer_new(void *data, size_t len, rif_buffer_storage_t storage) {
+  uint8_t size_class;
+  rif_buffer_t *buf_ptr = rif_slab_alloc(sizeof(rif_buffer_t), &size_class, "RIF_BUFFER_NEW");
+  buf_ptr = _rif_buffer_build(buf_ptr, true, data, len, storage);
+  rif_val_set_size_class(buf_ptr, size_class);
+  return buf_ptr;
+}
+
+rif_buffer_t * rif_buffer_init(rif_buffer_t *buf_ptr, void *data, size_t len, bool free) {
+  return _rif_buffer_build(buf_ptr, false, data, len, free ? RIF_BUFFER_STORAGE_OWNED : RIF_BUFFER_STORAGE_BORROWED);
+}
+
+rif_buffer_t * rif_buffer_new(void *data, size_t len, bool free) {
+  return _rif_buffer_new(data, len, free ? RIF_BUFFER_STORAGE_OWNED : RIF_BUFFER_STORAGE_BORROWED);
+}
+
+rif_buffer_t * rif_buffer_new_copy(const void *data, size_t len) {
+  if (!len) {
+    return _rif_buffer_new(NULL, 0, RIF_BUFFER_STORAGE_BORROWED);
+  }
+  void *copy = rif_malloc(len, "RIF_BUFFER_NEW_COPY");
+  if (!copy) {
+    return NULL;
+  }
+  memcpy(copy, data, len);
+  rif_buffer_t *buf_ptr = _rif_buffer_new(copy, len, RIF_BUFFER_STORAGE_OWNED);
+  if (!buf_ptr) {
+    rif_free(copy);
+  }
+  return buf_ptr;
+}
+
+rif_buffer_t * rif_buffer_new_external(void *data, size_t len, rif_buffer_release_t release, void *ctx) {
+  rif_buffer_t *buf_ptr = _rif_buffer_new(data, len, RIF_BUFFER_STORAGE_EXTERNAL);
+  if (buf_ptr) {
+    buf_ptr->u.external.release = release;
+    buf_ptr->u.external.ctx = ctx;
+  }
+  return buf_ptr;
+}
+
+rif_buffer_t * rif_buffer_new_mmap(int fd, off_t offset, size_t len) {
+  if (!len) {
+    return _rif_buffer_new(NULL, 0, RIF_BUFFER_STORAGE_BORROWED);
+  }
+
+  // Mappings must start on a page boundary
+  off_t page_size = (off_t) sysconf(_SC_PAGESIZE);
+  size_t delta = (size_t) (offset % page_size);
+  void *addr = mmap(NULL, len + delta, PROT_READ, MAP_PRIVATE, fd, offset - (off_t) delta);
+  if (addr == MAP_FAILED) {
+    return NULL;
+  }
+
+  rif_buffer_t *buf_ptr = _rif_buffer_new((uint8_t *) addr + delta, len, RIF_BUFFER_STORAGE_MAPPED);
+  if (!buf_ptr) {
+    munmap(addr, len + delta);
+    return NULL;
+  }
+  buf_ptr->u.mapping.addr = addr;
+  buf_ptr->u.mapping.len = len + delta;
+  return buf_ptr;
+}
+
+/******************************************************************************
+ * SLICING FUNCTIONS
+ */
+
+rif_buffer_t * rif_buffer_slice(rif_buffer_t *buf_ptr, size_t offset, size_t len) {
+  if (offset > buf_ptr->len || len > buf_ptr->len - offset) {
+    return NULL;
+  }
+  rif_buffer_t *parent_ptr = buf_ptr->storage == RIF_BUFFER_STORAGE_SLICE ? buf_ptr->u.parent : buf_ptr;
+  rif_buffer_t *slice_ptr = _rif_buffer_new(
+      buf_ptr->data ? buf_ptr->data + offset : NULL, len, RIF_BUFFER_STORAGE_SLICE);
+  if (slice_ptr) {
+    rif_val_retain(parent_ptr);
+    slice_ptr->u.parent = parent_ptr;
+  }
+  return slice_ptr;
+}
+
+/******************************************************************************
+ * CALLBACK FUNCTIONS
+ */
+
+void rif_buffer_destroy_callback(rif_val_t *val_ptr) {
+  rif_buffer_t *buf_ptr = rif_buffer_fromval(val_ptr);
+  switch (buf_ptr->storage) {
+    case RIF_BUFFER_STORAGE_OWNED:
+      rif_free(buf_ptr->data);
+      break;
+    case RIF_BUFFER_STORAGE_EXTERNAL:
+      if (buf_ptr->u.external.release) {
+        buf_ptr->u.external.release(buf_ptr->data, buf_ptr->len, buf_ptr->u.external.ctx);
+      }
+      break;
+    case RIF_BUFFER_STORAGE_MAPPED:
+      munmap(buf_ptr->u.mapping.addr, buf_ptr->u.mapping.len);
+      break;
+    case RIF_BUFFER_STORAGE_SLICE:
+      rif_val_release(buf_ptr->u.parent);
+      break;
+    default:
+      break;
+  }
+  buf_ptr->data = NULL;
+}
+
+uint32_t rif_buffer_hashcode_callback(const rif_val_t *val_ptr) {
+  rif_buffer_t *buf_ptr = rif_buffer_fromval(val_ptr);
+  uint32_t hash = atomic_load_explicit(&buf_ptr->hash, memory_order_relaxed);
+  if (!hash) {
+    hash = rif_hash_bytes(buf_ptr->data, buf_ptr->len);
+    // Ensure we are not storing 0 (used to mark the hash as not computed)
+    hash |= (hash == 0);
+    atomic_store_explicit(&buf_ptr->hash, hash, memory_order_relaxed);
+  }
+  return hash;
+}
+
+bool rif_buffer_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_ptr) {
+  rif_buffer_t *first_ptr = rif_buffer_fromval(val_ptr);
+  rif_buffer_t *second_ptr = rif_buffer_fromval(other_ptr);
+  if (first_ptr->len != second_ptr->len) {
+    return false;
+  }
+  // Views of the same bytes, such as identical slices, are equal without comparing them
+  if (first_ptr->data == second_ptr->data || !first_ptr->len) {
+    return true;
+  }
+  // Buffers with different memoized hashes cannot be equal
+  uint32_t first_hash = atomic_load_explicit(&first_ptr->hash, memory_order_relaxed);
+  uint32_t second_hash = atomic_load_explicit(&second_ptr->hash, memory_order_relaxed);
+  if (first_hash && second_hash && first_hash != second_hash) {
+    return false;
+  }
+  return !memcmp(first_ptr->data, second_ptr->data, first_ptr->len);
+}
+
+rif_status_t rif_buffer_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
+  rif_buffer_t *buf_ptr = rif_buffer_fromval(val_ptr);
+  return rif_strbuf_appendf(sb_ptr, "<Buffer [bytes: %" PRIu64 "]>", (uint64_t) rif_buffer_len(buf_ptr));
+}
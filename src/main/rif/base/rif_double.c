@@ -22,6 +22,25 @@
 #include "rif/base/rif_double.h"
 #include "rif/util/rif_hash.h"
 
+/******************************************************************************
+ * STATIC VARIABLES
+ */
+
+static bool _rif_double_cache_enabled = false;
+
+#define RIF_DOUBLE_CACHED(__value) { \
+    ._ = { \
+        .reference_count = ATOMIC_VAR_INIT(0), \
+        .type = RIF_DOUBLE, \
+        .flags = RIF_VAL_FLAG_IMMORTAL \
+    }, \
+    .value = (__value) \
+}
+
+static rif_double_t _rif_double_zero = RIF_DOUBLE_CACHED(0.0);
+static rif_double_t _rif_double_one = RIF_DOUBLE_CACHED(1.0);
+static rif_double_t _rif_double_nan = RIF_DOUBLE_CACHED(NAN);
+
 /******************************************************************************
  * LIFECYCLE FUNCTIONS
  */
@@ -40,9 +59,45 @@ rif_double_t * rif_double_init(rif_double_t *double_ptr, double value) {
   return rif_double_build(double_ptr, false, value);
 }
 
+static
+rif_double_t * _rif_double_alloc(double value) {
+  uint8_t size_class;
+  rif_double_t *double_ptr = rif_slab_alloc(sizeof(rif_double_t), &size_class, "RIF_DOUBLE_NEW");
+  double_ptr = rif_double_build(double_ptr, true, value);
+  rif_val_set_size_class(double_ptr, size_class);
+  return double_ptr;
+}
+
 rif_double_t * rif_double_new(double value) {
-  rif_double_t *double_ptr = rif_malloc(sizeof(rif_double_t));
-  return rif_double_build(double_ptr, true, value);
+  if (_rif_double_cache_enabled) {
+    return rif_double_get_cached(value);
+  }
+  return _rif_double_alloc(value);
+}
+
+rif_double_t * rif_double_get_cached(double value) {
+  if (isnan(value)) {
+    return &_rif_double_nan;
+  }
+  if (value == 0.0 && !signbit(value)) {
+    return &_rif_double_zero;
+  }
+  if (value == 1.0) {
+    return &_rif_double_one;
+  }
+  return _rif_double_alloc(value);
+}
+
+/******************************************************************************
+ * CACHE SETTINGS FUNCTIONS
+ */
+
+void rif_double_set_cache_enabled(bool enabled) {
+  _rif_double_cache_enabled = enabled;
+}
+
+bool rif_double_cache_enabled(void) {
+  return _rif_double_cache_enabled;
 }
 
 /******************************************************************************
@@ -65,17 +120,13 @@ bool rif_double_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other
   return rif_double_get(double_ptr) == rif_double_get(other_double_ptr);
 }
 
-char * rif_double_tostring_callback(const rif_val_t *val_ptr) {
+rif_status_t rif_double_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
   rif_double_t *double_ptr = rif_double_fromval(val_ptr);
-  char *tostring_str = rif_malloc(sizeof(char) * 64);
-  if (!tostring_str) {
-    return tostring_str;
-  }
-  memset(tostring_str, 0, 64);
-  snprintf(tostring_str, sizeof(char) * 64, "%.16g", rif_double_get(double_ptr));
-  if (!strchr(tostring_str, '.')) {
-    size_t tostring_str_len = strlen(tostring_str);
-    strcpy(tostring_str + tostring_str_len, ".0\0");
+  char buf[64];
+  int len = snprintf(buf, sizeof(buf), "%.16g", rif_double_get(double_ptr));
+  rif_strbuf_append(sb_ptr, buf, (size_t) len);
+  if (!memchr(buf, '.', (size_t) len)) {
+    rif_strbuf_append(sb_ptr, ".0", 2);
   }
-  return tostring_str;
+  return rif_strbuf_status(sb_ptr);
 }
\ No newline at end of file
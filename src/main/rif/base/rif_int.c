@@ -20,8 +20,34 @@
 #include "rif/rif_internal.h"
 
 #include "rif/base/rif_int.h"
+#include "rif/concurrent/rif_threads.h"
 #include "rif/util/rif_hash.h"
 
+/******************************************************************************
+ * STATIC VARIABLES
+ */
+
+#define RIF_INT_CACHE_SIZE (RIF_INT_CACHE_MAX - RIF_INT_CACHE_MIN + 1)
+
+static bool _rif_int_cache_enabled = false;
+
+/* Shared immortal instances, filled once on first use. */
+static rif_int_t _rif_int_cache[RIF_INT_CACHE_SIZE];
+static once_flag _rif_int_cache_once = ONCE_FLAG_INIT;
+
+static
+void _rif_int_cache_fill(void) {
+  int64_t i = 0;
+  for (; i < RIF_INT_CACHE_SIZE; ++i) {
+    rif_val_init(rif_val(&_rif_int_cache[i]), RIF_INT, false);
+    atomic_init(&rif_val(&_rif_int_cache[i])->reference_count, 0);
+    // Every thread shares the cache, whichever thread happens to fill it: entries must never be thread-local
+    rif_val(&_rif_int_cache[i])->flags = (rif_val(&_rif_int_cache[i])->flags | RIF_VAL_FLAG_IMMORTAL) &
+        (uint8_t) ~RIF_VAL_FLAG_LOCAL;
+    _rif_int_cache[i].value = RIF_INT_CACHE_MIN + i;
+  }
+}
+
 /******************************************************************************
  * LIFECYCLE FUNCTIONS
  */
@@ -40,9 +66,40 @@ rif_int_t * rif_int_init(rif_int_t *int_ptr, int64_t value) {
   return rif_int_build(int_ptr, false, value);
 }
 
+static
+rif_int_t * _rif_int_alloc(int64_t value) {
+  uint8_t size_class;
+  rif_int_t *int_ptr = rif_slab_alloc(sizeof(rif_int_t), &size_class, "RIF_INT_NEW");
+  int_ptr = rif_int_build(int_ptr, true, value);
+  rif_val_set_size_class(int_ptr, size_class);
+  return int_ptr;
+}
+
 rif_int_t * rif_int_new(int64_t value) {
-  rif_int_t *int_ptr = rif_malloc(sizeof(rif_int_t), "RIF_INT_NEW");
-  return rif_int_build(int_ptr, true, value);
+  if (_rif_int_cache_enabled) {
+    return rif_int_get_cached(value);
+  }
+  return _rif_int_alloc(value);
+}
+
+rif_int_t * rif_int_get_cached(int64_t value) {
+  if (value < RIF_INT_CACHE_MIN || value > RIF_INT_CACHE_MAX) {
+    return _rif_int_alloc(value);
+  }
+  call_once(&_rif_int_cache_once, _rif_int_cache_fill);
+  return &_rif_int_cache[value - RIF_INT_CACHE_MIN];
+}
+
+/******************************************************************************
+ * CACHE SETTINGS FUNCTIONS
+ */
+
+void rif_int_set_cache_enabled(bool enabled) {
+  _rif_int_cache_enabled = enabled;
+}
+
+bool rif_int_cache_enabled(void) {
+  return _rif_int_cache_enabled;
 }
 
 /******************************************************************************
@@ -65,13 +122,20 @@ bool rif_int_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_pt
   return rif_int_get(int_ptr) == rif_int_get(other_int_ptr);
 }
 
-char * rif_int_tostring_callback(const rif_val_t *val_ptr) {
-  rif_int_t *int_ptr = rif_int_fromval(val_ptr);
-  char *tostring_str = rif_malloc(sizeof(char) * 32, "RIF_INT_TOSTRING");
-  if (!tostring_str) {
-    return tostring_str;
+rif_status_t rif_int_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
+  int64_t value = rif_int_get(rif_int_fromval(val_ptr));
+  uint64_t magnitude = value < 0 ? -(uint64_t) value : (uint64_t) value;
+
+  // Format digits backwards, which is much cheaper than going through `snprintf`
+  char buf[20];
+  char *end = buf + sizeof(buf);
+  char *pos = end;
+  do {
+    *--pos = (char) ('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+  if (value < 0) {
+    *--pos = '-';
   }
-  memset(tostring_str, 0, 32);
-  snprintf(tostring_str, sizeof(char) * 32, "%" PRId64, rif_int_get(int_ptr));
-  return tostring_str;
+  return rif_strbuf_append(sb_ptr, pos, (size_t) (end - pos));
 }
\ No newline at end of file
@@ -29,7 +29,7 @@ static const rif_null_t _rif_null = {
     ._ = {
         .reference_count = ATOMIC_VAR_INIT(0),
         .type = RIF_NULL,
-        .free = false
+        .flags = RIF_VAL_FLAG_IMMORTAL
     }
 };
 
@@ -39,6 +39,6 @@ const rif_null_t *rif_null = &_rif_null;
  * CALLBACK FUNCTIONS
  */
 
-char * rif_null_tostring_callback(const rif_val_t *val_ptr) {
-  return rif_strdup("NULL");
+rif_status_t rif_null_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
+  return rif_strbuf_append(sb_ptr, "NULL", 4);
 }
@@ -26,39 +26,100 @@
  * STATIC FUNCTIONS
  */
 
+static inline
+rif_paged_pool_block_t * _rif_paged_pool_block_of(const rif_paged_pool_t *pool_ptr, void *ptr) {
+  return (rif_paged_pool_block_t *) ((uintptr_t) ptr & ~((uintptr_t) pool_ptr->block_bytes - 1));
+}
+
+static inline
+void _rif_paged_pool_unlink_available(rif_paged_pool_t *pool_ptr, rif_paged_pool_block_t *block_ptr) {
+  if (block_ptr->prev_available) {
+    block_ptr->prev_available->next_available = block_ptr->next_available;
+  } else {
+    pool_ptr->first_available = block_ptr->next_available;
+  }
+  if (block_ptr->next_available) {
+    block_ptr->next_available->prev_available = block_ptr->prev_available;
+  } else {
+    pool_ptr->last_available = block_ptr->prev_available;
+  }
+}
+
+static inline
+void _rif_paged_pool_push_available(rif_paged_pool_t *pool_ptr, rif_paged_pool_block_t *block_ptr) {
+  block_ptr->prev_available = NULL;
+  block_ptr->next_available = pool_ptr->first_available;
+  if (pool_ptr->first_available) {
+    pool_ptr->first_available->prev_available = block_ptr;
+  } else {
+    pool_ptr->last_available = block_ptr;
+  }
+  pool_ptr->first_available = block_ptr;
+}
+
+static inline
+void _rif_paged_pool_append_available(rif_paged_pool_t *pool_ptr, rif_paged_pool_block_t *block_ptr) {
+  block_ptr->next_available = NULL;
+  block_ptr->prev_available = pool_ptr->last_available;
+  if (pool_ptr->last_available) {
+    pool_ptr->last_available->next_available = block_ptr;
+  } else {
+    pool_ptr->first_available = block_ptr;
+  }
+  pool_ptr->last_available = block_ptr;
+}
+
 static
 rif_paged_pool_block_t * _rif_paged_pool_block_alloc(rif_paged_pool_t *pool_ptr) {
-  rif_paged_pool_block_t *block_ptr = rif_malloc(
-      sizeof(rif_paged_pool_block_t) + pool_ptr->element_size * pool_ptr->block_size, "RIF_POOL_ALLOC");
+  rif_paged_pool_block_t *block_ptr = rif_aligned_alloc(pool_ptr->block_bytes, pool_ptr->block_bytes, "RIF_POOL_ALLOC");
   if (!block_ptr) {
     return block_ptr;
   }
 
   // Register block
+  block_ptr->prev = NULL;
   block_ptr->next = pool_ptr->first_block;
+  if (pool_ptr->first_block) {
+    pool_ptr->first_block->prev = block_ptr;
+  }
   pool_ptr->first_block = block_ptr;
+  ++pool_ptr->block_count;
+  ++pool_ptr->free_block_count;
 
   // Initialize block
   uint8_t *cur = (uint8_t *) &block_ptr->elements;
   uint8_t *last = cur + (pool_ptr->element_size * (pool_ptr->block_size - 1));
-  for (; cur <= last - pool_ptr->element_size; cur += pool_ptr->element_size) {
+  for (; cur < last; cur += pool_ptr->element_size) {
     void **cur_ptr = (void **) cur;
     *cur_ptr = cur + pool_ptr->element_size;
   }
-
-  // Set first available
   void **last_ptr = (void **) last;
-  *last_ptr = pool_ptr->first_available;
-  pool_ptr->first_available = &block_ptr->elements;
+  *last_ptr = NULL;
+  block_ptr->first_available = &block_ptr->elements;
+  block_ptr->live_count = 0;
 
-  // Set last available, if necessary
-  if (!pool_ptr->last_available) {
-    pool_ptr->last_available = last;
-  }
+  // Empty blocks go last, after partially used ones
+  _rif_paged_pool_append_available(pool_ptr, block_ptr);
 
   return block_ptr;
 }
 
+static
+void _rif_paged_pool_block_free(rif_paged_pool_t *pool_ptr, rif_paged_pool_block_t *block_ptr) {
+  _rif_paged_pool_unlink_available(pool_ptr, block_ptr);
+  if (block_ptr->prev) {
+    block_ptr->prev->next = block_ptr->next;
+  } else {
+    pool_ptr->first_block = block_ptr->next;
+  }
+  if (block_ptr->next) {
+    block_ptr->next->prev = block_ptr->prev;
+  }
+  --pool_ptr->block_count;
+  --pool_ptr->free_block_count;
+  rif_aligned_free(block_ptr);
+}
+
 /******************************************************************************
  * LIFECYCLE FUNCTIONS
  */
@@ -71,8 +132,17 @@ rif_paged_pool_t * rif_paged_pool_init(rif_paged_pool_t *pool_ptr, uint32_t elem
   if (__unlikely(!rif_pool_init((rif_pool_t *) pool_ptr, &rif_paged_pool_hooks))) {
     return NULL;
   }
-  pool_ptr->block_size = block_size;
-  pool_ptr->element_size = rif_max(element_size, sizeof(size_t));
+
+  // Round elements up to keep them aligned, and blocks up to a power of two filled with as many elements as fit
+  uint32_t header_size = offsetof(rif_paged_pool_block_t, elements);
+  pool_ptr->element_size = (rif_max(element_size, sizeof(void *)) + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+  pool_ptr->block_bytes = rif_next_pow2(header_size + pool_ptr->element_size * rif_max(block_size, 1));
+  pool_ptr->block_size = (pool_ptr->block_bytes - header_size) / pool_ptr->element_size;
+
+  pool_ptr->block_count = 0;
+  pool_ptr->free_block_count = 0;
+  pool_ptr->max_free_blocks = UINT32_MAX;
+  pool_ptr->live_count = 0;
   pool_ptr->first_available = NULL;
   pool_ptr->last_available = NULL;
   pool_ptr->first_block = NULL;
@@ -86,40 +156,73 @@ void rif_paged_pool_destroy(rif_paged_pool_t *pool_ptr) {
   rif_paged_pool_block_t *cur = pool_ptr->first_block;
   while (cur) {
     rif_paged_pool_block_t *next = cur->next;
-    rif_free(cur);
+    rif_aligned_free(cur);
     cur = next;
   }
 }
 
+/******************************************************************************
+ * SIZING FUNCTIONS
+ */
+
+uint32_t rif_paged_pool_trim(rif_paged_pool_t *pool_ptr, uint32_t keep) {
+  uint32_t released = 0;
+  while (pool_ptr->free_block_count > keep) {
+    _rif_paged_pool_block_free(pool_ptr, pool_ptr->last_available);
+    ++released;
+  }
+  return released;
+}
+
+void rif_paged_pool_set_max_free_blocks(rif_paged_pool_t *pool_ptr, uint32_t max_free_blocks) {
+  pool_ptr->max_free_blocks = max_free_blocks;
+  rif_paged_pool_trim(pool_ptr, max_free_blocks);
+}
+
 /******************************************************************************
  * ACCESSOR FUNCTIONS
  */
 
 void * rif_paged_pool_borrow(rif_paged_pool_t *pool_ptr) {
-  if (!pool_ptr->first_available && !_rif_paged_pool_block_alloc(pool_ptr)) {
+  rif_paged_pool_block_t *block_ptr = pool_ptr->first_available;
+  if (!block_ptr && !(block_ptr = _rif_paged_pool_block_alloc(pool_ptr))) {
     return NULL;
   }
-  void *element = pool_ptr->first_available;
-  void **element_ptr = (void **) element;
-  pool_ptr->first_available = *element_ptr;
-  if (element == pool_ptr->last_available) {
-    pool_ptr->last_available = NULL;
+  void **element_ptr = (void **) block_ptr->first_available;
+  block_ptr->first_available = *element_ptr;
+  if (0 == block_ptr->live_count++) {
+    --pool_ptr->free_block_count;
+  }
+  if (!block_ptr->first_available) {
+    _rif_paged_pool_unlink_available(pool_ptr, block_ptr);
   }
-  return element;
+  ++pool_ptr->live_count;
+  return element_ptr;
 }
 
 void rif_paged_pool_return(rif_paged_pool_t *pool_ptr, void *ptr) {
   if (!ptr) {
     return;
   }
+  rif_paged_pool_block_t *block_ptr = _rif_paged_pool_block_of(pool_ptr, ptr);
   void **element_ptr = (void **) ptr;
-  *element_ptr = NULL;
-  if (pool_ptr->last_available) {
-    void **last_element_ptr = (void **) pool_ptr->last_available;
-    *last_element_ptr = ptr;
+  bool was_full = NULL == block_ptr->first_available;
+  *element_ptr = block_ptr->first_available;
+  block_ptr->first_available = ptr;
+  --pool_ptr->live_count;
+
+  // A block which was full goes first, so that it is filled again before emptier ones
+  if (was_full) {
+    _rif_paged_pool_push_available(pool_ptr, block_ptr);
   }
-  pool_ptr->last_available = ptr;
-  if (!pool_ptr->first_available) {
-    pool_ptr->first_available = ptr;
+
+  // A block which became free goes last, or is released beyond the free block limit
+  if (0 == --block_ptr->live_count) {
+    ++pool_ptr->free_block_count;
+    _rif_paged_pool_unlink_available(pool_ptr, block_ptr);
+    _rif_paged_pool_append_available(pool_ptr, block_ptr);
+    if (pool_ptr->free_block_count > pool_ptr->max_free_blocks) {
+      _rif_paged_pool_block_free(pool_ptr, block_ptr);
+    }
   }
-}
\ No newline at end of file
+}
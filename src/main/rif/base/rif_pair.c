@@ -27,25 +27,43 @@
  */
 
 static
-rif_pair_t *rif_pair_build(rif_pair_t *pair_ptr, bool free, rif_val_t *val_ptr_1, rif_val_t *val_ptr_2) {
+rif_pair_t *rif_pair_build(rif_pair_t *pair_ptr, bool free, bool steal, rif_val_t *val_ptr_1, rif_val_t *val_ptr_2) {
   if (!pair_ptr) {
+    if (steal) {
+      rif_val_release(val_ptr_1);
+      rif_val_release(val_ptr_2);
+    }
     return pair_ptr;
   }
   rif_val_init(rif_val(pair_ptr), RIF_PAIR, free);
-  rif_val_retain(val_ptr_1);
-  rif_val_retain(val_ptr_2);
+  if (!steal) {
+    rif_val_retain(val_ptr_1);
+    rif_val_retain(val_ptr_2);
+  }
   pair_ptr->val_ptr_1 = val_ptr_1;
   pair_ptr->val_ptr_2 = val_ptr_2;
   return pair_ptr;
 }
 
 rif_pair_t *rif_pair_init(rif_pair_t *pair_ptr, rif_val_t *val_ptr_1, rif_val_t *val_ptr_2) {
-  return rif_pair_build(pair_ptr, false, val_ptr_1, val_ptr_2);
+  return rif_pair_build(pair_ptr, false, false, val_ptr_1, val_ptr_2);
+}
+
+static
+rif_pair_t *_rif_pair_new(bool steal, rif_val_t *val_ptr_1, rif_val_t *val_ptr_2) {
+  uint8_t size_class;
+  rif_pair_t *pair_ptr = rif_slab_alloc(sizeof(rif_pair_t), &size_class, "RIF_PAIR_NEW");
+  pair_ptr = rif_pair_build(pair_ptr, true, steal, val_ptr_1, val_ptr_2);
+  rif_val_set_size_class(pair_ptr, size_class);
+  return pair_ptr;
 }
 
 rif_pair_t *rif_pair_new(rif_val_t *val_ptr_1, rif_val_t *val_ptr_2) {
-  rif_pair_t *pair_ptr = rif_malloc(sizeof(rif_pair_t), "RIF_PAIR_NEW");
-  return rif_pair_build(pair_ptr, true, val_ptr_1, val_ptr_2);
+  return _rif_pair_new(false, val_ptr_1, val_ptr_2);
+}
+
+rif_pair_t *rif_pair_new_steal(rif_val_t *val_ptr_1, rif_val_t *val_ptr_2) {
+  return _rif_pair_new(true, val_ptr_1, val_ptr_2);
 }
 
 /******************************************************************************
@@ -72,46 +90,11 @@ bool rif_pair_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_p
          rif_val_equals(rif_pair_2(pair_ptr), rif_pair_2(other_pair_ptr));
 }
 
-char *rif_pair_tostring_callback(const rif_val_t *val_ptr) {
-
-  char *tostring_str = NULL;
-
-  /* Get string representation of both members. */
+rif_status_t rif_pair_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
   const rif_pair_t *pair_ptr = rif_pair_fromval(val_ptr);
-  const rif_val_t *val_ptr_1 = rif_pair_1(pair_ptr);
-  const rif_val_t *val_ptr_2 = rif_pair_2(pair_ptr);
-  const char *tostring_1 = val_ptr_1 ? rif_val_tostring(rif_pair_1(pair_ptr)) : rif_undef_str;
-  const char *tostring_2 = val_ptr_2 ? rif_val_tostring(rif_pair_2(pair_ptr)) : rif_undef_str;
-  if (!tostring_1 || !tostring_2) {
-    goto CLEANUP_EXIT;
-  }
-
-  /* Get each length and allocate memory. */
-  size_t tostring_1_len = strlen(tostring_1);
-  size_t tostring_2_len = strlen(tostring_2);
-  size_t tostring_str_len = tostring_1_len + tostring_2_len + 5;
-  tostring_str = rif_malloc(tostring_str_len * sizeof(char), "RIF_PAIR_TOSTRING");
-  if (!tostring_str) {
-    goto CLEANUP_EXIT;
-  }
-
-  /* Copy memory. */
-  strcpy(tostring_str, "(");
-  strcpy(tostring_str + 1, tostring_1);
-  strcpy(tostring_str + 1 + tostring_1_len, ", ");
-  strcpy(tostring_str + 1 + tostring_1_len + 2, tostring_2);
-  strcpy(tostring_str + 1 + tostring_1_len + 2 + tostring_2_len, ")");
-  *(tostring_str + 1 + tostring_1_len + 2 + tostring_2_len + 1) = '\0';
-
-  CLEANUP_EXIT:
-
-  /* Free underlying string representations. */
-  if (rif_undef_str != tostring_1) {
-    rif_free((void *) tostring_1);
-  }
-  if (rif_undef_str != tostring_2) {
-    rif_free((void *) tostring_2);
-  }
-
-  return tostring_str;
+  rif_strbuf_append_char(sb_ptr, '(');
+  rif_val_write(rif_pair_1(pair_ptr), sb_ptr);
+  rif_strbuf_append(sb_ptr, ", ", 2);
+  rif_val_write(rif_pair_2(pair_ptr), sb_ptr);
+  return rif_strbuf_append_char(sb_ptr, ')');
 }
\ No newline at end of file
@@ -0,0 +1,229 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "rif/rif_internal.h"
+
+#include "rif/concurrent/rif_threads.h"
+#include "rif/util/rif_arena.h"
+#include "rif_reclaim_internal.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ */
+
+RIF_THREAD_LOCAL bool _rif_reclaim_deferred = false;
+
+/*
+ * Dead values waiting for destruction. The most recently queued values are destroyed first, so that a nested value is
+ * torn down depth-first, as the recursive destruction would.
+ */
+static rif_val_t **_rif_reclaim_queue = NULL;
+static uint32_t _rif_reclaim_size = 0;
+static uint32_t _rif_reclaim_capacity = 0;
+
+static once_flag _rif_reclaim_once = ONCE_FLAG_INIT;
+static bool _rif_reclaim_valid = false;
+static mtx_t _rif_reclaim_lock;
+static cnd_t _rif_reclaim_cond;
+
+static thrd_t _rif_reclaim_thread;
+static bool _rif_reclaim_running = false;
+static bool _rif_reclaim_stopping = false;
+
+/******************************************************************************
+ * HELPERS
+ */
+
+static
+void _rif_reclaim_init(void) {
+  if (thrd_success != mtx_init(&_rif_reclaim_lock, mtx_plain)) {
+    return;
+  }
+  if (thrd_success != cnd_init(&_rif_reclaim_cond)) {
+    mtx_destroy(&_rif_reclaim_lock);
+    return;
+  }
+  _rif_reclaim_valid = true;
+}
+
+static inline
+bool _rif_reclaim_deferrable(const rif_val_t *val_ptr) {
+  // Thread-local values may hold thread-confined values, which must not be released from another thread
+  if (val_ptr->flags & RIF_VAL_FLAG_LOCAL) {
+    return false;
+  }
+  switch (rif_val_type(val_ptr)) {
+    case RIF_LIST:
+    case RIF_MAP:
+    case RIF_QUEUE:
+    case RIF_PAIR:
+      return (val_ptr->flags & RIF_VAL_FLAG_FREE) && !_rif_arena_current;
+    default:
+      return false;
+  }
+}
+
+/*
+ * Pop the most recently queued value, or `NULL` if the queue is empty. Must be called with the lock held.
+ */
+static inline
+rif_val_t * _rif_reclaim_pop(void) {
+  return _rif_reclaim_size ? _rif_reclaim_queue[--_rif_reclaim_size] : NULL;
+}
+
+/******************************************************************************
+ * SETTINGS FUNCTIONS
+ */
+
+bool rif_reclaim_set_deferred(bool deferred) {
+  bool previous = _rif_reclaim_deferred;
+  _rif_reclaim_deferred = deferred;
+  return previous;
+}
+
+bool rif_reclaim_deferred(void) {
+  return _rif_reclaim_deferred;
+}
+
+/******************************************************************************
+ * RECLAIM FUNCTIONS
+ */
+
+bool _rif_reclaim_push(rif_val_t *val_ptr) {
+  if (!_rif_reclaim_deferrable(val_ptr)) {
+    return false;
+  }
+  call_once(&_rif_reclaim_once, _rif_reclaim_init);
+  if (!_rif_reclaim_valid) {
+    return false;
+  }
+  mtx_lock(&_rif_reclaim_lock);
+  if (_rif_reclaim_size == _rif_reclaim_capacity) {
+    uint32_t capacity = _rif_reclaim_capacity ? _rif_reclaim_capacity * 2 : 64;
+    rif_val_t **queue = rif_realloc(_rif_reclaim_queue, capacity * sizeof(rif_val_t *), "RIF_RECLAIM_QUEUE_REALLOC");
+    if (!queue) {
+      mtx_unlock(&_rif_reclaim_lock);
+      return false;
+    }
+    _rif_reclaim_queue = queue;
+    _rif_reclaim_capacity = capacity;
+  }
+  _rif_reclaim_queue[_rif_reclaim_size++] = val_ptr;
+  if (_rif_reclaim_running) {
+    cnd_signal(&_rif_reclaim_cond);
+  }
+  mtx_unlock(&_rif_reclaim_lock);
+  return true;
+}
+
+uint32_t rif_reclaim_step(uint32_t budget) {
+  call_once(&_rif_reclaim_once, _rif_reclaim_init);
+  if (!_rif_reclaim_valid) {
+    return 0;
+  }
+
+  // Values dying while queued values are destroyed are queued in turn, and never go to an arena
+  rif_arena_t *arena_ptr = rif_arena_set_current(NULL);
+  bool deferred = rif_reclaim_set_deferred(true);
+
+  uint32_t count = 0;
+  while (count < budget) {
+    mtx_lock(&_rif_reclaim_lock);
+    rif_val_t *val_ptr = _rif_reclaim_pop();
+    mtx_unlock(&_rif_reclaim_lock);
+    if (!val_ptr) {
+      break;
+    }
+    _rif_val_destroy(val_ptr);
+    ++count;
+  }
+
+  rif_reclaim_set_deferred(deferred);
+  rif_arena_set_current(arena_ptr);
+  return count;
+}
+
+uint32_t rif_reclaim_pending(void) {
+  call_once(&_rif_reclaim_once, _rif_reclaim_init);
+  if (!_rif_reclaim_valid) {
+    return 0;
+  }
+  mtx_lock(&_rif_reclaim_lock);
+  uint32_t size = _rif_reclaim_size;
+  mtx_unlock(&_rif_reclaim_lock);
+  return size;
+}
+
+/******************************************************************************
+ * RECLAIM THREAD FUNCTIONS
+ */
+
+static
+int _rif_reclaim_thread_main(void *arg) {
+  mtx_lock(&_rif_reclaim_lock);
+  while (_rif_reclaim_size || !_rif_reclaim_stopping) {
+    if (!_rif_reclaim_size) {
+      cnd_wait(&_rif_reclaim_cond, &_rif_reclaim_lock);
+      continue;
+    }
+    mtx_unlock(&_rif_reclaim_lock);
+    rif_reclaim_step(RIF_RECLAIM_THREAD_BATCH);
+    mtx_lock(&_rif_reclaim_lock);
+  }
+  mtx_unlock(&_rif_reclaim_lock);
+  return 0;
+}
+
+rif_status_t rif_reclaim_start(void) {
+  call_once(&_rif_reclaim_once, _rif_reclaim_init);
+  if (!_rif_reclaim_valid) {
+    return RIF_ERR_MEMORY;
+  }
+  mtx_lock(&_rif_reclaim_lock);
+  rif_status_t status = RIF_OK;
+  if (!_rif_reclaim_running) {
+    _rif_reclaim_stopping = false;
+    _rif_reclaim_running = thrd_success == thrd_create(&_rif_reclaim_thread, _rif_reclaim_thread_main, NULL);
+    status = _rif_reclaim_running ? RIF_OK : RIF_ERR_MEMORY;
+  }
+  mtx_unlock(&_rif_reclaim_lock);
+  return status;
+}
+
+void rif_reclaim_stop(void) {
+  call_once(&_rif_reclaim_once, _rif_reclaim_init);
+  if (!_rif_reclaim_valid) {
+    return;
+  }
+  mtx_lock(&_rif_reclaim_lock);
+  if (!_rif_reclaim_running) {
+    mtx_unlock(&_rif_reclaim_lock);
+    return;
+  }
+  _rif_reclaim_stopping = true;
+  cnd_signal(&_rif_reclaim_cond);
+  mtx_unlock(&_rif_reclaim_lock);
+
+  thrd_join(_rif_reclaim_thread, NULL);
+
+  mtx_lock(&_rif_reclaim_lock);
+  _rif_reclaim_running = false;
+  _rif_reclaim_stopping = false;
+  mtx_unlock(&_rif_reclaim_lock);
+}
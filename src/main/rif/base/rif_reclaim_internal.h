@@ -0,0 +1,55 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#pragma once
+
+#include "rif/base/rif_reclaim.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ */
+
+extern RIF_THREAD_LOCAL bool _rif_reclaim_deferred;
+
+/******************************************************************************
+ * RECLAIM FUNCTIONS
+ */
+
+/*
+ * Queue a value whose reference count reached 0. Returns `false` if the value cannot be deferred, and must be destroyed
+ * right away.
+ */
+bool _rif_reclaim_push(rif_val_t *val_ptr);
+
+/*
+ * Destroy a value and free its memory, without deferral. Defined in `rif_val.c`.
+ */
+void _rif_val_destroy(rif_val_t *val_ptr);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
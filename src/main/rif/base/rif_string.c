@@ -22,6 +22,40 @@
 #include "rif/base/rif_string.h"
 #include "rif/util/rif_hash.h"
 
+/******************************************************************************
+ * IMMEDIATE HELPERS
+ */
+
+/*
+ * Immediate strings hold their length in bits 2 to 4, and their characters in the following bytes, from the least
+ * significant one.
+ */
+#define _rif_string_immediate_len(__str_ptr) ((size_t) (((uintptr_t) (__str_ptr) >> 2) & 7))
+
+static
+const char * _rif_string_immediate_get(const rif_string_t *str_ptr, char *buf) {
+  size_t len = _rif_string_immediate_len(str_ptr);
+  size_t i = 0;
+  for (; i < len; ++i) {
+    buf[i] = (char) ((uintptr_t) str_ptr >> (8 * (i + 1)));
+  }
+  buf[len] = '\0';
+  return buf;
+}
+
+/*
+ * Get the characters and length of any string, decoding immediate strings to `buf`.
+ */
+static
+const char * _rif_string_view(const rif_string_t *str_ptr, char *buf, size_t *len_ptr) {
+  if (rif_val_isimmediate(str_ptr)) {
+    *len_ptr = _rif_string_immediate_len(str_ptr);
+    return _rif_string_immediate_get(str_ptr, buf);
+  }
+  *len_ptr = rif_string_len((rif_string_t *) str_ptr);
+  return str_ptr->value;
+}
+
 /******************************************************************************
  * LIFECYCLE FUNCTIONS
  */
@@ -36,6 +70,7 @@ rif_string_t *rif_string_build(rif_string_t *str_ptr, bool free, char *value, si
   str_ptr->free = value_free;
   str_ptr->value = value;
   str_ptr->len = len;
+  atomic_init(&str_ptr->hash, 0);
   return str_ptr;
 }
 
@@ -44,8 +79,11 @@ rif_string_t * rif_string_init_wlen(rif_string_t *str_ptr, char *value, size_t l
 }
 
 rif_string_t * rif_string_new_wlen(char *value, size_t len, bool free) {
-  rif_string_t * str_ptr = rif_malloc(sizeof(rif_string_t), "RIF_STRING_NEW");
-  return rif_string_build(str_ptr, true, value, len, free);
+  uint8_t size_class;
+  rif_string_t * str_ptr = rif_slab_alloc(sizeof(rif_string_t), &size_class, "RIF_STRING_NEW");
+  str_ptr = rif_string_build(str_ptr, true, value, len, free);
+  rif_val_set_size_class(str_ptr, size_class);
+  return str_ptr;
 }
 
 rif_string_t * rif_string_new_dup(const char *value) {
@@ -63,11 +101,37 @@ rif_string_t * rif_string_new_dup(const char *value) {
   return str_ptr;
 }
 
+rif_string_t * rif_string_new_immediate(const char *value) {
+  if (!value) {
+    return NULL;
+  }
+  size_t len = strlen(value);
+  if (len > RIF_STRING_IMMEDIATE_MAX_LEN) {
+    return rif_string_new_dup(value);
+  }
+  uintptr_t immediate = RIF_VAL_IMMEDIATE_STRING_TAG | (len << 2);
+  size_t i = 0;
+  for (; i < len; ++i) {
+    immediate |= (uintptr_t) (unsigned char) value[i] << (8 * (i + 1));
+  }
+  return (rif_string_t *) immediate;
+}
+
 /******************************************************************************
  * ACCESSOR FUNCTIONS
  */
 
+const char * rif_string_get_wbuf(rif_string_t *str_ptr, char *buf) {
+  if (rif_val_isimmediate(str_ptr)) {
+    return _rif_string_immediate_get(str_ptr, buf);
+  }
+  return str_ptr ? str_ptr->value : NULL;
+}
+
 size_t rif_string_len(rif_string_t *str_ptr) {
+  if (rif_val_isimmediate(str_ptr)) {
+    return _rif_string_immediate_len(str_ptr);
+  }
   if (str_ptr->len == SIZE_MAX) {
     str_ptr->len = str_ptr->value ? strlen(str_ptr->value) : 0;
   }
@@ -88,14 +152,22 @@ void rif_string_destroy_callback(rif_val_t *val_ptr) {
 
 uint32_t rif_string_hashcode_callback(const rif_val_t *val_ptr) {
   rif_string_t *str_ptr = rif_string_fromval(val_ptr);
+  if (rif_val_isimmediate(str_ptr)) {
+    char buf[RIF_STRING_IMMEDIATE_MAX_LEN + 1];
+    size_t len;
+    const char *value = _rif_string_view(str_ptr, buf, &len);
+    uint32_t hash = rif_hash_bytes(value, len);
+    return hash | (hash == 0);
+  }
   if (!str_ptr || !str_ptr->value) {
     return 0;
   }
-  uint32_t hash = 0;
-  char c;
-  const char *str_val = str_ptr->value;
-  while ((c = *str_val++)) {
-    hash = rif_hash_mix_32(hash, (uint32_t) c);
+  uint32_t hash = atomic_load_explicit(&str_ptr->hash, memory_order_relaxed);
+  if (!hash) {
+    hash = rif_hash_bytes(str_ptr->value, rif_string_len(str_ptr));
+    // Ensure we are not storing 0 (used to mark the hash as not computed)
+    hash |= (hash == 0);
+    atomic_store_explicit(&str_ptr->hash, hash, memory_order_relaxed);
   }
   return hash;
 }
@@ -103,24 +175,38 @@ uint32_t rif_string_hashcode_callback(const rif_val_t *val_ptr) {
 bool rif_string_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_ptr) {
   rif_string_t *first_ptr = rif_string_fromval(val_ptr);
   rif_string_t *second_ptr = rif_string_fromval(other_ptr);
-  return (!first_ptr->value && !second_ptr->value) ||
-         (first_ptr->value && second_ptr->value && !strcmp(first_ptr->value, second_ptr->value));
+  if (first_ptr == second_ptr) {
+    return true;
+  }
+  char first_buf[RIF_STRING_IMMEDIATE_MAX_LEN + 1];
+  char second_buf[RIF_STRING_IMMEDIATE_MAX_LEN + 1];
+  size_t first_len;
+  size_t second_len;
+  const char *first_value = _rif_string_view(first_ptr, first_buf, &first_len);
+  const char *second_value = _rif_string_view(second_ptr, second_buf, &second_len);
+  if (!first_value || !second_value) {
+    return !first_value && !second_value;
+  }
+  // Strings with different memoized hashes cannot be equal
+  if (!rif_val_isimmediate(first_ptr) && !rif_val_isimmediate(second_ptr)) {
+    uint32_t first_hash = atomic_load_explicit(&first_ptr->hash, memory_order_relaxed);
+    uint32_t second_hash = atomic_load_explicit(&second_ptr->hash, memory_order_relaxed);
+    if (first_hash && second_hash && first_hash != second_hash) {
+      return false;
+    }
+  }
+  return first_len == second_len && !memcmp(first_value, second_value, first_len);
 }
 
-char * rif_string_tostring_callback(const rif_val_t *val_ptr) {
+rif_status_t rif_string_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
   rif_string_t *str_ptr = rif_string_fromval(val_ptr);
-  if (!str_ptr->value) {
-    return NULL;
-  }
-  size_t str_len = rif_string_len(str_ptr);
-  size_t tostring_str_len = 3 + str_len;
-  char * tostring_str = rif_malloc(tostring_str_len * sizeof(char), "RIF_STRING_TOSTRING");
-  if (!tostring_str) {
-    return NULL;
+  char buf[RIF_STRING_IMMEDIATE_MAX_LEN + 1];
+  size_t str_len;
+  const char *value = _rif_string_view(str_ptr, buf, &str_len);
+  if (!value) {
+    return rif_strbuf_set_error(sb_ptr, RIF_ERR_UNSUPPORTED);
   }
-  *(tostring_str + 0) = '\"';
-  strncpy(tostring_str + 1, str_ptr->value, str_len);
-  *(tostring_str + 1 + str_len) = '\"';
-  *(tostring_str + 1 + str_len + 1) = '\0';
-  return tostring_str;
+  rif_strbuf_append_char(sb_ptr, '"');
+  rif_strbuf_append(sb_ptr, value, str_len);
+  return rif_strbuf_append_char(sb_ptr, '"');
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "rif/rif_internal.h"
+
+#include "rif/base/rif_string.h"
+#include "rif/concurrent/collection/rif_concurrent_hashmap.h"
+#include "rif/util/rif_arena.h"
+
+/******************************************************************************
+ * STATIC VARIABLES
+ */
+
+/* Canonical strings, mapped to themselves. Created on first use, and never destroyed. */
+static rif_concurrent_hashmap_t _rif_string_intern_table;
+static once_flag _rif_string_intern_once = ONCE_FLAG_INIT;
+static bool _rif_string_intern_valid = false;
+
+/******************************************************************************
+ * HELPERS
+ */
+
+static
+void _rif_string_intern_init(void) {
+  // The table is shared by every thread and lives forever: never allocate it from a thread arena
+  rif_arena_t *arena_ptr = rif_arena_set_current(NULL);
+  _rif_string_intern_valid = NULL != rif_concurrent_hashmap_init(&_rif_string_intern_table, 0, 0);
+  rif_arena_set_current(arena_ptr);
+}
+
+/******************************************************************************
+ * INTERNING FUNCTIONS
+ */
+
+rif_string_t * rif_string_intern(const char *value) {
+  if (!value) {
+    return NULL;
+  }
+  call_once(&_rif_string_intern_once, _rif_string_intern_init);
+  if (!_rif_string_intern_valid) {
+    return NULL;
+  }
+
+  // Fast path: the string is already interned
+  rif_string_t key;
+  rif_string_init(&key, (char *) value, false);
+  rif_val_t *val_ptr = rif_concurrent_hashmap_get_retained(&_rif_string_intern_table, rif_val(&key));
+  rif_string_release(&key);
+  if (val_ptr) {
+    return rif_string_fromval(val_ptr);
+  }
+
+  // Otherwise build a candidate, which is only kept if no other thread interned the same content meanwhile. It must
+  // not be flagged before the lookup, as two interned strings only compare by address, so it is flagged under the
+  // segment lock once it has actually been inserted.
+  rif_arena_t *arena_ptr = rif_arena_set_current(NULL);
+  rif_string_t *str_ptr = rif_string_new_dup(value);
+  if (str_ptr) {
+    val_ptr = rif_concurrent_hashmap_putifabsent_helper(
+        &_rif_string_intern_table, rif_val(str_ptr), rif_val(str_ptr), RIF_VAL_FLAG_INTERNED);
+    rif_string_release(str_ptr);
+  }
+  rif_arena_set_current(arena_ptr);
+  return rif_string_fromval(val_ptr);
+}
+
+uint32_t rif_string_intern_count(void) {
+  call_once(&_rif_string_intern_once, _rif_string_intern_init);
+  return _rif_string_intern_valid ? rif_concurrent_hashmap_size(&_rif_string_intern_table) : 0;
+}
@@ -20,6 +20,7 @@
 #include "rif/rif_internal.h"
 
 #include "rif/base/rif_bool.h"
+#include "rif/base/rif_buffer.h"
 #include "rif/base/rif_double.h"
 #include "rif/base/rif_int.h"
 #include "rif/base/rif_null.h"
@@ -27,6 +28,7 @@
 #include "rif/collection/rif_list.h"
 #include "rif/collection/rif_map.h"
 #include "rif/collection/rif_queue.h"
+#include "rif_reclaim_internal.h"
 
 /******************************************************************************
  * MACROS
@@ -38,16 +40,6 @@
  * TYPES
  */
 
-/**
- * The type retain callback type.
- */
-typedef rif_val_t * (*rif_val_retain_callback_t)(rif_val_t *val_ptr);
-
-/**
- * The type release callback type.
- */
-typedef rif_val_t * (*rif_val_release_callback_t)(rif_val_t *val_ptr);
-
 /**
  * The type destroy callback type.
  */
@@ -64,9 +56,9 @@ typedef uint32_t (*rif_val_hashcode_callback_t)(const rif_val_t *val_ptr);
 typedef bool (*rif_val_equals_callback_t)(const rif_val_t *val_ptr, const rif_val_t *other_ptr);
 
 /**
- * The type tostring callback type.
+ * The type write callback type.
  */
-typedef char * (*rif_val_tostring_callback_t)(const rif_val_t *val_ptr);
+typedef rif_status_t (*rif_val_write_callback_t)(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /******************************************************************************
  * GLOBAL CONSTANTS
@@ -78,48 +70,14 @@ const char *rif_undef_str = "[UNDEF]";
  * FUNCTION FORWARD DECLARATIONS
  */
 
-static rif_val_t * _rif_val_retain_count(rif_val_t *val_ptr);
-static rif_val_t * _rif_val_retain_noop(rif_val_t *val_ptr);
-static rif_val_t * _rif_val_release_count(rif_val_t *val_ptr);
-static rif_val_t * _rif_val_release_noop(rif_val_t *val_ptr);
 static uint32_t _rif_val_hashcode_noop(const rif_val_t *val_ptr);
 static bool _rif_val_equals_address(const rif_val_t *val_ptr, const rif_val_t *other_ptr);
-static char * _rif_val_tostring_noop(const rif_val_t *val_ptr);
+static rif_status_t _rif_val_write_unsupported(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr);
 
 /******************************************************************************
  * STATIC CONSTANTS
  */
 
-static const rif_val_retain_callback_t _rif_val_retain_callbacks[RIF_VAL_TYPE_COUNT] = {
-    [RIF_UNDEF]  = _rif_val_retain_noop,
-    [RIF_NULL]   = _rif_val_retain_noop,
-    [RIF_BOOL]   = _rif_val_retain_noop,
-    [RIF_INT]    = _rif_val_retain_count,
-    [RIF_DOUBLE] = _rif_val_retain_count,
-    [RIF_STRING] = _rif_val_retain_count,
-    [RIF_PTR]    = _rif_val_retain_count,
-    [RIF_LIST]   = _rif_val_retain_count,
-    [RIF_MAP]    = _rif_val_retain_count,
-    [RIF_QUEUE]  = _rif_val_retain_count,
-    [RIF_PAIR]   = _rif_val_retain_count,
-    [RIF_BUFFER] = _rif_val_retain_count
-};
-
-static const rif_val_release_callback_t _rif_val_release_callbacks[RIF_VAL_TYPE_COUNT] = {
-    [RIF_UNDEF]  = _rif_val_release_noop,
-    [RIF_NULL]   = _rif_val_release_noop,
-    [RIF_BOOL]   = _rif_val_release_noop,
-    [RIF_INT]    = _rif_val_release_count,
-    [RIF_DOUBLE] = _rif_val_release_count,
-    [RIF_STRING] = _rif_val_release_count,
-    [RIF_PTR]    = _rif_val_release_count,
-    [RIF_LIST]   = _rif_val_release_count,
-    [RIF_MAP]    = _rif_val_release_count,
-    [RIF_QUEUE]  = _rif_val_release_count,
-    [RIF_PAIR]   = _rif_val_release_count,
-    [RIF_BUFFER] = _rif_val_release_count
-};
-
 static const rif_val_destroy_callback_t _rif_val_destroy_callbacks[RIF_VAL_TYPE_COUNT] = {
     [RIF_INT]    = rif_int_destroy_callback,
     [RIF_DOUBLE] = rif_double_destroy_callback,
@@ -127,7 +85,8 @@ static const rif_val_destroy_callback_t _rif_val_destroy_callbacks[RIF_VAL_TYPE_
     [RIF_LIST]   = rif_list_destroy_callback,
     [RIF_MAP]    = rif_map_destroy_callback,
     [RIF_QUEUE]  = rif_queue_destroy_callback,
-    [RIF_PAIR]   = rif_pair_destroy_callback
+    [RIF_PAIR]   = rif_pair_destroy_callback,
+    [RIF_BUFFER] = rif_buffer_destroy_callback
 };
 
 static const rif_val_hashcode_callback_t _rif_val_hashcode_callbacks[RIF_VAL_TYPE_COUNT] = {
@@ -140,7 +99,8 @@ static const rif_val_hashcode_callback_t _rif_val_hashcode_callbacks[RIF_VAL_TYP
     [RIF_LIST]   = rif_list_hashcode_callback,
     [RIF_MAP]    = rif_map_hashcode_callback,
     [RIF_QUEUE]  = rif_queue_hashcode_callback,
-    [RIF_PAIR]   = rif_pair_hashcode_callback
+    [RIF_PAIR]   = rif_pair_hashcode_callback,
+    [RIF_BUFFER] = rif_buffer_hashcode_callback
 };
 
 static const rif_val_equals_callback_t _rif_val_equals_callbacks[RIF_VAL_TYPE_COUNT] = {
@@ -153,22 +113,30 @@ static const rif_val_equals_callback_t _rif_val_equals_callbacks[RIF_VAL_TYPE_CO
     [RIF_LIST]   = rif_list_equals_callback,
     [RIF_MAP]    =  rif_map_equals_callback,
     [RIF_QUEUE]  = _rif_val_equals_address,
-    [RIF_PAIR]   = rif_pair_equals_callback
+    [RIF_PAIR]   = rif_pair_equals_callback,
+    [RIF_BUFFER] = rif_buffer_equals_callback
 };
 
-static const rif_val_tostring_callback_t _rif_val_tostring_callbacks[RIF_VAL_TYPE_COUNT] = {
-    [RIF_UNDEF]  = _rif_val_tostring_noop,
-    [RIF_NULL]   = rif_null_tostring_callback,
-    [RIF_BOOL]   = rif_bool_tostring_callback,
-    [RIF_INT]    = rif_int_tostring_callback,
-    [RIF_DOUBLE] = rif_double_tostring_callback,
-    [RIF_STRING] = rif_string_tostring_callback,
-    [RIF_LIST]   = rif_list_tostring_callback,
-    [RIF_MAP]    = rif_map_tostring_callback,
-    [RIF_QUEUE]  = rif_queue_tostring_callback,
-    [RIF_PAIR]   = rif_pair_tostring_callback
+static const rif_val_write_callback_t _rif_val_write_callbacks[RIF_VAL_TYPE_COUNT] = {
+    [RIF_UNDEF]  = _rif_val_write_unsupported,
+    [RIF_NULL]   = rif_null_write_callback,
+    [RIF_BOOL]   = rif_bool_write_callback,
+    [RIF_INT]    = rif_int_write_callback,
+    [RIF_DOUBLE] = rif_double_write_callback,
+    [RIF_STRING] = rif_string_write_callback,
+    [RIF_LIST]   = rif_list_write_callback,
+    [RIF_MAP]    = rif_map_write_callback,
+    [RIF_QUEUE]  = rif_queue_write_callback,
+    [RIF_PAIR]   = rif_pair_write_callback,
+    [RIF_BUFFER] = rif_buffer_write_callback
 };
 
+/******************************************************************************
+ * STATIC VARIABLES
+ */
+
+static RIF_THREAD_LOCAL bool _rif_val_local_default = false;
+
 /******************************************************************************
  * LIFECYCLE FUNCTIONS
  */
@@ -177,8 +145,13 @@ rif_val_t * rif_val_init(rif_val_t *val_ptr, rif_val_type_t type, bool free) {
   if (!val_ptr) {
     return val_ptr;
   }
-  val_ptr->type = type;
-  val_ptr->free = free;
+  val_ptr->type = (uint8_t) type;
+  val_ptr->size_class = 0;
+  val_ptr->flags = (free ? RIF_VAL_FLAG_FREE : 0) | (_rif_val_local_default ? RIF_VAL_FLAG_LOCAL : 0);
+  // Values of these types are never reference counted, and are meant to be shared: they are never thread-local
+  if (type == RIF_UNDEF || type == RIF_NULL || type == RIF_BOOL) {
+    val_ptr->flags = (val_ptr->flags | RIF_VAL_FLAG_IMMORTAL) & (uint8_t) ~RIF_VAL_FLAG_LOCAL;
+  }
   atomic_init(&val_ptr->reference_count, 1);
   return val_ptr;
 }
@@ -187,49 +160,6 @@ rif_val_t * rif_val_init(rif_val_t *val_ptr, rif_val_type_t type, bool free) {
  * GENERAL CALLBACKS FUNCTIONS
  */
 
-/**
- * The basic retain callback.
- */
-static
-rif_val_t * _rif_val_retain_count(rif_val_t *val_ptr) {
-  atomic_fetch_add(&val_ptr->reference_count, 1);
-  return val_ptr;
-}
-
-/**
- * A retain callback that does nothing.
- */
-static
-rif_val_t * _rif_val_retain_noop(rif_val_t *val_ptr) {
-  return val_ptr;
-}
-
-/**
- * The basic release callback.
- */
-static
-rif_val_t * _rif_val_release_count(rif_val_t *val_ptr) {
-  if (atomic_load(&val_ptr->reference_count) == 0) {
-    return val_ptr;
-  }
-  if (atomic_fetch_sub(&val_ptr->reference_count, 1) == 1) {
-    _rif_val_destroy_callbacks[rif_val_type(val_ptr)](val_ptr);
-    if (val_ptr->free) {
-      rif_free(val_ptr);
-    }
-    val_ptr = NULL;
-  }
-  return val_ptr;
-}
-
-/**
- * A release callback that does nothing.
- */
-static
-rif_val_t * _rif_val_release_noop(rif_val_t *val_ptr) {
-  return val_ptr;
-}
-
 /**
  * A hashcode callback that does nothing.
  */
@@ -247,29 +177,45 @@ bool _rif_val_equals_address(const rif_val_t *val_ptr, const rif_val_t *other_pt
 }
 
 /**
- * A tostring callback that does nothing.
+ * A write callback for values which have no string representation.
  */
 static
-char * _rif_val_tostring_noop(const rif_val_t *val_ptr) {
-  return NULL;
+rif_status_t _rif_val_write_unsupported(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
+  return rif_strbuf_set_error(sb_ptr, RIF_ERR_UNSUPPORTED);
+}
+
+/******************************************************************************
+ * THREAD CONFINEMENT FUNCTIONS
+ */
+
+bool rif_val_set_local_default(bool local) {
+  bool previous = _rif_val_local_default;
+  _rif_val_local_default = local;
+  return previous;
+}
+
+bool rif_val_local_default(void) {
+  return _rif_val_local_default;
 }
 
 /******************************************************************************
  * HELPER FUNCTIONS
  */
 
-rif_val_t * rif_val_retain_helper(rif_val_t *val_ptr) {
-  if (!val_ptr) {
-    return NULL;
+void _rif_val_destroy(rif_val_t *val_ptr) {
+  _rif_val_destroy_callbacks[rif_val_type(val_ptr)](val_ptr);
+  if (val_ptr->size_class) {
+    rif_slab_free(val_ptr, val_ptr->size_class);
+  } else if (val_ptr->flags & RIF_VAL_FLAG_FREE) {
+    rif_free(val_ptr);
   }
-  return _rif_val_retain_callbacks[rif_val_type(val_ptr)](val_ptr);
 }
 
-rif_val_t * rif_val_release_helper(rif_val_t *val_ptr) {
-  if (!val_ptr) {
-    return NULL;
+void rif_val_destroy_helper(rif_val_t *val_ptr) {
+  if (__unlikely(_rif_reclaim_deferred) && _rif_reclaim_push(val_ptr)) {
+    return;
   }
-  return _rif_val_release_callbacks[rif_val_type(val_ptr)](val_ptr);
+  _rif_val_destroy(val_ptr);
 }
 
 uint32_t rif_val_hashcode_helper(const rif_val_t *val_ptr) {
@@ -286,15 +232,50 @@ bool rif_val_equals_helper(const rif_val_t *val_ptr, const rif_val_t *other_ptr)
   if (val_ptr == other_ptr) {
     return true;
   }
-  if (val_ptr->type != other_ptr->type) {
+  // Distinct canonical instances never have the same content
+  if (!rif_val_isimmediate(val_ptr) && !rif_val_isimmediate(other_ptr) &&
+      (val_ptr->flags & other_ptr->flags & RIF_VAL_FLAG_INTERNED)) {
     return false;
   }
-  return _rif_val_equals_callbacks[rif_val_type(val_ptr)](val_ptr, other_ptr);
+  rif_val_type_t type = rif_val_type(val_ptr);
+  if (type != rif_val_type(other_ptr)) {
+    return false;
+  }
+  return _rif_val_equals_callbacks[type](val_ptr, other_ptr);
 }
 
 char * rif_val_tostring_helper(const rif_val_t *val_ptr) {
   if (!val_ptr) {
     return NULL;
   }
-  return _rif_val_tostring_callbacks[rif_val_type(val_ptr)](val_ptr);
+  rif_strbuf_t sb;
+  if (!rif_strbuf_init(&sb, RIF_STRBUF_DEFAULT_CAPACITY)) {
+    return NULL;
+  }
+  rif_val_write_helper(val_ptr, &sb);
+  char *str = rif_strbuf_detach(&sb);
+  rif_strbuf_destroy(&sb);
+  return str;
+}
+
+rif_status_t rif_val_write_helper(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
+  if (!val_ptr) {
+    return rif_strbuf_append_str(sb_ptr, rif_undef_str);
+  }
+  return _rif_val_write_callbacks[rif_val_type(val_ptr)](val_ptr, sb_ptr);
+}
+
+rif_status_t rif_val_write_fd_helper(const rif_val_t *val_ptr, int fd) {
+  rif_strbuf_t sb;
+  if (!rif_strbuf_init_fd(&sb, fd, 0)) {
+    return RIF_ERR_MEMORY;
+  }
+  if (val_ptr) {
+    rif_val_write_helper(val_ptr, &sb);
+  } else {
+    rif_strbuf_set_error(&sb, RIF_ERR_UNSUPPORTED);
+  }
+  rif_status_t status = rif_strbuf_flush(&sb);
+  rif_strbuf_destroy(&sb);
+  return status;
 }
\ No newline at end of file
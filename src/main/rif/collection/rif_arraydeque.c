@@ -0,0 +1,298 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+
+#include "rif/rif_internal.h"
+
+#include "rif/collection/rif_arraydeque.h"
+#include "rif/util/rif_math.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+/*
+ * Reallocates the element array to `capacity` slots, a power of two which must be greater than the current capacity.
+ * Elements which wrapped around the end of the old array are moved right after it, so that they stay in order.
+ */
+static
+rif_status_t _rif_arraydeque_resize(rif_arraydeque_t *dq_ptr, uint32_t capacity) {
+
+  // Reallocate memory.
+  size_t needed_bytes = (size_t) capacity * sizeof(rif_val_t *);
+  rif_val_t **new_elements;
+  if (dq_ptr->capacity) {
+    new_elements = rif_realloc(dq_ptr->elements, needed_bytes, "ARRAYDEQUE_CAPACITY_REALLOC");
+  } else {
+    new_elements = rif_malloc(needed_bytes, "ARRAYDEQUE_CAPACITY_ALLOC");
+  }
+  if (new_elements == NULL) {
+    return RIF_ERR_MEMORY;
+  }
+  dq_ptr->elements = new_elements;
+
+  // Unwrap elements. The new array is at least twice as large, so the wrapped part always fits after the old end.
+  if (dq_ptr->head + dq_ptr->size > dq_ptr->capacity) {
+    uint32_t wrapped = dq_ptr->head + dq_ptr->size - dq_ptr->capacity;
+    memcpy(dq_ptr->elements + dq_ptr->capacity, dq_ptr->elements, wrapped * sizeof(rif_val_t *));
+  }
+
+  // Done.
+  dq_ptr->capacity = capacity;
+  return RIF_OK;
+}
+
+/*
+ * Moves `count` elements from logical position `src` to logical position `dst`, one contiguous chunk at a time so that
+ * wrapping around the end of the array is handled. Chunks are moved from the end when moving towards the back, and from
+ * the start otherwise, so that overlapping ranges are not overwritten before being read.
+ */
+static
+void _rif_arraydeque_move(rif_arraydeque_t *dq_ptr, uint32_t dst, uint32_t src, uint32_t count) {
+  uint32_t mask = dq_ptr->capacity - 1;
+  while (count) {
+    uint32_t chunk;
+    if (dst > src) {
+      uint32_t src_end = ((dq_ptr->head + src + count - 1) & mask) + 1;
+      uint32_t dst_end = ((dq_ptr->head + dst + count - 1) & mask) + 1;
+      chunk = rif_min(count, rif_min(src_end, dst_end));
+      memmove(dq_ptr->elements + dst_end - chunk, dq_ptr->elements + src_end - chunk, chunk * sizeof(rif_val_t *));
+    } else {
+      uint32_t src_start = (dq_ptr->head + src) & mask;
+      uint32_t dst_start = (dq_ptr->head + dst) & mask;
+      chunk = rif_min(count, rif_min(dq_ptr->capacity - src_start, dq_ptr->capacity - dst_start));
+      memmove(dq_ptr->elements + dst_start, dq_ptr->elements + src_start, chunk * sizeof(rif_val_t *));
+      src += chunk;
+      dst += chunk;
+    }
+    count -= chunk;
+  }
+}
+
+/*
+ * Makes room for one more element.
+ */
+static inline
+rif_status_t _rif_arraydeque_grow(rif_arraydeque_t *dq_ptr) {
+  if (__likely(dq_ptr->size < dq_ptr->capacity)) {
+    return RIF_OK;
+  }
+  if (dq_ptr->fixed) {
+    return RIF_ERR_CAPACITY;
+  }
+  if (__unlikely(dq_ptr->capacity > UINT32_MAX / 2)) {
+    return RIF_ERR_MEMORY;
+  }
+  return _rif_arraydeque_resize(dq_ptr, dq_ptr->capacity ? dq_ptr->capacity * 2 : RIF_ARRAYDEQUE_MIN_CAPACITY);
+}
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+static
+rif_arraydeque_t * _rif_arraydeque_build(rif_arraydeque_t *dq_ptr, bool free, uint32_t capacity, bool fixed) {
+  if (!dq_ptr) {
+    return dq_ptr;
+  }
+  rif_list_init((rif_list_t *) dq_ptr, &rif_arraydeque_hooks, free);
+  rif_queue_init(&dq_ptr->queue, &rif_arraydeque_queue_hooks, false);
+  dq_ptr->size = 0;
+  dq_ptr->capacity = 0;
+  dq_ptr->head = 0;
+  dq_ptr->fixed = false;
+  dq_ptr->elements = NULL;
+
+  // Allocate element array if needed.
+  if (capacity && RIF_OK != rif_arraydeque_ensure_capacity(dq_ptr, capacity)) {
+    return NULL;
+  }
+
+  dq_ptr->fixed = fixed;
+  return dq_ptr;
+}
+
+rif_arraydeque_t * rif_arraydeque_init(rif_arraydeque_t *dq_ptr, uint32_t capacity, bool fixed) {
+  return _rif_arraydeque_build(dq_ptr, false, capacity, fixed);
+}
+
+rif_arraydeque_t * rif_arraydeque_new(uint32_t capacity, bool fixed) {
+  rif_arraydeque_t *dq_ptr = rif_malloc(sizeof(rif_arraydeque_t), "RIF_ARRAYDEQUE_NEW");
+  if (dq_ptr && !_rif_arraydeque_build(dq_ptr, true, capacity, fixed)) {
+    rif_free(dq_ptr);
+    return NULL;
+  }
+  return dq_ptr;
+}
+
+/******************************************************************************
+ * SIZING FUNCTIONS
+ */
+
+rif_status_t rif_arraydeque_ensure_capacity(rif_arraydeque_t *dq_ptr, uint32_t capacity) {
+  if (__likely(capacity <= dq_ptr->capacity)) {
+    return RIF_OK;
+  }
+  if (dq_ptr->fixed) {
+    return RIF_ERR_CAPACITY;
+  }
+  if (__unlikely(capacity > UINT32_MAX / 2 + 1)) {
+    return RIF_ERR_MEMORY;
+  }
+  return _rif_arraydeque_resize(dq_ptr, rif_max(rif_next_pow2(capacity), RIF_ARRAYDEQUE_MIN_CAPACITY));
+}
+
+/******************************************************************************
+ * CALLBACK FUNCTIONS
+ */
+
+void rif_arraydeque_destroy_callback(rif_arraydeque_t *dq_ptr) {
+  uint32_t i = 0;
+  for (; i < dq_ptr->size; ++i) {
+    rif_val_t *val_ptr = *rif_arraydeque_slot(dq_ptr, i);
+    if (NULL != val_ptr) {
+      rif_val_release(val_ptr);
+    }
+  }
+  rif_free(dq_ptr->elements);
+}
+
+/******************************************************************************
+ * ELEMENT WRITE FUNCTIONS
+ */
+
+rif_status_t rif_arraydeque_insert(rif_arraydeque_t *dq_ptr, uint32_t index, rif_val_t *val_ptr) {
+
+  // Check index and ensure sufficient capacity.
+  if (__unlikely(index > dq_ptr->size)) {
+    return RIF_ERR_OUT_OF_BOUNDS;
+  }
+  rif_status_t grow_status = _rif_arraydeque_grow(dq_ptr);
+  if (__unlikely(RIF_OK != grow_status)) {
+    return grow_status;
+  }
+
+  // Shift the elements on the shorter side by one.
+  if (index < dq_ptr->size / 2) {
+    dq_ptr->head = rif_mod_pow2(dq_ptr->head - 1, dq_ptr->capacity);
+    _rif_arraydeque_move(dq_ptr, 0, 1, index);
+  } else {
+    _rif_arraydeque_move(dq_ptr, index + 1, index, dq_ptr->size - index);
+  }
+
+  // Retain the new value, and put it in place.
+  if (__likely(NULL != val_ptr)) {
+    rif_val_retain(val_ptr);
+  }
+  *rif_arraydeque_slot(dq_ptr, index) = val_ptr;
+
+  ++dq_ptr->size;
+  return RIF_OK;
+}
+
+rif_status_t rif_arraydeque_push_back(rif_arraydeque_t *dq_ptr, rif_val_t *val_ptr) {
+  return rif_arraydeque_push_back_steal(dq_ptr, rif_val_retain(val_ptr));
+}
+
+rif_status_t rif_arraydeque_push_back_steal(rif_arraydeque_t *dq_ptr, rif_val_t *val_ptr) {
+  rif_status_t grow_status = _rif_arraydeque_grow(dq_ptr);
+  if (__unlikely(RIF_OK != grow_status)) {
+    rif_val_release(val_ptr);
+    return grow_status;
+  }
+  *rif_arraydeque_slot(dq_ptr, dq_ptr->size) = val_ptr;
+  ++dq_ptr->size;
+  return RIF_OK;
+}
+
+rif_status_t rif_arraydeque_push_front(rif_arraydeque_t *dq_ptr, rif_val_t *val_ptr) {
+  rif_status_t grow_status = _rif_arraydeque_grow(dq_ptr);
+  if (__unlikely(RIF_OK != grow_status)) {
+    return grow_status;
+  }
+  if (__likely(NULL != val_ptr)) {
+    rif_val_retain(val_ptr);
+  }
+  dq_ptr->head = rif_mod_pow2(dq_ptr->head - 1, dq_ptr->capacity);
+  *rif_arraydeque_slot(dq_ptr, 0) = val_ptr;
+  ++dq_ptr->size;
+  return RIF_OK;
+}
+
+rif_status_t rif_arraydeque_set(rif_arraydeque_t *dq_ptr, uint32_t index, rif_val_t *val_ptr) {
+  if (__unlikely(index >= dq_ptr->size)) {
+    return RIF_ERR_OUT_OF_BOUNDS;
+  }
+  rif_val_t **elem_ptr = rif_arraydeque_slot(dq_ptr, index);
+  if (__likely(NULL != *elem_ptr)) {
+    rif_val_release(*elem_ptr);
+  }
+  if (__likely(NULL != val_ptr)) {
+    rif_val_retain(val_ptr);
+  }
+  *elem_ptr = val_ptr;
+  return RIF_OK;
+}
+
+/******************************************************************************
+ * ELEMENT DELETE FUNCTIONS
+ */
+
+rif_status_t rif_arraydeque_remove(rif_arraydeque_t *dq_ptr, uint32_t index) {
+
+  // Check index.
+  if (__unlikely(index >= dq_ptr->size)) {
+    return RIF_ERR_OUT_OF_BOUNDS;
+  }
+
+  // Release the value to remove.
+  rif_val_t *val_ptr = *rif_arraydeque_slot(dq_ptr, index);
+  if (__likely(NULL != val_ptr)) {
+    rif_val_release(val_ptr);
+  }
+
+  // Shift the elements on the shorter side by one, over the removed one.
+  if (index < dq_ptr->size / 2) {
+    _rif_arraydeque_move(dq_ptr, 1, 0, index);
+    dq_ptr->head = rif_mod_pow2(dq_ptr->head + 1, dq_ptr->capacity);
+  } else {
+    _rif_arraydeque_move(dq_ptr, index, index + 1, dq_ptr->size - index - 1);
+  }
+
+  --dq_ptr->size;
+  return RIF_OK;
+}
+
+rif_val_t * rif_arraydeque_pop_back(rif_arraydeque_t *dq_ptr) {
+  if (__unlikely(0 == dq_ptr->size)) {
+    return NULL;
+  }
+  --dq_ptr->size;
+  return *rif_arraydeque_slot(dq_ptr, dq_ptr->size);
+}
+
+rif_val_t * rif_arraydeque_pop_front(rif_arraydeque_t *dq_ptr) {
+  if (__unlikely(0 == dq_ptr->size)) {
+    return NULL;
+  }
+  rif_val_t *val_ptr = *rif_arraydeque_slot(dq_ptr, 0);
+  dq_ptr->head = rif_mod_pow2(dq_ptr->head + 1, dq_ptr->capacity);
+  --dq_ptr->size;
+  return val_ptr;
+}
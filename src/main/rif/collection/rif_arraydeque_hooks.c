@@ -0,0 +1,136 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+
+#include "rif/rif_internal.h"
+
+#include "rif/collection/rif_arraydeque.h"
+#include "rif/collection/rif_arraydeque_iterator.h"
+
+/******************************************************************************
+ * HOOK HELPERS
+ */
+
+#define _rif_arraydeque_fromqueue(__queue_ptr) \
+    ((rif_arraydeque_t *) ((char *) (__queue_ptr) - offsetof(rif_arraydeque_t, queue)))
+
+static
+void _rif_arraydeque_hook_destroy(rif_list_t *list_ptr) {
+  rif_arraydeque_destroy_callback((rif_arraydeque_t *) list_ptr);
+}
+
+static
+uint32_t _rif_arraydeque_hook_size(rif_list_t *list_ptr) {
+  return rif_arraydeque_size((rif_arraydeque_t *) list_ptr);
+}
+
+static
+rif_val_t * _rif_arraydeque_hook_get(rif_list_t *list_ptr, uint32_t index) {
+  return rif_arraydeque_get((rif_arraydeque_t *) list_ptr, index);
+}
+
+static
+rif_status_t _rif_arraydeque_hook_insert(rif_list_t *list_ptr, uint32_t index, rif_val_t *val_ptr) {
+  return rif_arraydeque_insert((rif_arraydeque_t *) list_ptr, index, val_ptr);
+}
+
+static
+rif_status_t _rif_arraydeque_hook_append(rif_list_t *list_ptr, rif_val_t *val_ptr) {
+  return rif_arraydeque_push_back((rif_arraydeque_t *) list_ptr, val_ptr);
+}
+
+static
+rif_status_t _rif_arraydeque_hook_append_steal(rif_list_t *list_ptr, rif_val_t *val_ptr) {
+  return rif_arraydeque_push_back_steal((rif_arraydeque_t *) list_ptr, val_ptr);
+}
+
+static
+rif_status_t _rif_arraydeque_hook_prepend(rif_list_t *list_ptr, rif_val_t *val_ptr) {
+  return rif_arraydeque_push_front((rif_arraydeque_t *) list_ptr, val_ptr);
+}
+
+static
+rif_status_t _rif_arraydeque_hook_set(rif_list_t *list_ptr, uint32_t index, rif_val_t *val_ptr) {
+  return rif_arraydeque_set((rif_arraydeque_t *) list_ptr, index, val_ptr);
+}
+
+static
+rif_status_t _rif_arraydeque_hook_remove(rif_list_t *list_ptr, uint32_t index) {
+  return rif_arraydeque_remove((rif_arraydeque_t *) list_ptr, index);
+}
+
+static
+rif_list_iterator_t * _rif_arraydeque_hook_iterator_init(rif_list_t *list_ptr, rif_list_iterator_t *it_ptr) {
+  return (rif_list_iterator_t *) rif_arraydeque_iterator_init(
+      (rif_arraydeque_iterator_t *) it_ptr, (rif_arraydeque_t *) list_ptr);
+}
+
+static
+rif_list_iterator_t * _rif_arraydeque_hook_iterator_new(rif_list_t *list_ptr) {
+  return (rif_list_iterator_t *) rif_arraydeque_iterator_new((rif_arraydeque_t *) list_ptr);
+}
+
+static
+uint32_t _rif_arraydeque_queue_hook_size(rif_queue_t *queue_ptr) {
+  return rif_arraydeque_size(_rif_arraydeque_fromqueue(queue_ptr));
+}
+
+static
+rif_status_t _rif_arraydeque_queue_hook_push(rif_queue_t *queue_ptr, rif_val_t *val_ptr) {
+  return rif_arraydeque_push_back(_rif_arraydeque_fromqueue(queue_ptr), val_ptr);
+}
+
+static
+rif_status_t _rif_arraydeque_queue_hook_push_steal(rif_queue_t *queue_ptr, rif_val_t *val_ptr) {
+  return rif_arraydeque_push_back_steal(_rif_arraydeque_fromqueue(queue_ptr), val_ptr);
+}
+
+static
+rif_val_t * _rif_arraydeque_queue_hook_pop(rif_queue_t *queue_ptr) {
+  return rif_arraydeque_pop_front(_rif_arraydeque_fromqueue(queue_ptr));
+}
+
+/******************************************************************************
+ * HOOKS
+ */
+
+const rif_list_hooks_t rif_arraydeque_hooks = {
+    .destroy       = _rif_arraydeque_hook_destroy,
+    .size          = _rif_arraydeque_hook_size,
+    .get           = _rif_arraydeque_hook_get,
+    .insert        = _rif_arraydeque_hook_insert,
+    .append        = _rif_arraydeque_hook_append,
+    .append_steal  = _rif_arraydeque_hook_append_steal,
+    .prepend       = _rif_arraydeque_hook_prepend,
+    .set           = _rif_arraydeque_hook_set,
+    .remove        = _rif_arraydeque_hook_remove,
+    .iterator_init = _rif_arraydeque_hook_iterator_init,
+    .iterator_new  = _rif_arraydeque_hook_iterator_new
+};
+
+/*
+ * The queue view does not own the deque, so it has nothing to destroy.
+ */
+const rif_queue_hooks_t rif_arraydeque_queue_hooks = {
+    .destroy    = NULL,
+    .size       = _rif_arraydeque_queue_hook_size,
+    .push       = _rif_arraydeque_queue_hook_push,
+    .push_steal = _rif_arraydeque_queue_hook_push_steal,
+    .pop        = _rif_arraydeque_queue_hook_pop
+};
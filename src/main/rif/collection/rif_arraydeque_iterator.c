@@ -0,0 +1,65 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "rif/rif_internal.h"
+
+#include "rif/collection/rif_arraydeque_iterator.h"
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+static
+rif_arraydeque_iterator_t *_rif_arraydeque_iterator_build(
+    rif_arraydeque_iterator_t *it_ptr, const rif_arraydeque_t *dq_ptr, bool free) {
+  if (!it_ptr) {
+    return NULL;
+  }
+  rif_iterator_init((rif_iterator_t *) it_ptr, &rif_arraydeque_iterator_hooks, free);
+  it_ptr->dq_ptr = dq_ptr;
+  it_ptr->index = 0;
+  return it_ptr;
+}
+
+rif_arraydeque_iterator_t *rif_arraydeque_iterator_init(
+    rif_arraydeque_iterator_t *it_ptr, const rif_arraydeque_t *dq_ptr) {
+  return _rif_arraydeque_iterator_build(it_ptr, dq_ptr, false);
+}
+
+rif_arraydeque_iterator_t *rif_arraydeque_iterator_new(const rif_arraydeque_t *dq_ptr) {
+  rif_arraydeque_iterator_t *it_ptr = rif_malloc(sizeof(rif_arraydeque_iterator_t), "RIF_ARRAYDEQUE_ITERATOR_NEW");
+  return _rif_arraydeque_iterator_build(it_ptr, dq_ptr, true);
+}
+
+/******************************************************************************
+ * ITERATOR FUNCTIONS
+ */
+
+rif_val_t *rif_arraydeque_iterator_next(rif_arraydeque_iterator_t *it_ptr) {
+  if (!rif_arraydeque_iterator_hasnext(it_ptr)) {
+    return NULL;
+  }
+  return *rif_arraydeque_slot(it_ptr->dq_ptr, it_ptr->index++);
+}
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -20,6 +20,118 @@
 #include "rif/rif_internal.h"
 
 #include "rif/collection/rif_arraylist.h"
+#include "rif/util/rif_math.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+/*
+ * Reallocates the element array to hold exactly `capacity` elements, which must not be lower than the list size.
+ */
+static
+rif_status_t _rif_arraylist_resize(rif_arraylist_t *al_ptr, uint32_t capacity) {
+
+  // An empty array is simply freed.
+  if (0 == capacity) {
+    rif_free(al_ptr->elements);
+    al_ptr->elements = NULL;
+    al_ptr->capacity = 0;
+    return RIF_OK;
+  }
+
+  // Reallocate memory.
+  size_t needed_bytes = (size_t) capacity * sizeof(rif_val_t *);
+  rif_val_t **new_elements;
+  if (al_ptr->capacity) {
+    new_elements = rif_realloc(al_ptr->elements, needed_bytes, "ARRAYLIST_CAPACITY_REALLOC");
+  } else {
+    new_elements = rif_malloc(needed_bytes, "ARRAYLIST_CAPACITY_ALLOC");
+  }
+  if (new_elements == NULL) {
+    return RIF_ERR_MEMORY;
+  }
+  al_ptr->elements = new_elements;
+
+  // Zero-out every element beyond original pointers.
+  if (capacity > al_ptr->capacity) {
+    memset(al_ptr->elements + al_ptr->capacity, 0, (capacity - al_ptr->capacity) * sizeof(rif_val_t *));
+  }
+
+  // Done.
+  al_ptr->capacity = capacity;
+  return RIF_OK;
+}
+
+/*
+ * Rounds a capacity up to the next block size multiple, or returns `0` on overflow.
+ */
+static inline
+uint32_t _rif_arraylist_round_to_block(const rif_arraylist_t *al_ptr, uint32_t capacity) {
+  uint32_t block_size = al_ptr->block_size ? al_ptr->block_size : 1;
+  uint64_t rounded = ((uint64_t) capacity + block_size - 1) / block_size * block_size;
+  return rounded > UINT32_MAX ? 0 : (uint32_t) rounded;
+}
+
+/*
+ * Computes the capacity to grow to when `capacity` elements are needed by an insertion.
+ */
+static
+uint32_t _rif_arraylist_growth_capacity(const rif_arraylist_t *al_ptr, uint32_t capacity) {
+  uint64_t target;
+  switch (al_ptr->growth) {
+    case RIF_ARRAYLIST_GROWTH_GEOMETRIC:
+      target = (uint64_t) al_ptr->capacity + (al_ptr->capacity >> 1);
+      break;
+    case RIF_ARRAYLIST_GROWTH_DOUBLE:
+      target = (uint64_t) al_ptr->capacity << 1;
+      break;
+    default:
+      return _rif_arraylist_round_to_block(al_ptr, capacity);
+  }
+  target = rif_max(target, rif_max(al_ptr->block_size, RIF_ARRAYLIST_MIN_CAPACITY));
+  return (uint32_t) rif_min(rif_max(target, capacity), UINT32_MAX);
+}
+
+/*
+ * Grows the element array so that it can hold at least `capacity` elements, according to the growth strategy.
+ */
+static
+rif_status_t _rif_arraylist_grow(rif_arraylist_t *al_ptr, uint32_t capacity) {
+  if (__likely(capacity <= al_ptr->capacity)) {
+    return RIF_OK;
+  }
+  if (RIF_ARRAYLIST_GROWTH_FIXED == al_ptr->growth && al_ptr->elements) {
+    return RIF_ERR_CAPACITY;
+  }
+  uint32_t needed_capacity = _rif_arraylist_growth_capacity(al_ptr, capacity);
+  if (__unlikely(0 == needed_capacity)) {
+    return RIF_ERR_MEMORY;
+  }
+  return _rif_arraylist_resize(al_ptr, needed_capacity);
+}
+
+/*
+ * Gives memory back once the list has been drained below a quarter of its capacity. The capacity is only halved, so
+ * that a list oscillating around the threshold does not reallocate on every operation.
+ */
+static
+void _rif_arraylist_maybe_shrink(rif_arraylist_t *al_ptr) {
+  if (__likely(!al_ptr->autoshrink || al_ptr->size > (al_ptr->capacity >> 2))) {
+    return;
+  }
+  uint32_t min_capacity = rif_max(al_ptr->block_size, RIF_ARRAYLIST_MIN_CAPACITY);
+  if (al_ptr->capacity <= min_capacity) {
+    return;
+  }
+  uint32_t capacity = rif_max(al_ptr->capacity >> 1, min_capacity);
+  if (RIF_ARRAYLIST_GROWTH_LINEAR == al_ptr->growth) {
+    capacity = _rif_arraylist_round_to_block(al_ptr, capacity);
+  }
+
+  // Shrinking is best-effort: on failure, the list simply keeps its current array.
+  _rif_arraylist_resize(al_ptr, capacity);
+}
 
 /******************************************************************************
  * LIFECYCLE FUNCTIONS
@@ -35,8 +147,19 @@ rif_arraylist_t * _rif_arraylist_build(rif_arraylist_t *al_ptr, bool free, uint3
   al_ptr->capacity = 0;
   al_ptr->elements = NULL;
   al_ptr->free_elements = true;
+  al_ptr->autoshrink = false;
   al_ptr->size = 0;
 
+  // Without a block size, the list is fixed to its initial capacity. Without either, there is nothing to fix the
+  // capacity to, so the list grows geometrically.
+  if (block_size) {
+    al_ptr->growth = RIF_ARRAYLIST_GROWTH_LINEAR;
+  } else if (capacity) {
+    al_ptr->growth = RIF_ARRAYLIST_GROWTH_FIXED;
+  } else {
+    al_ptr->growth = RIF_ARRAYLIST_GROWTH_GEOMETRIC;
+  }
+
   // Allocate element array if needed.
   if (capacity && RIF_OK != rif_arraylist_ensure_capacity(al_ptr, capacity)) {
     return NULL;
@@ -49,6 +172,15 @@ rif_arraylist_t * rif_arraylist_init(rif_arraylist_t *al_ptr, uint32_t capacity,
   return _rif_arraylist_build(al_ptr, false, capacity, block_size);
 }
 
+rif_arraylist_t * rif_arraylist_new(uint32_t capacity, uint32_t block_size) {
+  rif_arraylist_t *al_ptr = rif_malloc(sizeof(rif_arraylist_t), "RIF_ARRAYLIST_NEW");
+  if (al_ptr && !_rif_arraylist_build(al_ptr, true, capacity, block_size)) {
+    rif_free(al_ptr);
+    return NULL;
+  }
+  return al_ptr;
+}
+
 /******************************************************************************
  * SIZING FUNCTIONS
  */
@@ -60,43 +192,47 @@ rif_status_t rif_arraylist_ensure_capacity(rif_arraylist_t *al_ptr, uint32_t cap
     return RIF_OK;
   }
 
-  // Maybe the list has a fixed size. If so,
-  if (al_ptr->block_size == 0 && al_ptr->elements) {
+  // Maybe the list has a fixed size.
+  if (RIF_ARRAYLIST_GROWTH_FIXED == al_ptr->growth && al_ptr->elements) {
     return RIF_ERR_CAPACITY;
   }
 
-  // Else, calculate how much space we need to allocate.
-  uint32_t needed_capacity;
-  if (al_ptr->block_size) {
-    uint32_t needed_blocks = (uint32_t) ceil(capacity / (double) al_ptr->block_size);
-    needed_capacity = needed_blocks * al_ptr->block_size;
-  } else {
-    needed_capacity = capacity;
+  // Else, allocate exactly what was asked for, up to the block size for linear lists.
+  uint32_t needed_capacity = capacity;
+  if (RIF_ARRAYLIST_GROWTH_LINEAR == al_ptr->growth) {
+    needed_capacity = _rif_arraylist_round_to_block(al_ptr, capacity);
+    if (__unlikely(0 == needed_capacity)) {
+      return RIF_ERR_MEMORY;
+    }
   }
-  uint32_t needed_bytes = needed_capacity * sizeof(rif_val_t *);
+  return _rif_arraylist_resize(al_ptr, needed_capacity);
+}
 
-  // Reallocate memory.
-  rif_val_t **new_elements;
-  if (al_ptr->capacity) {
-    new_elements = rif_realloc(al_ptr->elements, needed_bytes, "ARRAYLIST_CAPACITY_REALLOC");
-  } else {
-    new_elements = rif_malloc(needed_bytes, "ARRAYLIST_CAPACITY_ALLOC");
+rif_status_t rif_arraylist_shrink_to_fit(rif_arraylist_t *al_ptr) {
+  if (RIF_ARRAYLIST_GROWTH_FIXED == al_ptr->growth) {
+    return RIF_ERR_CAPACITY;
   }
-  if (new_elements == NULL) {
-    return RIF_ERR_MEMORY;
+  if (al_ptr->size == al_ptr->capacity) {
+    return RIF_OK;
   }
-  al_ptr->elements = new_elements;
-
-  // Zero-out every element beyond original pointers.
-  rif_val_t **zero_start = al_ptr->elements + al_ptr->capacity;
-  uint32_t zero_bytes = needed_bytes - (al_ptr->capacity * sizeof(rif_val_t *));
-  memset(zero_start, 0, zero_bytes);
+  return _rif_arraylist_resize(al_ptr, al_ptr->size);
+}
 
-  // Done.
-  al_ptr->capacity = needed_capacity;
+rif_status_t rif_arraylist_set_growth(rif_arraylist_t *al_ptr, rif_arraylist_growth_t growth) {
+  if (!al_ptr->free_elements && RIF_ARRAYLIST_GROWTH_FIXED != growth) {
+    return RIF_ERR_CAPACITY;
+  }
+  al_ptr->growth = growth;
+  if (RIF_ARRAYLIST_GROWTH_FIXED == growth) {
+    al_ptr->autoshrink = false;
+  }
   return RIF_OK;
 }
 
+void rif_arraylist_set_autoshrink(rif_arraylist_t *al_ptr, bool autoshrink) {
+  al_ptr->autoshrink = autoshrink && al_ptr->free_elements && RIF_ARRAYLIST_GROWTH_FIXED != al_ptr->growth;
+}
+
 /******************************************************************************
  * CALLBACK FUNCTIONS
  */
@@ -119,14 +255,20 @@ void rif_arraylist_destroy_callback(rif_arraylist_t *al_ptr) {
  */
 
 rif_status_t rif_arraylist_insert(rif_arraylist_t *al_ptr, uint32_t index, rif_val_t *val_ptr) {
+  return rif_arraylist_insert_steal(al_ptr, index, rif_val_retain(val_ptr));
+}
+
+rif_status_t rif_arraylist_insert_steal(rif_arraylist_t *al_ptr, uint32_t index, rif_val_t *val_ptr) {
 
   // Check index and ensure sufficient capacity.
   if (__unlikely(index > al_ptr->size)) {
+    rif_val_release(val_ptr);
     return RIF_ERR_OUT_OF_BOUNDS;
   }
-  rif_status_t ensure_capacity_status = rif_arraylist_ensure_capacity(al_ptr, al_ptr->size + 1);
-  if (__unlikely(RIF_OK != ensure_capacity_status)) {
-    return ensure_capacity_status;
+  rif_status_t grow_status = _rif_arraylist_grow(al_ptr, al_ptr->size + 1);
+  if (__unlikely(RIF_OK != grow_status)) {
+    rif_val_release(val_ptr);
+    return grow_status;
   }
 
   // Shift subsequent elements by one, if any.
@@ -135,10 +277,7 @@ rif_status_t rif_arraylist_insert(rif_arraylist_t *al_ptr, uint32_t index, rif_v
     memmove(elem_ptr + 1, elem_ptr, sizeof(rif_val_t *) * (al_ptr->size - index));
   }
 
-  // Retain the new value, and put it in place.
-  if (__likely(NULL != val_ptr)) {
-    rif_val_retain(val_ptr);
-  }
+  // Put the new value in place, it already holds a reference for the list.
   *elem_ptr = val_ptr;
 
   ++al_ptr->size;
@@ -184,5 +323,6 @@ rif_status_t rif_arraylist_remove(rif_arraylist_t *al_ptr, uint32_t index) {
   }
 
   --al_ptr->size;
+  _rif_arraylist_maybe_shrink(al_ptr);
   return RIF_OK;
 }
\ No newline at end of file
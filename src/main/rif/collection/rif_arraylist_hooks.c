@@ -51,6 +51,11 @@ rif_status_t _rif_arraylist_hook_append(rif_list_t *list_ptr, rif_val_t *val_ptr
   return rif_arraylist_append((rif_arraylist_t *) list_ptr, val_ptr);
 }
 
+static
+rif_status_t _rif_arraylist_hook_append_steal(rif_list_t *list_ptr, rif_val_t *val_ptr) {
+  return rif_arraylist_append_steal((rif_arraylist_t *) list_ptr, val_ptr);
+}
+
 static
 rif_status_t _rif_arraylist_hook_prepend(rif_list_t *list_ptr, rif_val_t *val_ptr) {
   return rif_arraylist_prepend((rif_arraylist_t *) list_ptr, val_ptr);
@@ -87,6 +92,7 @@ const rif_list_hooks_t rif_arraylist_hooks = {
     .get           = _rif_arraylist_hook_get,
     .insert        = _rif_arraylist_hook_insert,
     .append        = _rif_arraylist_hook_append,
+    .append_steal  = _rif_arraylist_hook_append_steal,
     .prepend       = _rif_arraylist_hook_prepend,
     .set           = _rif_arraylist_hook_set,
     .remove        = _rif_arraylist_hook_remove,
@@ -30,22 +30,19 @@
 
 #define MIN_CAPACITY 8
 
+#define LOOKUP_BATCH 16
+
 #define slot_distance(__capacity, __hash, __index) \
     (rif_mod_pow2((__index + __capacity - rif_mod_pow2(__hash, __capacity)), __capacity))
 
-#define is_deleted(__hash) ((__hash >> 31) != 0)
-
 static inline
-uint32_t _rif_hashmap_hash(const rif_val_t *val_ptr, uint64_t salt) {
+uint32_t _rif_hashmap_hash(const rif_hashmap_t *hm_ptr, const rif_val_t *val_ptr) {
 
   // Hash the value
   uint32_t hash = rif_val_hashcode(val_ptr);
 
-  // Mix with hashmap element address for salt
-  hash = rif_hash_mix_32(hash, rif_hash_64((uint64_t) salt));
-
-  // Clear most significant bit (used to mark deleted elements)
-  hash &= 0x7fffffff;
+  // Mix with the map seed
+  hash = rif_hash_mix_32(hash, hm_ptr->seed);
 
   // Ensure we are not returning 0 (used to mark free slots)
   hash |= hash == 0;
@@ -53,6 +50,65 @@ uint32_t _rif_hashmap_hash(const rif_val_t *val_ptr, uint64_t salt) {
   return hash;
 }
 
+/*
+ * Places an element known not to be in the map, starting at `pos`, `dist` slots away from its ideal position.
+ *
+ * Element hashes do not depend on the element array, so elements can be moved to another array without hashing their
+ * keys again.
+ */
+static inline
+void _rif_hashmap_place(
+    rif_hashmap_element_t *elements, uint32_t capacity, uint32_t pos, uint32_t dist, rif_hashmap_element_t element) {
+  while (true) {
+    rif_hashmap_element_t *cur = elements + pos;
+    if (0 == cur->hash) {
+      *cur = element;
+      return;
+    }
+    uint32_t cur_dist = slot_distance(capacity, cur->hash, pos);
+    if (cur_dist < dist) {
+      rif_swap(*cur, element);
+      dist = cur_dist;
+    }
+    pos = rif_mod_pow2(pos + 1, capacity);
+    ++dist;
+  }
+}
+
+/*
+ * Frees the slot at `pos`, shifting the following elements of the probe sequence back, until we reach a free slot or
+ * an element at its ideal position.
+ */
+static
+void _rif_hashmap_erase(rif_hashmap_element_t *elements, uint32_t capacity, uint32_t pos) {
+  while (true) {
+    uint32_t next_pos = rif_mod_pow2(pos + 1, capacity);
+    rif_hashmap_element_t *next = elements + next_pos;
+    if (0 == next->hash || 0 == slot_distance(capacity, next->hash, next_pos)) {
+      break;
+    }
+    elements[pos] = *next;
+    pos = next_pos;
+  }
+
+  // Free the last slot of the shifted sequence
+  elements[pos].hash = 0;
+  elements[pos].key_ptr = NULL;
+  elements[pos].val_ptr = NULL;
+}
+
+static
+void _rif_hashmap_release_elements(rif_hashmap_element_t *elements, uint32_t capacity) {
+  uint32_t pos = 0;
+  for (; pos < capacity; ++pos) {
+    rif_hashmap_element_t *cur = elements + pos;
+    if (cur->hash) {
+      rif_val_release(cur->key_ptr);
+      rif_val_release(cur->val_ptr);
+    }
+  }
+}
+
 /******************************************************************************
  * LIFECYCLE FUNCTIONS
  */
@@ -67,7 +123,14 @@ rif_hashmap_t * _rif_hashmap_build(rif_hashmap_t *hm_ptr, bool free, uint32_t ca
   hm_ptr->elements = NULL;
   hm_ptr->free_elements = true;
   hm_ptr->size = 0;
+  hm_ptr->max_load_factor = RIF_HASHMAP_DEFAULT_MAX_LOAD_FACTOR;
+  hm_ptr->seed = rif_hash_64((uint64_t) (uintptr_t) hm_ptr);
   hm_ptr->fixed = fixed;
+  hm_ptr->incremental = false;
+  hm_ptr->old_elements = NULL;
+  hm_ptr->old_capacity = 0;
+  hm_ptr->old_size = 0;
+  hm_ptr->rehash_pos = 0;
 
   // Allocate element array if needed.
   if (capacity && RIF_OK != rif_hashmap_ensure_capacity(hm_ptr, capacity)) {
@@ -81,14 +144,20 @@ rif_hashmap_t * rif_hashmap_init(rif_hashmap_t *hm_ptr, uint32_t capacity, bool
   return _rif_hashmap_build(hm_ptr, false, capacity, fixed);
 }
 
+rif_hashmap_t * rif_hashmap_new(uint32_t capacity, bool fixed) {
+  rif_hashmap_t *hm_ptr = rif_malloc(sizeof(rif_hashmap_t), "RIF_HASHMAP_NEW");
+  if (hm_ptr && !_rif_hashmap_build(hm_ptr, true, capacity, fixed)) {
+    rif_free(hm_ptr);
+    return NULL;
+  }
+  return hm_ptr;
+}
+
 void rif_hashmap_destroy_callback(rif_hashmap_t *hm_ptr) {
-  uint32_t pos = 0;
-  for (; pos < hm_ptr->capacity; ++pos) {
-    rif_hashmap_element_t *cur = hm_ptr->elements + pos;
-    if (cur->hash && !is_deleted(cur->hash)) {
-      rif_val_release(cur->key_ptr);
-      rif_val_release(cur->val_ptr);
-    }
+  _rif_hashmap_release_elements(hm_ptr->elements, hm_ptr->capacity);
+  if (hm_ptr->old_elements) {
+    _rif_hashmap_release_elements(hm_ptr->old_elements, hm_ptr->old_capacity);
+    rif_free(hm_ptr->old_elements);
   }
   if (hm_ptr->free_elements) {
     rif_free(hm_ptr->elements);
@@ -99,27 +168,97 @@ void rif_hashmap_destroy_callback(rif_hashmap_t *hm_ptr) {
  * SIZING FUNCTIONS
  */
 
-// Forward declare the put helper we need
-static inline
-uint32_t _rif_hashmap_put_helper(
-    rif_hashmap_element_t *elements, uint32_t capacity, rif_val_t *key_ptr, rif_val_t *val_ptr);
-
 static inline
 void _rif_hashmap_remap(rif_hashmap_t *hm_ptr, rif_hashmap_element_t *to, uint32_t to_capacity) {
   uint32_t pos = 0;
   for (; pos < hm_ptr->capacity; ++pos) {
     rif_hashmap_element_t *cur = hm_ptr->elements + pos;
-    if (cur->hash && !is_deleted(cur->hash)) {
-      _rif_hashmap_put_helper(to, to_capacity, cur->key_ptr, cur->val_ptr);
+    if (cur->hash) {
+      _rif_hashmap_place(to, to_capacity, rif_mod_pow2(cur->hash, to_capacity), 0, *cur);
     }
   }
 }
 
-rif_status_t rif_hashmap_ensure_capacity(rif_hashmap_t *hm_ptr, uint32_t capacity) {
+static
+rif_status_t _rif_hashmap_resize(rif_hashmap_t *hm_ptr, uint32_t capacity) {
+
+  // Allocate memory.
+  rif_hashmap_element_t *new_elements = rif_calloc(capacity, sizeof(rif_hashmap_element_t), "HASHMAP_CAPACITY_ALLOC");
+  if (new_elements == NULL) {
+    return RIF_ERR_MEMORY;
+  }
+
+  // Remap values
+  if (hm_ptr->size) {
+    _rif_hashmap_remap(hm_ptr, new_elements, capacity);
+  }
+
+  // Free existing array
+  rif_free(hm_ptr->elements);
+  hm_ptr->elements = new_elements;
+
+  // Done.
+  hm_ptr->capacity = capacity;
+  return RIF_OK;
+}
+
+/*
+ * Migrates up to `steps` slots of the previous element array. Each step either skips a free slot, or moves one
+ * element; shifting the following elements back may refill the slot, in which case it is migrated again by the next
+ * step. Slots before `rehash_pos` are free, and stay so as elements are only ever shifted back into removed ones.
+ */
+static
+void _rif_hashmap_rehash(rif_hashmap_t *hm_ptr, uint32_t steps) {
+  while (hm_ptr->old_size && steps--) {
+    rif_hashmap_element_t *cur = hm_ptr->old_elements + hm_ptr->rehash_pos;
+    if (cur->hash) {
+      _rif_hashmap_place(hm_ptr->elements, hm_ptr->capacity, rif_mod_pow2(cur->hash, hm_ptr->capacity), 0, *cur);
+      _rif_hashmap_erase(hm_ptr->old_elements, hm_ptr->old_capacity, hm_ptr->rehash_pos);
+      --hm_ptr->old_size;
+    } else {
+      ++hm_ptr->rehash_pos;
+    }
+  }
+
+  // Free the previous array once drained
+  if (hm_ptr->old_elements && 0 == hm_ptr->old_size) {
+    rif_free(hm_ptr->old_elements);
+    hm_ptr->old_elements = NULL;
+    hm_ptr->old_capacity = 0;
+    hm_ptr->rehash_pos = 0;
+  }
+}
+
+/*
+ * Allocates a new element array, and keeps the current one around to be migrated by `_rif_hashmap_rehash`.
+ */
+static
+rif_status_t _rif_hashmap_start_rehash(rif_hashmap_t *hm_ptr, uint32_t capacity) {
+
+  // Allocate memory.
+  rif_hashmap_element_t *new_elements = rif_calloc(capacity, sizeof(rif_hashmap_element_t), "HASHMAP_CAPACITY_ALLOC");
+  if (new_elements == NULL) {
+    return RIF_ERR_MEMORY;
+  }
+
+  // Swap arrays
+  hm_ptr->old_elements = hm_ptr->elements;
+  hm_ptr->old_capacity = hm_ptr->capacity;
+  hm_ptr->old_size = hm_ptr->size;
+  hm_ptr->rehash_pos = 0;
+  hm_ptr->elements = new_elements;
+  hm_ptr->capacity = capacity;
+
+  // Done.
+  return RIF_OK;
+}
+
+static
+rif_status_t _rif_hashmap_reserve(rif_hashmap_t *hm_ptr, uint32_t capacity, bool incremental) {
 
   // Calculate the capacity we need to allocate.
   capacity = rif_max(MIN_CAPACITY, capacity);
-  uint32_t needed_capacity = rif_next_pow2(capacity + capacity / 10);
+  uint32_t needed_capacity = rif_hashmap_capacity_helper(capacity, hm_ptr->max_load_factor);
 
   // Maybe we don't need to do anything.
   if (needed_capacity <= hm_ptr->capacity) {
@@ -131,62 +270,176 @@ rif_status_t rif_hashmap_ensure_capacity(rif_hashmap_t *hm_ptr, uint32_t capacit
     return RIF_ERR_CAPACITY;
   }
 
-  // Allocate memory.
-  rif_hashmap_element_t *new_elements =
-      rif_calloc(needed_capacity, sizeof(rif_hashmap_element_t), "HASHMAP_CAPACITY_ALLOC");
-  if (new_elements == NULL) {
-    return RIF_ERR_MEMORY;
+  // Only two element arrays may coexist, so complete any migration in progress first.
+  _rif_hashmap_rehash(hm_ptr, UINT32_MAX);
+
+  if (incremental && hm_ptr->size) {
+    return _rif_hashmap_start_rehash(hm_ptr, needed_capacity);
   }
+  return _rif_hashmap_resize(hm_ptr, needed_capacity);
+}
 
-  // Remap values
-  if (hm_ptr->size) {
-    _rif_hashmap_remap(hm_ptr, new_elements, needed_capacity);
+rif_status_t rif_hashmap_ensure_capacity(rif_hashmap_t *hm_ptr, uint32_t capacity) {
+  return _rif_hashmap_reserve(hm_ptr, capacity, false);
+}
+
+rif_status_t rif_hashmap_shrink_to_fit(rif_hashmap_t *hm_ptr) {
+
+  // Fixed maps keep their capacity.
+  if (hm_ptr->fixed) {
+    return RIF_ERR_CAPACITY;
   }
 
-  // Free existing array
-  rif_free(hm_ptr->elements);
-  hm_ptr->elements = new_elements;
+  // Complete any migration in progress.
+  _rif_hashmap_rehash(hm_ptr, UINT32_MAX);
+
+  // Release the storage of empty maps altogether.
+  if (0 == hm_ptr->size) {
+    rif_free(hm_ptr->elements);
+    hm_ptr->elements = NULL;
+    hm_ptr->capacity = 0;
+    return RIF_OK;
+  }
+
+  // Maybe we don't need to do anything.
+  uint32_t needed_capacity =
+      rif_hashmap_capacity_helper(rif_max(MIN_CAPACITY, hm_ptr->size), hm_ptr->max_load_factor);
+  if (needed_capacity >= hm_ptr->capacity) {
+    return RIF_OK;
+  }
+
+  return _rif_hashmap_resize(hm_ptr, needed_capacity);
+}
+
+rif_status_t rif_hashmap_set_max_load_factor(rif_hashmap_t *hm_ptr, float max_load_factor) {
+
+  // Check bounds.
+  if (!(max_load_factor > 0 && max_load_factor <= 1)) {
+    return RIF_ERR_OUT_OF_BOUNDS;
+  }
+
+  // Grow the map if its elements no longer fit, or restore the previous load factor if we can't.
+  float previous_max_load_factor = hm_ptr->max_load_factor;
+  hm_ptr->max_load_factor = max_load_factor;
+  if (hm_ptr->size) {
+    rif_status_t ensure_capacity_status = rif_hashmap_ensure_capacity(hm_ptr, hm_ptr->size);
+    if (RIF_OK != ensure_capacity_status) {
+      hm_ptr->max_load_factor = previous_max_load_factor;
+      return ensure_capacity_status;
+    }
+  }
 
-  // Done.
-  hm_ptr->capacity = needed_capacity;
   return RIF_OK;
 }
 
+void rif_hashmap_set_incremental(rif_hashmap_t *hm_ptr, bool incremental) {
+  hm_ptr->incremental = incremental;
+  if (!incremental) {
+    _rif_hashmap_rehash(hm_ptr, UINT32_MAX);
+  }
+}
+
+bool rif_hashmap_rehash_step(rif_hashmap_t *hm_ptr, uint32_t steps) {
+  _rif_hashmap_rehash(hm_ptr, steps);
+  return rif_hashmap_isrehashing(hm_ptr);
+}
+
 /******************************************************************************
  * ELEMENT READ FUNCTIONS
  */
 
 static
-rif_hashmap_element_t * _rif_hashmap_locate(const rif_hashmap_t *hm_ptr, const rif_val_t *key_ptr) {
-
-  // Hash the key
-  uint32_t hash = _rif_hashmap_hash(key_ptr, (uint64_t) hm_ptr->elements);
-
-  // If the map is not yet allocated, return
-  if (0 == hm_ptr->capacity) {
-    return NULL;
-  }
+rif_hashmap_element_t * _rif_hashmap_locate_in(
+    rif_hashmap_element_t *elements, uint32_t capacity, uint32_t hash, const rif_val_t *key_ptr) {
 
   // Setup counters
-  uint32_t pos = hash % hm_ptr->capacity;
+  uint32_t pos = rif_mod_pow2(hash, capacity);
   uint32_t dist = 0;
 
-  // Lookup element
+  // Lookup element, matching the same key instance (such as an interned string) without calling into its callbacks
   while (true) {
-    rif_hashmap_element_t *cur = hm_ptr->elements + pos;
-    if (hash == cur->hash && rif_val_equals(cur->key_ptr, key_ptr)) {
+    rif_hashmap_element_t *cur = elements + pos;
+    if (hash == cur->hash && (cur->key_ptr == key_ptr || rif_val_equals(cur->key_ptr, key_ptr))) {
       return cur;
     } else if (0 == cur->hash) {
       return NULL;
-    } else if (dist > slot_distance(hm_ptr->capacity, cur->hash, pos)) {
+    } else if (dist > slot_distance(capacity, cur->hash, pos)) {
       return NULL;
     }
-    pos = rif_mod_pow2(pos + 1, hm_ptr->capacity);
+    pos = rif_mod_pow2(pos + 1, capacity);
     ++dist;
   }
 
 }
 
+static inline
+rif_hashmap_element_t * _rif_hashmap_locate_hashed(
+    const rif_hashmap_t *hm_ptr, uint32_t hash, const rif_val_t *key_ptr) {
+
+  // Lookup element, in the previous element array as well if it is being migrated
+  rif_hashmap_element_t *elem_ptr = _rif_hashmap_locate_in(hm_ptr->elements, hm_ptr->capacity, hash, key_ptr);
+  if (NULL == elem_ptr && hm_ptr->old_elements) {
+    elem_ptr = _rif_hashmap_locate_in(hm_ptr->old_elements, hm_ptr->old_capacity, hash, key_ptr);
+  }
+  return elem_ptr;
+
+}
+
+static
+rif_hashmap_element_t * _rif_hashmap_locate(const rif_hashmap_t *hm_ptr, const rif_val_t *key_ptr) {
+
+  // If the map is not yet allocated, return
+  if (0 == hm_ptr->capacity) {
+    return NULL;
+  }
+
+  return _rif_hashmap_locate_hashed(hm_ptr, _rif_hashmap_hash(hm_ptr, key_ptr), key_ptr);
+}
+
+/*
+ * Looks up to `LOOKUP_BATCH` keys up, one stage at a time for the whole batch, so that the cache misses of a stage
+ * overlap: the keys are prefetched, then hashed while their home slots are prefetched, then the keys stored in
+ * matching home slots are prefetched, and only then are probe sequences resolved.
+ */
+static
+void _rif_hashmap_locate_batch(
+    const rif_hashmap_t *hm_ptr, rif_val_t * const *key_ptrs, uint32_t count, rif_hashmap_element_t **elem_ptrs) {
+  uint32_t hashes[LOOKUP_BATCH];
+  uint32_t i;
+
+  // If the map is not yet allocated, nothing is found
+  if (0 == hm_ptr->capacity) {
+    for (i = 0; i < count; ++i) {
+      elem_ptrs[i] = NULL;
+    }
+    return;
+  }
+
+  // Prefetch the keys to hash
+  for (i = 0; i < count; ++i) {
+    __prefetch(key_ptrs[i]);
+  }
+
+  // Hash keys and prefetch their home slots
+  for (i = 0; i < count; ++i) {
+    hashes[i] = _rif_hashmap_hash(hm_ptr, key_ptrs[i]);
+    __prefetch(hm_ptr->elements + rif_mod_pow2(hashes[i], hm_ptr->capacity));
+  }
+
+  // Prefetch the keys to compare with
+  for (i = 0; i < count; ++i) {
+    rif_hashmap_element_t *home = hm_ptr->elements + rif_mod_pow2(hashes[i], hm_ptr->capacity);
+    if (hashes[i] == home->hash) {
+      __prefetch(home->key_ptr);
+    }
+  }
+
+  // Resolve probe sequences
+  for (i = 0; i < count; ++i) {
+    elem_ptrs[i] = _rif_hashmap_locate_hashed(hm_ptr, hashes[i], key_ptrs[i]);
+  }
+}
+
 bool rif_hashmap_exists(const rif_hashmap_t *hm_ptr, const rif_val_t *key_ptr) {
   return NULL != _rif_hashmap_locate(hm_ptr, key_ptr);
 }
@@ -196,10 +449,44 @@ rif_val_t * rif_hashmap_get(const rif_hashmap_t *hm_ptr, const rif_val_t *key_pt
   return NULL == elem_ptr ? NULL : elem_ptr->val_ptr;
 }
 
+uint32_t rif_hashmap_get_many(
+    const rif_hashmap_t *hm_ptr, rif_val_t * const *key_ptrs, uint32_t count, rif_val_t **val_ptrs) {
+  rif_hashmap_element_t *elem_ptrs[LOOKUP_BATCH];
+  uint32_t found = 0;
+  uint32_t base = 0;
+  for (; base < count; base += LOOKUP_BATCH) {
+    uint32_t batch = rif_min(LOOKUP_BATCH, count - base);
+    uint32_t i = 0;
+    _rif_hashmap_locate_batch(hm_ptr, key_ptrs + base, batch, elem_ptrs);
+    for (; i < batch; ++i) {
+      val_ptrs[base + i] = NULL == elem_ptrs[i] ? NULL : elem_ptrs[i]->val_ptr;
+      found += NULL != elem_ptrs[i];
+    }
+  }
+  return found;
+}
+
+uint32_t rif_hashmap_exists_many(const rif_hashmap_t *hm_ptr, rif_val_t * const *key_ptrs, uint32_t count, bool *exists) {
+  rif_hashmap_element_t *elem_ptrs[LOOKUP_BATCH];
+  uint32_t found = 0;
+  uint32_t base = 0;
+  for (; base < count; base += LOOKUP_BATCH) {
+    uint32_t batch = rif_min(LOOKUP_BATCH, count - base);
+    uint32_t i = 0;
+    _rif_hashmap_locate_batch(hm_ptr, key_ptrs + base, batch, elem_ptrs);
+    for (; i < batch; ++i) {
+      exists[base + i] = NULL != elem_ptrs[i];
+      found += exists[base + i];
+    }
+  }
+  return found;
+}
+
 rif_hashmap_element_t * rif_hashmap_atindex(const rif_hashmap_t *hm_ptr, uint32_t index) {
-  assert(index < rif_hashmap_capacity(hm_ptr));
-  rif_hashmap_element_t *atindex = hm_ptr->elements + index;
-  if (!atindex->hash || is_deleted(atindex->hash)) {
+  assert(index < rif_hashmap_capacity(hm_ptr) + hm_ptr->old_capacity);
+  rif_hashmap_element_t *atindex = index < hm_ptr->capacity ?
+      hm_ptr->elements + index : hm_ptr->old_elements + (index - hm_ptr->capacity);
+  if (!atindex->hash) {
     return NULL;
   }
   return atindex;
@@ -210,66 +497,91 @@ rif_hashmap_element_t * rif_hashmap_atindex(const rif_hashmap_t *hm_ptr, uint32_
  */
 
 static inline
-uint32_t _rif_hashmap_put_helper(
-    rif_hashmap_element_t *elements, uint32_t capacity, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+uint32_t _rif_hashmap_put_helper(rif_hashmap_t *hm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
 
   // Compute hash
-  uint32_t hash = _rif_hashmap_hash(key_ptr, (uint64_t) elements);
+  uint32_t hash = _rif_hashmap_hash(hm_ptr, key_ptr);
+
+  // Replace an element not migrated yet in place
+  if (hm_ptr->old_elements) {
+    rif_hashmap_element_t *old_ptr =
+        _rif_hashmap_locate_in(hm_ptr->old_elements, hm_ptr->old_capacity, hash, key_ptr);
+    if (old_ptr) {
+      rif_val_release(old_ptr->key_ptr);
+      rif_val_release(old_ptr->val_ptr);
+      old_ptr->key_ptr = key_ptr;
+      old_ptr->val_ptr = val_ptr;
+      return 0;
+    }
+  }
 
   // Setup counters
-  uint32_t pos = hash % capacity;
+  uint32_t pos = rif_mod_pow2(hash, hm_ptr->capacity);
   uint32_t dist = 0;
 
-  // Position element
+  // Look for an existing element, up to the first slot the key cannot be past
   while (true) {
-
-    rif_hashmap_element_t *cur = elements + pos;
-    if (hash == cur->hash && rif_val_equals(cur->key_ptr, key_ptr)) {
+    rif_hashmap_element_t *cur = hm_ptr->elements + pos;
+    if (0 == cur->hash || dist > slot_distance(hm_ptr->capacity, cur->hash, pos)) {
+      break;
+    } else if (hash == cur->hash && (cur->key_ptr == key_ptr || rif_val_equals(cur->key_ptr, key_ptr))) {
       rif_val_release(cur->key_ptr);
       rif_val_release(cur->val_ptr);
       cur->key_ptr = key_ptr;
       cur->val_ptr = val_ptr;
       return 0;
-    } else if (0 == cur->hash) {
-      cur->hash = hash;
-      cur->key_ptr = key_ptr;
-      cur->val_ptr = val_ptr;
-      return 1;
     }
-
-    uint32_t cur_dist = slot_distance(capacity, cur->hash, pos);
-
-    if (cur_dist < dist) {
-      if (is_deleted(cur->hash)) {
-        cur->hash = hash;
-        cur->key_ptr = key_ptr;
-        cur->val_ptr = val_ptr;
-        return 1;
-      }
-      rif_swap(cur->hash, hash);
-      rif_swap(cur->key_ptr, key_ptr);
-      rif_swap(cur->val_ptr, val_ptr);
-      dist = cur_dist;
-    }
-
-    pos = rif_mod_pow2(pos + 1, capacity);
+    pos = rif_mod_pow2(pos + 1, hm_ptr->capacity);
     ++dist;
   }
 
+  // Position the new element
+  rif_hashmap_element_t element = {hash, key_ptr, val_ptr};
+  _rif_hashmap_place(hm_ptr->elements, hm_ptr->capacity, pos, dist, element);
+  return 1;
 }
 
 rif_status_t rif_hashmap_put(rif_hashmap_t *hm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+  return rif_hashmap_put_steal(hm_ptr, rif_val_retain(key_ptr), rif_val_retain(val_ptr));
+}
+
+rif_status_t rif_hashmap_put_steal(rif_hashmap_t *hm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+
+  // Migrate part of the previous element array
+  _rif_hashmap_rehash(hm_ptr, RIF_HASHMAP_REHASH_STEP);
 
   // Ensure we got sufficient capacity
-  rif_status_t ensure_capacity_status = rif_hashmap_ensure_capacity(hm_ptr, hm_ptr->size + 1);
+  rif_status_t ensure_capacity_status = _rif_hashmap_reserve(hm_ptr, hm_ptr->size + 1, hm_ptr->incremental);
   if (RIF_OK != ensure_capacity_status) {
+    rif_val_release(key_ptr);
+    rif_val_release(val_ptr);
     return ensure_capacity_status;
   }
 
-  // Insert the element
-  rif_val_retain(key_ptr);
-  rif_val_retain(val_ptr);
-  hm_ptr->size += _rif_hashmap_put_helper(hm_ptr->elements, hm_ptr->capacity, key_ptr, val_ptr);
+  // Insert the element, the caller references become the map ones
+  hm_ptr->size += _rif_hashmap_put_helper(hm_ptr, key_ptr, val_ptr);
+
+  // Done
+  return RIF_OK;
+}
+
+rif_status_t rif_hashmap_put_many(
+    rif_hashmap_t *hm_ptr, rif_val_t * const *key_ptrs, rif_val_t * const *val_ptrs, uint32_t count) {
+
+  // Ensure we got sufficient capacity for every element at once
+  rif_status_t ensure_capacity_status = _rif_hashmap_reserve(hm_ptr, hm_ptr->size + count, hm_ptr->incremental);
+  if (RIF_OK != ensure_capacity_status) {
+    return ensure_capacity_status;
+  }
+
+  // Insert the elements
+  uint32_t i = 0;
+  for (; i < count; ++i) {
+    _rif_hashmap_rehash(hm_ptr, RIF_HASHMAP_REHASH_STEP);
+    rif_val_retain(key_ptrs[i]);
+    rif_val_retain(val_ptrs[i]);
+    hm_ptr->size += _rif_hashmap_put_helper(hm_ptr, key_ptrs[i], val_ptrs[i]);
+  }
 
   // Done
   return RIF_OK;
@@ -289,14 +601,24 @@ rif_status_t rif_hashmap_remove(rif_hashmap_t *hm_ptr, rif_val_t *key_ptr) {
     return RIF_OK;
   }
 
-  // Mark the element as deleted
-  elem_ptr->hash |= 0x80000000;
-  rif_val_release(elem_ptr->key_ptr);
-  rif_val_release(elem_ptr->val_ptr);
-  elem_ptr->val_ptr = NULL;
+  rif_val_t *removed_key_ptr = elem_ptr->key_ptr;
+  rif_val_t *removed_val_ptr = elem_ptr->val_ptr;
+
+  // Free the slot, in whichever element array holds it
+  if (elem_ptr >= hm_ptr->elements && elem_ptr < hm_ptr->elements + hm_ptr->capacity) {
+    _rif_hashmap_erase(hm_ptr->elements, hm_ptr->capacity, (uint32_t) (elem_ptr - hm_ptr->elements));
+  } else {
+    _rif_hashmap_erase(hm_ptr->old_elements, hm_ptr->old_capacity, (uint32_t) (elem_ptr - hm_ptr->old_elements));
+    --hm_ptr->old_size;
+  }
 
   // Do the bookkeeping
   --hm_ptr->size;
+  rif_val_release(removed_key_ptr);
+  rif_val_release(removed_val_ptr);
+
+  // Migrate part of the previous element array
+  _rif_hashmap_rehash(hm_ptr, RIF_HASHMAP_REHASH_STEP);
 
   return RIF_OK;
-}
\ No newline at end of file
+}
@@ -51,6 +51,11 @@ rif_status_t _rif_hashmap_hook_put(rif_map_t *map_ptr, rif_val_t *key_ptr, rif_v
   return rif_hashmap_put((rif_hashmap_t *) map_ptr, key_ptr, val_ptr);
 }
 
+static
+rif_status_t _rif_hashmap_hook_put_steal(rif_map_t *map_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+  return rif_hashmap_put_steal((rif_hashmap_t *) map_ptr, key_ptr, val_ptr);
+}
+
 static
 rif_status_t _rif_hashmap_hook_remove(rif_map_t *map_ptr, rif_val_t *key_ptr) {
   return rif_hashmap_remove((rif_hashmap_t *) map_ptr, key_ptr);
@@ -78,6 +83,7 @@ const rif_map_hooks_t rif_hashmap_hooks = {
     .exists        = _rif_hashmap_hook_exists,
     .get           = _rif_hashmap_hook_get,
     .put           = _rif_hashmap_hook_put,
+    .put_steal     = _rif_hashmap_hook_put_steal,
     .remove        = _rif_hashmap_hook_remove,
     .iterator_init = _rif_hashmap_hook_iterator_init,
     .iterator_new  = _rif_hashmap_hook_iterator_new
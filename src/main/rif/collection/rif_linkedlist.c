@@ -32,31 +32,36 @@
  */
 
 static inline
-rif_linkedlist_node_t * _rif_linkedlist_node_select_atindex_asc(const rif_linkedlist_t *ll_ptr, uint32_t index) {
-  rif_linkedlist_node_t *node_ptr = ll_ptr->first;
-  while (index > 0 && NULL != node_ptr) {
-    --index;
+rif_linkedlist_node_t * _rif_linkedlist_node_walk(rif_linkedlist_node_t *node_ptr, uint32_t from, uint32_t to) {
+  for (; from < to; ++from) {
     node_ptr = node_ptr->succ;
   }
-  return node_ptr;
-}
-
-static inline
-rif_linkedlist_node_t * _rif_linkedlist_node_select_atindex_desc(const rif_linkedlist_t *ll_ptr, uint32_t index) {
-  rif_linkedlist_node_t *node_ptr = ll_ptr->last;
-  index = ll_ptr->size - index - 1;
-  while (index > 0 && NULL != node_ptr) {
-    --index;
+  for (; from > to; --from) {
     node_ptr = node_ptr->pred;
   }
   return node_ptr;
 }
 
+/*
+ * Selects the node at `index`, which must be lower than the list size, walking from whichever of the first node, the
+ * last node or the cursor is nearest. The cursor is then moved to the selected node.
+ */
 static inline
 rif_linkedlist_node_t * _rif_linkedlist_node_select_atindex(const rif_linkedlist_t *ll_ptr, uint32_t index) {
-  return index < ll_ptr->size / 2 ?
-         _rif_linkedlist_node_select_atindex_asc(ll_ptr, index) :
-         _rif_linkedlist_node_select_atindex_desc(ll_ptr, index);
+  rif_linkedlist_t *mutable_ll_ptr = (rif_linkedlist_t *) ll_ptr;
+  rif_linkedlist_node_t *node_ptr;
+  uint32_t from_last = ll_ptr->size - index - 1;
+  uint32_t from_cursor = ll_ptr->cursor_index > index ? ll_ptr->cursor_index - index : index - ll_ptr->cursor_index;
+  if (NULL != ll_ptr->cursor && from_cursor < index && from_cursor < from_last) {
+    node_ptr = _rif_linkedlist_node_walk(ll_ptr->cursor, ll_ptr->cursor_index, index);
+  } else if (index <= from_last) {
+    node_ptr = _rif_linkedlist_node_walk(ll_ptr->first, 0, index);
+  } else {
+    node_ptr = _rif_linkedlist_node_walk(ll_ptr->last, ll_ptr->size - 1, index);
+  }
+  mutable_ll_ptr->cursor = node_ptr;
+  mutable_ll_ptr->cursor_index = index;
+  return node_ptr;
 }
 
 /******************************************************************************
@@ -71,11 +76,16 @@ rif_linkedlist_t * rif_linkedlist_build(rif_linkedlist_t *ll_ptr, bool free) {
   rif_list_init((rif_list_t *) ll_ptr, &rif_linkedlist_hooks, free);
   ll_ptr->first = NULL;
   ll_ptr->last = NULL;
+  ll_ptr->cursor = NULL;
+  ll_ptr->cursor_index = 0;
   ll_ptr->size = 0;
   if (!rif_paged_pool_init(&ll_ptr->pool, sizeof(rif_linkedlist_node_t), POOL_SIZE, true)) {
     rif_val_release(ll_ptr);
     return NULL;
   }
+
+  // Give memory back when the list shrinks, keeping one free block to absorb oscillations.
+  rif_paged_pool_set_max_free_blocks(&ll_ptr->pool, 1);
   return ll_ptr;
 }
 
@@ -107,8 +117,10 @@ void rif_linkedlist_destroy_callback(rif_linkedlist_t *ll_ptr) {
  */
 
 rif_val_t * rif_linkedlist_get(const rif_linkedlist_t *ll_ptr, uint32_t index) {
-  rif_linkedlist_node_t *node_ptr = _rif_linkedlist_node_select_atindex(ll_ptr, index);
-  return NULL != node_ptr ? node_ptr->val : NULL;
+  if (index >= ll_ptr->size) {
+    return NULL;
+  }
+  return _rif_linkedlist_node_select_atindex(ll_ptr, index)->val;
 }
 
 /******************************************************************************
@@ -116,6 +128,10 @@ rif_val_t * rif_linkedlist_get(const rif_linkedlist_t *ll_ptr, uint32_t index) {
  */
 
 rif_status_t rif_linkedlist_insert(rif_linkedlist_t *ll_ptr, uint32_t index, rif_val_t *val_ptr) {
+  return rif_linkedlist_insert_steal(ll_ptr, index, rif_val_retain(val_ptr));
+}
+
+rif_status_t rif_linkedlist_insert_steal(rif_linkedlist_t *ll_ptr, uint32_t index, rif_val_t *val_ptr) {
 
   // Find the element place in the list.
   rif_linkedlist_node_t *pred = NULL, *succ = NULL;
@@ -128,15 +144,16 @@ rif_status_t rif_linkedlist_insert(rif_linkedlist_t *ll_ptr, uint32_t index, rif
     succ = current;
     pred = current->pred;
   } else {
+    rif_val_release(val_ptr);
     return RIF_ERR_OUT_OF_BOUNDS;
   }
 
   // Allocate a new node.
   rif_linkedlist_node_t *new_node_ptr = rif_paged_pool_borrow(&ll_ptr->pool);
   if (NULL == new_node_ptr) {
+    rif_val_release(val_ptr);
     return RIF_ERR_MEMORY;
   }
-  rif_val_retain(val_ptr);
   new_node_ptr->val = val_ptr;
   new_node_ptr->pred = pred;
   new_node_ptr->succ = succ;
@@ -153,6 +170,10 @@ rif_status_t rif_linkedlist_insert(rif_linkedlist_t *ll_ptr, uint32_t index, rif
     ll_ptr->last = new_node_ptr;
   }
 
+  // Point the cursor to the new node, as the following elements have shifted.
+  ll_ptr->cursor = new_node_ptr;
+  ll_ptr->cursor_index = index;
+
   ++ll_ptr->size;
   return RIF_OK;
 }
@@ -194,6 +215,15 @@ rif_status_t rif_linkedlist_remove(rif_linkedlist_t *ll_ptr, uint32_t index) {
     ll_ptr->last = current->pred;
   }
 
+  // Point the cursor to the node which took its place, or to the new last node.
+  if (NULL != current->succ) {
+    ll_ptr->cursor = current->succ;
+    ll_ptr->cursor_index = index;
+  } else {
+    ll_ptr->cursor = current->pred;
+    ll_ptr->cursor_index = index - 1;
+  }
+
   // Free it.
   rif_val_release(current->val);
   rif_paged_pool_return(&ll_ptr->pool, current);
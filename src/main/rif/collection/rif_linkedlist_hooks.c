@@ -51,6 +51,11 @@ rif_status_t _rif_linkedlist_hook_append(rif_list_t *list_ptr, rif_val_t *val_pt
   return rif_linkedlist_append((rif_linkedlist_t *) list_ptr, val_ptr);
 }
 
+static
+rif_status_t _rif_linkedlist_hook_append_steal(rif_list_t *list_ptr, rif_val_t *val_ptr) {
+  return rif_linkedlist_append_steal((rif_linkedlist_t *) list_ptr, val_ptr);
+}
+
 static
 rif_status_t _rif_linkedlist_hook_prepend(rif_list_t *list_ptr, rif_val_t *val_ptr) {
   return rif_linkedlist_prepend((rif_linkedlist_t *) list_ptr, val_ptr);
@@ -87,6 +92,7 @@ const rif_list_hooks_t rif_linkedlist_hooks = {
     .get           = _rif_linkedlist_hook_get,
     .insert        = _rif_linkedlist_hook_insert,
     .append        = _rif_linkedlist_hook_append,
+    .append_steal  = _rif_linkedlist_hook_append_steal,
     .prepend       = _rif_linkedlist_hook_prepend,
     .set           = _rif_linkedlist_hook_set,
     .remove        = _rif_linkedlist_hook_remove,
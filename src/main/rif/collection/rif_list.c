@@ -23,15 +23,6 @@
 #include "rif/collection/rif_list_iterator.h"
 #include "rif/util/rif_hash.h"
 
-/******************************************************************************
- * DATA TYPES
- */
-
-struct rif_list_tostring_s {
-  char *str;
-  uint32_t len;
-};
-
 /******************************************************************************
  * LIFECYCLE FUNCTIONS
  */
@@ -74,60 +65,30 @@ bool rif_list_equals_callback(const rif_val_t *val_ptr, const rif_val_t *other_p
   rif_list_iterator_init(&second_it, second_ptr);
   rif_iterator_t *first_it_ptr = (rif_iterator_t *) &first_it;
   rif_iterator_t *second_it_ptr = (rif_iterator_t *) &second_it;
-  while (rif_iterator_hasnext(first_it_ptr) && rif_iterator_hasnext(second_it_ptr)) {
-    if (!rif_val_equals(rif_iterator_next(first_it_ptr), rif_iterator_next(second_it_ptr))) {
-      return false;
-    }
+  bool equals = true;
+  while (equals && rif_iterator_hasnext(first_it_ptr) && rif_iterator_hasnext(second_it_ptr)) {
+    equals = rif_val_equals(rif_iterator_next(first_it_ptr), rif_iterator_next(second_it_ptr));
   }
-  rif_val_release(&first_it);
-  rif_val_release(&second_it);
-  return rif_iterator_hasnext(first_it_ptr) == rif_iterator_hasnext(second_it_ptr);
+  equals = equals && rif_iterator_hasnext(first_it_ptr) == rif_iterator_hasnext(second_it_ptr);
+  rif_iterator_destroy(first_it_ptr);
+  rif_iterator_destroy(second_it_ptr);
+  return equals;
 }
 
-char * rif_list_tostring_callback(const rif_val_t *val_ptr) {
-
-  // Collect element string representations and sizes.
+rif_status_t rif_list_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
   rif_list_t *list_ptr = rif_list_fromval(val_ptr);
-  uint32_t list_size = rif_list_size(list_ptr);
-  char *tostring_str = NULL;
-  struct rif_list_tostring_s element_tostring[list_size];
-  uint32_t tostring_str_len = 0;
-  uint32_t i = 0;
-  for (; i < list_size; ++i) {
-    rif_val_t *element_ptr = rif_list_get(list_ptr, i);
-    element_tostring[i].str = element_ptr ? rif_val_tostring(element_ptr) : (char *) rif_undef_str;
-    if (!element_tostring[i].str) {
-      goto CLEANUP_EXIT;
-    }
-    element_tostring[i].len = (uint32_t) strlen(element_tostring[i].str);
-    tostring_str_len += element_tostring[i].len + 2;
-  }
-
-  // Create new string.
-  tostring_str_len += 3;
-  tostring_str = rif_malloc(sizeof(char) * tostring_str_len, "RIF_LIST_TOSTRING");
-  if (!tostring_str) {
-    goto CLEANUP_EXIT;
-  }
-  uint32_t pos = 1;
-  strcpy(tostring_str, "[");
-  uint32_t j = 0;
-  for (; j < list_size; ++j) {
-    strcpy(tostring_str + pos, element_tostring[j].str);
-    strncpy(tostring_str + pos + element_tostring[j].len, ", ", 2); // Do not copy the terminating NULL character.
-    pos += element_tostring[j].len + 2;
-  }
-  strcpy(tostring_str + pos - (pos == 1 ? 0 : 2), "]");
-
-  CLEANUP_EXIT:;
-
-  // Free underlying string representations.
-  uint32_t k = 0;
-  for (; k < i; ++k) {
-    if (element_tostring[k].str != rif_undef_str) {
-      rif_free(element_tostring[k].str);
+  rif_list_iterator_t it;
+  rif_list_iterator_init(&it, list_ptr);
+  rif_iterator_t *it_ptr = (rif_iterator_t *) &it;
+  rif_strbuf_append_char(sb_ptr, '[');
+  bool first = true;
+  while (rif_strbuf_status(sb_ptr) == RIF_OK && rif_iterator_hasnext(it_ptr)) {
+    if (!first) {
+      rif_strbuf_append(sb_ptr, ", ", 2);
     }
+    rif_val_write(rif_iterator_next(it_ptr), sb_ptr);
+    first = false;
   }
-
-  return tostring_str;
+  rif_iterator_destroy(it_ptr);
+  return rif_strbuf_append_char(sb_ptr, ']');
 }
\ No newline at end of file
@@ -45,12 +45,6 @@ uint32_t rif_queue_hashcode_callback(const rif_val_t *val_ptr) {
   return rif_hash_64((uint64_t) val_ptr);
 }
 
-char * rif_queue_tostring_callback(const rif_val_t *val_ptr) {
-rif_queue_t *queue_ptr = rif_queue_fromval(val_ptr);
-  char *tostring_str = rif_malloc(sizeof(char) * 28);
-  if (!tostring_str) {
-    return tostring_str;
-  }
-  snprintf(tostring_str, 28, "<Queue [items: %u]>", rif_queue_size(queue_ptr));
-  return tostring_str;
+rif_status_t rif_queue_write_callback(const rif_val_t *val_ptr, rif_strbuf_t *sb_ptr) {
+  return rif_strbuf_appendf(sb_ptr, "<Queue [items: %u]>", rif_queue_size(rif_queue_fromval(val_ptr)));
 }
\ No newline at end of file
@@ -0,0 +1,408 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "rif/rif_internal.h"
+
+#include "rif/collection/rif_swissmap.h"
+#include "rif/util/rif_hash.h"
+#include "rif/util/rif_math.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/******************************************************************************
+ * HELPERS
+ */
+
+#define MIN_CAPACITY RIF_SWISSMAP_GROUP_WIDTH
+
+#define CTRL_EMPTY   ((int8_t) -128)
+#define CTRL_DELETED ((int8_t) -2)
+
+#define NOT_FOUND UINT32_MAX
+
+#define h1(__hash) ((__hash) >> 7)
+#define h2(__hash) ((int8_t) ((__hash) & 0x7f))
+
+/*
+ * The map is rebuilt when more than 7/8 of its slots are used, which guarantees there is always a free slot to end
+ * probe sequences.
+ */
+#define max_growth(__capacity) ((__capacity) - (__capacity) / 8)
+
+static inline
+uint32_t _rif_swissmap_hash(const rif_swissmap_t *sm_ptr, const rif_val_t *key_ptr) {
+  return rif_hash_mix_32(rif_val_hashcode(key_ptr), sm_ptr->seed);
+}
+
+static inline
+uint32_t _rif_swissmap_capacity_for(uint32_t size) {
+  // Smallest power of two for which `max_growth(capacity) >= size`
+  uint32_t capacity = size ? size + (size - 1) / 7 : 0;
+  return rif_next_pow2(rif_max(MIN_CAPACITY, capacity));
+}
+
+/******************************************************************************
+ * GROUP FUNCTIONS
+ */
+
+/*
+ * Each function returns a bit mask of the slots of the group starting at `ctrl` matching a condition, lowest bit
+ * first.
+ */
+
+#ifdef __SSE2__
+
+static inline
+uint32_t _rif_swissmap_group_match(const int8_t *ctrl, int8_t h2) {
+  __m128i group = _mm_loadu_si128((const __m128i *) ctrl);
+  return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), group));
+}
+
+static inline
+uint32_t _rif_swissmap_group_match_empty(const int8_t *ctrl) {
+  return _rif_swissmap_group_match(ctrl, CTRL_EMPTY);
+}
+
+static inline
+uint32_t _rif_swissmap_group_match_empty_or_deleted(const int8_t *ctrl) {
+  // Free slots are the only ones with their sign bit set
+  return (uint32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) ctrl));
+}
+
+#else
+
+static inline
+uint32_t _rif_swissmap_group_match(const int8_t *ctrl, int8_t h2) {
+  uint32_t mask = 0;
+  uint32_t i = 0;
+  for (; i < RIF_SWISSMAP_GROUP_WIDTH; ++i) {
+    mask |= (uint32_t) (ctrl[i] == h2) << i;
+  }
+  return mask;
+}
+
+static inline
+uint32_t _rif_swissmap_group_match_empty(const int8_t *ctrl) {
+  return _rif_swissmap_group_match(ctrl, CTRL_EMPTY);
+}
+
+static inline
+uint32_t _rif_swissmap_group_match_empty_or_deleted(const int8_t *ctrl) {
+  uint32_t mask = 0;
+  uint32_t i = 0;
+  for (; i < RIF_SWISSMAP_GROUP_WIDTH; ++i) {
+    mask |= (uint32_t) (ctrl[i] < 0) << i;
+  }
+  return mask;
+}
+
+#endif
+
+static inline
+void _rif_swissmap_set_ctrl(int8_t *ctrl, uint32_t capacity, uint32_t index, int8_t value) {
+  ctrl[index] = value;
+  // Keep the copy of the first group, read by groups wrapping around the end of the table, up to date
+  if (index < RIF_SWISSMAP_GROUP_WIDTH) {
+    ctrl[capacity + index] = value;
+  }
+}
+
+/*
+ * Probe sequences visit groups at triangular offsets from the initial position, which covers the whole table when
+ * the number of slots is a power of two.
+ */
+static inline
+uint32_t _rif_swissmap_find_free(const int8_t *ctrl, uint32_t capacity, uint32_t hash) {
+  uint32_t mask = capacity - 1;
+  uint32_t pos = h1(hash) & mask;
+  uint32_t step = 0;
+  while (true) {
+    uint32_t match = _rif_swissmap_group_match_empty_or_deleted(ctrl + pos);
+    if (match) {
+      return (pos + __builtin_ctz(match)) & mask;
+    }
+    step += RIF_SWISSMAP_GROUP_WIDTH;
+    pos = (pos + step) & mask;
+  }
+}
+
+static
+uint32_t _rif_swissmap_find(const rif_swissmap_t *sm_ptr, const rif_val_t *key_ptr, uint32_t hash) {
+  uint32_t mask = sm_ptr->capacity - 1;
+  uint32_t pos = h1(hash) & mask;
+  uint32_t step = 0;
+  while (true) {
+    uint32_t match = _rif_swissmap_group_match(sm_ptr->ctrl + pos, h2(hash));
+    while (match) {
+      uint32_t index = (pos + __builtin_ctz(match)) & mask;
+      if (__likely(sm_ptr->hashes[index] == hash &&
+                   (sm_ptr->keys[index] == key_ptr || rif_val_equals(sm_ptr->keys[index], key_ptr)))) {
+        return index;
+      }
+      match &= match - 1;
+    }
+    if (__likely(_rif_swissmap_group_match_empty(sm_ptr->ctrl + pos))) {
+      return NOT_FOUND;
+    }
+    step += RIF_SWISSMAP_GROUP_WIDTH;
+    pos = (pos + step) & mask;
+  }
+}
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+static
+rif_swissmap_t * _rif_swissmap_build(rif_swissmap_t *sm_ptr, bool free, uint32_t capacity, bool fixed) {
+  if (!sm_ptr) {
+    return sm_ptr;
+  }
+  rif_map_init((rif_map_t *) sm_ptr, &rif_swissmap_hooks, free);
+  sm_ptr->size = 0;
+  sm_ptr->capacity = 0;
+  sm_ptr->growth_left = 0;
+  sm_ptr->seed = rif_hash_64((uint64_t) (uintptr_t) sm_ptr);
+  sm_ptr->fixed = fixed;
+  sm_ptr->ctrl = NULL;
+  sm_ptr->hashes = NULL;
+  sm_ptr->keys = NULL;
+  sm_ptr->vals = NULL;
+
+  // Allocate storage if needed.
+  if (capacity && RIF_OK != rif_swissmap_ensure_capacity(sm_ptr, capacity)) {
+    return NULL;
+  }
+
+  return sm_ptr;
+}
+
+rif_swissmap_t * rif_swissmap_init(rif_swissmap_t *sm_ptr, uint32_t capacity, bool fixed) {
+  return _rif_swissmap_build(sm_ptr, false, capacity, fixed);
+}
+
+rif_swissmap_t * rif_swissmap_new(uint32_t capacity, bool fixed) {
+  rif_swissmap_t *sm_ptr = rif_malloc(sizeof(rif_swissmap_t), "RIF_SWISSMAP_NEW");
+  if (sm_ptr && !_rif_swissmap_build(sm_ptr, true, capacity, fixed)) {
+    rif_free(sm_ptr);
+    return NULL;
+  }
+  return sm_ptr;
+}
+
+void rif_swissmap_destroy_callback(rif_swissmap_t *sm_ptr) {
+  uint32_t pos = 0;
+  for (; pos < sm_ptr->capacity; ++pos) {
+    if (rif_swissmap_isfull(sm_ptr, pos)) {
+      rif_val_release(sm_ptr->keys[pos]);
+      rif_val_release(sm_ptr->vals[pos]);
+    }
+  }
+  rif_free(sm_ptr->keys);
+}
+
+/******************************************************************************
+ * SIZING FUNCTIONS
+ */
+
+/*
+ * Moves every element to a new table of `capacity` slots. This also drops every deleted slot.
+ */
+static
+rif_status_t _rif_swissmap_rebuild(rif_swissmap_t *sm_ptr, uint32_t capacity) {
+
+  // Allocate every array at once: keys, values, hashes, then control bytes.
+  size_t ctrl_size = capacity + RIF_SWISSMAP_GROUP_WIDTH;
+  size_t alloc_size = capacity * (2 * sizeof(rif_val_t *) + sizeof(uint32_t)) + ctrl_size;
+  rif_val_t **keys = rif_malloc(alloc_size, "SWISSMAP_CAPACITY_ALLOC");
+  if (!keys) {
+    return RIF_ERR_MEMORY;
+  }
+  rif_val_t **vals = keys + capacity;
+  uint32_t *hashes = (uint32_t *) (vals + capacity);
+  int8_t *ctrl = (int8_t *) (hashes + capacity);
+  memset(ctrl, CTRL_EMPTY, ctrl_size);
+
+  // Move elements. The new table has no deleted slot, so elements go to the first empty slot of their sequence.
+  uint32_t pos = 0;
+  for (; pos < sm_ptr->capacity; ++pos) {
+    if (rif_swissmap_isfull(sm_ptr, pos)) {
+      uint32_t hash = sm_ptr->hashes[pos];
+      uint32_t index = _rif_swissmap_find_free(ctrl, capacity, hash);
+      _rif_swissmap_set_ctrl(ctrl, capacity, index, h2(hash));
+      hashes[index] = hash;
+      keys[index] = sm_ptr->keys[pos];
+      vals[index] = sm_ptr->vals[pos];
+    }
+  }
+
+  // Swap storage.
+  rif_free(sm_ptr->keys);
+  sm_ptr->keys = keys;
+  sm_ptr->vals = vals;
+  sm_ptr->hashes = hashes;
+  sm_ptr->ctrl = ctrl;
+  sm_ptr->capacity = capacity;
+  sm_ptr->growth_left = max_growth(capacity) - sm_ptr->size;
+
+  return RIF_OK;
+}
+
+rif_status_t rif_swissmap_ensure_capacity(rif_swissmap_t *sm_ptr, uint32_t capacity) {
+
+  // Calculate the capacity we need to allocate.
+  uint32_t needed_capacity = _rif_swissmap_capacity_for(capacity);
+
+  // Maybe we don't need to do anything.
+  if (needed_capacity <= sm_ptr->capacity) {
+    return RIF_OK;
+  }
+
+  // Maybe the map has a fixed size.
+  if (sm_ptr->fixed && sm_ptr->ctrl) {
+    return RIF_ERR_CAPACITY;
+  }
+
+  return _rif_swissmap_rebuild(sm_ptr, needed_capacity);
+}
+
+/*
+ * Makes room for one more element, either by growing the map, or by rebuilding it in place if deleted slots are what
+ * is using up its capacity. An in-place rebuild only frees as many slots as there are deleted ones, so it is only
+ * worth it when the map is well below its maximum load: otherwise, churn close to the maximum load would rebuild the
+ * whole table on nearly every insertion. Fixed capacity maps have no choice but to rebuild in place.
+ */
+static
+rif_status_t _rif_swissmap_reserve_one(rif_swissmap_t *sm_ptr) {
+  uint32_t needed_capacity = _rif_swissmap_capacity_for(sm_ptr->size + 1);
+  if (needed_capacity <= sm_ptr->capacity &&
+      (sm_ptr->fixed || (uint64_t) sm_ptr->size * 32 <= (uint64_t) sm_ptr->capacity * 25)) {
+    return _rif_swissmap_rebuild(sm_ptr, sm_ptr->capacity);
+  }
+  return rif_swissmap_ensure_capacity(sm_ptr, rif_max(sm_ptr->size + 1, max_growth(sm_ptr->capacity) + 1));
+}
+
+/******************************************************************************
+ * ELEMENT READ FUNCTIONS
+ */
+
+bool rif_swissmap_exists(const rif_swissmap_t *sm_ptr, const rif_val_t *key_ptr) {
+  if (0 == sm_ptr->size) {
+    return false;
+  }
+  return NOT_FOUND != _rif_swissmap_find(sm_ptr, key_ptr, _rif_swissmap_hash(sm_ptr, key_ptr));
+}
+
+rif_val_t * rif_swissmap_get(const rif_swissmap_t *sm_ptr, const rif_val_t *key_ptr) {
+  if (0 == sm_ptr->size) {
+    return NULL;
+  }
+  uint32_t index = _rif_swissmap_find(sm_ptr, key_ptr, _rif_swissmap_hash(sm_ptr, key_ptr));
+  return NOT_FOUND == index ? NULL : sm_ptr->vals[index];
+}
+
+/******************************************************************************
+ * ELEMENT WRITE FUNCTIONS
+ */
+
+rif_status_t rif_swissmap_put(rif_swissmap_t *sm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+  return rif_swissmap_put_steal(sm_ptr, rif_val_retain(key_ptr), rif_val_retain(val_ptr));
+}
+
+rif_status_t rif_swissmap_put_steal(rif_swissmap_t *sm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+
+  uint32_t hash = _rif_swissmap_hash(sm_ptr, key_ptr);
+
+  // Replace an existing element
+  if (sm_ptr->size) {
+    uint32_t index = _rif_swissmap_find(sm_ptr, key_ptr, hash);
+    if (NOT_FOUND != index) {
+      rif_val_release(sm_ptr->keys[index]);
+      rif_val_release(sm_ptr->vals[index]);
+      sm_ptr->keys[index] = key_ptr;
+      sm_ptr->vals[index] = val_ptr;
+      return RIF_OK;
+    }
+  }
+
+  // Ensure we got sufficient capacity
+  uint32_t index = NOT_FOUND;
+  if (sm_ptr->capacity) {
+    index = _rif_swissmap_find_free(sm_ptr->ctrl, sm_ptr->capacity, hash);
+  }
+  if (NOT_FOUND == index || (0 == sm_ptr->growth_left && CTRL_EMPTY == sm_ptr->ctrl[index])) {
+    rif_status_t reserve_status = _rif_swissmap_reserve_one(sm_ptr);
+    if (RIF_OK != reserve_status) {
+      rif_val_release(key_ptr);
+      rif_val_release(val_ptr);
+      return reserve_status;
+    }
+    index = _rif_swissmap_find_free(sm_ptr->ctrl, sm_ptr->capacity, hash);
+  }
+
+  // Insert the element, the caller references become the map ones; reusing a deleted slot does not consume growth
+  sm_ptr->growth_left -= CTRL_EMPTY == sm_ptr->ctrl[index];
+  _rif_swissmap_set_ctrl(sm_ptr->ctrl, sm_ptr->capacity, index, h2(hash));
+  sm_ptr->hashes[index] = hash;
+  sm_ptr->keys[index] = key_ptr;
+  sm_ptr->vals[index] = val_ptr;
+  ++sm_ptr->size;
+
+  return RIF_OK;
+}
+
+/******************************************************************************
+ * ELEMENT DELETE FUNCTIONS
+ */
+
+rif_status_t rif_swissmap_remove(rif_swissmap_t *sm_ptr, rif_val_t *key_ptr) {
+
+  // Locate the element
+  if (0 == sm_ptr->size) {
+    return RIF_OK;
+  }
+  uint32_t index = _rif_swissmap_find(sm_ptr, key_ptr, _rif_swissmap_hash(sm_ptr, key_ptr));
+  if (NOT_FOUND == index) {
+    return RIF_OK;
+  }
+
+  rif_val_t *removed_key_ptr = sm_ptr->keys[index];
+  rif_val_t *removed_val_ptr = sm_ptr->vals[index];
+
+  // The slot can be marked as empty only if no group containing it was ever full, otherwise a probe sequence may
+  // have gone past it and must not be cut short.
+  uint32_t mask = sm_ptr->capacity - 1;
+  uint32_t empty_before = _rif_swissmap_group_match_empty(sm_ptr->ctrl + ((index - RIF_SWISSMAP_GROUP_WIDTH) & mask));
+  uint32_t empty_after = _rif_swissmap_group_match_empty(sm_ptr->ctrl + index);
+  bool was_never_full = empty_before && empty_after &&
+      (__builtin_ctz(empty_after) + __builtin_clz(empty_before << 16)) < RIF_SWISSMAP_GROUP_WIDTH;
+  _rif_swissmap_set_ctrl(sm_ptr->ctrl, sm_ptr->capacity, index, was_never_full ? CTRL_EMPTY : CTRL_DELETED);
+  sm_ptr->growth_left += was_never_full;
+  sm_ptr->keys[index] = NULL;
+  sm_ptr->vals[index] = NULL;
+
+  // Do the bookkeeping
+  --sm_ptr->size;
+  rif_val_release(removed_key_ptr);
+  rif_val_release(removed_val_ptr);
+
+  return RIF_OK;
+}
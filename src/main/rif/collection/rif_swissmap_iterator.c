@@ -0,0 +1,96 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "rif/rif_internal.h"
+
+#include "rif/collection/rif_swissmap_iterator.h"
+
+/******************************************************************************
+ * TYPES
+ */
+
+typedef struct rif_swissmap_iterator_heap_s {
+
+  rif_swissmap_iterator_t it;
+  rif_pair_t pair;
+
+} rif_swissmap_iterator_heap_t;
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+static
+rif_swissmap_iterator_t * _rif_swissmap_iterator_build(
+    rif_swissmap_iterator_t *it_ptr, const rif_swissmap_t *sm_ptr, rif_pair_t *pair_ptr, bool free) {
+  if (!it_ptr) {
+    return NULL;
+  }
+  rif_iterator_init((rif_iterator_t *) it_ptr, &rif_swissmap_iterator_hooks, free);
+  it_ptr->sm_ptr = sm_ptr;
+  it_ptr->index = 0;
+  it_ptr->found = 0;
+  it_ptr->pair_ptr = rif_pair_init(pair_ptr, NULL, NULL);
+  return it_ptr;
+}
+
+rif_swissmap_iterator_t *rif_swissmap_iterator_init(
+    rif_swissmap_iterator_t *it_ptr, const rif_swissmap_t *sm_ptr, rif_pair_t *pair_ptr) {
+  return _rif_swissmap_iterator_build(it_ptr, sm_ptr, pair_ptr, false);
+}
+
+rif_swissmap_iterator_t *rif_swissmap_iterator_new(const rif_swissmap_t *sm_ptr) {
+  rif_swissmap_iterator_heap_t *it_heap_ptr =
+      rif_malloc(sizeof(rif_swissmap_iterator_heap_t), "RIF_SWISSMAP_ITERATOR_NEW");
+  return _rif_swissmap_iterator_build(&it_heap_ptr->it, sm_ptr, &it_heap_ptr->pair, true);
+}
+
+/******************************************************************************
+ * ITERATOR FUNCTIONS
+ */
+
+rif_val_t * rif_swissmap_iterator_next(rif_swissmap_iterator_t *it_ptr) {
+  if (!rif_swissmap_iterator_hasnext(it_ptr)) {
+    return NULL;
+  }
+  while (!rif_swissmap_isfull(it_ptr->sm_ptr, it_ptr->index)) {
+    ++it_ptr->index;
+  }
+  it_ptr->pair_ptr->val_ptr_1 = it_ptr->sm_ptr->vals[it_ptr->index];
+  it_ptr->pair_ptr->val_ptr_2 = it_ptr->sm_ptr->keys[it_ptr->index];
+  ++it_ptr->index;
+  ++it_ptr->found;
+  return rif_val(it_ptr->pair_ptr);
+}
+
+/******************************************************************************
+ * CALLBACK FUNCTIONS
+ */
+
+void rif_swissmap_iterator_destroy_callback(rif_swissmap_iterator_t *it_ptr) {
+  it_ptr->pair_ptr->val_ptr_1 = NULL;
+  it_ptr->pair_ptr->val_ptr_2 = NULL;
+  rif_val_release(it_ptr->pair_ptr);
+}
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -40,6 +40,11 @@ rif_status_t _rif_concurrent_blocking_queue_hook_push(rif_queue_t *queue_ptr, ri
   return rif_concurrent_blocking_queue_push((rif_concurrent_blocking_queue_t *) queue_ptr, val_ptr);
 }
 
+static
+rif_status_t _rif_concurrent_blocking_queue_hook_push_steal(rif_queue_t *queue_ptr, rif_val_t *val_ptr) {
+  return rif_concurrent_blocking_queue_push_steal((rif_concurrent_blocking_queue_t *) queue_ptr, val_ptr);
+}
+
 static
 rif_val_t * _rif_concurrent_blocking_queue_hook_pop(rif_queue_t *queue_ptr) {
   return rif_concurrent_blocking_queue_pop((rif_concurrent_blocking_queue_t *) queue_ptr);
@@ -50,8 +55,9 @@ rif_val_t * _rif_concurrent_blocking_queue_hook_pop(rif_queue_t *queue_ptr) {
  */
 
 const rif_queue_hooks_t rif_concurrent_blocking_queue_hooks = {
-    .destroy = _rif_concurrent_blocking_queue_hook_destroy,
-    .size    = _rif_concurrent_blocking_queue_hook_size,
-    .push    = _rif_concurrent_blocking_queue_hook_push,
-    .pop     = _rif_concurrent_blocking_queue_hook_pop
+    .destroy    = _rif_concurrent_blocking_queue_hook_destroy,
+    .size       = _rif_concurrent_blocking_queue_hook_size,
+    .push       = _rif_concurrent_blocking_queue_hook_push,
+    .push_steal = _rif_concurrent_blocking_queue_hook_push_steal,
+    .pop        = _rif_concurrent_blocking_queue_hook_pop
 };
\ No newline at end of file
@@ -0,0 +1,190 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+
+#include "rif/rif_internal.h"
+
+#include "rif/concurrent/collection/rif_concurrent_hashmap.h"
+#include "rif/util/rif_hash.h"
+#include "rif/util/rif_math.h"
+
+/******************************************************************************
+ * HELPERS
+ */
+
+static inline
+rif_concurrent_hashmap_segment_t * _rif_concurrent_hashmap_segment(
+    rif_concurrent_hashmap_t *chm_ptr, const rif_val_t *key_ptr) {
+  uint32_t hash = rif_hash_mix_32(rif_val_hashcode(key_ptr), chm_ptr->seed);
+  return chm_ptr->segments + rif_mod_pow2(hash, chm_ptr->segment_count);
+}
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+static
+void _rif_concurrent_hashmap_destroy_segments(rif_concurrent_hashmap_t *chm_ptr, uint32_t count) {
+  uint32_t i = 0;
+  for (; i < count; ++i) {
+    rif_hashmap_release(&chm_ptr->segments[i].map);
+    mtx_destroy(&chm_ptr->segments[i].lock);
+  }
+  rif_free(chm_ptr->segments);
+}
+
+static
+rif_concurrent_hashmap_t * _rif_concurrent_hashmap_build(
+    rif_concurrent_hashmap_t *chm_ptr, bool free, uint32_t capacity, uint32_t concurrency) {
+  if (!chm_ptr) {
+    return chm_ptr;
+  }
+  rif_map_init((rif_map_t *) chm_ptr, &rif_concurrent_hashmap_hooks, free);
+  rif_val_share(chm_ptr);
+  atomic_init(&chm_ptr->size, 0);
+  chm_ptr->segment_count = rif_next_pow2(concurrency ? concurrency : RIF_CONCURRENT_HASHMAP_DEFAULT_CONCURRENCY);
+  chm_ptr->seed = rif_hash_64((uint64_t) (uintptr_t) chm_ptr);
+
+  // Allocate segments
+  chm_ptr->segments = rif_malloc(
+      chm_ptr->segment_count * sizeof(rif_concurrent_hashmap_segment_t), "CONCURRENT_HASHMAP_SEGMENTS_ALLOC");
+  if (!chm_ptr->segments) {
+    return NULL;
+  }
+
+  // Initialize them, spreading the capacity evenly
+  uint32_t segment_capacity = capacity ? (capacity - 1) / chm_ptr->segment_count + 1 : 0;
+  uint32_t i = 0;
+  for (; i < chm_ptr->segment_count; ++i) {
+    rif_concurrent_hashmap_segment_t *segment = chm_ptr->segments + i;
+    if (thrd_success != mtx_init(&segment->lock, mtx_plain)) {
+      _rif_concurrent_hashmap_destroy_segments(chm_ptr, i);
+      return NULL;
+    }
+    if (!rif_hashmap_init(&segment->map, segment_capacity, false)) {
+      mtx_destroy(&segment->lock);
+      _rif_concurrent_hashmap_destroy_segments(chm_ptr, i);
+      return NULL;
+    }
+  }
+
+  return chm_ptr;
+}
+
+rif_concurrent_hashmap_t * rif_concurrent_hashmap_init(
+    rif_concurrent_hashmap_t *chm_ptr, uint32_t capacity, uint32_t concurrency) {
+  return _rif_concurrent_hashmap_build(chm_ptr, false, capacity, concurrency);
+}
+
+void rif_concurrent_hashmap_destroy_callback(rif_concurrent_hashmap_t *chm_ptr) {
+  _rif_concurrent_hashmap_destroy_segments(chm_ptr, chm_ptr->segment_count);
+}
+
+/******************************************************************************
+ * ELEMENT READ FUNCTIONS
+ */
+
+bool rif_concurrent_hashmap_exists(rif_concurrent_hashmap_t *chm_ptr, const rif_val_t *key_ptr) {
+  rif_concurrent_hashmap_segment_t *segment = _rif_concurrent_hashmap_segment(chm_ptr, key_ptr);
+  mtx_lock(&segment->lock);
+  bool exists = rif_hashmap_exists(&segment->map, key_ptr);
+  mtx_unlock(&segment->lock);
+  return exists;
+}
+
+rif_val_t * rif_concurrent_hashmap_get(rif_concurrent_hashmap_t *chm_ptr, const rif_val_t *key_ptr) {
+  rif_concurrent_hashmap_segment_t *segment = _rif_concurrent_hashmap_segment(chm_ptr, key_ptr);
+  mtx_lock(&segment->lock);
+  rif_val_t *val_ptr = rif_hashmap_get(&segment->map, key_ptr);
+  mtx_unlock(&segment->lock);
+  return val_ptr;
+}
+
+rif_val_t * rif_concurrent_hashmap_get_retained(rif_concurrent_hashmap_t *chm_ptr, const rif_val_t *key_ptr) {
+  rif_concurrent_hashmap_segment_t *segment = _rif_concurrent_hashmap_segment(chm_ptr, key_ptr);
+  mtx_lock(&segment->lock);
+  rif_val_t *val_ptr = rif_hashmap_get(&segment->map, key_ptr);
+  if (val_ptr) {
+    rif_val_retain(val_ptr);
+  }
+  mtx_unlock(&segment->lock);
+  return val_ptr;
+}
+
+/******************************************************************************
+ * ELEMENT WRITE FUNCTIONS
+ */
+
+rif_status_t rif_concurrent_hashmap_put(rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+  return rif_concurrent_hashmap_put_steal(chm_ptr, rif_val_retain(key_ptr), rif_val_retain(val_ptr));
+}
+
+rif_status_t rif_concurrent_hashmap_put_steal(
+    rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+  rif_concurrent_hashmap_segment_t *segment = _rif_concurrent_hashmap_segment(chm_ptr, key_ptr);
+  rif_val_share(key_ptr);
+  rif_val_share(val_ptr);
+  mtx_lock(&segment->lock);
+  uint32_t size = rif_hashmap_size(&segment->map);
+  rif_status_t status = rif_hashmap_put_steal(&segment->map, key_ptr, val_ptr);
+  atomic_fetch_add_explicit(&chm_ptr->size, rif_hashmap_size(&segment->map) - size, memory_order_relaxed);
+  mtx_unlock(&segment->lock);
+  return status;
+}
+
+rif_val_t * rif_concurrent_hashmap_putifabsent(
+    rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr) {
+  return rif_concurrent_hashmap_putifabsent_helper(chm_ptr, key_ptr, val_ptr, 0);
+}
+
+rif_val_t * rif_concurrent_hashmap_putifabsent_helper(
+    rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr, rif_val_t *val_ptr, uint8_t flags) {
+  rif_concurrent_hashmap_segment_t *segment = _rif_concurrent_hashmap_segment(chm_ptr, key_ptr);
+  rif_val_share(key_ptr);
+  rif_val_share(val_ptr);
+  mtx_lock(&segment->lock);
+  rif_val_t *current_ptr = rif_hashmap_get(&segment->map, key_ptr);
+  if (!current_ptr && RIF_OK == rif_hashmap_put(&segment->map, key_ptr, val_ptr)) {
+    atomic_fetch_add_explicit(&chm_ptr->size, 1, memory_order_relaxed);
+    // Static and immediate values may live in read-only memory, or not be addressable at all: only write when asked
+    if (flags && !rif_val_isimmediate(val_ptr)) {
+      val_ptr->flags |= flags;
+    }
+    current_ptr = val_ptr;
+  }
+  if (current_ptr) {
+    rif_val_retain(current_ptr);
+  }
+  mtx_unlock(&segment->lock);
+  return current_ptr;
+}
+
+/******************************************************************************
+ * ELEMENT DELETE FUNCTIONS
+ */
+
+rif_status_t rif_concurrent_hashmap_remove(rif_concurrent_hashmap_t *chm_ptr, rif_val_t *key_ptr) {
+  rif_concurrent_hashmap_segment_t *segment = _rif_concurrent_hashmap_segment(chm_ptr, key_ptr);
+  mtx_lock(&segment->lock);
+  uint32_t size = rif_hashmap_size(&segment->map);
+  rif_status_t status = rif_hashmap_remove(&segment->map, key_ptr);
+  atomic_fetch_sub_explicit(&chm_ptr->size, size - rif_hashmap_size(&segment->map), memory_order_relaxed);
+  mtx_unlock(&segment->lock);
+  return status;
+}
@@ -45,6 +45,7 @@ rif_concurrent_queue_t * rif_concurrent_queue_init(rif_concurrent_queue_t *queue
     return queue_ptr;
   }
   rif_queue_init((rif_queue_t *) queue_ptr, &rif_concurrent_queue_hooks, false);
+  rif_val_share(queue_ptr);
   if (__unlikely(!rif_concurrent_pool_init(&queue_ptr->pool, sizeof(rif_concurrent_queue_node_t)))) {
     return NULL;
   }
@@ -62,16 +63,21 @@ rif_concurrent_queue_t * rif_concurrent_queue_init(rif_concurrent_queue_t *queue
  */
 
 rif_status_t rif_concurrent_queue_push(rif_concurrent_queue_t *queue_ptr, rif_val_t *val_ptr) {
+  assert(NULL != val_ptr);
+  return rif_concurrent_queue_push_steal(queue_ptr, rif_val_retain(val_ptr));
+}
+
+rif_status_t rif_concurrent_queue_push_steal(rif_concurrent_queue_t *queue_ptr, rif_val_t *val_ptr) {
   assert(NULL != queue_ptr);
   assert(NULL != val_ptr);
   rif_concurrent_queue_node_t *node = rif_concurrent_pool_borrow(&queue_ptr->pool);
   if (__unlikely(!node)) {
+    rif_val_release(val_ptr);
     return RIF_ERR_MEMORY;
   }
   rif_concurrent_queue_base_node_init((rif_concurrent_queue_base_t *) &queue_ptr,
                                       (rif_concurrent_queue_base_node_t *) node);
-  node->val = val_ptr;
-  rif_val_retain(val_ptr);
+  node->val = rif_val_share(val_ptr);
   rif_concurrent_queue_base_push(&queue_ptr->queue_base, (rif_concurrent_queue_base_node_t *) node);
   return RIF_OK;
 }
@@ -26,20 +26,240 @@
  * STATIC HELPERS
  */
 
+/*
+ * Free nodes are chained through the first word of their element memory.
+ */
+#define _rif_concurrent_pool_link(__node) (*(rif_concurrent_pool_node_t **) (__node)->element)
+
+/******************************************************************************
+ * CHAIN HELPERS
+ */
+
+static inline
+void _rif_concurrent_pool_chain_push(rif_concurrent_pool_chain_t *chain_ptr, rif_concurrent_pool_node_t *node_ptr) {
+  _rif_concurrent_pool_link(node_ptr) = chain_ptr->first;
+  chain_ptr->first = node_ptr;
+  ++chain_ptr->count;
+}
+
+static inline
+rif_concurrent_pool_node_t * _rif_concurrent_pool_chain_pop(rif_concurrent_pool_chain_t *chain_ptr) {
+  rif_concurrent_pool_node_t *node_ptr = chain_ptr->first;
+  chain_ptr->first = _rif_concurrent_pool_link(node_ptr);
+  --chain_ptr->count;
+  return node_ptr;
+}
+
+/*
+ * Publish a whole chain to the shared free stack, with a single push of its first node.
+ */
+static
+void _rif_concurrent_pool_chain_spill(rif_concurrent_pool_t *pool_ptr, rif_concurrent_pool_chain_t *chain_ptr) {
+  if (chain_ptr->first) {
+    atomic_fetch_add_explicit(&pool_ptr->shared_free_count, chain_ptr->count, memory_order_relaxed);
+    rif_concurrent_queue_base_push(&pool_ptr->free_queue, (rif_concurrent_queue_base_node_t *) chain_ptr->first);
+  }
+  chain_ptr->first = NULL;
+  chain_ptr->count = 0;
+}
+
+/*
+ * Take a whole chain from the shared free stack.
+ */
+static
+bool _rif_concurrent_pool_chain_refill(rif_concurrent_pool_t *pool_ptr, rif_concurrent_pool_chain_t *chain_ptr) {
+  rif_concurrent_pool_node_t *node_ptr =
+      (rif_concurrent_pool_node_t *) rif_concurrent_queue_base_pop(&pool_ptr->free_queue);
+  chain_ptr->first = node_ptr;
+  chain_ptr->count = 0;
+  for (; node_ptr; node_ptr = _rif_concurrent_pool_link(node_ptr)) {
+    ++chain_ptr->count;
+  }
+  atomic_fetch_sub_explicit(&pool_ptr->shared_free_count, chain_ptr->count, memory_order_relaxed);
+  return chain_ptr->count > 0;
+}
+
+/******************************************************************************
+ * SLAB HELPERS
+ */
+
+/*
+ * Reserve up to `count` nodes within the pool limit, and return how many were granted.
+ */
+static
+uint32_t _rif_concurrent_pool_reserve_nodes(rif_concurrent_pool_t *pool_ptr, uint32_t count) {
+  uint32_t node_count = atomic_load_explicit(&pool_ptr->node_count, memory_order_relaxed);
+  uint32_t granted;
+  do {
+    granted = count;
+    if (pool_ptr->max_nodes) {
+      uint32_t available = pool_ptr->max_nodes > node_count ? pool_ptr->max_nodes - node_count : 0;
+      granted = available < count ? available : count;
+    }
+    if (!granted) {
+      return 0;
+    }
+  } while (!atomic_compare_exchange_weak_explicit(&pool_ptr->node_count, &node_count, node_count + granted,
+                                                  memory_order_relaxed, memory_order_relaxed));
+  return granted;
+}
+
+/*
+ * Number of nodes of the next slab: slabs double in size, from a single batch up to the maximum slab size.
+ */
+static
+uint32_t _rif_concurrent_pool_slab_nodes(rif_concurrent_pool_t *pool_ptr) {
+  uint32_t max_nodes = (RIF_CONCURRENT_POOL_SLAB_MAX_BYTES - sizeof(rif_concurrent_pool_slab_t)) / pool_ptr->node_stride;
+  uint32_t slab_count = atomic_load_explicit(&pool_ptr->slab_count, memory_order_relaxed);
+  uint32_t nodes = RIF_CONCURRENT_POOL_MAGAZINE_SIZE;
+  for (; slab_count && nodes < max_nodes; --slab_count) {
+    nodes *= 2;
+  }
+  nodes = nodes < max_nodes ? nodes : max_nodes;
+  return nodes ? nodes : 1;
+}
+
+/*
+ * Carve a slab of up to `count` nodes. The batch with the lowest addresses goes to `chain_ptr` if it is not `NULL`, and
+ * every other batch to the shared free stack.
+ */
+static
+bool _rif_concurrent_pool_slab_alloc(rif_concurrent_pool_t *pool_ptr, uint32_t count,
+                                     rif_concurrent_pool_chain_t *chain_ptr) {
+  count = _rif_concurrent_pool_reserve_nodes(pool_ptr, count);
+  if (__unlikely(!count)) {
+    return false;
+  }
+
+  // Slabs are shared by every thread and live as long as the pool: never carve them from a thread arena
+  rif_arena_t *arena_ptr = rif_arena_set_current(NULL);
+  rif_concurrent_pool_slab_t *slab_ptr = rif_aligned_alloc(
+      RIF_CONCURRENT_POOL_SLAB_ALIGNMENT, sizeof(rif_concurrent_pool_slab_t) + (size_t) count * pool_ptr->node_stride,
+      "RIF_CONCURRENT_POOL_ALLOC");
+  rif_arena_set_current(arena_ptr);
+  if (__unlikely(!slab_ptr)) {
+    atomic_fetch_sub_explicit(&pool_ptr->node_count, count, memory_order_relaxed);
+    return false;
+  }
+
+  // Register the slab
+  uintptr_t first_slab = atomic_load_explicit(&pool_ptr->first_slab, memory_order_relaxed);
+  do {
+    slab_ptr->next = (rif_concurrent_pool_slab_t *) first_slab;
+  } while (!atomic_compare_exchange_weak_explicit(&pool_ptr->first_slab, &first_slab, (uintptr_t) slab_ptr,
+                                                  memory_order_release, memory_order_relaxed));
+  atomic_fetch_add_explicit(&pool_ptr->slab_count, 1, memory_order_relaxed);
+
+  // Carve nodes backwards, so that every batch is chained in address order
+  rif_concurrent_pool_chain_t batch = {NULL, 0};
+  uint32_t i = count;
+  while (i--) {
+    rif_concurrent_pool_node_t *node_ptr =
+        (rif_concurrent_pool_node_t *) (slab_ptr->nodes + (size_t) i * pool_ptr->node_stride);
+    rif_concurrent_queue_base_node_init(&pool_ptr->free_queue, (rif_concurrent_queue_base_node_t *) node_ptr);
+    _rif_concurrent_pool_chain_push(&batch, node_ptr);
+    if (!i && chain_ptr) {
+      *chain_ptr = batch;
+    } else if (!i || RIF_CONCURRENT_POOL_MAGAZINE_SIZE == batch.count) {
+      _rif_concurrent_pool_chain_spill(pool_ptr, &batch);
+    }
+  }
+  return true;
+}
+
+/******************************************************************************
+ * MAGAZINE HELPERS
+ */
+
+/*
+ * Called on thread exit: hand the magazine content back to the shared free stack.
+ */
+static
+void _rif_concurrent_pool_magazine_dtor(void *ptr) {
+  rif_concurrent_pool_magazine_t *magazine_ptr = ptr;
+  rif_concurrent_pool_t *pool_ptr = magazine_ptr->pool;
+  _rif_concurrent_pool_chain_spill(pool_ptr, &magazine_ptr->loaded);
+  _rif_concurrent_pool_chain_spill(pool_ptr, &magazine_ptr->previous);
+  mtx_lock(&pool_ptr->magazines_lock);
+  atomic_store_explicit(&magazine_ptr->free_count, 0, memory_order_relaxed);
+  if (magazine_ptr->prev) {
+    magazine_ptr->prev->next = magazine_ptr->next;
+  } else {
+    pool_ptr->first_magazine = magazine_ptr->next;
+  }
+  if (magazine_ptr->next) {
+    magazine_ptr->next->prev = magazine_ptr->prev;
+  }
+  mtx_unlock(&pool_ptr->magazines_lock);
+  rif_free(magazine_ptr);
+}
+
 static
-void _rif_concurrent_pool_dtor(rif_concurrent_queue_base_node_t *node, void *udata) {
-  rif_free(node);
+rif_concurrent_pool_magazine_t * _rif_concurrent_pool_magazine_create(rif_concurrent_pool_t *pool_ptr) {
+  rif_arena_t *arena_ptr = rif_arena_set_current(NULL);
+  rif_concurrent_pool_magazine_t *magazine_ptr =
+      rif_calloc(1, sizeof(rif_concurrent_pool_magazine_t), "RIF_CONCURRENT_POOL_MAGAZINE_ALLOC");
+  rif_arena_set_current(arena_ptr);
+  if (__unlikely(!magazine_ptr)) {
+    return magazine_ptr;
+  }
+  if (__unlikely(thrd_success != tss_set(pool_ptr->magazine_key, magazine_ptr))) {
+    rif_free(magazine_ptr);
+    return NULL;
+  }
+  magazine_ptr->pool = pool_ptr;
+  mtx_lock(&pool_ptr->magazines_lock);
+  magazine_ptr->next = pool_ptr->first_magazine;
+  if (magazine_ptr->next) {
+    magazine_ptr->next->prev = magazine_ptr;
+  }
+  pool_ptr->first_magazine = magazine_ptr;
+  mtx_unlock(&pool_ptr->magazines_lock);
+  return magazine_ptr;
+}
+
+static inline
+void _rif_concurrent_pool_magazine_publish(rif_concurrent_pool_magazine_t *magazine_ptr) {
+  atomic_store_explicit(&magazine_ptr->free_count, magazine_ptr->loaded.count + magazine_ptr->previous.count,
+                        memory_order_relaxed);
 }
 
+/*
+ * Get the calling thread magazine, or `NULL` if elements have to go through the shared free stack.
+ */
+static inline
+rif_concurrent_pool_magazine_t * _rif_concurrent_pool_magazine(rif_concurrent_pool_t *pool_ptr) {
+  if (__unlikely(!pool_ptr->magazines)) {
+    return NULL;
+  }
+  rif_concurrent_pool_magazine_t *magazine_ptr = tss_get(pool_ptr->magazine_key);
+  if (__likely(magazine_ptr)) {
+    return magazine_ptr;
+  }
+  return _rif_concurrent_pool_magazine_create(pool_ptr);
+}
+
+/******************************************************************************
+ * SHARED STACK HELPERS
+ */
+
 static
-rif_concurrent_pool_node_t *_rif_concurrent_pool_alloc(rif_concurrent_pool_t *pool_ptr) {
-  rif_concurrent_pool_node_t *node = rif_malloc(sizeof(rif_concurrent_pool_node_t) + pool_ptr->element_size,
-                                                "RIF_CONCURRENT_POOL_ALLOC");
-  if (__unlikely(!node)) {
-    return node;
+void * _rif_concurrent_pool_shared_borrow(rif_concurrent_pool_t *pool_ptr) {
+  rif_concurrent_pool_chain_t chain;
+  if (!_rif_concurrent_pool_chain_refill(pool_ptr, &chain) &&
+      !_rif_concurrent_pool_slab_alloc(pool_ptr, _rif_concurrent_pool_slab_nodes(pool_ptr), &chain)) {
+    return NULL;
   }
-  rif_concurrent_queue_base_node_init(&pool_ptr->free_queue, (rif_concurrent_queue_base_node_t *) node);
-  return node;
+  rif_concurrent_pool_node_t *node_ptr = _rif_concurrent_pool_chain_pop(&chain);
+  _rif_concurrent_pool_chain_spill(pool_ptr, &chain);
+  return node_ptr->element;
+}
+
+static
+void _rif_concurrent_pool_shared_return(rif_concurrent_pool_t *pool_ptr, rif_concurrent_pool_node_t *node_ptr) {
+  _rif_concurrent_pool_link(node_ptr) = NULL;
+  atomic_fetch_add_explicit(&pool_ptr->shared_free_count, 1, memory_order_relaxed);
+  rif_concurrent_queue_base_push(&pool_ptr->free_queue, (rif_concurrent_queue_base_node_t *) node_ptr);
 }
 
 /******************************************************************************
@@ -53,16 +273,91 @@ rif_concurrent_pool_t * rif_concurrent_pool_init(rif_concurrent_pool_t *pool_ptr
   if (__unlikely(!rif_pool_init((rif_pool_t *) pool_ptr, &rif_concurrent_pool_hooks))) {
     return NULL;
   }
-  if (__unlikely(NULL == rif_concurrent_queue_base_init(
-      &pool_ptr->free_queue, NULL, _rif_concurrent_pool_dtor, NULL))) {
+  if (__unlikely(NULL == rif_concurrent_queue_base_init(&pool_ptr->free_queue, NULL, NULL, NULL))) {
     return NULL;
   }
-  pool_ptr->element_size = element_size;
+
+  // Free elements must be able to hold the chain link, and nodes are kept aligned in slabs
+  pool_ptr->element_size = element_size < sizeof(void *) ? sizeof(void *) : element_size;
+  pool_ptr->node_stride = sizeof(rif_concurrent_pool_node_t) + pool_ptr->element_size;
+  pool_ptr->node_stride = (pool_ptr->node_stride + 2 * sizeof(void *) - 1) & ~(2 * sizeof(void *) - 1);
+  pool_ptr->max_nodes = 0;
+  atomic_init(&pool_ptr->node_count, 0);
+  atomic_init(&pool_ptr->shared_free_count, 0);
+  atomic_init(&pool_ptr->slab_count, 0);
+  atomic_init(&pool_ptr->first_slab, 0);
+
+  // Without thread-specific storage, fall back to the shared free stack only
+  pool_ptr->first_magazine = NULL;
+  pool_ptr->magazines = thrd_success == tss_create(&pool_ptr->magazine_key, _rif_concurrent_pool_magazine_dtor);
+  if (pool_ptr->magazines && thrd_success != mtx_init(&pool_ptr->magazines_lock, mtx_plain)) {
+    tss_delete(pool_ptr->magazine_key);
+    pool_ptr->magazines = false;
+  }
   return pool_ptr;
 }
 
 void rif_concurrent_pool_destroy(rif_concurrent_pool_t *pool_ptr) {
+  if (pool_ptr->magazines) {
+    tss_delete(pool_ptr->magazine_key);
+    rif_concurrent_pool_magazine_t *magazine_ptr = pool_ptr->first_magazine;
+    while (magazine_ptr) {
+      rif_concurrent_pool_magazine_t *next = magazine_ptr->next;
+      rif_free(magazine_ptr);
+      magazine_ptr = next;
+    }
+    mtx_destroy(&pool_ptr->magazines_lock);
+  }
   rif_concurrent_queue_base_destroy(&pool_ptr->free_queue);
+  rif_concurrent_pool_slab_t *slab_ptr =
+      (rif_concurrent_pool_slab_t *) atomic_load_explicit(&pool_ptr->first_slab, memory_order_acquire);
+  while (slab_ptr) {
+    rif_concurrent_pool_slab_t *next = slab_ptr->next;
+    rif_aligned_free(slab_ptr);
+    slab_ptr = next;
+  }
+}
+
+/******************************************************************************
+ * SIZING FUNCTIONS
+ */
+
+rif_status_t rif_concurrent_pool_reserve(rif_concurrent_pool_t *pool_ptr, uint32_t count) {
+  if (pool_ptr->max_nodes && count > pool_ptr->max_nodes) {
+    return RIF_ERR_CAPACITY;
+  }
+  uint32_t node_count = atomic_load_explicit(&pool_ptr->node_count, memory_order_relaxed);
+  if (node_count >= count) {
+    return RIF_OK;
+  }
+  return _rif_concurrent_pool_slab_alloc(pool_ptr, count - node_count, NULL) ? RIF_OK : RIF_ERR_MEMORY;
+}
+
+void rif_concurrent_pool_set_max_nodes(rif_concurrent_pool_t *pool_ptr, uint32_t max_nodes) {
+  pool_ptr->max_nodes = max_nodes;
+}
+
+/******************************************************************************
+ * STATISTICS FUNCTIONS
+ */
+
+uint32_t rif_concurrent_pool_free_count(rif_concurrent_pool_t *pool_ptr) {
+  uint32_t free_count = atomic_load_explicit(&pool_ptr->shared_free_count, memory_order_relaxed);
+  if (pool_ptr->magazines) {
+    mtx_lock(&pool_ptr->magazines_lock);
+    rif_concurrent_pool_magazine_t *magazine_ptr = pool_ptr->first_magazine;
+    for (; magazine_ptr; magazine_ptr = magazine_ptr->next) {
+      free_count += atomic_load_explicit(&magazine_ptr->free_count, memory_order_relaxed);
+    }
+    mtx_unlock(&pool_ptr->magazines_lock);
+  }
+  return free_count;
+}
+
+uint32_t rif_concurrent_pool_live_count(rif_concurrent_pool_t *pool_ptr) {
+  uint32_t free_count = rif_concurrent_pool_free_count(pool_ptr);
+  uint32_t node_count = atomic_load_explicit(&pool_ptr->node_count, memory_order_relaxed);
+  return node_count > free_count ? node_count - free_count : 0;
 }
 
 /******************************************************************************
@@ -70,12 +365,24 @@ void rif_concurrent_pool_destroy(rif_concurrent_pool_t *pool_ptr) {
  */
 
 void * rif_concurrent_pool_borrow(rif_concurrent_pool_t *pool_ptr) {
-  rif_concurrent_pool_node_t *node =
-      (rif_concurrent_pool_node_t *) rif_concurrent_queue_base_pop(&pool_ptr->free_queue);
-  if (__unlikely(NULL == node)) {
-    node = _rif_concurrent_pool_alloc(pool_ptr);
+  rif_concurrent_pool_magazine_t *magazine_ptr = _rif_concurrent_pool_magazine(pool_ptr);
+  if (__unlikely(!magazine_ptr)) {
+    return _rif_concurrent_pool_shared_borrow(pool_ptr);
   }
-  return &node->element;
+  if (__unlikely(!magazine_ptr->loaded.count)) {
+    if (magazine_ptr->previous.count) {
+      magazine_ptr->loaded = magazine_ptr->previous;
+      magazine_ptr->previous.first = NULL;
+      magazine_ptr->previous.count = 0;
+    } else if (!_rif_concurrent_pool_chain_refill(pool_ptr, &magazine_ptr->loaded) &&
+               !_rif_concurrent_pool_slab_alloc(pool_ptr, _rif_concurrent_pool_slab_nodes(pool_ptr),
+                                                &magazine_ptr->loaded)) {
+      return NULL;
+    }
+  }
+  rif_concurrent_pool_node_t *node_ptr = _rif_concurrent_pool_chain_pop(&magazine_ptr->loaded);
+  _rif_concurrent_pool_magazine_publish(magazine_ptr);
+  return node_ptr->element;
 }
 
 void rif_concurrent_pool_return(rif_concurrent_pool_t *pool_ptr, void *ptr) {
@@ -84,5 +391,17 @@ void rif_concurrent_pool_return(rif_concurrent_pool_t *pool_ptr, void *ptr) {
   }
   rif_concurrent_pool_node_t *node_ptr = ptr;
   --node_ptr; // Move back before the node header
-  rif_concurrent_queue_base_push(&pool_ptr->free_queue, (rif_concurrent_queue_base_node_t *) node_ptr);
-}
\ No newline at end of file
+  rif_concurrent_pool_magazine_t *magazine_ptr = _rif_concurrent_pool_magazine(pool_ptr);
+  if (__unlikely(!magazine_ptr)) {
+    _rif_concurrent_pool_shared_return(pool_ptr, node_ptr);
+    return;
+  }
+  if (__unlikely(magazine_ptr->loaded.count >= RIF_CONCURRENT_POOL_MAGAZINE_SIZE)) {
+    _rif_concurrent_pool_chain_spill(pool_ptr, &magazine_ptr->previous);
+    magazine_ptr->previous = magazine_ptr->loaded;
+    magazine_ptr->loaded.first = NULL;
+    magazine_ptr->loaded.count = 0;
+  }
+  _rif_concurrent_pool_chain_push(&magazine_ptr->loaded, node_ptr);
+  _rif_concurrent_pool_magazine_publish(magazine_ptr);
+}
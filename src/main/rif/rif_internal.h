@@ -22,4 +22,5 @@
 #include "rif/rif_common.h"
 
 #include "util/rif_alloc_internal.h"
-#include "util/rif_hints.h"
\ No newline at end of file
+#include "util/rif_hints.h"
+#include "util/rif_slab_internal.h"
\ No newline at end of file
@@ -35,7 +35,8 @@ bool _rif_alloc_filter_noop(const char * tag) {
 struct rif_allocators_s _rif_allocators = {
     malloc,
     realloc,
-    free
+    free,
+    true
 };
 
 rif_alloc_filter_t _rif_alloc_filter = _rif_alloc_filter_noop;
@@ -49,6 +50,8 @@ void rif_set_allocators(void * (*f_malloc)(size_t), void * (*f_realloc)(void *,
   _rif_allocators.f_malloc = f_malloc ? f_malloc : _rif_allocators.f_malloc;
   _rif_allocators.f_realloc = f_realloc ? f_realloc : _rif_allocators.f_realloc;
   _rif_allocators.f_free = f_free ? f_free : _rif_allocators.f_free;
+  _rif_allocators.system_allocators = malloc == _rif_allocators.f_malloc && realloc == _rif_allocators.f_realloc &&
+      free == _rif_allocators.f_free;
 }
 
 void rif_alloc_set_filter(rif_alloc_filter_t f_filter) {
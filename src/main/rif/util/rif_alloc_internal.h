@@ -20,6 +20,8 @@
 #pragma once
 
 #include "rif/util/rif_alloc.h"
+#include "rif/util/rif_arena.h"
+#include "rif_hints.h"
 
 /*****************************************************************************/
 
@@ -37,6 +39,11 @@ struct rif_allocators_s {
   void * (*f_realloc)(void *, size_t);
   void (*f_free)(void *);
 
+  // Are all of the above the system functions? Only then can memory come from the system `calloc`, which gets zeroed
+  // pages lazily from the OS rather than touching every page of large allocations up front, or from `posix_memalign`:
+  // either must be released with the system `free`.
+  bool system_allocators;
+
 };
 
 typedef bool (*rif_alloc_filter_t)(const char* tag);
@@ -48,6 +55,9 @@ typedef bool (*rif_alloc_filter_t)(const char* tag);
 extern struct rif_allocators_s _rif_allocators;
 extern rif_alloc_filter_t _rif_alloc_filter;
 
+/* Arena made current for the calling thread, if any, serving every allocation instead of `_rif_allocators`. */
+extern RIF_THREAD_LOCAL rif_arena_t *_rif_arena_current;
+
 /******************************************************************************
  * ALLOCATOR MACROS
  */
@@ -61,6 +71,9 @@ extern rif_alloc_filter_t _rif_alloc_filter;
 #define rif_tagged_calloc(__count, __size, __tag, ...) rif_calloc_helper(__count, __size, __tag);
 #define rif_calloc(...) rif_tagged_calloc(__VA_ARGS__, NULL);
 
+#define rif_tagged_aligned_alloc(__alignment, __size, __tag, ...) rif_aligned_alloc_helper(__alignment, __size, __tag);
+#define rif_aligned_alloc(...) rif_tagged_aligned_alloc(__VA_ARGS__, NULL);
+
 #define rif_tagged_strdup(__str, __tag, ...) rif_strdup_helper(__str, __tag);
 #define rif_strdup(...) rif_tagged_strdup(__VA_ARGS__, NULL);
 
@@ -77,6 +90,9 @@ void * rif_malloc_helper(size_t size, const char *tag) {
   }
 #endif
 
+  if (__unlikely(_rif_arena_current)) {
+    return rif_arena_alloc(_rif_arena_current, size);
+  }
   return _rif_allocators.f_malloc(size);
 }
 
@@ -89,11 +105,18 @@ void * rif_realloc_helper(void *ptr, size_t size, const char *tag) {
   }
 #endif
 
+  if (__unlikely(_rif_arena_current) && (!ptr || rif_arena_owns(_rif_arena_current, ptr))) {
+    return rif_arena_realloc(_rif_arena_current, ptr, size);
+  }
   return _rif_allocators.f_realloc(ptr, size);
 }
 
 RIF_INLINE
 void rif_free(void *ptr) {
+  if (__unlikely(_rif_arena_current) && rif_arena_owns(_rif_arena_current, ptr)) {
+    rif_arena_free(_rif_arena_current, ptr);
+    return;
+  }
   _rif_allocators.f_free(ptr);
 }
 
@@ -106,6 +129,10 @@ void * rif_calloc_helper(size_t count, size_t size, const char *tag) {
   }
 #endif
 
+  if (_rif_allocators.system_allocators && __likely(!_rif_arena_current)) {
+    return calloc(count, size);
+  }
+
   void *ptr = rif_malloc(count * size);
   if (!ptr) {
     return ptr;
@@ -125,6 +152,50 @@ char * rif_strdup_helper(const char *str, const char *tag) {
   return rv;
 }
 
+/*
+ * Allocates `size` bytes aligned on `alignment`, which must be a power of two and a multiple of `sizeof(void *)`. The
+ * memory must be released with `rif_aligned_free`, with the same allocators installed.
+ *
+ * With the system allocators, this is `posix_memalign`. With custom ones, which have no aligned variant, the block is
+ * over-allocated by `alignment` bytes, and the pointer to free is stored right before the aligned address.
+ */
+RIF_INLINE
+void * rif_aligned_alloc_helper(size_t alignment, size_t size, const char *tag) {
+
+#ifndef NDEBUG
+  if (tag && !_rif_alloc_filter(tag)) {
+    return NULL;
+  }
+#endif
+
+  if (__unlikely(_rif_arena_current)) {
+    return rif_arena_aligned_alloc(_rif_arena_current, alignment, size);
+  }
+  if (_rif_allocators.system_allocators) {
+    void *ptr;
+    return posix_memalign(&ptr, alignment, size) ? NULL : ptr;
+  }
+
+  uint8_t *raw_ptr = (uint8_t *) _rif_allocators.f_malloc(size + alignment);
+  if (!raw_ptr) {
+    return raw_ptr;
+  }
+  void **ptr = (void **) (((uintptr_t) raw_ptr + alignment) & ~((uintptr_t) alignment - 1));
+  ptr[-1] = raw_ptr;
+  return ptr;
+}
+
+RIF_INLINE
+void rif_aligned_free(void *ptr) {
+  if (__unlikely(_rif_arena_current) && rif_arena_owns(_rif_arena_current, ptr)) {
+    return;
+  }
+  if (ptr && !_rif_allocators.system_allocators) {
+    ptr = ((void **) ptr)[-1];
+  }
+  rif_free(ptr);
+}
+
 #define rif_alloca(__size) (alloca(__size))
 
 /******************************************************************************
@@ -0,0 +1,281 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "rif/rif_internal.h"
+
+#include "rif/util/rif_arena.h"
+#include "rif/util/rif_hash.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ */
+
+RIF_THREAD_LOCAL rif_arena_t *_rif_arena_current = NULL;
+
+/******************************************************************************
+ * STATIC HELPERS
+ */
+
+static inline
+char * _rif_arena_align(char *ptr, size_t alignment) {
+  return (char *) (((uintptr_t) ptr + alignment - 1) & ~((uintptr_t) alignment - 1));
+}
+
+/*
+ * Chunks come straight from the heap allocators: they must not be served by the current arena itself.
+ */
+static
+rif_arena_chunk_t * _rif_arena_chunk_alloc(size_t size) {
+
+#ifndef NDEBUG
+  if (!_rif_alloc_filter("RIF_ARENA_CHUNK_ALLOC")) {
+    return NULL;
+  }
+#endif
+
+  rif_arena_chunk_t *chunk_ptr = _rif_allocators.f_malloc(sizeof(rif_arena_chunk_t) + size);
+  if (__unlikely(!chunk_ptr)) {
+    return chunk_ptr;
+  }
+  chunk_ptr->end = chunk_ptr->data + size;
+  chunk_ptr->left = NULL;
+  chunk_ptr->right = NULL;
+  chunk_ptr->priority = rif_hash_64((uint64_t) (uintptr_t) chunk_ptr);
+  return chunk_ptr;
+}
+
+/*
+ * Inserts a chunk in the tree rooted at `node_ptr`, and returns the new root. Chunks are ordered by address, and
+ * rotated up while their priority is higher than their parent one, which keeps the tree balanced in expectation: chunk
+ * addresses are often increasing, and would otherwise degenerate the tree into a list.
+ */
+static
+rif_arena_chunk_t * _rif_arena_tree_insert(rif_arena_chunk_t *node_ptr, rif_arena_chunk_t *chunk_ptr) {
+  if (!node_ptr) {
+    return chunk_ptr;
+  }
+  rif_arena_chunk_t *child_ptr;
+  if ((uintptr_t) chunk_ptr < (uintptr_t) node_ptr) {
+    child_ptr = node_ptr->left = _rif_arena_tree_insert(node_ptr->left, chunk_ptr);
+    if (child_ptr->priority > node_ptr->priority) {
+      node_ptr->left = child_ptr->right;
+      child_ptr->right = node_ptr;
+      return child_ptr;
+    }
+  } else {
+    child_ptr = node_ptr->right = _rif_arena_tree_insert(node_ptr->right, chunk_ptr);
+    if (child_ptr->priority > node_ptr->priority) {
+      node_ptr->right = child_ptr->left;
+      child_ptr->left = node_ptr;
+      return child_ptr;
+    }
+  }
+  return node_ptr;
+}
+
+static
+const rif_arena_chunk_t * _rif_arena_chunk_of(const rif_arena_t *arena_ptr, const void *ptr) {
+
+  // Most arena memory being freed or resized comes from the current chunk
+  const rif_arena_chunk_t *chunk_ptr = arena_ptr->chunk;
+  if (chunk_ptr && (const char *) ptr >= chunk_ptr->data && (const char *) ptr < chunk_ptr->end) {
+    return chunk_ptr;
+  }
+
+  chunk_ptr = arena_ptr->root;
+  while (chunk_ptr) {
+    if ((const char *) ptr < chunk_ptr->data) {
+      chunk_ptr = chunk_ptr->left;
+    } else if ((const char *) ptr >= chunk_ptr->end) {
+      chunk_ptr = chunk_ptr->right;
+    } else {
+      return chunk_ptr;
+    }
+  }
+  return NULL;
+}
+
+static
+void * _rif_arena_alloc_slow(rif_arena_t *arena_ptr, size_t alignment, size_t size) {
+  size_t needed = size + alignment - 1;
+  if (__unlikely(needed < size)) {
+    return NULL;
+  }
+
+  // Large allocations get a dedicated chunk, kept behind the current one so that its free space is not lost
+  if (needed > arena_ptr->chunk_size) {
+    rif_arena_chunk_t *chunk_ptr = _rif_arena_chunk_alloc(needed);
+    if (__unlikely(!chunk_ptr)) {
+      return NULL;
+    }
+    arena_ptr->root = _rif_arena_tree_insert(arena_ptr->root, chunk_ptr);
+    if (arena_ptr->chunk) {
+      chunk_ptr->prev = arena_ptr->chunk->prev;
+      arena_ptr->chunk->prev = chunk_ptr;
+    } else {
+      chunk_ptr->prev = NULL;
+      arena_ptr->chunk = chunk_ptr;
+      arena_ptr->position = chunk_ptr->end;
+      arena_ptr->last = NULL;
+    }
+    return _rif_arena_align(chunk_ptr->data, alignment);
+  }
+
+  // Otherwise, start a new regular chunk
+  rif_arena_chunk_t *chunk_ptr = _rif_arena_chunk_alloc(arena_ptr->chunk_size);
+  if (__unlikely(!chunk_ptr)) {
+    return NULL;
+  }
+  chunk_ptr->prev = arena_ptr->chunk;
+  arena_ptr->chunk = chunk_ptr;
+  arena_ptr->root = _rif_arena_tree_insert(arena_ptr->root, chunk_ptr);
+  arena_ptr->last = _rif_arena_align(chunk_ptr->data, alignment);
+  arena_ptr->position = arena_ptr->last + size;
+  return arena_ptr->last;
+}
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+rif_arena_t * rif_arena_init(rif_arena_t *arena_ptr, size_t chunk_size) {
+  if (!arena_ptr) {
+    return arena_ptr;
+  }
+  arena_ptr->chunk_size = chunk_size ? chunk_size : RIF_ARENA_DEFAULT_CHUNK_SIZE;
+  arena_ptr->chunk = NULL;
+  arena_ptr->root = NULL;
+  arena_ptr->position = NULL;
+  arena_ptr->last = NULL;
+  return arena_ptr;
+}
+
+void rif_arena_destroy(rif_arena_t *arena_ptr) {
+  rif_arena_chunk_t *chunk_ptr = arena_ptr->chunk;
+  while (chunk_ptr) {
+    rif_arena_chunk_t *prev = chunk_ptr->prev;
+    _rif_allocators.f_free(chunk_ptr);
+    chunk_ptr = prev;
+  }
+  rif_arena_init(arena_ptr, arena_ptr->chunk_size);
+}
+
+void rif_arena_reset(rif_arena_t *arena_ptr) {
+  rif_arena_chunk_t *kept = NULL;
+  rif_arena_chunk_t *chunk_ptr = arena_ptr->chunk;
+  while (chunk_ptr) {
+    rif_arena_chunk_t *prev = chunk_ptr->prev;
+    if (!kept && (size_t) (chunk_ptr->end - chunk_ptr->data) == arena_ptr->chunk_size) {
+      kept = chunk_ptr;
+    } else {
+      _rif_allocators.f_free(chunk_ptr);
+    }
+    chunk_ptr = prev;
+  }
+  arena_ptr->chunk = kept;
+  arena_ptr->root = kept;
+  arena_ptr->position = kept ? kept->data : NULL;
+  arena_ptr->last = NULL;
+  if (kept) {
+    kept->prev = NULL;
+    kept->left = NULL;
+    kept->right = NULL;
+  }
+}
+
+/******************************************************************************
+ * ALLOCATION FUNCTIONS
+ */
+
+void * rif_arena_aligned_alloc(rif_arena_t *arena_ptr, size_t alignment, size_t size) {
+  size = size ? size : 1;
+  if (__likely(arena_ptr->chunk)) {
+    char *ptr = _rif_arena_align(arena_ptr->position, alignment);
+    if (__likely(ptr <= arena_ptr->chunk->end && size <= (size_t) (arena_ptr->chunk->end - ptr))) {
+      arena_ptr->last = ptr;
+      arena_ptr->position = ptr + size;
+      return ptr;
+    }
+  }
+  return _rif_arena_alloc_slow(arena_ptr, alignment, size);
+}
+
+void * rif_arena_alloc(rif_arena_t *arena_ptr, size_t size) {
+  return rif_arena_aligned_alloc(arena_ptr, RIF_ARENA_ALIGNMENT, size);
+}
+
+void * rif_arena_realloc(rif_arena_t *arena_ptr, void *ptr, size_t size) {
+  if (!ptr) {
+    return rif_arena_alloc(arena_ptr, size);
+  }
+
+  // Grow or shrink the last allocation in place
+  if (ptr == arena_ptr->last && size <= (size_t) (arena_ptr->chunk->end - (char *) ptr)) {
+    arena_ptr->position = (char *) ptr + (size ? size : 1);
+    return ptr;
+  }
+
+  // Otherwise move it. The old size is unknown, so copy as much as the old chunk holds past `ptr`.
+  const rif_arena_chunk_t *chunk_ptr = _rif_arena_chunk_of(arena_ptr, ptr);
+  void *new_ptr = rif_arena_alloc(arena_ptr, size);
+  if (__unlikely(!new_ptr)) {
+    return new_ptr;
+  }
+  size_t available = (size_t) (chunk_ptr->end - (char *) ptr);
+  memmove(new_ptr, ptr, size < available ? size : available);
+  return new_ptr;
+}
+
+void rif_arena_free(rif_arena_t *arena_ptr, void *ptr) {
+  if (ptr && ptr == arena_ptr->last) {
+    arena_ptr->position = arena_ptr->last;
+    arena_ptr->last = NULL;
+  }
+}
+
+/******************************************************************************
+ * INFO FUNCTIONS
+ */
+
+bool rif_arena_owns(const rif_arena_t *arena_ptr, const void *ptr) {
+  return ptr && NULL != _rif_arena_chunk_of(arena_ptr, ptr);
+}
+
+uint32_t rif_arena_chunk_count(const rif_arena_t *arena_ptr) {
+  uint32_t count = 0;
+  const rif_arena_chunk_t *chunk_ptr = arena_ptr->chunk;
+  for (; chunk_ptr; chunk_ptr = chunk_ptr->prev) {
+    ++count;
+  }
+  return count;
+}
+
+/******************************************************************************
+ * SCOPE FUNCTIONS
+ */
+
+rif_arena_t * rif_arena_set_current(rif_arena_t *arena_ptr) {
+  rif_arena_t *previous = _rif_arena_current;
+  _rif_arena_current = arena_ptr;
+  return previous;
+}
+
+rif_arena_t * rif_arena_current(void) {
+  return _rif_arena_current;
+}
@@ -34,4 +34,9 @@ uint32_t rif_hash_64(uint64_t key) {
 uint32_t rif_hash_mix_32(uint32_t first, uint32_t second) {
   uint64_t comb = (uint64_t) first << 32 | second;
   return XXH32(&comb, sizeof(uint64_t), 0);
-}
\ No newline at end of file
+}
+
+uint32_t rif_hash_bytes(const void *data, size_t len) {
+  uint64_t hash = XXH64(data, len, 0);
+  return (uint32_t) (hash ^ (hash >> 32));
+}
@@ -24,7 +24,9 @@
 #if defined(__GNUC__)
   RIF_INLINE bool __likely(bool x) { return __builtin_expect((x), true); }
   RIF_INLINE bool __unlikely(bool x) { return __builtin_expect((x), false); }
+  RIF_INLINE void __prefetch(const void *addr) { __builtin_prefetch(addr, 0, 3); }
 #else
   RIF_INLINE bool __likely(bool x) { return x; }
 	RIF_INLINE bool __unlikely(bool x) { return x; }
+  RIF_INLINE void __prefetch(const void *addr) { (void) addr; }
 #endif
\ No newline at end of file
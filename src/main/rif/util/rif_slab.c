@@ -0,0 +1,233 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "rif/rif_internal.h"
+
+#include "rif/concurrent/rif_atomic.h"
+#include "rif/concurrent/rif_threads.h"
+
+/******************************************************************************
+ * TYPES
+ */
+
+/*
+ * Shared depot of one size class: a stack of chains, linked through the second word of their first object.
+ */
+typedef struct rif_slab_depot_s {
+  atomic_flag lock;
+  void *first_chain;
+} rif_slab_depot_t;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ */
+
+bool _rif_slab_enabled = true;
+uint32_t _rif_slab_batch_size = RIF_SLAB_DEFAULT_BATCH_SIZE;
+RIF_THREAD_LOCAL rif_slab_cache_t _rif_slab_cache;
+
+/******************************************************************************
+ * STATIC VARIABLES
+ */
+
+static rif_slab_depot_t _rif_slab_depots[RIF_SLAB_CLASS_COUNT];
+
+/* Every slab, linked through its first word, so that slabs stay reachable. */
+static atomic_uintptr_t _rif_slab_first;
+static atomic_uint32_t _rif_slab_count;
+
+/* Thread-specific storage key, only used to flush thread caches on thread exit. */
+static once_flag _rif_slab_key_once = ONCE_FLAG_INIT;
+static tss_t _rif_slab_key;
+static bool _rif_slab_key_valid = false;
+
+/******************************************************************************
+ * DEPOT HELPERS
+ */
+
+#define _rif_slab_next(__ptr) (*(void **) (__ptr))
+#define _rif_slab_next_chain(__ptr) (((void **) (__ptr))[1])
+
+static
+void _rif_slab_depot_push(uint8_t size_class, rif_slab_chain_t *chain_ptr) {
+  if (!chain_ptr->first) {
+    return;
+  }
+  rif_slab_depot_t *depot_ptr = &_rif_slab_depots[size_class];
+  while (atomic_flag_test_and_set_explicit(&depot_ptr->lock, memory_order_acquire));
+  _rif_slab_next_chain(chain_ptr->first) = depot_ptr->first_chain;
+  depot_ptr->first_chain = chain_ptr->first;
+  atomic_flag_clear_explicit(&depot_ptr->lock, memory_order_release);
+  chain_ptr->first = NULL;
+  chain_ptr->count = 0;
+}
+
+static
+bool _rif_slab_depot_pop(uint8_t size_class, rif_slab_chain_t *chain_ptr) {
+  rif_slab_depot_t *depot_ptr = &_rif_slab_depots[size_class];
+  while (atomic_flag_test_and_set_explicit(&depot_ptr->lock, memory_order_acquire));
+  void *ptr = depot_ptr->first_chain;
+  if (ptr) {
+    depot_ptr->first_chain = _rif_slab_next_chain(ptr);
+  }
+  atomic_flag_clear_explicit(&depot_ptr->lock, memory_order_release);
+  chain_ptr->first = ptr;
+  chain_ptr->count = 0;
+  for (; ptr; ptr = _rif_slab_next(ptr)) {
+    ++chain_ptr->count;
+  }
+  return chain_ptr->count > 0;
+}
+
+/******************************************************************************
+ * THREAD CACHE HELPERS
+ */
+
+static
+void _rif_slab_cache_flush(void *ptr) {
+  rif_slab_cache_t *cache_ptr = ptr;
+  uint8_t size_class = 0;
+  for (; size_class < RIF_SLAB_CLASS_COUNT; ++size_class) {
+    _rif_slab_depot_push(size_class, &cache_ptr->loaded[size_class]);
+    _rif_slab_depot_push(size_class, &cache_ptr->previous[size_class]);
+  }
+}
+
+static
+void _rif_slab_key_create(void) {
+  _rif_slab_key_valid = thrd_success == tss_create(&_rif_slab_key, _rif_slab_cache_flush);
+}
+
+/*
+ * Have the thread cache flushed to the depots when the thread exits.
+ */
+static
+void _rif_slab_cache_register(void) {
+  call_once(&_rif_slab_key_once, _rif_slab_key_create);
+  if (_rif_slab_key_valid) {
+    tss_set(_rif_slab_key, &_rif_slab_cache);
+  }
+  _rif_slab_cache.registered = true;
+}
+
+/******************************************************************************
+ * SLAB HELPERS
+ */
+
+/*
+ * Carve a new slab: the first batch goes to `chain_ptr`, every other batch to the depot.
+ */
+static
+bool _rif_slab_carve(uint8_t size_class, rif_slab_chain_t *chain_ptr) {
+
+#ifndef NDEBUG
+  if (!_rif_alloc_filter("RIF_SLAB_ALLOC")) {
+    return false;
+  }
+#endif
+
+  // Slabs are kept forever: never carve them from an arena
+  char *slab_ptr = _rif_allocators.f_malloc(RIF_SLAB_BYTES);
+  if (__unlikely(!slab_ptr)) {
+    return false;
+  }
+  uintptr_t first = atomic_load_explicit(&_rif_slab_first, memory_order_relaxed);
+  do {
+    _rif_slab_next(slab_ptr) = (void *) first;
+  } while (!atomic_compare_exchange_weak_explicit(&_rif_slab_first, &first, (uintptr_t) slab_ptr,
+                                                  memory_order_release, memory_order_relaxed));
+  atomic_fetch_add_explicit(&_rif_slab_count, 1, memory_order_relaxed);
+
+  // Carve objects backwards, so that every batch is chained in address order
+  size_t size = RIF_SLAB_MIN_SIZE + (size_t) size_class * RIF_SLAB_GRANULARITY;
+  uint32_t count = (RIF_SLAB_BYTES - RIF_SLAB_MIN_SIZE) / size;
+  rif_slab_chain_t batch = {NULL, 0};
+  while (count--) {
+    void *ptr = slab_ptr + RIF_SLAB_MIN_SIZE + (size_t) count * size;
+    _rif_slab_next(ptr) = batch.first;
+    batch.first = ptr;
+    ++batch.count;
+    if (!count) {
+      *chain_ptr = batch;
+    } else if (batch.count == _rif_slab_batch_size) {
+      _rif_slab_depot_push(size_class, &batch);
+    }
+  }
+  return true;
+}
+
+/******************************************************************************
+ * SLOW PATHS
+ */
+
+void * _rif_slab_alloc_slow(uint8_t size_class) {
+  if (__unlikely(!_rif_slab_cache.registered)) {
+    _rif_slab_cache_register();
+  }
+  rif_slab_chain_t *loaded_ptr = &_rif_slab_cache.loaded[size_class];
+  rif_slab_chain_t *previous_ptr = &_rif_slab_cache.previous[size_class];
+  if (previous_ptr->first) {
+    *loaded_ptr = *previous_ptr;
+    previous_ptr->first = NULL;
+    previous_ptr->count = 0;
+  } else if (!_rif_slab_depot_pop(size_class, loaded_ptr) && !_rif_slab_carve(size_class, loaded_ptr)) {
+    return NULL;
+  }
+  void *ptr = loaded_ptr->first;
+  loaded_ptr->first = _rif_slab_next(ptr);
+  --loaded_ptr->count;
+  return ptr;
+}
+
+void _rif_slab_free_slow(void *ptr, uint8_t size_class) {
+  if (__unlikely(!_rif_slab_cache.registered)) {
+    _rif_slab_cache_register();
+  }
+  rif_slab_chain_t *loaded_ptr = &_rif_slab_cache.loaded[size_class];
+  rif_slab_chain_t *previous_ptr = &_rif_slab_cache.previous[size_class];
+  _rif_slab_depot_push(size_class, previous_ptr);
+  *previous_ptr = *loaded_ptr;
+  loaded_ptr->first = ptr;
+  loaded_ptr->count = 1;
+  _rif_slab_next(ptr) = NULL;
+}
+
+/******************************************************************************
+ * SETTINGS FUNCTIONS
+ */
+
+void rif_slab_set_enabled(bool enabled) {
+  _rif_slab_enabled = enabled;
+}
+
+bool rif_slab_enabled(void) {
+  return _rif_slab_enabled;
+}
+
+void rif_slab_set_batch_size(uint32_t batch_size) {
+  _rif_slab_batch_size = batch_size ? batch_size : RIF_SLAB_DEFAULT_BATCH_SIZE;
+}
+
+/******************************************************************************
+ * STATISTICS FUNCTIONS
+ */
+
+uint32_t rif_slab_count(void) {
+  return atomic_load_explicit(&_rif_slab_count, memory_order_relaxed);
+}
@@ -0,0 +1,141 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#pragma once
+
+#include "rif/util/rif_slab.h"
+#include "rif_alloc_internal.h"
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ */
+
+/*
+ * Chain of free objects, linked through their first word.
+ */
+typedef struct rif_slab_chain_s {
+  void *first;
+  uint32_t count;
+} rif_slab_chain_t;
+
+/*
+ * Per-thread cache: for each size class, a chain objects are allocated from and freed to, and a full chain kept aside
+ * so that alternating allocations and frees at a batch boundary do not hit the depot.
+ */
+typedef struct rif_slab_cache_s {
+  rif_slab_chain_t loaded[RIF_SLAB_CLASS_COUNT];
+  rif_slab_chain_t previous[RIF_SLAB_CLASS_COUNT];
+  bool registered;
+} rif_slab_cache_t;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ */
+
+extern bool _rif_slab_enabled;
+extern uint32_t _rif_slab_batch_size;
+extern RIF_THREAD_LOCAL rif_slab_cache_t _rif_slab_cache;
+
+/******************************************************************************
+ * SLOW PATHS
+ */
+
+void * _rif_slab_alloc_slow(uint8_t size_class);
+void _rif_slab_free_slow(void *ptr, uint8_t size_class);
+
+/******************************************************************************
+ * ALLOCATOR MACROS
+ */
+
+#define rif_tagged_slab_alloc(__size, __size_class_ptr, __tag, ...) \
+    rif_slab_alloc_helper(__size, __size_class_ptr, __tag);
+#define rif_slab_alloc(...) rif_tagged_slab_alloc(__VA_ARGS__, NULL);
+
+/*
+ * Record the size class of a value built from `rif_slab_alloc` memory, so that it is returned to its cache.
+ */
+#define rif_val_set_size_class(__val_ptr, __size_class) \
+    do { \
+      if (__val_ptr) { \
+        rif_val(__val_ptr)->size_class = (__size_class); \
+      } \
+    } while (0)
+
+/******************************************************************************
+ * ALLOCATOR ACCESSORS
+ */
+
+/*
+ * Allocate a small object. `size_class_ptr` receives the size class index plus one, or `0` if the object comes from the
+ * heap allocators (caches disabled, arena current, or object too large) and must be released with `rif_free`.
+ */
+RIF_INLINE
+void * rif_slab_alloc_helper(size_t size, uint8_t *size_class_ptr, const char *tag) {
+
+#ifndef NDEBUG
+  if (tag && !_rif_alloc_filter(tag)) {
+    *size_class_ptr = 0;
+    return NULL;
+  }
+#endif
+
+  if (__unlikely(!_rif_slab_enabled || _rif_arena_current || size > RIF_SLAB_MAX_SIZE)) {
+    *size_class_ptr = 0;
+    return rif_malloc(size);
+  }
+  uint8_t size_class = size <= RIF_SLAB_MIN_SIZE ? 0 :
+                       (uint8_t) ((size - RIF_SLAB_MIN_SIZE + RIF_SLAB_GRANULARITY - 1) / RIF_SLAB_GRANULARITY);
+  *size_class_ptr = size_class + 1;
+  rif_slab_chain_t *chain_ptr = &_rif_slab_cache.loaded[size_class];
+  void *ptr = chain_ptr->first;
+  if (__likely(ptr)) {
+    chain_ptr->first = *(void **) ptr;
+    --chain_ptr->count;
+    return ptr;
+  }
+  return _rif_slab_alloc_slow(size_class);
+}
+
+/*
+ * Return an object to the calling thread cache. `size_class` is the value given by `rif_slab_alloc`, and must not be
+ * `0`.
+ */
+RIF_INLINE
+void rif_slab_free(void *ptr, uint8_t size_class) {
+  rif_slab_chain_t *chain_ptr = &_rif_slab_cache.loaded[--size_class];
+  if (__unlikely(chain_ptr->count >= _rif_slab_batch_size)) {
+    _rif_slab_free_slow(ptr, size_class);
+    return;
+  }
+  *(void **) ptr = chain_ptr->first;
+  chain_ptr->first = ptr;
+  ++chain_ptr->count;
+}
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
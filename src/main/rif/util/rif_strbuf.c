@@ -0,0 +1,201 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "rif/rif_internal.h"
+
+#include "rif/util/rif_strbuf.h"
+
+/******************************************************************************
+ * STATIC HELPERS
+ */
+
+static
+bool _rif_strbuf_write_all(int fd, const char *str, size_t len) {
+  while (len > 0) {
+    ssize_t count = write(fd, str, len);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    str += count;
+    len -= (size_t) count;
+  }
+  return true;
+}
+
+/*
+ * Grows the storage of an in-memory buffer so that it can hold at least `capacity` bytes.
+ */
+static
+bool _rif_strbuf_grow(rif_strbuf_t *sb_ptr, size_t capacity) {
+  size_t new_capacity = sb_ptr->capacity ? sb_ptr->capacity * 2 : RIF_STRBUF_DEFAULT_CAPACITY;
+  if (new_capacity < capacity) {
+    new_capacity = capacity;
+  }
+  char *data;
+  if (sb_ptr->data) {
+    data = rif_realloc(sb_ptr->data, new_capacity, "RIF_STRBUF_GROW");
+  } else {
+    data = rif_malloc(new_capacity, "RIF_STRBUF_GROW");
+  }
+  if (!data) {
+    return false;
+  }
+  sb_ptr->data = data;
+  sb_ptr->capacity = new_capacity;
+  return true;
+}
+
+/******************************************************************************
+ * LIFECYCLE FUNCTIONS
+ */
+
+static
+rif_strbuf_t * _rif_strbuf_build(rif_strbuf_t *sb_ptr, int fd, size_t capacity) {
+  if (!sb_ptr) {
+    return sb_ptr;
+  }
+  sb_ptr->data = NULL;
+  sb_ptr->size = 0;
+  sb_ptr->capacity = 0;
+  sb_ptr->written = 0;
+  sb_ptr->fd = fd;
+  sb_ptr->status = RIF_OK;
+  if (capacity) {
+    sb_ptr->data = rif_malloc(capacity, "RIF_STRBUF_ALLOC");
+    if (!sb_ptr->data) {
+      return NULL;
+    }
+    sb_ptr->capacity = capacity;
+  }
+  return sb_ptr;
+}
+
+rif_strbuf_t * rif_strbuf_init(rif_strbuf_t *sb_ptr, size_t capacity) {
+  return _rif_strbuf_build(sb_ptr, -1, capacity);
+}
+
+rif_strbuf_t * rif_strbuf_init_fd(rif_strbuf_t *sb_ptr, int fd, size_t chunk_size) {
+  return _rif_strbuf_build(sb_ptr, fd, chunk_size ? chunk_size : RIF_STRBUF_DEFAULT_CHUNK_SIZE);
+}
+
+void rif_strbuf_destroy(rif_strbuf_t *sb_ptr) {
+  if (sb_ptr->data) {
+    rif_free(sb_ptr->data);
+  }
+  sb_ptr->data = NULL;
+  sb_ptr->size = 0;
+  sb_ptr->capacity = 0;
+}
+
+/******************************************************************************
+ * APPEND FUNCTIONS
+ */
+
+rif_status_t rif_strbuf_append_helper(rif_strbuf_t *sb_ptr, const char *str, size_t len) {
+  if (__unlikely(sb_ptr->status != RIF_OK)) {
+    return sb_ptr->status;
+  }
+  if (sb_ptr->capacity - sb_ptr->size < len) {
+    if (sb_ptr->fd < 0) {
+      if (!_rif_strbuf_grow(sb_ptr, sb_ptr->size + len)) {
+        return rif_strbuf_set_error(sb_ptr, RIF_ERR_MEMORY);
+      }
+    } else {
+      if (RIF_OK != rif_strbuf_flush(sb_ptr)) {
+        return sb_ptr->status;
+      }
+      // Text larger than the chunk goes straight to the file descriptor
+      if (len >= sb_ptr->capacity) {
+        if (!_rif_strbuf_write_all(sb_ptr->fd, str, len)) {
+          return rif_strbuf_set_error(sb_ptr, RIF_ERR_IO);
+        }
+        sb_ptr->written += len;
+        return RIF_OK;
+      }
+    }
+  }
+  memcpy(sb_ptr->data + sb_ptr->size, str, len);
+  sb_ptr->size += len;
+  return RIF_OK;
+}
+
+rif_status_t rif_strbuf_appendf(rif_strbuf_t *sb_ptr, const char *format, ...) {
+  if (__unlikely(sb_ptr->status != RIF_OK)) {
+    return sb_ptr->status;
+  }
+
+  // Most formatted values are short: format them on the stack first
+  char buf[128];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  if (len < 0) {
+    return rif_strbuf_set_error(sb_ptr, RIF_ERR_UNSUPPORTED);
+  }
+  if ((size_t) len < sizeof(buf)) {
+    return rif_strbuf_append(sb_ptr, buf, (size_t) len);
+  }
+
+  char *str = rif_malloc((size_t) len + 1, "RIF_STRBUF_FORMAT");
+  if (!str) {
+    return rif_strbuf_set_error(sb_ptr, RIF_ERR_MEMORY);
+  }
+  va_start(args, format);
+  vsnprintf(str, (size_t) len + 1, format, args);
+  va_end(args);
+  rif_strbuf_append(sb_ptr, str, (size_t) len);
+  rif_free(str);
+  return sb_ptr->status;
+}
+
+/******************************************************************************
+ * OUTPUT FUNCTIONS
+ */
+
+rif_status_t rif_strbuf_flush(rif_strbuf_t *sb_ptr) {
+  if (sb_ptr->status != RIF_OK || sb_ptr->fd < 0 || !sb_ptr->size) {
+    return sb_ptr->status;
+  }
+  if (!_rif_strbuf_write_all(sb_ptr->fd, sb_ptr->data, sb_ptr->size)) {
+    return rif_strbuf_set_error(sb_ptr, RIF_ERR_IO);
+  }
+  sb_ptr->written += sb_ptr->size;
+  sb_ptr->size = 0;
+  return RIF_OK;
+}
+
+char * rif_strbuf_detach(rif_strbuf_t *sb_ptr) {
+  if (sb_ptr->status != RIF_OK || sb_ptr->fd >= 0) {
+    return NULL;
+  }
+  if (sb_ptr->size == sb_ptr->capacity && !_rif_strbuf_grow(sb_ptr, sb_ptr->size + 1)) {
+    rif_strbuf_set_error(sb_ptr, RIF_ERR_MEMORY);
+    return NULL;
+  }
+  char *str = sb_ptr->data;
+  str[sb_ptr->size] = '\0';
+  sb_ptr->data = NULL;
+  sb_ptr->size = 0;
+  sb_ptr->capacity = 0;
+  return str;
+}
@@ -0,0 +1,285 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include <fcntl.h>
+
+#include "../test_internal.h"
+
+/******************************************************************************
+ * TEST HELPERS
+ */
+
+static
+bool _alloc_filter_buffer_new(const char *tag) {
+  return 0 != strcmp(tag, "RIF_BUFFER_NEW");
+}
+
+static
+bool _alloc_filter_buffer_new_copy(const char *tag) {
+  return 0 != strcmp(tag, "RIF_BUFFER_NEW_COPY");
+}
+
+static uint32_t _release_calls = 0;
+static void *_release_data = NULL;
+static size_t _release_len = 0;
+static void *_release_ctx = NULL;
+
+static
+void _counting_release(void *data, size_t len, void *ctx) {
+  ++_release_calls;
+  _release_data = data;
+  _release_len = len;
+  _release_ctx = ctx;
+}
+
+/******************************************************************************
+ * TEST CONFIG
+ */
+
+static const char _bytes[8] = {'f', 'o', 'o', '\0', 'b', 'a', 'r', '\0'};
+
+class Buffer : public MemoryAwareTest {
+
+public:
+
+  rif_buffer_t buf_foo;
+  rif_buffer_t buf_bar;
+
+private:
+
+  virtual void SetUp() {
+    MemoryAwareTest::SetUp();
+    rif_buffer_init(&buf_foo, (void *) _bytes, 3, false);
+    rif_buffer_init(&buf_bar, (void *) (_bytes + 4), 3, false);
+    _release_calls = 0;
+    _release_data = NULL;
+    _release_len = 0;
+    _release_ctx = NULL;
+  }
+
+  virtual void TearDown() {
+    rif_alloc_set_filter(NULL);
+    rif_buffer_release(&buf_foo);
+    rif_buffer_release(&buf_bar);
+    MemoryAwareTest::TearDown();
+  }
+
+};
+
+/******************************************************************************
+ * LIFECYCLE TESTS
+ */
+
+TEST_F(Buffer, rif_buffer_init_should_return_null_with_null_ptr) {
+  ASSERT_TRUE(NULL == rif_buffer_init(NULL, (void *) _bytes, 3, false));
+}
+
+TEST_F(Buffer, rif_buffer_init_should_wrap_memory) {
+  EXPECT_EQ(RIF_BUFFER, rif_val_type(&buf_foo));
+  EXPECT_EQ((const uint8_t *) _bytes, rif_buffer_data(&buf_foo));
+  EXPECT_EQ(3, rif_buffer_len(&buf_foo));
+  EXPECT_EQ(RIF_BUFFER_STORAGE_BORROWED, rif_buffer_storage(&buf_foo));
+}
+
+TEST_F(Buffer, rif_buffer_new_should_free_owned_memory) {
+  void *data = rif_malloc(16, "TEST");
+  rif_buffer_t *buf_ptr = rif_buffer_new(data, 16, true);
+  ASSERT_TRUE(NULL != buf_ptr);
+  EXPECT_EQ(RIF_BUFFER_STORAGE_OWNED, rif_buffer_storage(buf_ptr));
+  rif_buffer_release(buf_ptr);
+}
+
+TEST_F(Buffer, rif_buffer_new_should_return_null_on_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_buffer_new);
+  EXPECT_TRUE(NULL == rif_buffer_new((void *) _bytes, 3, false));
+  EXPECT_TRUE(NULL == rif_buffer_new_copy(_bytes, 3));
+  EXPECT_TRUE(NULL == rif_buffer_new_external((void *) _bytes, 3, _counting_release, NULL));
+  EXPECT_EQ(0, _release_calls);
+}
+
+TEST_F(Buffer, rif_buffer_new_copy_should_copy_bytes_with_zeros) {
+  char bytes[8];
+  memcpy(bytes, _bytes, sizeof(bytes));
+  rif_buffer_t *buf_ptr = rif_buffer_new_copy(bytes, sizeof(bytes));
+  ASSERT_TRUE(NULL != buf_ptr);
+  memset(bytes, 0, sizeof(bytes));
+  EXPECT_EQ(8, rif_buffer_len(buf_ptr));
+  EXPECT_EQ(0, memcmp(_bytes, rif_buffer_data(buf_ptr), sizeof(_bytes)));
+  rif_buffer_release(buf_ptr);
+}
+
+TEST_F(Buffer, rif_buffer_new_copy_should_return_null_on_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_buffer_new_copy);
+  EXPECT_TRUE(NULL == rif_buffer_new_copy(_bytes, 3));
+}
+
+TEST_F(Buffer, rif_buffer_new_copy_should_accept_empty_buffers) {
+  rif_buffer_t *buf_ptr = rif_buffer_new_copy(NULL, 0);
+  ASSERT_TRUE(NULL != buf_ptr);
+  EXPECT_EQ(0, rif_buffer_len(buf_ptr));
+  rif_buffer_release(buf_ptr);
+}
+
+TEST_F(Buffer, rif_buffer_new_external_should_call_release_once) {
+  int ctx;
+  rif_buffer_t *buf_ptr = rif_buffer_new_external((void *) _bytes, 3, _counting_release, &ctx);
+  ASSERT_TRUE(NULL != buf_ptr);
+  EXPECT_EQ(RIF_BUFFER_STORAGE_EXTERNAL, rif_buffer_storage(buf_ptr));
+  rif_val_retain(buf_ptr);
+  rif_buffer_release(buf_ptr);
+  EXPECT_EQ(0, _release_calls);
+  rif_buffer_release(buf_ptr);
+  EXPECT_EQ(1, _release_calls);
+  EXPECT_EQ((void *) _bytes, _release_data);
+  EXPECT_EQ(3, _release_len);
+  EXPECT_EQ(&ctx, _release_ctx);
+}
+
+TEST_F(Buffer, rif_buffer_new_mmap_should_map_file_region) {
+  FILE *file = tmpfile();
+  ASSERT_TRUE(NULL != file);
+  std::vector<char> content(3 * sysconf(_SC_PAGESIZE));
+  for (size_t i = 0; i < content.size(); ++i) {
+    content[i] = (char) (i * 7);
+  }
+  fwrite(content.data(), 1, content.size(), file);
+  fflush(file);
+  int fd = dup(fileno(file));
+  fclose(file);
+
+  size_t offset = sysconf(_SC_PAGESIZE) + 123;
+  rif_buffer_t *buf_ptr = rif_buffer_new_mmap(fd, (off_t) offset, 1000);
+  close(fd);
+  ASSERT_TRUE(NULL != buf_ptr);
+  EXPECT_EQ(RIF_BUFFER_STORAGE_MAPPED, rif_buffer_storage(buf_ptr));
+  EXPECT_EQ(1000, rif_buffer_len(buf_ptr));
+  EXPECT_EQ(0, memcmp(content.data() + offset, rif_buffer_data(buf_ptr), 1000));
+  rif_buffer_t *copy_ptr = rif_buffer_new_copy(content.data() + offset, 1000);
+  EXPECT_TRUE(rif_val_equals(buf_ptr, copy_ptr));
+  EXPECT_EQ(rif_val_hashcode(buf_ptr), rif_val_hashcode(copy_ptr));
+  rif_buffer_release(copy_ptr);
+  rif_buffer_release(buf_ptr);
+}
+
+TEST_F(Buffer, rif_buffer_new_mmap_should_return_null_with_invalid_fd) {
+  int fd = open("/dev/null", O_WRONLY);
+  ASSERT_LE(0, fd);
+  EXPECT_TRUE(NULL == rif_buffer_new_mmap(fd, 0, 16));
+  close(fd);
+  EXPECT_TRUE(NULL == rif_buffer_new_mmap(-1, 0, 16));
+}
+
+/******************************************************************************
+ * SLICING TESTS
+ */
+
+TEST_F(Buffer, rif_buffer_slice_should_not_copy_bytes) {
+  rif_buffer_t whole;
+  rif_buffer_init(&whole, (void *) _bytes, sizeof(_bytes), false);
+  rif_buffer_t *slice_ptr = rif_buffer_slice(&whole, 4, 3);
+  ASSERT_TRUE(NULL != slice_ptr);
+  EXPECT_EQ(RIF_BUFFER_STORAGE_SLICE, rif_buffer_storage(slice_ptr));
+  EXPECT_EQ(rif_buffer_data(&whole) + 4, rif_buffer_data(slice_ptr));
+  EXPECT_EQ(3, rif_buffer_len(slice_ptr));
+  EXPECT_TRUE(rif_val_equals(&buf_bar, slice_ptr));
+  EXPECT_EQ(2, rif_val_reference_count(&whole));
+  rif_buffer_release(slice_ptr);
+  EXPECT_EQ(1, rif_val_reference_count(&whole));
+}
+
+TEST_F(Buffer, rif_buffer_slice_should_return_null_out_of_bounds) {
+  EXPECT_TRUE(NULL == rif_buffer_slice(&buf_foo, 4, 0));
+  EXPECT_TRUE(NULL == rif_buffer_slice(&buf_foo, 1, 3));
+  EXPECT_TRUE(NULL == rif_buffer_slice(&buf_foo, 1, SIZE_MAX));
+  rif_buffer_t *slice_ptr = rif_buffer_slice(&buf_foo, 3, 0);
+  ASSERT_TRUE(NULL != slice_ptr);
+  EXPECT_EQ(0, rif_buffer_len(slice_ptr));
+  rif_buffer_release(slice_ptr);
+}
+
+TEST_F(Buffer, rif_buffer_slice_should_refer_to_the_storage_buffer) {
+  rif_buffer_t *buf_ptr = rif_buffer_new_external((void *) _bytes, sizeof(_bytes), _counting_release, NULL);
+  rif_buffer_t *slice_ptr = rif_buffer_slice(buf_ptr, 1, 6);
+  rif_buffer_t *sub_slice_ptr = rif_buffer_slice(slice_ptr, 3, 3);
+  ASSERT_TRUE(NULL != sub_slice_ptr);
+  EXPECT_EQ(3, rif_val_reference_count(buf_ptr));
+  EXPECT_EQ(1, rif_val_reference_count(slice_ptr));
+  EXPECT_TRUE(rif_val_equals(&buf_bar, sub_slice_ptr));
+
+  // The storage outlives the buffer as long as a slice needs it
+  rif_buffer_release(buf_ptr);
+  rif_buffer_release(slice_ptr);
+  EXPECT_EQ(0, _release_calls);
+  rif_buffer_release(sub_slice_ptr);
+  EXPECT_EQ(1, _release_calls);
+}
+
+TEST_F(Buffer, rif_buffer_slice_should_return_null_on_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_buffer_new);
+  EXPECT_TRUE(NULL == rif_buffer_slice(&buf_foo, 0, 1));
+  EXPECT_EQ(1, rif_val_reference_count(&buf_foo));
+}
+
+/******************************************************************************
+ * CALLBACK TESTS
+ */
+
+TEST_F(Buffer, rif_buffer_hashcode_should_be_value_dependent) {
+  rif_buffer_t *copy_ptr = rif_buffer_new_copy("foo", 3);
+  EXPECT_EQ(rif_val_hashcode(&buf_foo), rif_val_hashcode(copy_ptr));
+  EXPECT_NE(rif_val_hashcode(&buf_foo), rif_val_hashcode(&buf_bar));
+  rif_buffer_release(copy_ptr);
+}
+
+TEST_F(Buffer, rif_buffer_equals_should_compare_bytes) {
+  rif_buffer_t *copy_ptr = rif_buffer_new_copy("foo", 3);
+  rif_buffer_t *zero_ptr = rif_buffer_new_copy(_bytes, 4);
+  rif_buffer_t empty;
+  rif_buffer_init(&empty, NULL, 0, false);
+  EXPECT_TRUE(rif_val_equals(&buf_foo, copy_ptr));
+  EXPECT_FALSE(rif_val_equals(&buf_foo, &buf_bar));
+  EXPECT_FALSE(rif_val_equals(&buf_foo, zero_ptr));
+  EXPECT_FALSE(rif_val_equals(&buf_foo, &empty));
+  rif_val_hashcode(&buf_foo);
+  rif_val_hashcode(&buf_bar);
+  EXPECT_FALSE(rif_val_equals(&buf_foo, &buf_bar));
+  rif_buffer_release(copy_ptr);
+  rif_buffer_release(zero_ptr);
+}
+
+TEST_F(Buffer, rif_buffer_should_not_equal_strings) {
+  rif_string_t str;
+  rif_string_init(&str, (char *) "foo", false);
+  EXPECT_FALSE(rif_val_equals(&buf_foo, &str));
+}
+
+TEST_F(Buffer, rif_buffer_tostring_should_be_meaningful) {
+  RIF_EXPECT_TOSTRING("<Buffer [bytes: 3]>", rif_val_tostring(&buf_foo));
+}
+
+TEST_F(Buffer, rif_buffer_should_be_usable_as_map_key) {
+  rif_hashmap_t *hm_ptr = rif_hashmap_new(0, false);
+  rif_hashmap_put(hm_ptr, rif_val(&buf_bar), rif_val(rif_true));
+  rif_buffer_t *packet_ptr = rif_buffer_new_copy(_bytes, sizeof(_bytes));
+  rif_buffer_t *key_ptr = rif_buffer_slice(packet_ptr, 4, 3);
+  EXPECT_EQ(rif_val(rif_true), rif_hashmap_get(hm_ptr, rif_val(key_ptr)));
+  rif_buffer_release(key_ptr);
+  rif_buffer_release(packet_ptr);
+  rif_hashmap_release(hm_ptr);
+}
\ No newline at end of file
@@ -127,4 +127,40 @@ TEST_F(Double, rif_double_should_be_equal_to_itself) {
   rif_double_t * double_ptr = rif_double_new(1.0);
   EXPECT_TRUE(rif_val_equals(&double_1, double_ptr));
   rif_double_release(double_ptr);
-}
\ No newline at end of file
+}
+
+TEST_F(Double, rif_double_get_cached_should_share_immortal_instances) {
+  rif_double_t *double_ptr = rif_double_get_cached(1.0);
+  EXPECT_EQ(1.0, rif_double_get(double_ptr));
+  EXPECT_EQ(double_ptr, rif_double_get_cached(1.0));
+  EXPECT_EQ(rif_val(double_ptr), rif_val_retain(double_ptr));
+  EXPECT_EQ(0, rif_val_reference_count(double_ptr));
+  EXPECT_EQ(rif_val(double_ptr), rif_val_release(double_ptr));
+  EXPECT_EQ(1.0, rif_double_get(double_ptr));
+  EXPECT_EQ(rif_double_get_cached(0.0), rif_double_get_cached(0.0));
+  EXPECT_TRUE(rif_val_equals(&double_0, rif_double_get_cached(0.0)));
+  EXPECT_EQ(rif_double_get_cached(NAN), rif_double_get_cached(-NAN));
+  EXPECT_TRUE(isnan(rif_double_get(rif_double_get_cached(NAN))));
+}
+
+TEST_F(Double, rif_double_get_cached_should_allocate_other_values) {
+  rif_double_t *double_ptr = rif_double_get_cached(-0.0);
+  EXPECT_NE(rif_double_get_cached(0.0), double_ptr);
+  EXPECT_TRUE(signbit(rif_double_get(double_ptr)));
+  EXPECT_EQ(1, rif_val_reference_count(double_ptr));
+  rif_double_release(double_ptr);
+  double_ptr = rif_double_get_cached(13.37);
+  EXPECT_EQ(13.37, rif_double_get(double_ptr));
+  rif_double_release(double_ptr);
+}
+
+TEST_F(Double, rif_double_new_should_share_instances_if_cache_enabled) {
+  EXPECT_FALSE(rif_double_cache_enabled());
+  rif_double_t *double_ptr = rif_double_new(0.0);
+  EXPECT_NE(rif_double_get_cached(0.0), double_ptr);
+  rif_double_release(double_ptr);
+  rif_double_set_cache_enabled(true);
+  EXPECT_TRUE(rif_double_cache_enabled());
+  EXPECT_EQ(rif_double_get_cached(0.0), rif_double_new(0.0));
+  rif_double_set_cache_enabled(false);
+}
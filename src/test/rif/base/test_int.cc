@@ -24,8 +24,8 @@
  */
 
 static
-bool _alloc_filter_int_tostring(const char *tag) {
-  return 0 != strcmp(tag, "RIF_INT_TOSTRING");
+bool _alloc_filter_strbuf_alloc(const char *tag) {
+  return 0 != strcmp(tag, "RIF_STRBUF_ALLOC");
 }
 
 /******************************************************************************
@@ -107,8 +107,15 @@ TEST_F(Int, rif_int_should_have_meaningful_tostring) {
   RIF_EXPECT_TOSTRING("1337", rif_val_tostring(&int_1337));
 }
 
+TEST_F(Int, rif_int_tostring_should_format_negative_and_extreme_values) {
+  rif_int_t int_tmp;
+  RIF_EXPECT_TOSTRING("-1337", rif_val_tostring(rif_int_init(&int_tmp, -1337)));
+  RIF_EXPECT_TOSTRING("9223372036854775807", rif_val_tostring(rif_int_init(&int_tmp, INT64_MAX)));
+  RIF_EXPECT_TOSTRING("-9223372036854775808", rif_val_tostring(rif_int_init(&int_tmp, INT64_MIN)));
+}
+
 TEST_F(Int, rif_int_tostring_should_return_null_on_failing_alloc) {
-  rif_alloc_set_filter(_alloc_filter_int_tostring);
+  rif_alloc_set_filter(_alloc_filter_strbuf_alloc);
   EXPECT_TRUE(NULL == rif_val_tostring(&int_1337));
   rif_alloc_set_filter(NULL);
 }
@@ -127,4 +134,84 @@ TEST_F(Int, rif_int_should_be_equal_to_itself) {
   rif_int_t * int_ptr = rif_int_new(1);
   EXPECT_TRUE(rif_val_equals(&int_1, int_ptr));
   rif_int_release(int_ptr);
-}
\ No newline at end of file
+}
+
+TEST_F(Int, rif_int_get_cached_should_never_be_thread_local) {
+  // The cache is filled by the first thread asking for it, whatever its settings
+  bool local = rif_val_set_local_default(true);
+  rif_int_t *int_ptr = rif_int_get_cached(42);
+  rif_val_set_local_default(local);
+  EXPECT_FALSE(rif_val_islocal(int_ptr));
+  for (int64_t i = RIF_INT_CACHE_MIN; i <= RIF_INT_CACHE_MAX; ++i) {
+    EXPECT_FALSE(rif_val_islocal(rif_int_get_cached(i)));
+  }
+}
+
+TEST_F(Int, rif_int_get_cached_should_share_immortal_instances_in_range) {
+  rif_int_t *int_ptr = rif_int_get_cached(42);
+  EXPECT_EQ(42, rif_int_get(int_ptr));
+  EXPECT_EQ(int_ptr, rif_int_get_cached(42));
+  EXPECT_EQ(rif_val(int_ptr), rif_val_retain(int_ptr));
+  EXPECT_EQ(0, rif_val_reference_count(int_ptr));
+  EXPECT_EQ(rif_val(int_ptr), rif_val_release(int_ptr));
+  EXPECT_EQ(rif_val(int_ptr), rif_val_release(int_ptr));
+  EXPECT_EQ(42, rif_int_get(int_ptr));
+  EXPECT_TRUE(rif_val_equals(&int_1, rif_int_get_cached(1)));
+  EXPECT_EQ(RIF_INT_CACHE_MIN, rif_int_get(rif_int_get_cached(RIF_INT_CACHE_MIN)));
+  EXPECT_EQ(RIF_INT_CACHE_MAX, rif_int_get(rif_int_get_cached(RIF_INT_CACHE_MAX)));
+}
+
+TEST_F(Int, rif_int_get_cached_should_allocate_values_out_of_range) {
+  rif_int_t *int_ptr = rif_int_get_cached(RIF_INT_CACHE_MAX + 1);
+  rif_int_t *other_ptr = rif_int_get_cached(RIF_INT_CACHE_MAX + 1);
+  EXPECT_NE(int_ptr, other_ptr);
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  EXPECT_EQ(RIF_INT_CACHE_MAX + 1, rif_int_get(int_ptr));
+  rif_int_release(int_ptr);
+  rif_int_release(other_ptr);
+  int_ptr = rif_int_get_cached(RIF_INT_CACHE_MIN - 1);
+  EXPECT_EQ(RIF_INT_CACHE_MIN - 1, rif_int_get(int_ptr));
+  rif_int_release(int_ptr);
+}
+
+TEST_F(Int, rif_int_new_should_share_instances_if_cache_enabled) {
+  EXPECT_FALSE(rif_int_cache_enabled());
+  rif_int_t *int_ptr = rif_int_new(7);
+  EXPECT_NE(rif_int_get_cached(7), int_ptr);
+  rif_int_release(int_ptr);
+  rif_int_set_cache_enabled(true);
+  EXPECT_TRUE(rif_int_cache_enabled());
+  EXPECT_EQ(rif_int_get_cached(7), rif_int_new(7));
+  rif_int_set_cache_enabled(false);
+}
+
+
+TEST_F(Int, rif_int_new_immediate_should_encode_values_in_range) {
+  int64_t values[] = {0, 1, -1, 1337, RIF_INT_IMMEDIATE_MIN, RIF_INT_IMMEDIATE_MAX};
+  for (uint32_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+    rif_int_t *int_ptr = rif_int_new_immediate(values[i]);
+    EXPECT_TRUE(rif_val_isimmediate(int_ptr));
+    EXPECT_EQ(RIF_INT, rif_val_type(int_ptr));
+    EXPECT_EQ(values[i], rif_int_get(int_ptr));
+    EXPECT_EQ(rif_val(int_ptr), rif_val_retain(int_ptr));
+    EXPECT_EQ(rif_val(int_ptr), rif_val_release(int_ptr));
+    EXPECT_EQ(int_ptr, rif_int_new_immediate(values[i]));
+  }
+}
+
+TEST_F(Int, rif_int_new_immediate_should_allocate_values_out_of_range) {
+  rif_int_t *int_ptr = rif_int_new_immediate(INT64_MAX);
+  EXPECT_FALSE(rif_val_isimmediate(int_ptr));
+  EXPECT_EQ(INT64_MAX, rif_int_get(int_ptr));
+  rif_int_release(int_ptr);
+}
+
+TEST_F(Int, rif_int_immediate_should_equal_allocated_ints) {
+  rif_int_t *int_ptr = rif_int_new_immediate(1337);
+  EXPECT_TRUE(rif_val_equals(int_ptr, &int_1337));
+  EXPECT_TRUE(rif_val_equals(&int_1337, int_ptr));
+  EXPECT_FALSE(rif_val_equals(int_ptr, &int_5));
+  EXPECT_FALSE(rif_val_equals(int_ptr, rif_string_new_immediate("1337")));
+  EXPECT_EQ(rif_val_hashcode(&int_1337), rif_val_hashcode(int_ptr));
+  RIF_EXPECT_TOSTRING("1337", rif_val_tostring(int_ptr));
+}
@@ -17,6 +17,8 @@
  * License along with this library.
  */
 
+#include <vector>
+
 #include "../test_internal.h"
 
 #include "support/pool_conformity.hh"
@@ -85,43 +87,57 @@ TEST_F(PagedPool, rif_paged_pool_init_should_return_null_on_failing_alloc) {
   rif_alloc_set_filter(NULL);
 }
 
+TEST_F(PagedPool, rif_paged_pool_init_should_fill_power_of_two_blocks) {
+  EXPECT_TRUE(rif_is_pow2(this->pool.block_bytes));
+  EXPECT_GE(this->pool.block_size, NUM_ELEMENTS);
+  EXPECT_LE(offsetof(rif_paged_pool_block_t, elements) + this->pool.block_size * this->pool.element_size,
+            this->pool.block_bytes);
+  EXPECT_EQ(0, ((uintptr_t) this->pool.first_block) % this->pool.block_bytes);
+}
+
 TEST_F(PagedPool, rif_paged_pool_borrow_should_return_an_existing_pointer) {
-  for(uint32_t i = 0; i < NUM_ELEMENTS; ++i) {
+  uint32_t block_size = this->pool.block_size;
+  for(uint32_t i = 0; i < block_size; ++i) {
     void *element = rif_paged_pool_borrow(&this->pool);
     ASSERT_FALSE(element == NULL);
   }
   ASSERT_TRUE(NULL == this->pool.first_available);
   ASSERT_TRUE(NULL == this->pool.last_available);
   ASSERT_TRUE(NULL == this->pool.first_block->next);
-  for(uint32_t i = 0; i < NUM_ELEMENTS; ++i) {
+  for(uint32_t i = 0; i < block_size; ++i) {
     void *element = rif_paged_pool_borrow(&this->pool);
     ASSERT_FALSE(element == NULL);
   }
   ASSERT_TRUE(NULL == this->pool.first_available);
   ASSERT_TRUE(NULL == this->pool.last_available);
+  EXPECT_EQ(2, rif_paged_pool_block_count(&this->pool));
+  EXPECT_EQ(2 * block_size, rif_paged_pool_live_count(&this->pool));
 }
 
 TEST_F(PagedPool, rif_paged_pool_return_should_release_a_pointer) {
-  void *elements[NUM_ELEMENTS];
-  for(uint32_t i = 0; i < NUM_ELEMENTS; ++i) {
+  uint32_t block_size = this->pool.block_size;
+  std::vector<void *> elements(block_size);
+  for(uint32_t i = 0; i < block_size; ++i) {
     void *element = rif_paged_pool_borrow(&this->pool);
     elements[i] = element;
     ASSERT_FALSE(element == NULL);
   }
   ASSERT_TRUE(NULL == this->pool.first_block->next);
   rif_paged_pool_return(&this->pool, elements[0]);
-  ASSERT_TRUE(elements[0] == this->pool.first_available);
-  ASSERT_TRUE(elements[0] == this->pool.last_available);
+  ASSERT_TRUE(this->pool.first_block == this->pool.first_available);
+  ASSERT_TRUE(this->pool.first_block == this->pool.last_available);
+  ASSERT_TRUE(elements[0] == this->pool.first_block->first_available);
   ASSERT_TRUE(NULL == this->pool.first_block->next);
   void *released = elements[0];
   elements[0] = rif_paged_pool_borrow(&this->pool);
   ASSERT_TRUE(released == elements[0]);
   ASSERT_TRUE(NULL == this->pool.first_available);
   ASSERT_TRUE(NULL == this->pool.last_available);
-  for(uint32_t i = 0; i < NUM_ELEMENTS; ++i) {
+  for(uint32_t i = 0; i < block_size; ++i) {
     rif_paged_pool_return(&this->pool, elements[i]);
   }
-  for(uint32_t i = 0; i < NUM_ELEMENTS; ++i) {
+  EXPECT_EQ(0, rif_paged_pool_live_count(&this->pool));
+  for(uint32_t i = 0; i < block_size; ++i) {
     void *element = rif_paged_pool_borrow(&this->pool);
     ASSERT_FALSE(element == NULL);
   }
@@ -130,6 +146,89 @@ TEST_F(PagedPool, rif_paged_pool_return_should_release_a_pointer) {
   ASSERT_TRUE(NULL == this->pool.first_block->next);
 }
 
+TEST_F(PagedPool, rif_paged_pool_borrow_should_prefer_partially_used_blocks) {
+  uint32_t block_size = this->pool.block_size;
+  std::vector<void *> elements(3 * block_size);
+  for(uint32_t i = 0; i < elements.size(); ++i) {
+    elements[i] = rif_paged_pool_borrow(&this->pool);
+  }
+
+  // Empty the first block, and free one element of the second
+  for(uint32_t i = 0; i < block_size; ++i) {
+    rif_paged_pool_return(&this->pool, elements[i]);
+  }
+  rif_paged_pool_return(&this->pool, elements[block_size]);
+  EXPECT_EQ(1, this->pool.free_block_count);
+
+  // The second block is filled before the empty one is touched
+  void *element = rif_paged_pool_borrow(&this->pool);
+  EXPECT_EQ(elements[block_size], element);
+  EXPECT_EQ(1, this->pool.free_block_count);
+  element = rif_paged_pool_borrow(&this->pool);
+  EXPECT_EQ(0, this->pool.free_block_count);
+}
+
+TEST_F(PagedPool, rif_paged_pool_trim_should_release_free_blocks) {
+  uint32_t block_size = this->pool.block_size;
+  std::vector<void *> elements(4 * block_size);
+  for(uint32_t i = 0; i < elements.size(); ++i) {
+    elements[i] = rif_paged_pool_borrow(&this->pool);
+  }
+  EXPECT_EQ(4, rif_paged_pool_block_count(&this->pool));
+  for(uint32_t i = 0; i < elements.size() - 1; ++i) {
+    rif_paged_pool_return(&this->pool, elements[i]);
+  }
+  EXPECT_EQ(1, rif_paged_pool_live_count(&this->pool));
+  EXPECT_EQ(2, rif_paged_pool_trim(&this->pool, 1));
+  EXPECT_EQ(2, rif_paged_pool_block_count(&this->pool));
+  EXPECT_EQ(0, rif_paged_pool_trim(&this->pool, 1));
+  EXPECT_EQ(1, rif_paged_pool_trim(&this->pool, 0));
+  EXPECT_EQ(1, rif_paged_pool_block_count(&this->pool));
+  rif_paged_pool_return(&this->pool, elements[elements.size() - 1]);
+  EXPECT_EQ(0, rif_paged_pool_live_count(&this->pool));
+  EXPECT_EQ(1, rif_paged_pool_block_count(&this->pool));
+}
+
+TEST_F(PagedPool, rif_paged_pool_return_should_release_blocks_beyond_max_free_blocks) {
+  uint32_t block_size = this->pool.block_size;
+  rif_paged_pool_set_max_free_blocks(&this->pool, 1);
+  std::vector<void *> elements(4 * block_size);
+  for(uint32_t i = 0; i < elements.size(); ++i) {
+    elements[i] = rif_paged_pool_borrow(&this->pool);
+  }
+  for(uint32_t i = 0; i < elements.size(); ++i) {
+    rif_paged_pool_return(&this->pool, elements[i]);
+    EXPECT_LE(this->pool.free_block_count, 1);
+  }
+  EXPECT_EQ(1, rif_paged_pool_block_count(&this->pool));
+}
+
+static
+void * _counting_malloc(size_t size) {
+  return malloc(size);
+}
+
+TEST_F(PagedPool, rif_paged_pool_should_align_blocks_with_custom_allocators) {
+  rif_set_allocators(_counting_malloc, NULL, NULL);
+  rif_paged_pool_t pool_tmp;
+  rif_paged_pool_init(&pool_tmp, 24, 32, false);
+  std::vector<void *> elements(3 * pool_tmp.block_size);
+  for(uint32_t i = 0; i < elements.size(); ++i) {
+    elements[i] = rif_paged_pool_borrow(&pool_tmp);
+    ASSERT_TRUE(NULL != elements[i]);
+  }
+  for(rif_paged_pool_block_t *block_ptr = pool_tmp.first_block; block_ptr; block_ptr = block_ptr->next) {
+    EXPECT_EQ(0, ((uintptr_t) block_ptr) % pool_tmp.block_bytes);
+  }
+  for(uint32_t i = 0; i < elements.size(); ++i) {
+    rif_paged_pool_return(&pool_tmp, elements[i]);
+  }
+  EXPECT_EQ(3, rif_paged_pool_trim(&pool_tmp, 0));
+  rif_paged_pool_destroy(&pool_tmp);
+  rif_set_allocators(malloc, NULL, NULL);
+  EXPECT_TRUE(_rif_allocators.system_allocators);
+}
+
 /******************************************************************************
  * CONFORMITY
  */
@@ -24,13 +24,8 @@
  */
 
 static
-bool _alloc_filter_pair_tostring(const char *tag) {
-  return 0 != strcmp(tag, "RIF_PAIR_TOSTRING");
-}
-
-static
-bool _alloc_filter_int_tostring(const char *tag) {
-  return 0 != strcmp(tag, "RIF_INT_TOSTRING");
+bool _alloc_filter_strbuf_alloc(const char *tag) {
+  return 0 != strcmp(tag, "RIF_STRBUF_ALLOC");
 }
 
 /******************************************************************************
@@ -103,6 +98,17 @@ TEST_F(Pair, rif_pair_new_should_return_an_initialized_pair) {
   rif_pair_release(pair_ptr);
 }
 
+TEST_F(Pair, rif_pair_new_steal_should_take_over_the_references) {
+  rif_int_t *int_ptr_1 = rif_int_new(1 << 20);
+  rif_int_t *int_ptr_2 = rif_int_new(1 << 21);
+  rif_pair_t * pair_ptr = rif_pair_new_steal(rif_val(int_ptr_1), rif_val(int_ptr_2));
+  ASSERT_EQ(rif_val(int_ptr_1), rif_pair_1(pair_ptr));
+  ASSERT_EQ(rif_val(int_ptr_2), rif_pair_2(pair_ptr));
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr_1));
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr_2));
+  rif_pair_release(pair_ptr);
+}
+
 TEST_F(Pair, rif_pair_accessors_should_return_null_on_null_pair) {
   ASSERT_TRUE(NULL == rif_pair_1(NULL));
   ASSERT_TRUE(NULL == rif_pair_2(NULL));
@@ -123,9 +129,7 @@ TEST_F(Pair, rif_pair_tostring_should_be_maningful) {
 }
 
 TEST_F(Pair, rif_pair_tostring_should_return_null_on_failing_alloc) {
-  rif_alloc_set_filter(_alloc_filter_pair_tostring);
-  EXPECT_TRUE(NULL == rif_val_tostring(&pair_0_1));
-  rif_alloc_set_filter(_alloc_filter_int_tostring);
+  rif_alloc_set_filter(_alloc_filter_strbuf_alloc);
   EXPECT_TRUE(NULL == rif_val_tostring(&pair_0_1));
   rif_alloc_set_filter(NULL);
 }
@@ -0,0 +1,150 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "../test_internal.h"
+
+/******************************************************************************
+ * TEST CONFIG
+ */
+
+class Reclaim : public MemoryAwareTest {
+
+  virtual void SetUp() {
+    MemoryAwareTest::SetUp();
+  }
+
+  virtual void TearDown() {
+    rif_reclaim_stop();
+    rif_reclaim_set_deferred(false);
+    rif_reclaim_step(UINT32_MAX);
+    MemoryAwareTest::TearDown();
+  }
+
+};
+
+/******************************************************************************
+ * SETTINGS TESTS
+ */
+
+TEST_F(Reclaim, rif_reclaim_set_deferred_should_return_the_previous_setting) {
+  EXPECT_FALSE(rif_reclaim_deferred());
+  EXPECT_FALSE(rif_reclaim_set_deferred(true));
+  EXPECT_TRUE(rif_reclaim_deferred());
+  EXPECT_TRUE(rif_reclaim_set_deferred(false));
+  EXPECT_FALSE(rif_reclaim_deferred());
+}
+
+/******************************************************************************
+ * RECLAIM TESTS
+ */
+
+TEST_F(Reclaim, rif_val_release_should_destroy_right_away_by_default) {
+  rif_int_t *int_ptr = rif_int_new(1 << 20);
+  rif_arraylist_t *al_ptr = rif_arraylist_new(0, 0);
+  rif_arraylist_append(al_ptr, rif_val(int_ptr));
+  EXPECT_EQ(2, rif_val_reference_count(int_ptr));
+  rif_val_release(al_ptr);
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  EXPECT_EQ(0, rif_reclaim_pending());
+  rif_val_release(int_ptr);
+}
+
+TEST_F(Reclaim, rif_val_release_should_queue_heap_collections_when_deferred) {
+  rif_int_t *int_ptr = rif_int_new(1 << 20);
+  rif_hashmap_t *hm_ptr = rif_hashmap_new(0, false);
+  rif_hashmap_put(hm_ptr, rif_val(int_ptr), rif_val(int_ptr));
+  EXPECT_EQ(3, rif_val_reference_count(int_ptr));
+  rif_reclaim_set_deferred(true);
+  rif_val_release(hm_ptr);
+  EXPECT_EQ(3, rif_val_reference_count(int_ptr));
+  EXPECT_EQ(1, rif_reclaim_pending());
+  EXPECT_EQ(1, rif_reclaim_step(8));
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  EXPECT_EQ(0, rif_reclaim_pending());
+  EXPECT_EQ(0, rif_reclaim_step(8));
+  rif_val_release(int_ptr);
+}
+
+TEST_F(Reclaim, rif_val_release_should_not_queue_values_it_does_not_own) {
+  rif_int_t *int_ptr = rif_int_new(1 << 20);
+  rif_arraylist_t al;
+  rif_arraylist_init(&al, 0, 0);
+  rif_arraylist_append(&al, rif_val(int_ptr));
+  rif_reclaim_set_deferred(true);
+  rif_val_release(&al);
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  rif_val_release(int_ptr);
+  EXPECT_EQ(0, rif_reclaim_pending());
+}
+
+TEST_F(Reclaim, rif_val_release_should_not_queue_thread_local_values) {
+  bool local = rif_val_set_local_default(true);
+  rif_int_t *int_ptr = rif_int_new(1 << 20);
+  rif_arraylist_t *al_ptr = rif_arraylist_new(0, 0);
+  rif_val_set_local_default(local);
+  rif_arraylist_append(al_ptr, rif_val(int_ptr));
+  EXPECT_TRUE(rif_val_islocal(al_ptr));
+  rif_reclaim_set_deferred(true);
+  rif_val_release(al_ptr);
+  EXPECT_EQ(0, rif_reclaim_pending());
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  rif_val_release(int_ptr);
+}
+
+TEST_F(Reclaim, rif_reclaim_step_should_destroy_nested_collections_iteratively) {
+  const uint32_t depth = 100000;
+  rif_int_t *int_ptr = rif_int_new(1 << 20);
+  rif_arraylist_t *al_ptr = rif_arraylist_new(0, 0);
+  rif_arraylist_append(al_ptr, rif_val(int_ptr));
+  for (uint32_t i = 1; i < depth; ++i) {
+    rif_arraylist_t *outer_ptr = rif_arraylist_new(0, 0);
+    rif_arraylist_append_steal(outer_ptr, rif_val(al_ptr));
+    al_ptr = outer_ptr;
+  }
+  rif_reclaim_set_deferred(true);
+  rif_val_release(al_ptr);
+
+  // Each destroyed level queues the next one
+  EXPECT_EQ(1, rif_reclaim_step(1));
+  EXPECT_EQ(1, rif_reclaim_pending());
+  EXPECT_EQ(depth - 1, rif_reclaim_step(UINT32_MAX));
+  EXPECT_EQ(0, rif_reclaim_pending());
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  rif_val_release(int_ptr);
+}
+
+/******************************************************************************
+ * RECLAIM THREAD TESTS
+ */
+
+TEST_F(Reclaim, rif_reclaim_start_should_destroy_queued_values_in_the_background) {
+  ASSERT_EQ(RIF_OK, rif_reclaim_start());
+  ASSERT_EQ(RIF_OK, rif_reclaim_start());
+  rif_int_t *int_ptr = rif_int_new(1 << 20);
+  rif_reclaim_set_deferred(true);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    rif_arraylist_t *al_ptr = rif_arraylist_new(0, 0);
+    rif_arraylist_append(al_ptr, rif_val(int_ptr));
+    rif_val_release(al_ptr);
+  }
+  rif_reclaim_stop();
+  EXPECT_EQ(0, rif_reclaim_pending());
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  rif_val_release(int_ptr);
+}
\ No newline at end of file
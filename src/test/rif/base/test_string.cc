@@ -17,6 +17,9 @@
  * License along with this library.
  */
 
+#include <thread>
+#include <vector>
+
 #include "../test_internal.h"
 
 /******************************************************************************
@@ -34,8 +37,8 @@ bool _alloc_filter_string_new_dup(const char *tag) {
 }
 
 static
-bool _alloc_filter_string_tostring(const char *tag) {
-  return 0 != strcmp(tag, "RIF_STRING_TOSTRING");
+bool _alloc_filter_strbuf_alloc(const char *tag) {
+  return 0 != strcmp(tag, "RIF_STRBUF_ALLOC");
 }
 
 /******************************************************************************
@@ -167,7 +170,7 @@ TEST_F(String, rif_string_tostring_should_return_null_with_null_value) {
 }
 
 TEST_F(String, rif_string_tostring_should_return_null_on_failing_alloc) {
-  rif_alloc_set_filter(_alloc_filter_string_tostring);
+  rif_alloc_set_filter(_alloc_filter_strbuf_alloc);
   EXPECT_TRUE(NULL == rif_val_tostring(&str_foo));
   rif_alloc_set_filter(NULL);
 }
@@ -187,6 +190,21 @@ TEST_F(String, rif_string_hashcode_should_be_value_dependent) {
   rif_val_release(str_tmp2_ptr);
 }
 
+TEST_F(String, rif_string_hashcode_should_be_memoized) {
+  EXPECT_EQ(0, atomic_load(&str_foo.hash));
+  uint32_t hash = rif_val_hashcode(&str_foo);
+  EXPECT_EQ(hash, atomic_load(&str_foo.hash));
+  EXPECT_EQ(hash, rif_val_hashcode(&str_foo));
+}
+
+TEST_F(String, rif_string_hashcode_should_hash_all_characters) {
+  rif_string_t *str_tmp1_ptr = rif_string_new_dup("a long string differing only at its very end: 1");
+  rif_string_t *str_tmp2_ptr = rif_string_new_dup("a long string differing only at its very end: 2");
+  EXPECT_NE(rif_val_hashcode(str_tmp1_ptr), rif_val_hashcode(str_tmp2_ptr));
+  rif_val_release(str_tmp1_ptr);
+  rif_val_release(str_tmp2_ptr);
+}
+
 TEST_F(String, rif_string_equals_should_be_value_dependent) {
   EXPECT_TRUE(rif_val_equals(&str_foo, &str_foo));
   EXPECT_FALSE(rif_val_equals(&str_foo, &str_bar));
@@ -200,4 +218,167 @@ TEST_F(String, rif_string_equals_should_be_value_dependent) {
   str_tmp2_ptr = rif_string_new(NULL, false);
   ASSERT_TRUE(rif_val_equals(str_tmp2_ptr, str_tmp2_ptr));
   rif_val_release(str_tmp2_ptr);
+}
+
+TEST_F(String, rif_string_equals_should_compare_lengths) {
+  rif_string_t *str_tmp_ptr = rif_string_new_dup("foobar");
+  EXPECT_FALSE(rif_val_equals(&str_foo, str_tmp_ptr));
+  EXPECT_FALSE(rif_val_equals(str_tmp_ptr, &str_foo));
+  rif_val_release(str_tmp_ptr);
+}
+
+TEST_F(String, rif_string_equals_should_be_consistent_with_memoized_hashes) {
+  rif_string_t *str_tmp_ptr = rif_string_new_dup(_strs[0]);
+  rif_val_hashcode(&str_foo);
+  EXPECT_TRUE(rif_val_equals(&str_foo, str_tmp_ptr));
+  rif_val_hashcode(str_tmp_ptr);
+  rif_val_hashcode(&str_bar);
+  EXPECT_TRUE(rif_val_equals(&str_foo, str_tmp_ptr));
+  EXPECT_FALSE(rif_val_equals(&str_foo, &str_bar));
+  rif_val_release(str_tmp_ptr);
+}
+
+
+TEST_F(String, rif_string_new_immediate_should_encode_short_strings) {
+  rif_string_t *str_ptr = rif_string_new_immediate("foo");
+  EXPECT_TRUE(rif_val_isimmediate(str_ptr));
+  EXPECT_EQ(RIF_STRING, rif_val_type(str_ptr));
+  EXPECT_EQ(3, rif_string_len(str_ptr));
+  char buf[RIF_STRING_IMMEDIATE_MAX_LEN + 1];
+  EXPECT_STREQ("foo", rif_string_get_wbuf(str_ptr, buf));
+  EXPECT_EQ(rif_val(str_ptr), rif_val_retain(str_ptr));
+  EXPECT_EQ(rif_val(str_ptr), rif_val_release(str_ptr));
+  EXPECT_EQ(str_ptr, rif_string_new_immediate("foo"));
+  RIF_EXPECT_TOSTRING("\"foo\"", rif_val_tostring(str_ptr));
+
+  str_ptr = rif_string_new_immediate("");
+  EXPECT_TRUE(rif_val_isimmediate(str_ptr));
+  EXPECT_EQ(0, rif_string_len(str_ptr));
+  EXPECT_STREQ("", rif_string_get_wbuf(str_ptr, buf));
+}
+
+TEST_F(String, rif_string_new_immediate_should_allocate_long_strings) {
+  EXPECT_TRUE(NULL == rif_string_new_immediate(NULL));
+  rif_string_t *str_ptr = rif_string_new_immediate("a string too long to be immediate");
+  EXPECT_FALSE(rif_val_isimmediate(str_ptr));
+  EXPECT_STREQ("a string too long to be immediate", rif_string_get(str_ptr));
+  char buf[RIF_STRING_IMMEDIATE_MAX_LEN + 1];
+  EXPECT_EQ(rif_string_get(str_ptr), rif_string_get_wbuf(str_ptr, buf));
+  rif_val_release(str_ptr);
+}
+
+TEST_F(String, rif_string_immediate_should_equal_allocated_strings) {
+  rif_string_t *str_ptr = rif_string_new_immediate("foo");
+  EXPECT_TRUE(rif_val_equals(str_ptr, &str_foo));
+  EXPECT_TRUE(rif_val_equals(&str_foo, str_ptr));
+  EXPECT_FALSE(rif_val_equals(str_ptr, &str_bar));
+  EXPECT_FALSE(rif_val_equals(str_ptr, rif_string_new_immediate("fo")));
+  EXPECT_EQ(rif_val_hashcode(&str_foo), rif_val_hashcode(str_ptr));
+  rif_val_hashcode(&str_bar);
+  EXPECT_FALSE(rif_val_equals(&str_bar, str_ptr));
+}
+
+
+TEST_F(String, rif_string_intern_should_return_a_canonical_instance) {
+  EXPECT_TRUE(NULL == rif_string_intern(NULL));
+  uint32_t count = rif_string_intern_count();
+  rif_string_t *str_ptr = rif_string_intern("interned foo");
+  EXPECT_EQ(count + 1, rif_string_intern_count());
+  EXPECT_TRUE(rif_string_isinterned(str_ptr));
+  EXPECT_FALSE(rif_string_isinterned(&str_foo));
+  EXPECT_STREQ("interned foo", rif_string_get(str_ptr));
+  char *dup = strdup("interned foo");
+  rif_string_t *other_ptr = rif_string_intern(dup);
+  free(dup);
+  EXPECT_EQ(str_ptr, other_ptr);
+  EXPECT_EQ(count + 1, rif_string_intern_count());
+  rif_string_release(other_ptr);
+  rif_string_release(str_ptr);
+
+  // The table keeps interned strings alive
+  EXPECT_EQ(str_ptr, rif_string_intern("interned foo"));
+  rif_string_release(str_ptr);
+}
+
+TEST_F(String, rif_string_intern_should_compare_by_content_with_other_strings) {
+  rif_string_t *str_ptr = rif_string_intern("foo");
+  rif_string_t *other_ptr = rif_string_intern("bar");
+  EXPECT_TRUE(rif_val_equals(str_ptr, &str_foo));
+  EXPECT_TRUE(rif_val_equals(&str_foo, str_ptr));
+  EXPECT_TRUE(rif_val_equals(str_ptr, rif_string_new_immediate("foo")));
+  EXPECT_FALSE(rif_val_equals(str_ptr, other_ptr));
+  EXPECT_EQ(rif_val_hashcode(&str_foo), rif_val_hashcode(str_ptr));
+  rif_string_release(str_ptr);
+  rif_string_release(other_ptr);
+}
+
+TEST_F(String, rif_string_intern_should_not_allocate_from_the_current_arena) {
+  rif_arena_t arena;
+  rif_arena_init(&arena, 0);
+  rif_arena_set_current(&arena);
+  rif_string_t *str_ptr = rif_string_intern("interned in arena scope");
+  rif_arena_set_current(NULL);
+  EXPECT_FALSE(rif_arena_owns(&arena, str_ptr));
+  EXPECT_FALSE(rif_arena_owns(&arena, rif_string_get(str_ptr)));
+  rif_arena_destroy(&arena);
+  EXPECT_STREQ("interned in arena scope", rif_string_get(str_ptr));
+  rif_string_release(str_ptr);
+}
+
+TEST_F(String, rif_string_intern_should_return_the_same_instance_to_every_thread) {
+  std::vector<std::thread> threads;
+  std::vector<rif_string_t *> strs(8 * 64);
+  for (uint32_t i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&strs, i] {
+      char buf[32];
+      for (uint32_t n = 0; n < 64; ++n) {
+        snprintf(buf, sizeof(buf), "concurrent %u", n);
+        strs[i * 64 + n] = rif_string_intern(buf);
+      }
+    }));
+  }
+  for (uint32_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+  for (uint32_t i = 0; i < strs.size(); ++i) {
+    EXPECT_EQ(strs[i % 64], strs[i]);
+    rif_string_release(strs[i]);
+  }
+}
+
+TEST_F(String, rif_string_intern_should_not_duplicate_contended_strings) {
+  uint32_t count = rif_string_intern_count();
+  std::vector<std::thread> threads;
+  std::vector<std::vector<rif_string_t *>> strs(8, std::vector<rif_string_t *>(20000));
+  for (uint32_t i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&strs, i] {
+      char buf[32];
+      for (uint32_t n = 0; n < 20000; ++n) {
+        snprintf(buf, sizeof(buf), "contended %u", n);
+        strs[i][n] = rif_string_intern(buf);
+      }
+    }));
+  }
+  for (uint32_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+  EXPECT_EQ(count + 20000, rif_string_intern_count());
+  for (uint32_t n = 0; n < 20000; ++n) {
+    for (uint32_t i = 0; i < 8; ++i) {
+      EXPECT_EQ(strs[0][n], strs[i][n]);
+      EXPECT_TRUE(rif_string_isinterned(strs[i][n]));
+      rif_string_release(strs[i][n]);
+    }
+  }
+}
+
+TEST_F(String, rif_string_intern_should_be_found_in_maps_by_address) {
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, 8, false);
+  rif_string_t *key_ptr = rif_string_intern("key");
+  rif_hashmap_put(&hm, rif_val(key_ptr), rif_val(rif_true));
+  EXPECT_EQ(rif_val(rif_true), rif_hashmap_get(&hm, rif_val(key_ptr)));
+  EXPECT_EQ(rif_val(rif_true), rif_hashmap_get(&hm, rif_val(rif_string_new_immediate("key"))));
+  rif_hashmap_release(&hm);
+  rif_string_release(key_ptr);
 }
\ No newline at end of file
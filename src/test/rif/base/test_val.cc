@@ -17,6 +17,8 @@
  * License along with this library.
  */
 
+#include <thread>
+
 #include "../test_internal.h"
 
 /******************************************************************************
@@ -51,4 +53,84 @@ TEST(Val, rif_val_release_should_handle_zero_reference_count) {
   rif_val_init(&fake_integer, RIF_INT, false);
   atomic_store(&(fake_integer.reference_count), 0);
   ASSERT_TRUE(&fake_integer == rif_val_release(&fake_integer));
+}
+
+TEST(Val, rif_val_header_should_fit_in_8_bytes) {
+  ASSERT_EQ(8, sizeof(rif_val_t));
+}
+
+TEST(Val, rif_val_retain_and_release_should_not_count_immortal_values) {
+  uint32_t count = atomic_load(&rif_val(rif_null)->reference_count);
+  ASSERT_TRUE(rif_val(rif_null) == rif_val_retain(rif_null));
+  ASSERT_TRUE(rif_val(rif_null) == rif_val_release(rif_null));
+  ASSERT_TRUE(rif_val(rif_null) == rif_val_release(rif_null));
+  ASSERT_EQ(count, atomic_load(&rif_val(rif_null)->reference_count));
+}
+
+TEST(Val, rif_val_init_should_not_create_local_values_by_default) {
+  EXPECT_FALSE(rif_val_local_default());
+  rif_int_t *int_ptr = rif_int_new(1);
+  EXPECT_FALSE(rif_val_islocal(int_ptr));
+  rif_val_release(int_ptr);
+}
+
+TEST(Val, rif_val_set_local_default_should_create_local_values) {
+  EXPECT_FALSE(rif_val_set_local_default(true));
+  rif_int_t *int_ptr = rif_int_new(1);
+  EXPECT_TRUE(rif_val_set_local_default(false));
+  EXPECT_TRUE(rif_val_islocal(int_ptr));
+  rif_val_retain(int_ptr);
+  rif_val_retain(int_ptr);
+  EXPECT_EQ(3, rif_val_reference_count(int_ptr));
+  EXPECT_EQ(rif_val(int_ptr), rif_val_release(int_ptr));
+  EXPECT_EQ(rif_val(int_ptr), rif_val_release(int_ptr));
+  EXPECT_EQ(NULL, rif_val_release(int_ptr));
+}
+
+TEST(Val, rif_val_set_local_default_should_only_apply_to_the_calling_thread) {
+  rif_val_set_local_default(true);
+  std::thread([] {
+    EXPECT_FALSE(rif_val_local_default());
+    rif_int_t *int_ptr = rif_int_new(1);
+    EXPECT_FALSE(rif_val_islocal(int_ptr));
+    rif_val_release(int_ptr);
+  }).join();
+  rif_val_set_local_default(false);
+}
+
+TEST(Val, rif_val_share_should_make_local_values_shared) {
+  rif_val_set_local_default(true);
+  rif_int_t *int_ptr = rif_int_new(1);
+  rif_val_set_local_default(false);
+  EXPECT_EQ(rif_val(int_ptr), rif_val_share(int_ptr));
+  EXPECT_FALSE(rif_val_islocal(int_ptr));
+  std::thread([int_ptr] {
+    for (uint32_t i = 0; i < 10000; ++i) {
+      rif_val_retain(int_ptr);
+      rif_val_release(int_ptr);
+    }
+  }).join();
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  rif_val_release(int_ptr);
+
+  // Static and immediate values are never local
+  EXPECT_EQ(rif_val(rif_true), rif_val_share(rif_true));
+  EXPECT_FALSE(rif_val_islocal(rif_int_new_immediate(1)));
+  EXPECT_EQ(NULL, rif_val_share(NULL));
+}
+
+TEST(Val, rif_concurrent_collections_should_share_their_elements) {
+  rif_val_set_local_default(true);
+  rif_concurrent_hashmap_t chm;
+  rif_concurrent_hashmap_init(&chm, 0, 0);
+  rif_int_t *key_ptr = rif_int_new(1);
+  rif_int_t *val_ptr = rif_int_new(2);
+  rif_val_set_local_default(false);
+  EXPECT_FALSE(rif_val_islocal(&chm));
+  rif_concurrent_hashmap_put(&chm, rif_val(key_ptr), rif_val(val_ptr));
+  EXPECT_FALSE(rif_val_islocal(key_ptr));
+  EXPECT_FALSE(rif_val_islocal(val_ptr));
+  rif_val_release(key_ptr);
+  rif_val_release(val_ptr);
+  rif_concurrent_hashmap_release(&chm);
 }
\ No newline at end of file
@@ -34,13 +34,8 @@ void rif_list_fill(rif_list_t *list_ptr, uint8_t elements) {
 #define NUM_ELEMENTS 8
 
 static
-bool _alloc_filter_list_tostring(const char *tag) {
-  return 0 != strcmp(tag, "RIF_LIST_TOSTRING");
-}
-
-static
-bool _alloc_filter_int_tostring(const char *tag) {
-  return 0 != strcmp(tag, "RIF_INT_TOSTRING");
+bool _alloc_filter_strbuf_alloc(const char *tag) {
+  return 0 != strcmp(tag, "RIF_STRBUF_ALLOC");
 }
 
 /******************************************************************************
@@ -174,6 +169,15 @@ TEST_P(ListConformity, list_append_should_append_element) {
   rif_val_release(int_ptr_2);
 }
 
+TEST_P(ListConformity, list_append_steal_should_take_over_the_reference) {
+  rif_int_t *int_ptr = rif_int_new(1 << 20);
+  ASSERT_EQ(RIF_OK, rif_list_append_steal(list_ptr, rif_val(int_ptr)));
+  EXPECT_EQ(rif_val(int_ptr), rif_list_get(list_ptr, 0));
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  ASSERT_EQ(RIF_OK, rif_list_append_steal(list_ptr, NULL));
+  EXPECT_EQ(2, rif_list_size(list_ptr));
+}
+
 /******************************************************************************
  * TEST PREPEND
  */
@@ -269,9 +273,7 @@ TEST_P(ListConformity, list_tostring_should_return_meaningful_string) {
 
 TEST_P(ListConformity, list_tostring_should_return_null_on_failing_alloc) {
   rif_list_fill(list_ptr, NUM_ELEMENTS);
-  rif_alloc_set_filter(_alloc_filter_int_tostring);
-  EXPECT_EQ(NULL, rif_val_tostring(list_ptr));
-  rif_alloc_set_filter(_alloc_filter_list_tostring);
+  rif_alloc_set_filter(_alloc_filter_strbuf_alloc);
   EXPECT_EQ(NULL, rif_val_tostring(list_ptr));
   rif_alloc_set_filter(NULL);
 }
@@ -38,13 +38,8 @@ void rif_map_fill(rif_map_t *map_ptr, uint8_t elements) {
 #define NUM_ELEMENTS 8
 
 static
-bool _alloc_filter_map_tostring(const char *tag) {
-  return 0 != strcmp(tag, "RIF_MAP_TOSTRING");
-}
-
-static
-bool _alloc_filter_int_tostring(const char *tag) {
-  return 0 != strcmp(tag, "RIF_INT_TOSTRING");
+bool _alloc_filter_strbuf_alloc(const char *tag) {
+  return 0 != strcmp(tag, "RIF_STRBUF_ALLOC");
 }
 
 /******************************************************************************
@@ -125,6 +120,24 @@ TEST_P(MapConformity, map_put_should_put_element) {
   ASSERT_EQ(1, rif_int_get(rif_int_fromval(rif_map_get(map_ptr, rif_val(strs[0])))));
 }
 
+TEST_P(MapConformity, map_put_steal_should_take_over_the_references) {
+  rif_string_t *key_ptr = rif_string_new_dup("steal");
+  rif_int_t *val_ptr = rif_int_new(1 << 20);
+  ASSERT_EQ(RIF_OK, rif_map_put_steal(map_ptr, rif_val(key_ptr), rif_val(val_ptr)));
+  EXPECT_EQ(rif_val(val_ptr), rif_map_get(map_ptr, rif_val(key_ptr)));
+  EXPECT_EQ(1, rif_val_reference_count(key_ptr));
+  EXPECT_EQ(1, rif_val_reference_count(val_ptr));
+
+  // Replacing an element releases the previous one
+  rif_val_retain(val_ptr);
+  rif_val_retain(key_ptr);
+  ASSERT_EQ(RIF_OK, rif_map_put_steal(map_ptr, rif_val(key_ptr), rif_val(rif_int_new(1 << 21))));
+  EXPECT_EQ(1, rif_map_size(map_ptr));
+  EXPECT_EQ(1, rif_val_reference_count(key_ptr));
+  EXPECT_EQ(1, rif_val_reference_count(val_ptr));
+  rif_val_release(val_ptr);
+}
+
 /******************************************************************************
  * TEST REMOVE
  */
@@ -222,9 +235,7 @@ TEST_P(MapConformity, map_equals_should_be_value_dependent) {
 
 TEST_P(MapConformity, map_tostring_should_return_null_on_failing_alloc) {
   rif_map_fill(map_ptr, NUM_ELEMENTS);
-  rif_alloc_set_filter(_alloc_filter_int_tostring);
-  EXPECT_EQ(NULL, rif_val_tostring(map_ptr));
-  rif_alloc_set_filter(_alloc_filter_map_tostring);
+  rif_alloc_set_filter(_alloc_filter_strbuf_alloc);
   EXPECT_EQ(NULL, rif_val_tostring(map_ptr));
   rif_alloc_set_filter(NULL);
 }
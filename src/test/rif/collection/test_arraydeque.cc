@@ -0,0 +1,276 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+
+#include <deque>
+
+#include "../test_internal.h"
+
+#include "support/list_conformity.hh"
+
+/******************************************************************************
+ * TEST FIXTURES
+ */
+
+static
+bool _alloc_filter_capacity_alloc(const char *tag) {
+  return 0 != strcmp(tag, "ARRAYDEQUE_CAPACITY_ALLOC");
+}
+
+static
+bool _alloc_filter_capacity_realloc(const char *tag) {
+  return 0 != strcmp(tag, "ARRAYDEQUE_CAPACITY_REALLOC");
+}
+
+/*
+ * Checks a deque holds the same integers, in the same order, as a reference deque.
+ */
+static
+void _expect_elements(const rif_arraydeque_t *dq_ptr, const std::deque<int64_t> &expected) {
+  ASSERT_EQ(expected.size(), rif_arraydeque_size(dq_ptr));
+  for (uint32_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], rif_int_get(rif_int_fromval(rif_arraydeque_get(dq_ptr, i))));
+  }
+}
+
+/******************************************************************************
+ * TEST CONFIG
+ */
+
+class Arraydeque : public MemoryAwareTest {
+
+public:
+
+  rif_arraydeque_t dq_empty;
+  rif_arraydeque_t dq_empty_fixed;
+
+private:
+
+  virtual void SetUp() {
+    MemoryAwareTest::SetUp();
+    rif_arraydeque_init(&dq_empty, 8, false);
+    rif_arraydeque_init(&dq_empty_fixed, 8, true);
+  }
+
+  virtual void TearDown() {
+    rif_arraydeque_release(&dq_empty);
+    rif_arraydeque_release(&dq_empty_fixed);
+    MemoryAwareTest::TearDown();
+  }
+
+};
+
+/******************************************************************************
+ * INIT TESTS
+ */
+
+TEST_F(Arraydeque, rif_arraydeque_init_should_return_null_with_null_ptr) {
+  ASSERT_EQ(NULL, rif_arraydeque_init(NULL, 8, false));
+}
+
+TEST_F(Arraydeque, rif_arraydeque_init_should_round_capacity_to_a_power_of_two) {
+  rif_arraydeque_t dq;
+  ASSERT_TRUE(NULL != rif_arraydeque_init(&dq, 9, true));
+  EXPECT_EQ(16, rif_arraydeque_capacity(&dq));
+  EXPECT_EQ(0, rif_arraydeque_size(&dq));
+  rif_arraydeque_release(&dq);
+}
+
+TEST_F(Arraydeque, rif_arraydeque_init_should_not_allocate_memory_with_zero_capacity) {
+  rif_arraydeque_t dq;
+  ASSERT_TRUE(NULL != rif_arraydeque_init(&dq, 0, false));
+  EXPECT_EQ(NULL, dq.elements);
+  EXPECT_EQ(NULL, rif_arraydeque_get(&dq, 0));
+  EXPECT_EQ(NULL, rif_arraydeque_pop_front(&dq));
+  EXPECT_EQ(NULL, rif_arraydeque_pop_back(&dq));
+  rif_arraydeque_release(&dq);
+}
+
+TEST_F(Arraydeque, rif_arraydeque_init_should_return_null_on_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_capacity_alloc);
+  rif_arraydeque_t dq;
+  ASSERT_TRUE(NULL == rif_arraydeque_init(&dq, 8, false));
+  rif_alloc_set_filter(NULL);
+}
+
+/******************************************************************************
+ * CAPACITY TESTS
+ */
+
+TEST_F(Arraydeque, rif_arraydeque_ensure_capacity_should_increase_capacity) {
+  ASSERT_EQ(RIF_OK, rif_arraydeque_ensure_capacity(&dq_empty, 100));
+  EXPECT_EQ(128, rif_arraydeque_capacity(&dq_empty));
+}
+
+TEST_F(Arraydeque, rif_arraydeque_ensure_capacity_should_not_increase_capacity_of_a_fixed_size_arraydeque) {
+  ASSERT_EQ(RIF_ERR_CAPACITY, rif_arraydeque_ensure_capacity(&dq_empty_fixed, 16));
+  EXPECT_EQ(8, rif_arraydeque_capacity(&dq_empty_fixed));
+}
+
+TEST_F(Arraydeque, rif_arraydeque_ensure_capacity_should_handle_failing_realloc) {
+  rif_alloc_set_filter(_alloc_filter_capacity_realloc);
+  ASSERT_EQ(RIF_ERR_MEMORY, rif_arraydeque_ensure_capacity(&dq_empty, 16));
+  EXPECT_EQ(8, rif_arraydeque_capacity(&dq_empty));
+  rif_alloc_set_filter(NULL);
+}
+
+TEST_F(Arraydeque, rif_arraydeque_ensure_capacity_should_keep_wrapped_elements_in_order) {
+  std::deque<int64_t> expected;
+  for (int64_t n = 0; n < 8; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    if (n % 2) {
+      rif_arraydeque_push_back(&dq_empty, rif_val(val));
+      expected.push_back(n);
+    } else {
+      rif_arraydeque_push_front(&dq_empty, rif_val(val));
+      expected.push_front(n);
+    }
+    rif_val_release(val);
+  }
+  ASSERT_EQ(RIF_OK, rif_arraydeque_ensure_capacity(&dq_empty, 64));
+  _expect_elements(&dq_empty, expected);
+}
+
+TEST_F(Arraydeque, rif_arraydeque_push_should_handle_insufficient_capacity) {
+  for (uint32_t n = 0; n < 8; ++n) {
+    EXPECT_EQ(RIF_OK, rif_arraydeque_push_front(&dq_empty_fixed, NULL));
+  }
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_arraydeque_push_front(&dq_empty_fixed, NULL));
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_arraydeque_push_back(&dq_empty_fixed, NULL));
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_arraydeque_insert(&dq_empty_fixed, 4, NULL));
+  EXPECT_EQ(8, rif_arraydeque_size(&dq_empty_fixed));
+}
+
+TEST_F(Arraydeque, rif_arraydeque_push_should_handle_failing_realloc) {
+  for (uint32_t n = 0; n < 8; ++n) {
+    rif_arraydeque_push_back(&dq_empty, NULL);
+  }
+  rif_alloc_set_filter(_alloc_filter_capacity_realloc);
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_arraydeque_push_back(&dq_empty, NULL));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(8, rif_arraydeque_size(&dq_empty));
+}
+
+/******************************************************************************
+ * ELEMENT TESTS
+ */
+
+TEST_F(Arraydeque, rif_arraydeque_should_reuse_its_buffer_as_a_fifo) {
+  for (int64_t n = 0; n < 1000; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    ASSERT_EQ(RIF_OK, rif_arraydeque_push_back(&dq_empty, rif_val(val)));
+    rif_val_release(val);
+    if (n >= 5) {
+      rif_val_t *popped = rif_arraydeque_pop_front(&dq_empty);
+      EXPECT_EQ(n - 5, rif_int_get(rif_int_fromval(popped)));
+      rif_val_release(popped);
+    }
+  }
+  EXPECT_EQ(8, rif_arraydeque_capacity(&dq_empty));
+  EXPECT_EQ(5, rif_arraydeque_size(&dq_empty));
+}
+
+TEST_F(Arraydeque, rif_arraydeque_pop_should_transfer_ownership) {
+  rif_int_t *val = rif_int_new(1000);
+  rif_arraydeque_push_back(&dq_empty, rif_val(val));
+  rif_arraydeque_push_front(&dq_empty, rif_val(val));
+  EXPECT_EQ(3, rif_val_reference_count(val));
+  EXPECT_EQ(rif_val(val), rif_arraydeque_pop_back(&dq_empty));
+  EXPECT_EQ(rif_val(val), rif_arraydeque_pop_front(&dq_empty));
+  EXPECT_EQ(3, rif_val_reference_count(val));
+  EXPECT_EQ(0, rif_arraydeque_size(&dq_empty));
+  rif_val_release(val);
+  rif_val_release(val);
+  rif_val_release(val);
+}
+
+TEST_F(Arraydeque, rif_arraydeque_insert_and_remove_should_match_a_reference_deque) {
+  std::deque<int64_t> expected;
+  uint64_t state = 42;
+  for (int64_t n = 0; n < 2000; ++n) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint32_t size = (uint32_t) expected.size();
+    uint32_t index = (uint32_t) ((state >> 33) % (size + 1));
+    if (size && (state >> 20) % 3 == 0) {
+      index = index % size;
+      ASSERT_EQ(RIF_OK, rif_arraydeque_remove(&dq_empty, index));
+      expected.erase(expected.begin() + index);
+    } else {
+      rif_int_t *val = rif_int_new(n);
+      ASSERT_EQ(RIF_OK, rif_arraydeque_insert(&dq_empty, index, rif_val(val)));
+      rif_val_release(val);
+      expected.insert(expected.begin() + index, n);
+    }
+  }
+  _expect_elements(&dq_empty, expected);
+}
+
+/******************************************************************************
+ * QUEUE VIEW TESTS
+ */
+
+TEST_F(Arraydeque, rif_arraydeque_asqueue_should_push_back_and_pop_front) {
+  rif_queue_t *queue_ptr = rif_arraydeque_asqueue(&dq_empty);
+  EXPECT_EQ(RIF_QUEUE, rif_val_type(queue_ptr));
+  rif_int_t *val1 = rif_int_new(1);
+  rif_int_t *val2 = rif_int_new(2);
+  EXPECT_EQ(RIF_OK, rif_queue_push(queue_ptr, rif_val(val1)));
+  EXPECT_EQ(RIF_OK, rif_queue_push(queue_ptr, rif_val(val2)));
+  EXPECT_EQ(2, rif_queue_size(queue_ptr));
+  EXPECT_EQ(rif_val(val1), rif_arraydeque_get(&dq_empty, 0));
+  rif_val_t *popped = rif_queue_pop(queue_ptr);
+  EXPECT_EQ(rif_val(val1), popped);
+  rif_val_release(popped);
+  EXPECT_EQ(1, rif_arraydeque_size(&dq_empty));
+  rif_val_release(val1);
+  rif_val_release(val2);
+}
+
+TEST_F(Arraydeque, rif_arraydeque_asqueue_should_push_steal_without_retaining) {
+  rif_queue_t *queue_ptr = rif_arraydeque_asqueue(&dq_empty);
+  rif_int_t *val = rif_int_new(1 << 20);
+  EXPECT_EQ(RIF_OK, rif_queue_push_steal(queue_ptr, rif_val(val)));
+  EXPECT_EQ(1, rif_val_reference_count(val));
+  rif_val_t *popped = rif_queue_pop(queue_ptr);
+  EXPECT_EQ(rif_val(val), popped);
+  rif_val_release(popped);
+}
+
+/******************************************************************************
+ * CONFORMITY
+ */
+
+static
+rif_list_t *_rif_arraydeque_init() {
+  rif_arraydeque_t *list_ptr = (rif_arraydeque_t *) rif_malloc(sizeof(rif_arraydeque_t));
+  return (rif_list_t *) rif_arraydeque_init(list_ptr, 0, false);
+}
+
+static
+void _rif_arraydeque_destroy(rif_list_t *list_ptr) {
+  rif_val_release(list_ptr);
+  rif_free(list_ptr);
+}
+
+static rif_list_conformity_generator_t rif_arraydeque_generator = {
+    .init = _rif_arraydeque_init,
+    .destroy = _rif_arraydeque_destroy
+};
+
+INSTANTIATE_TEST_CASE_P(Arraydeque, ListConformity, ::testing::Values(&rif_arraydeque_generator));
@@ -145,6 +145,159 @@ TEST_F(Arraylist, rif_arraylist_insert_should_handle_failing_realloc) {
   rif_alloc_set_filter(NULL);
 }
 
+TEST_F(Arraylist, rif_arraylist_insert_steal_should_consume_the_reference_on_failure) {
+  rif_int_t *int_ptr = rif_int_new(1 << 20);
+  rif_val_retain(int_ptr);
+  ASSERT_EQ(RIF_ERR_OUT_OF_BOUNDS, rif_arraylist_insert_steal(&al_empty, 1, rif_val(int_ptr)));
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  for (uint8_t n = 0; n < 8; ++n) {
+    EXPECT_EQ(RIF_OK, rif_arraylist_append(&al_empty_fixed, NULL));
+  }
+  rif_val_retain(int_ptr);
+  ASSERT_EQ(RIF_ERR_CAPACITY, rif_arraylist_append_steal(&al_empty_fixed, rif_val(int_ptr)));
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  rif_val_release(int_ptr);
+}
+
+/******************************************************************************
+ * GROWTH TESTS
+ */
+
+TEST_F(Arraylist, rif_arraylist_init_should_grow_geometrically_without_capacity_nor_block_size) {
+  rif_arraylist_t al;
+  ASSERT_TRUE(NULL != rif_arraylist_init(&al, 0, 0));
+  EXPECT_EQ(RIF_ARRAYLIST_GROWTH_GEOMETRIC, al.growth);
+  uint32_t expected_capacities[] = {8, 12, 18, 27, 40};
+  uint32_t step = 0;
+  for (uint32_t n = 0; n < 40; ++n) {
+    ASSERT_EQ(RIF_OK, rif_arraylist_append(&al, NULL));
+    if (rif_arraylist_capacity(&al) != expected_capacities[step]) {
+      ++step;
+    }
+    EXPECT_EQ(expected_capacities[step], rif_arraylist_capacity(&al));
+  }
+  rif_arraylist_release(&al);
+}
+
+TEST_F(Arraylist, rif_arraylist_insert_should_double_capacity_with_double_growth) {
+  ASSERT_EQ(RIF_OK, rif_arraylist_set_growth(&al_empty, RIF_ARRAYLIST_GROWTH_DOUBLE));
+  for (uint32_t n = 0; n < 9; ++n) {
+    ASSERT_EQ(RIF_OK, rif_arraylist_append(&al_empty, NULL));
+  }
+  EXPECT_EQ(16, rif_arraylist_capacity(&al_empty));
+  for (uint32_t n = 9; n < 17; ++n) {
+    ASSERT_EQ(RIF_OK, rif_arraylist_append(&al_empty, NULL));
+  }
+  EXPECT_EQ(32, rif_arraylist_capacity(&al_empty));
+}
+
+TEST_F(Arraylist, rif_arraylist_ensure_capacity_should_allocate_exactly_with_geometric_growth) {
+  ASSERT_EQ(RIF_OK, rif_arraylist_set_growth(&al_empty, RIF_ARRAYLIST_GROWTH_GEOMETRIC));
+  ASSERT_EQ(RIF_OK, rif_arraylist_ensure_capacity(&al_empty, 9));
+  EXPECT_EQ(9, rif_arraylist_capacity(&al_empty));
+}
+
+TEST_F(Arraylist, rif_arraylist_ensure_capacity_should_handle_capacity_overflow) {
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_arraylist_ensure_capacity(&al_empty, UINT32_MAX));
+  EXPECT_EQ(8, rif_arraylist_capacity(&al_empty));
+}
+
+TEST_F(Arraylist, rif_arraylist_set_growth_should_allow_a_fixed_list_to_grow) {
+  ASSERT_EQ(RIF_OK, rif_arraylist_set_growth(&al_empty_fixed, RIF_ARRAYLIST_GROWTH_LINEAR));
+  ASSERT_EQ(RIF_OK, rif_arraylist_ensure_capacity(&al_empty_fixed, 9));
+  EXPECT_EQ(9, rif_arraylist_capacity(&al_empty_fixed));
+}
+
+TEST_F(Arraylist, rif_arraylist_set_growth_should_not_allow_a_stack_allocated_list_to_grow) {
+  rif_arraylist_t al;
+  rif_arraylist_inita(&al, 8);
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_arraylist_set_growth(&al, RIF_ARRAYLIST_GROWTH_GEOMETRIC));
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_arraylist_ensure_capacity(&al, 16));
+  rif_arraylist_release(&al);
+}
+
+/******************************************************************************
+ * SHRINK TESTS
+ */
+
+TEST_F(Arraylist, rif_arraylist_shrink_to_fit_should_reduce_capacity_to_size) {
+  ASSERT_EQ(RIF_OK, rif_arraylist_ensure_capacity(&al_empty, 64));
+  for (uint32_t n = 0; n < 10; ++n) {
+    rif_arraylist_append(&al_empty, rif_val(rif_true));
+  }
+  ASSERT_EQ(RIF_OK, rif_arraylist_shrink_to_fit(&al_empty));
+  EXPECT_EQ(10, rif_arraylist_capacity(&al_empty));
+  EXPECT_EQ(rif_val(rif_true), rif_arraylist_get(&al_empty, 9));
+}
+
+TEST_F(Arraylist, rif_arraylist_shrink_to_fit_should_free_elements_of_an_empty_list) {
+  ASSERT_EQ(RIF_OK, rif_arraylist_shrink_to_fit(&al_empty));
+  EXPECT_EQ(0, rif_arraylist_capacity(&al_empty));
+  EXPECT_EQ(NULL, al_empty.elements);
+  EXPECT_EQ(RIF_OK, rif_arraylist_append(&al_empty, NULL));
+  EXPECT_EQ(8, rif_arraylist_capacity(&al_empty));
+}
+
+TEST_F(Arraylist, rif_arraylist_shrink_to_fit_should_not_shrink_a_fixed_size_arraylist) {
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_arraylist_shrink_to_fit(&al_empty_fixed));
+  EXPECT_EQ(8, rif_arraylist_capacity(&al_empty_fixed));
+}
+
+TEST_F(Arraylist, rif_arraylist_shrink_to_fit_should_handle_failing_realloc) {
+  rif_arraylist_append(&al_empty, NULL);
+  rif_alloc_set_filter(_alloc_filter_capacity_realloc);
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_arraylist_shrink_to_fit(&al_empty));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(8, rif_arraylist_capacity(&al_empty));
+}
+
+TEST_F(Arraylist, rif_arraylist_remove_should_shrink_drained_lists_with_autoshrink) {
+  rif_arraylist_set_autoshrink(&al_empty, true);
+  for (uint32_t n = 0; n < 128; ++n) {
+    rif_arraylist_append(&al_empty, rif_val(rif_true));
+  }
+  EXPECT_EQ(128, rif_arraylist_capacity(&al_empty));
+  while (rif_arraylist_size(&al_empty) > 32) {
+    rif_arraylist_remove(&al_empty, 0);
+  }
+  EXPECT_EQ(64, rif_arraylist_capacity(&al_empty));
+  while (rif_arraylist_size(&al_empty) > 0) {
+    rif_arraylist_remove(&al_empty, 0);
+  }
+  EXPECT_EQ(8, rif_arraylist_capacity(&al_empty));
+}
+
+TEST_F(Arraylist, rif_arraylist_remove_should_not_shrink_without_autoshrink) {
+  for (uint32_t n = 0; n < 128; ++n) {
+    rif_arraylist_append(&al_empty, NULL);
+  }
+  while (rif_arraylist_size(&al_empty) > 0) {
+    rif_arraylist_remove(&al_empty, 0);
+  }
+  EXPECT_EQ(128, rif_arraylist_capacity(&al_empty));
+}
+
+TEST_F(Arraylist, rif_arraylist_set_autoshrink_should_be_ignored_by_fixed_size_arraylists) {
+  rif_arraylist_set_autoshrink(&al_empty_fixed, true);
+  EXPECT_FALSE(al_empty_fixed.autoshrink);
+}
+
+TEST_F(Arraylist, rif_arraylist_set_growth_should_disable_autoshrink_when_fixed) {
+  rif_arraylist_set_autoshrink(&al_empty, true);
+  for (uint32_t n = 0; n < 128; ++n) {
+    rif_arraylist_append(&al_empty, rif_val(rif_true));
+  }
+  ASSERT_EQ(RIF_OK, rif_arraylist_set_growth(&al_empty, RIF_ARRAYLIST_GROWTH_FIXED));
+  EXPECT_FALSE(al_empty.autoshrink);
+  while (rif_arraylist_size(&al_empty) > 0) {
+    rif_arraylist_remove(&al_empty, 0);
+  }
+  EXPECT_EQ(128, rif_arraylist_capacity(&al_empty));
+  for (uint32_t n = 0; n < 128; ++n) {
+    EXPECT_EQ(RIF_OK, rif_arraylist_append(&al_empty, rif_val(rif_true)));
+  }
+}
+
 /******************************************************************************
  * CONFORMITY
  */
@@ -166,4 +319,19 @@ static rif_list_conformity_generator_t rif_arraylist_generator = {
     .destroy = _rif_arraylist_destroy
 };
 
-INSTANTIATE_TEST_CASE_P(Arraylist, ListConformity, ::testing::Values(&rif_arraylist_generator));
\ No newline at end of file
+INSTANTIATE_TEST_CASE_P(Arraylist, ListConformity, ::testing::Values(&rif_arraylist_generator));
+
+static
+rif_list_t *_rif_arraylist_init_geometric() {
+  rif_arraylist_t *list_ptr = (rif_arraylist_t *) rif_malloc(sizeof(rif_arraylist_t));
+  rif_arraylist_init(list_ptr, 0, 0);
+  rif_arraylist_set_autoshrink(list_ptr, true);
+  return (rif_list_t *) list_ptr;
+}
+
+static rif_list_conformity_generator_t rif_arraylist_geometric_generator = {
+    .init = _rif_arraylist_init_geometric,
+    .destroy = _rif_arraylist_destroy
+};
+
+INSTANTIATE_TEST_CASE_P(ArraylistGeometric, ListConformity, ::testing::Values(&rif_arraylist_geometric_generator));
\ No newline at end of file
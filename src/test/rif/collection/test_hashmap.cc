@@ -30,6 +30,27 @@ bool _alloc_filter_capacity_alloc(const char *tag) {
   return 0 != strcmp(tag, "HASHMAP_CAPACITY_ALLOC");
 }
 
+static
+uint32_t _occupied_slots(const rif_hashmap_t *hm_ptr) {
+  uint32_t occupied = 0;
+  for (uint32_t pos = 0; pos < rif_hashmap_capacity(hm_ptr); ++pos) {
+    occupied += NULL != rif_hashmap_atindex(hm_ptr, pos);
+  }
+  return occupied;
+}
+
+static
+uint32_t _fill_until_rehashing(rif_hashmap_t *hm_ptr) {
+  uint32_t n = 0;
+  rif_hashmap_set_incremental(hm_ptr, true);
+  while (!rif_hashmap_isrehashing(hm_ptr)) {
+    rif_int_t *val = rif_int_new(n++);
+    rif_hashmap_put(hm_ptr, rif_val(val), rif_val(val));
+    rif_val_release(val);
+  }
+  return n;
+}
+
 /******************************************************************************
  * TEST CONFIG
  */
@@ -68,7 +89,7 @@ TEST_F(Hashmap, rif_hashmap_init_should_return_null_with_null_ptr) {
 TEST_F(Hashmap, rif_hashmap_init_should_return_an_initialized_hashmap) {
   rif_hashmap_t hm;
   ASSERT_TRUE(NULL != rif_hashmap_init(&hm, 8, true));
-  EXPECT_EQ(hm.capacity, 8);
+  EXPECT_EQ(hm.capacity, 16);
   rif_hashmap_release(&hm);
 }
 
@@ -91,7 +112,7 @@ TEST_F(Hashmap, rif_hashmap_init_should_return_null_on_failing_alloc) {
 TEST_F(Hashmap, rif_hashmap_inita_should_return_an_initialized_hashmap) {
   rif_hashmap_t hm_ptr;
   rif_hashmap_inita(&hm_ptr, 8);
-  EXPECT_EQ(hm_ptr.capacity, 8);
+  EXPECT_EQ(hm_ptr.capacity, 16);
   rif_hashmap_release(&hm_ptr);
 }
 
@@ -99,6 +120,17 @@ TEST_F(Hashmap, rif_hashmap_inita_should_return_an_initialized_hashmap) {
  * CAPACITY TESTS
  */
 
+TEST_F(Hashmap, rif_hashmap_capacity_helper_should_not_exceed_the_max_load_factor) {
+  EXPECT_EQ(32, rif_hashmap_capacity_helper(15, 0.9f));
+  EXPECT_EQ(16, rif_hashmap_capacity_helper(12, 0.75f));
+  EXPECT_EQ(16, rif_hashmap_capacity_helper(16, 1.0f));
+  EXPECT_EQ(UINT32_C(1) << 31, rif_hashmap_capacity_helper(UINT32_MAX, 0.5f));
+  rif_hashmap_t hm;
+  rif_hashmap_inita(&hm, 15);
+  EXPECT_GE(0.75f * rif_hashmap_capacity(&hm), 15);
+  rif_hashmap_release(&hm);
+}
+
 TEST_F(Hashmap, rif_hashmap_ensure_capacity_should_increase_capacity) {
   ASSERT_EQ(RIF_OK, rif_hashmap_ensure_capacity(&hm_empty, 16));
   EXPECT_TRUE(16 <= rif_hashmap_capacity(&hm_empty));
@@ -106,21 +138,185 @@ TEST_F(Hashmap, rif_hashmap_ensure_capacity_should_increase_capacity) {
 
 TEST_F(Hashmap, rif_hashmap_ensure_capacity_should_not_increase_capacity_if_desired_capacity_is_zero) {
   ASSERT_EQ(RIF_OK, rif_hashmap_ensure_capacity(&hm_empty, 0));
-  EXPECT_EQ(8, rif_hashmap_capacity(&hm_empty));
+  EXPECT_EQ(16, rif_hashmap_capacity(&hm_empty));
 }
 
 TEST_F(Hashmap, rif_hashmap_ensure_capacity_should_not_increase_capacity_of_a_fixed_size_hashmap) {
   ASSERT_EQ(RIF_ERR_CAPACITY, rif_hashmap_ensure_capacity(&hm_empty_fixed, 16));
-  EXPECT_EQ(8, rif_hashmap_capacity(&hm_empty_fixed));
+  EXPECT_EQ(16, rif_hashmap_capacity(&hm_empty_fixed));
 }
 
 TEST_F(Hashmap, rif_hashmap_ensure_capacity_should_handle_failing_alloc) {
   rif_alloc_set_filter(_alloc_filter_capacity_alloc);
   ASSERT_EQ(RIF_ERR_MEMORY, rif_hashmap_ensure_capacity(&hm_empty, 16));
-  EXPECT_EQ(8, rif_hashmap_capacity(&hm_empty));
+  EXPECT_EQ(16, rif_hashmap_capacity(&hm_empty));
   rif_alloc_set_filter(NULL);
 }
 
+TEST_F(Hashmap, rif_hashmap_ensure_capacity_should_preserve_element_hashes) {
+  for (uint8_t n = 0; n < 8; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    rif_hashmap_put(&hm_empty, rif_val(val), rif_val(val));
+    rif_val_release(val);
+  }
+  uint32_t hashes[8];
+  for (uint32_t pos = 0; pos < rif_hashmap_capacity(&hm_empty); ++pos) {
+    rif_hashmap_element_t *elem_ptr = rif_hashmap_atindex(&hm_empty, pos);
+    if (elem_ptr) {
+      hashes[rif_int_get(rif_int_fromval(elem_ptr->key_ptr))] = elem_ptr->hash;
+    }
+  }
+  ASSERT_EQ(RIF_OK, rif_hashmap_ensure_capacity(&hm_empty, 128));
+  for (uint32_t pos = 0; pos < rif_hashmap_capacity(&hm_empty); ++pos) {
+    rif_hashmap_element_t *elem_ptr = rif_hashmap_atindex(&hm_empty, pos);
+    if (elem_ptr) {
+      EXPECT_EQ(hashes[rif_int_get(rif_int_fromval(elem_ptr->key_ptr))], elem_ptr->hash);
+    }
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_shrink_to_fit_should_reduce_capacity) {
+  for (uint8_t n = 0; n < 128; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    rif_hashmap_put(&hm_empty, rif_val(val), rif_val(val));
+    if (n >= 8) {
+      rif_hashmap_remove(&hm_empty, rif_val(val));
+    }
+    rif_val_release(val);
+  }
+  ASSERT_EQ(RIF_OK, rif_hashmap_shrink_to_fit(&hm_empty));
+  EXPECT_EQ(16, rif_hashmap_capacity(&hm_empty));
+  for (uint8_t n = 0; n < 8; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n, rif_int_get(rif_int_fromval(rif_hashmap_get(&hm_empty, rif_val(val)))));
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_shrink_to_fit_should_release_storage_of_empty_map) {
+  ASSERT_EQ(RIF_OK, rif_hashmap_shrink_to_fit(&hm_empty));
+  EXPECT_EQ(0, rif_hashmap_capacity(&hm_empty));
+  EXPECT_EQ(NULL, hm_empty.elements);
+  EXPECT_EQ(NULL, rif_hashmap_get(&hm_empty, rif_val(rif_true)));
+  EXPECT_EQ(RIF_OK, rif_hashmap_put(&hm_empty, rif_val(rif_true), rif_val(rif_null)));
+  EXPECT_EQ(rif_val(rif_null), rif_hashmap_get(&hm_empty, rif_val(rif_true)));
+}
+
+TEST_F(Hashmap, rif_hashmap_shrink_to_fit_should_not_shrink_a_fixed_size_hashmap) {
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_hashmap_shrink_to_fit(&hm_empty_fixed));
+  EXPECT_EQ(16, rif_hashmap_capacity(&hm_empty_fixed));
+}
+
+TEST_F(Hashmap, rif_hashmap_shrink_to_fit_should_handle_failing_alloc) {
+  rif_hashmap_ensure_capacity(&hm_empty, 64);
+  rif_hashmap_put(&hm_empty, rif_val(rif_true), rif_val(rif_null));
+  uint32_t capacity = rif_hashmap_capacity(&hm_empty);
+  rif_alloc_set_filter(_alloc_filter_capacity_alloc);
+  ASSERT_EQ(RIF_ERR_MEMORY, rif_hashmap_shrink_to_fit(&hm_empty));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(capacity, rif_hashmap_capacity(&hm_empty));
+  EXPECT_EQ(rif_val(rif_null), rif_hashmap_get(&hm_empty, rif_val(rif_true)));
+}
+
+/******************************************************************************
+ * BATCH LOOKUPS
+ */
+
+TEST_F(Hashmap, rif_hashmap_get_many_should_return_every_element) {
+  std::vector<rif_val_t *> keys;
+  for (uint32_t n = 0; n < 100; ++n) {
+    keys.push_back(rif_val(rif_int_new(n)));
+    if (n % 3) {
+      rif_hashmap_put(&hm_empty, keys[n], keys[n]);
+    }
+  }
+  std::vector<rif_val_t *> vals(100, rif_val(rif_null));
+  EXPECT_EQ(66, rif_hashmap_get_many(&hm_empty, keys.data(), 100, vals.data()));
+  for (uint32_t n = 0; n < 100; ++n) {
+    EXPECT_EQ(n % 3 ? keys[n] : NULL, vals[n]);
+    rif_val_release(keys[n]);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_get_many_should_handle_unallocated_map) {
+  rif_hashmap_t hm;
+  rif_hashmap_init(&hm, 0, false);
+  rif_val_t *keys[2] = {rif_val(rif_true), rif_val(rif_false)};
+  rif_val_t *vals[2] = {rif_val(rif_null), rif_val(rif_null)};
+  EXPECT_EQ(0, rif_hashmap_get_many(&hm, keys, 2, vals));
+  EXPECT_EQ(NULL, vals[0]);
+  EXPECT_EQ(NULL, vals[1]);
+  rif_hashmap_release(&hm);
+}
+
+TEST_F(Hashmap, rif_hashmap_exists_many_should_check_every_key) {
+  std::vector<rif_val_t *> keys;
+  for (uint32_t n = 0; n < 100; ++n) {
+    keys.push_back(rif_val(rif_int_new(n)));
+    if (n % 2) {
+      rif_hashmap_put(&hm_empty, keys[n], keys[n]);
+    }
+  }
+  bool exists[100];
+  EXPECT_EQ(50, rif_hashmap_exists_many(&hm_empty, keys.data(), 100, exists));
+  for (uint32_t n = 0; n < 100; ++n) {
+    EXPECT_EQ(n % 2 != 0, exists[n]);
+    rif_val_release(keys[n]);
+  }
+}
+
+/******************************************************************************
+ * LOAD FACTOR
+ */
+
+TEST_F(Hashmap, rif_hashmap_init_should_use_default_max_load_factor) {
+  EXPECT_FLOAT_EQ(RIF_HASHMAP_DEFAULT_MAX_LOAD_FACTOR, rif_hashmap_max_load_factor(&hm_empty));
+}
+
+TEST_F(Hashmap, rif_hashmap_set_max_load_factor_should_reject_invalid_values) {
+  EXPECT_EQ(RIF_ERR_OUT_OF_BOUNDS, rif_hashmap_set_max_load_factor(&hm_empty, 0));
+  EXPECT_EQ(RIF_ERR_OUT_OF_BOUNDS, rif_hashmap_set_max_load_factor(&hm_empty, -0.5f));
+  EXPECT_EQ(RIF_ERR_OUT_OF_BOUNDS, rif_hashmap_set_max_load_factor(&hm_empty, 1.5f));
+  EXPECT_FLOAT_EQ(RIF_HASHMAP_DEFAULT_MAX_LOAD_FACTOR, rif_hashmap_max_load_factor(&hm_empty));
+}
+
+TEST_F(Hashmap, rif_hashmap_set_max_load_factor_should_bound_load_factor) {
+  ASSERT_EQ(RIF_OK, rif_hashmap_set_max_load_factor(&hm_empty, 0.5f));
+  for (uint8_t n = 0; n < 100; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_hashmap_put(&hm_empty, rif_val(val), rif_val(val)));
+    EXPECT_LE(rif_hashmap_size(&hm_empty), rif_hashmap_capacity(&hm_empty) / 2);
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_set_max_load_factor_should_grow_map_if_needed) {
+  for (uint8_t n = 0; n < 8; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    rif_hashmap_put(&hm_empty, rif_val(val), rif_val(val));
+    rif_val_release(val);
+  }
+  ASSERT_EQ(16, rif_hashmap_capacity(&hm_empty));
+  ASSERT_EQ(RIF_OK, rif_hashmap_set_max_load_factor(&hm_empty, 0.25f));
+  EXPECT_EQ(32, rif_hashmap_capacity(&hm_empty));
+  EXPECT_EQ(8, rif_hashmap_size(&hm_empty));
+}
+
+TEST_F(Hashmap, rif_hashmap_set_max_load_factor_should_not_grow_a_fixed_size_hashmap) {
+  for (uint8_t n = 0; n < 8; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    rif_hashmap_put(&hm_empty_fixed, rif_val(val), rif_val(val));
+    rif_val_release(val);
+  }
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_hashmap_set_max_load_factor(&hm_empty_fixed, 0.25f));
+  EXPECT_FLOAT_EQ(RIF_HASHMAP_DEFAULT_MAX_LOAD_FACTOR, rif_hashmap_max_load_factor(&hm_empty_fixed));
+  EXPECT_EQ(16, rif_hashmap_capacity(&hm_empty_fixed));
+}
+
+/******************************************************************************
+ * PUT
+ */
+
 TEST_F(Hashmap, rif_hashmap_put_should_increase_capacity_if_needed) {
   for (uint8_t n = 0; n < 128; ++n) {
     rif_int_t *val = rif_int_new(n);
@@ -136,7 +332,8 @@ TEST_F(Hashmap, rif_hashmap_put_should_increase_capacity_if_needed) {
 }
 
 TEST_F(Hashmap, rif_hashmap_put_should_handle_insufficient_capacity) {
-  for (uint8_t n = 0; n < 8; ++n) {
+  // 16 slots hold at most 14 elements at the default load factor
+  for (uint8_t n = 0; n < 14; ++n) {
     rif_int_t *val = rif_int_new(n);
     EXPECT_EQ(RIF_OK, rif_hashmap_put(&hm_empty_fixed, rif_val(val), rif_val(val)));
     rif_val_release(val);
@@ -144,6 +341,56 @@ TEST_F(Hashmap, rif_hashmap_put_should_handle_insufficient_capacity) {
   EXPECT_EQ(RIF_ERR_CAPACITY, rif_hashmap_put(&hm_empty_fixed, rif_val(rif_true), rif_val(rif_null)));
 }
 
+TEST_F(Hashmap, rif_hashmap_put_many_should_insert_every_element) {
+  std::vector<rif_val_t *> keys;
+  for (uint32_t n = 0; n < 100; ++n) {
+    keys.push_back(rif_val(rif_int_new(n)));
+  }
+  ASSERT_EQ(RIF_OK, rif_hashmap_put_many(&hm_empty, keys.data(), keys.data(), 100));
+  EXPECT_EQ(100, rif_hashmap_size(&hm_empty));
+  EXPECT_EQ(rif_hashmap_capacity_helper(100, RIF_HASHMAP_DEFAULT_MAX_LOAD_FACTOR), rif_hashmap_capacity(&hm_empty));
+  for (uint32_t n = 0; n < 100; ++n) {
+    EXPECT_EQ(keys[n], rif_hashmap_get(&hm_empty, keys[n]));
+    rif_val_release(keys[n]);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_put_many_should_replace_duplicate_keys) {
+  rif_int_t *key = rif_int_new(42);
+  rif_val_t *keys[3] = {rif_val(key), rif_val(key), rif_val(key)};
+  rif_val_t *vals[3] = {rif_val(rif_null), rif_val(rif_false), rif_val(rif_true)};
+  ASSERT_EQ(RIF_OK, rif_hashmap_put_many(&hm_empty, keys, vals, 3));
+  EXPECT_EQ(1, rif_hashmap_size(&hm_empty));
+  EXPECT_EQ(rif_val(rif_true), rif_hashmap_get(&hm_empty, rif_val(key)));
+  rif_val_release(key);
+}
+
+TEST_F(Hashmap, rif_hashmap_put_many_should_insert_nothing_on_insufficient_capacity) {
+  std::vector<rif_val_t *> keys;
+  for (uint32_t n = 0; n < 15; ++n) {
+    keys.push_back(rif_val(rif_int_new(n)));
+  }
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_hashmap_put_many(&hm_empty_fixed, keys.data(), keys.data(), 15));
+  EXPECT_EQ(0, rif_hashmap_size(&hm_empty_fixed));
+  for (uint32_t n = 0; n < 15; ++n) {
+    rif_val_release(keys[n]);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_put_many_should_handle_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_capacity_alloc);
+  std::vector<rif_val_t *> keys;
+  for (uint32_t n = 0; n < 100; ++n) {
+    keys.push_back(rif_val(rif_int_new(n)));
+  }
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_hashmap_put_many(&hm_empty, keys.data(), keys.data(), 100));
+  EXPECT_EQ(0, rif_hashmap_size(&hm_empty));
+  rif_alloc_set_filter(NULL);
+  for (uint32_t n = 0; n < 100; ++n) {
+    rif_val_release(keys[n]);
+  }
+}
+
 /******************************************************************************
  * REMOVE
  */
@@ -163,6 +410,182 @@ TEST_F(Hashmap, rif_hashmap_put_should_replace_deleted_elements) {
   }
 }
 
+TEST_F(Hashmap, rif_hashmap_remove_should_not_leave_tombstones) {
+  for (uint8_t n = 0; n < 128; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    rif_hashmap_put(&hm_empty, rif_val(val), rif_val(val));
+    rif_val_release(val);
+  }
+  for (uint8_t n = 0; n < 128; n += 2) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_hashmap_remove(&hm_empty, rif_val(val)));
+    rif_val_release(val);
+  }
+  EXPECT_EQ(64, rif_hashmap_size(&hm_empty));
+  EXPECT_EQ(64, _occupied_slots(&hm_empty));
+  for (uint8_t n = 0; n < 128; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n % 2 != 0, rif_hashmap_exists(&hm_empty, rif_val(val)));
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_remove_should_keep_map_consistent_under_churn) {
+  for (uint32_t n = 0; n < 1000; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_hashmap_put(&hm_empty_fixed, rif_val(val), rif_val(val)));
+    rif_val_release(val);
+    if (n >= 6) {
+      rif_int_t *old = rif_int_new(n - 6);
+      EXPECT_EQ(RIF_OK, rif_hashmap_remove(&hm_empty_fixed, rif_val(old)));
+      rif_val_release(old);
+    }
+  }
+  EXPECT_EQ(6, rif_hashmap_size(&hm_empty_fixed));
+  EXPECT_EQ(6, _occupied_slots(&hm_empty_fixed));
+  for (uint32_t n = 994; n < 1000; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n, rif_int_get(rif_int_fromval(rif_hashmap_get(&hm_empty_fixed, rif_val(val)))));
+    rif_val_release(val);
+  }
+}
+
+/******************************************************************************
+ * INCREMENTAL RESIZE
+ */
+
+TEST_F(Hashmap, rif_hashmap_put_should_not_resize_incremental_map_at_once) {
+  rif_hashmap_ensure_capacity(&hm_empty, 50);
+  uint32_t capacity = rif_hashmap_capacity(&hm_empty);
+  uint32_t count = _fill_until_rehashing(&hm_empty);
+  EXPECT_EQ(2 * capacity, rif_hashmap_capacity(&hm_empty));
+  EXPECT_EQ(count, rif_hashmap_size(&hm_empty));
+  EXPECT_EQ(1, _occupied_slots(&hm_empty));
+  for (uint32_t n = 0; n < count; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n, rif_int_get(rif_int_fromval(rif_hashmap_get(&hm_empty, rif_val(val)))));
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_put_should_migrate_incremental_map_gradually) {
+  rif_hashmap_ensure_capacity(&hm_empty, 50);
+  uint32_t count = _fill_until_rehashing(&hm_empty);
+  uint32_t puts = 0;
+  for (uint32_t n = count; rif_hashmap_isrehashing(&hm_empty); ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_hashmap_put(&hm_empty, rif_val(val), rif_val(val)));
+    EXPECT_EQ(n + 1, rif_hashmap_size(&hm_empty));
+    rif_val_release(val);
+    ++puts;
+  }
+  EXPECT_LT(1, puts);
+  EXPECT_EQ(rif_hashmap_size(&hm_empty), _occupied_slots(&hm_empty));
+  for (uint32_t n = 0; n < count + puts; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n, rif_int_get(rif_int_fromval(rif_hashmap_get(&hm_empty, rif_val(val)))));
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_put_should_replace_elements_not_migrated_yet) {
+  rif_hashmap_ensure_capacity(&hm_empty, 50);
+  uint32_t count = _fill_until_rehashing(&hm_empty);
+  for (uint32_t n = 0; n < count; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_hashmap_put(&hm_empty, rif_val(val), rif_val(rif_null)));
+    rif_val_release(val);
+  }
+  EXPECT_EQ(count, rif_hashmap_size(&hm_empty));
+  for (uint32_t n = 0; n < count; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(rif_val(rif_null), rif_hashmap_get(&hm_empty, rif_val(val)));
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_remove_should_remove_elements_not_migrated_yet) {
+  rif_hashmap_ensure_capacity(&hm_empty, 50);
+  uint32_t count = _fill_until_rehashing(&hm_empty);
+  for (uint32_t n = 0; n < count; n += 2) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_hashmap_remove(&hm_empty, rif_val(val)));
+    rif_val_release(val);
+  }
+  EXPECT_EQ(count / 2, rif_hashmap_size(&hm_empty));
+  EXPECT_FALSE(rif_hashmap_isrehashing(&hm_empty));
+  EXPECT_EQ(count / 2, _occupied_slots(&hm_empty));
+  for (uint32_t n = 0; n < count; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n % 2 != 0, rif_hashmap_exists(&hm_empty, rif_val(val)));
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_iterator_should_visit_every_element_while_rehashing) {
+  rif_hashmap_ensure_capacity(&hm_empty, 50);
+  uint32_t count = _fill_until_rehashing(&hm_empty);
+  rif_hashmap_rehash_step(&hm_empty, 20);
+  ASSERT_TRUE(rif_hashmap_isrehashing(&hm_empty));
+  std::vector<bool> seen(count, false);
+  rif_hashmap_iterator_t it;
+  rif_pair_t pair;
+  rif_hashmap_iterator_init(&it, &hm_empty, &pair);
+  uint32_t found = 0;
+  while (rif_hashmap_iterator_hasnext(&it)) {
+    rif_pair_t *cur = rif_pair_fromval(rif_hashmap_iterator_next(&it));
+    int64_t n = rif_int_get(rif_int_fromval(rif_pair_1(cur)));
+    EXPECT_FALSE(seen[n]);
+    seen[n] = true;
+    ++found;
+  }
+  rif_iterator_destroy((rif_iterator_t *) &it);
+  EXPECT_EQ(count, found);
+}
+
+TEST_F(Hashmap, rif_hashmap_get_many_should_find_elements_while_rehashing) {
+  rif_hashmap_ensure_capacity(&hm_empty, 50);
+  uint32_t count = _fill_until_rehashing(&hm_empty);
+  std::vector<rif_val_t *> keys;
+  for (uint32_t n = 0; n < count + 10; ++n) {
+    keys.push_back(rif_val(rif_int_new(n)));
+  }
+  std::vector<rif_val_t *> vals(count + 10);
+  EXPECT_EQ(count, rif_hashmap_get_many(&hm_empty, keys.data(), count + 10, vals.data()));
+  for (uint32_t n = 0; n < count + 10; ++n) {
+    if (n < count) {
+      EXPECT_TRUE(rif_val_equals(keys[n], vals[n]));
+    } else {
+      EXPECT_EQ(NULL, vals[n]);
+    }
+    rif_val_release(keys[n]);
+  }
+}
+
+TEST_F(Hashmap, rif_hashmap_rehash_step_should_complete_migration) {
+  rif_hashmap_ensure_capacity(&hm_empty, 50);
+  uint32_t count = _fill_until_rehashing(&hm_empty);
+  EXPECT_TRUE(rif_hashmap_rehash_step(&hm_empty, 1));
+  EXPECT_FALSE(rif_hashmap_rehash_step(&hm_empty, UINT32_MAX));
+  EXPECT_EQ(count, _occupied_slots(&hm_empty));
+}
+
+TEST_F(Hashmap, rif_hashmap_set_incremental_should_complete_migration_when_disabled) {
+  rif_hashmap_ensure_capacity(&hm_empty, 50);
+  uint32_t count = _fill_until_rehashing(&hm_empty);
+  rif_hashmap_set_incremental(&hm_empty, false);
+  EXPECT_FALSE(rif_hashmap_isrehashing(&hm_empty));
+  EXPECT_EQ(count, _occupied_slots(&hm_empty));
+}
+
+TEST_F(Hashmap, rif_hashmap_ensure_capacity_should_complete_migration) {
+  rif_hashmap_ensure_capacity(&hm_empty, 50);
+  uint32_t count = _fill_until_rehashing(&hm_empty);
+  ASSERT_EQ(RIF_OK, rif_hashmap_ensure_capacity(&hm_empty, 1000));
+  EXPECT_FALSE(rif_hashmap_isrehashing(&hm_empty));
+  EXPECT_EQ(count, _occupied_slots(&hm_empty));
+}
+
 /******************************************************************************
  * CONFORMITY
  */
@@ -184,4 +607,18 @@ static rif_map_conformity_generator_t rif_hashmap_generator = {
     .destroy = _rif_hashmap_destroy
 };
 
-INSTANTIATE_TEST_CASE_P(Hashmap, MapConformity, ::testing::Values(&rif_hashmap_generator));
\ No newline at end of file
+static
+rif_map_t *_rif_hashmap_incremental_init() {
+  rif_hashmap_t *map_ptr = (rif_hashmap_t *) rif_malloc(sizeof(rif_hashmap_t));
+  rif_hashmap_init(map_ptr, 8, false);
+  rif_hashmap_set_incremental(map_ptr, true);
+  return (rif_map_t *) map_ptr;
+}
+
+static rif_map_conformity_generator_t rif_hashmap_incremental_generator = {
+    .init = _rif_hashmap_incremental_init,
+    .destroy = _rif_hashmap_destroy
+};
+
+INSTANTIATE_TEST_CASE_P(Hashmap, MapConformity, ::testing::Values(&rif_hashmap_generator));
+INSTANTIATE_TEST_CASE_P(HashmapIncremental, MapConformity, ::testing::Values(&rif_hashmap_incremental_generator));
\ No newline at end of file
@@ -17,6 +17,8 @@
  * License along with this library.
  */
 
+#include <vector>
+
 #include "../test_internal.h"
 
 #include "support/list_conformity.hh"
@@ -97,6 +99,60 @@ TEST_F(Linkedlist, rif_linkedlist_insert_should_return_memory_error_on_failing_a
   rif_alloc_set_filter(NULL);
 }
 
+/******************************************************************************
+ * CURSOR TESTS
+ */
+
+TEST_F(Linkedlist, rif_linkedlist_get_should_move_cursor_to_accessed_node) {
+  for (int64_t n = 0; n < 100; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    rif_linkedlist_append(&ll_empty, rif_val(val));
+    rif_val_release(val);
+  }
+  for (uint32_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, rif_int_get(rif_int_fromval(rif_linkedlist_get(&ll_empty, i))));
+    EXPECT_EQ(i, ll_empty.cursor_index);
+    EXPECT_EQ(rif_linkedlist_get(&ll_empty, i), ll_empty.cursor->val);
+  }
+  EXPECT_EQ(NULL, rif_linkedlist_get(&ll_empty, 100));
+}
+
+TEST_F(Linkedlist, rif_linkedlist_cursor_should_stay_valid_across_insert_and_remove) {
+  std::vector<int64_t> expected;
+  uint64_t state = 42;
+  for (int64_t n = 0; n < 2000; ++n) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint32_t size = (uint32_t) expected.size();
+    uint32_t index = (uint32_t) ((state >> 33) % (size + 1));
+    switch ((state >> 20) % 4) {
+      case 0:
+        if (size) {
+          index = index % size;
+          ASSERT_EQ(RIF_OK, rif_linkedlist_remove(&ll_empty, index));
+          expected.erase(expected.begin() + index);
+          break;
+        }
+        // Fall through: nothing to remove, insert instead.
+      case 1: {
+        rif_int_t *val = rif_int_new(n);
+        ASSERT_EQ(RIF_OK, rif_linkedlist_insert(&ll_empty, index, rif_val(val)));
+        rif_val_release(val);
+        expected.insert(expected.begin() + index, n);
+        break;
+      }
+      default:
+        if (size) {
+          index = index % size;
+          ASSERT_EQ(expected[index], rif_int_get(rif_int_fromval(rif_linkedlist_get(&ll_empty, index))));
+        }
+    }
+  }
+  ASSERT_EQ(expected.size(), rif_linkedlist_size(&ll_empty));
+  for (uint32_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], rif_int_get(rif_int_fromval(rif_linkedlist_get(&ll_empty, i))));
+  }
+}
+
 /******************************************************************************
  * CONFORMITY
  */
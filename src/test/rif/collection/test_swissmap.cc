@@ -0,0 +1,310 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include "../test_internal.h"
+
+#include "support/map_conformity.hh"
+
+/******************************************************************************
+ * TEST FIXTURES
+ */
+
+static
+bool _alloc_filter_capacity_alloc(const char *tag) {
+  return 0 != strcmp(tag, "SWISSMAP_CAPACITY_ALLOC");
+}
+
+static uint32_t _capacity_allocs = 0;
+
+static
+bool _alloc_filter_count_capacity_allocs(const char *tag) {
+  _capacity_allocs += 0 == strcmp(tag, "SWISSMAP_CAPACITY_ALLOC");
+  return true;
+}
+
+static
+uint32_t _occupied_slots(const rif_swissmap_t *sm_ptr) {
+  uint32_t occupied = 0;
+  for (uint32_t pos = 0; pos < rif_swissmap_capacity(sm_ptr); ++pos) {
+    occupied += rif_swissmap_isfull(sm_ptr, pos);
+  }
+  return occupied;
+}
+
+/******************************************************************************
+ * TEST CONFIG
+ */
+
+class Swissmap : public MemoryAwareTest {
+
+public:
+
+  rif_swissmap_t sm_empty;
+  rif_swissmap_t sm_empty_fixed;
+
+private:
+
+  virtual void SetUp() {
+    MemoryAwareTest::SetUp();
+    rif_swissmap_init(&sm_empty, 8, false);
+    rif_swissmap_init(&sm_empty_fixed, 8, true);
+  }
+
+  virtual void TearDown() {
+    rif_swissmap_release(&sm_empty);
+    rif_swissmap_release(&sm_empty_fixed);
+    MemoryAwareTest::TearDown();
+  }
+
+};
+
+/******************************************************************************
+ * INIT TESTS
+ */
+
+TEST_F(Swissmap, rif_swissmap_init_should_return_null_with_null_ptr) {
+  ASSERT_EQ(NULL, rif_swissmap_init(NULL, 8, true));
+}
+
+TEST_F(Swissmap, rif_swissmap_init_should_return_an_initialized_swissmap) {
+  rif_swissmap_t sm;
+  ASSERT_TRUE(NULL != rif_swissmap_init(&sm, 8, true));
+  EXPECT_EQ(RIF_SWISSMAP_GROUP_WIDTH, rif_swissmap_capacity(&sm));
+  EXPECT_EQ(0, rif_swissmap_size(&sm));
+  rif_swissmap_release(&sm);
+}
+
+TEST_F(Swissmap, rif_swissmap_init_should_not_allocate_memory_with_zero_capacity) {
+  rif_swissmap_t sm;
+  ASSERT_TRUE(NULL != rif_swissmap_init(&sm, 0, false));
+  EXPECT_EQ(NULL, sm.ctrl);
+  EXPECT_EQ(NULL, rif_swissmap_get(&sm, rif_val(rif_null)));
+  EXPECT_FALSE(rif_swissmap_exists(&sm, rif_val(rif_null)));
+  EXPECT_EQ(RIF_OK, rif_swissmap_remove(&sm, rif_val(rif_null)));
+  EXPECT_EQ(0, rif_swissmap_capacity(&sm));
+  rif_swissmap_release(&sm);
+}
+
+TEST_F(Swissmap, rif_swissmap_init_should_return_null_on_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_capacity_alloc);
+  rif_swissmap_t sm;
+  ASSERT_TRUE(NULL == rif_swissmap_init(&sm, 8, true));
+  rif_alloc_set_filter(NULL);
+}
+
+/******************************************************************************
+ * CAPACITY TESTS
+ */
+
+TEST_F(Swissmap, rif_swissmap_ensure_capacity_should_increase_capacity) {
+  ASSERT_EQ(RIF_OK, rif_swissmap_ensure_capacity(&sm_empty, 100));
+  EXPECT_EQ(128, rif_swissmap_capacity(&sm_empty));
+  ASSERT_EQ(RIF_OK, rif_swissmap_ensure_capacity(&sm_empty, 112));
+  EXPECT_EQ(128, rif_swissmap_capacity(&sm_empty));
+  ASSERT_EQ(RIF_OK, rif_swissmap_ensure_capacity(&sm_empty, 113));
+  EXPECT_EQ(256, rif_swissmap_capacity(&sm_empty));
+}
+
+TEST_F(Swissmap, rif_swissmap_ensure_capacity_should_not_increase_capacity_if_desired_capacity_is_zero) {
+  ASSERT_EQ(RIF_OK, rif_swissmap_ensure_capacity(&sm_empty, 0));
+  EXPECT_EQ(RIF_SWISSMAP_GROUP_WIDTH, rif_swissmap_capacity(&sm_empty));
+}
+
+TEST_F(Swissmap, rif_swissmap_ensure_capacity_should_not_increase_capacity_of_a_fixed_size_swissmap) {
+  ASSERT_EQ(RIF_ERR_CAPACITY, rif_swissmap_ensure_capacity(&sm_empty_fixed, 64));
+  EXPECT_EQ(RIF_SWISSMAP_GROUP_WIDTH, rif_swissmap_capacity(&sm_empty_fixed));
+}
+
+TEST_F(Swissmap, rif_swissmap_ensure_capacity_should_handle_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_capacity_alloc);
+  ASSERT_EQ(RIF_ERR_MEMORY, rif_swissmap_ensure_capacity(&sm_empty, 64));
+  EXPECT_EQ(RIF_SWISSMAP_GROUP_WIDTH, rif_swissmap_capacity(&sm_empty));
+  rif_alloc_set_filter(NULL);
+}
+
+TEST_F(Swissmap, rif_swissmap_ensure_capacity_should_keep_elements) {
+  for (uint8_t n = 0; n < 10; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    rif_swissmap_put(&sm_empty, rif_val(val), rif_val(val));
+    rif_val_release(val);
+  }
+  ASSERT_EQ(RIF_OK, rif_swissmap_ensure_capacity(&sm_empty, 1000));
+  EXPECT_EQ(10, rif_swissmap_size(&sm_empty));
+  EXPECT_EQ(10, _occupied_slots(&sm_empty));
+  for (uint8_t n = 0; n < 10; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n, rif_int_get(rif_int_fromval(rif_swissmap_get(&sm_empty, rif_val(val)))));
+    rif_val_release(val);
+  }
+}
+
+/******************************************************************************
+ * PUT
+ */
+
+TEST_F(Swissmap, rif_swissmap_put_should_increase_capacity_if_needed) {
+  for (uint32_t n = 0; n < 1000; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_swissmap_put(&sm_empty, rif_val(val), rif_val(val)));
+    EXPECT_LE(rif_swissmap_size(&sm_empty), rif_swissmap_capacity(&sm_empty) / 8 * 7);
+    rif_val_release(val);
+  }
+  for (uint32_t n = 0; n < 1000; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n, rif_int_get(rif_int_fromval(rif_swissmap_get(&sm_empty, rif_val(val)))));
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Swissmap, rif_swissmap_put_should_handle_insufficient_capacity) {
+  for (uint8_t n = 0; n < 14; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_swissmap_put(&sm_empty_fixed, rif_val(val), rif_val(val)));
+    rif_val_release(val);
+  }
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_swissmap_put(&sm_empty_fixed, rif_val(rif_true), rif_val(rif_null)));
+  EXPECT_EQ(14, rif_swissmap_size(&sm_empty_fixed));
+}
+
+TEST_F(Swissmap, rif_swissmap_put_should_handle_failing_alloc) {
+  for (uint8_t n = 0; n < 14; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    rif_swissmap_put(&sm_empty, rif_val(val), rif_val(val));
+    rif_val_release(val);
+  }
+  rif_alloc_set_filter(_alloc_filter_capacity_alloc);
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_swissmap_put(&sm_empty, rif_val(rif_true), rif_val(rif_null)));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(14, rif_swissmap_size(&sm_empty));
+  EXPECT_FALSE(rif_swissmap_exists(&sm_empty, rif_val(rif_true)));
+}
+
+/******************************************************************************
+ * REMOVE
+ */
+
+TEST_F(Swissmap, rif_swissmap_put_should_reuse_deleted_slots) {
+  for (uint32_t n = 0; n < 1000; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_swissmap_put(&sm_empty_fixed, rif_val(val), rif_val(val)));
+    rif_val_release(val);
+    if (n >= 10) {
+      rif_int_t *old = rif_int_new(n - 10);
+      EXPECT_EQ(RIF_OK, rif_swissmap_remove(&sm_empty_fixed, rif_val(old)));
+      rif_val_release(old);
+    }
+  }
+  EXPECT_EQ(RIF_SWISSMAP_GROUP_WIDTH, rif_swissmap_capacity(&sm_empty_fixed));
+  EXPECT_EQ(10, rif_swissmap_size(&sm_empty_fixed));
+  EXPECT_EQ(10, _occupied_slots(&sm_empty_fixed));
+  for (uint32_t n = 990; n < 1000; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n, rif_int_get(rif_int_fromval(rif_swissmap_get(&sm_empty_fixed, rif_val(val)))));
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Swissmap, rif_swissmap_remove_should_keep_map_consistent_under_churn) {
+  rif_swissmap_ensure_capacity(&sm_empty, 512);
+  uint32_t capacity = rif_swissmap_capacity(&sm_empty);
+  for (uint32_t n = 0; n < 20000; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_swissmap_put(&sm_empty, rif_val(val), rif_val(val)));
+    rif_val_release(val);
+    if (n >= 400) {
+      rif_int_t *old = rif_int_new(n - 400);
+      EXPECT_EQ(RIF_OK, rif_swissmap_remove(&sm_empty, rif_val(old)));
+      rif_val_release(old);
+    }
+  }
+  EXPECT_EQ(capacity, rif_swissmap_capacity(&sm_empty));
+  EXPECT_EQ(400, rif_swissmap_size(&sm_empty));
+  EXPECT_EQ(400, _occupied_slots(&sm_empty));
+  for (uint32_t n = 19000; n < 20000; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(n >= 19600, rif_swissmap_exists(&sm_empty, rif_val(val)));
+    rif_val_release(val);
+  }
+}
+
+TEST_F(Swissmap, rif_swissmap_remove_should_not_rebuild_on_every_put_under_churn_at_max_load) {
+  rif_swissmap_ensure_capacity(&sm_empty, 56);
+  ASSERT_EQ(64, rif_swissmap_capacity(&sm_empty));
+  for (uint32_t n = 0; n < 56; ++n) {
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_swissmap_put(&sm_empty, rif_val(val), rif_val(val)));
+    rif_val_release(val);
+  }
+  _capacity_allocs = 0;
+  rif_alloc_set_filter(_alloc_filter_count_capacity_allocs);
+  for (uint32_t n = 56; n < 2056; ++n) {
+    rif_int_t *old = rif_int_new(n - 56);
+    EXPECT_EQ(RIF_OK, rif_swissmap_remove(&sm_empty, rif_val(old)));
+    rif_val_release(old);
+    rif_int_t *val = rif_int_new(n);
+    EXPECT_EQ(RIF_OK, rif_swissmap_put(&sm_empty, rif_val(val), rif_val(val)));
+    rif_val_release(val);
+  }
+  rif_alloc_set_filter(NULL);
+  EXPECT_LT(_capacity_allocs, 100);
+  EXPECT_EQ(56, rif_swissmap_size(&sm_empty));
+  EXPECT_EQ(56, _occupied_slots(&sm_empty));
+}
+
+/******************************************************************************
+ * IMMEDIATE VALUES
+ */
+
+TEST_F(Swissmap, rif_swissmap_should_store_immediate_values) {
+  for (int64_t n = 0; n < 1000; ++n) {
+    rif_int_t *val = rif_int_new_immediate(n);
+    EXPECT_EQ(RIF_OK, rif_swissmap_put(&sm_empty, rif_val(val), rif_val(rif_string_new_immediate("imm"))));
+  }
+  EXPECT_EQ(1000, rif_swissmap_size(&sm_empty));
+  for (int64_t n = 0; n < 1000; ++n) {
+    rif_int_t *key = rif_int_new(n);
+    EXPECT_TRUE(rif_val_equals(rif_swissmap_get(&sm_empty, rif_val(key)), rif_string_new_immediate("imm")));
+    rif_val_release(key);
+  }
+  EXPECT_EQ(RIF_OK, rif_swissmap_remove(&sm_empty, rif_val(rif_int_new_immediate(42))));
+  EXPECT_FALSE(rif_swissmap_exists(&sm_empty, rif_val(rif_int_new_immediate(42))));
+}
+
+/******************************************************************************
+ * CONFORMITY
+ */
+
+static
+rif_map_t *_rif_swissmap_init() {
+  rif_swissmap_t *map_ptr = (rif_swissmap_t *) rif_malloc(sizeof(rif_swissmap_t));
+  return (rif_map_t *) rif_swissmap_init(map_ptr, 8, false);
+}
+
+static
+void _rif_swissmap_destroy(rif_map_t *map_ptr) {
+  rif_val_release(map_ptr);
+  rif_free(map_ptr);
+}
+
+static rif_map_conformity_generator_t rif_swissmap_generator = {
+    .init = _rif_swissmap_init,
+    .destroy = _rif_swissmap_destroy
+};
+
+INSTANTIATE_TEST_CASE_P(Swissmap, MapConformity, ::testing::Values(&rif_swissmap_generator));
@@ -103,6 +103,15 @@ TEST_F(ConcurrentBlockingQueue, rif_concurrent_blocking_queue_trypop_should_work
   ASSERT_TRUE(NULL == rif_concurrent_blocking_queue_trypop(&queue));
 }
 
+TEST_F(ConcurrentBlockingQueue, rif_concurrent_blocking_queue_push_steal_should_take_over_the_reference) {
+  rif_int_t *int_ptr = rif_int_new(1 << 20);
+  ASSERT_EQ(RIF_OK, rif_queue_push_steal((rif_queue_t *) &queue, rif_val(int_ptr)));
+  EXPECT_EQ(1, rif_val_reference_count(int_ptr));
+  rif_val_t *popped = rif_concurrent_blocking_queue_trypop(&queue);
+  ASSERT_TRUE(rif_val(int_ptr) == popped);
+  rif_val_release(popped);
+}
+
 TEST_F(ConcurrentBlockingQueue, rif_concurrent_blocking_queue_pop_should_block_waiting_for_data) {
   auto thread = std::thread(_rif_concurrent_blocking_queue_test_pop, &queue);
   SLEEP(SLEEP_TIME);
@@ -0,0 +1,282 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "../../test_internal.h"
+
+#include "../../collection/support/map_conformity.hh"
+
+/******************************************************************************
+ * TEST HELPERS
+ */
+
+#define NUM_THREADS  8
+#define NUM_ELEMENTS 4096
+
+static
+bool _alloc_filter_segments_alloc(const char *tag) {
+  return 0 != strcmp(tag, "CONCURRENT_HASHMAP_SEGMENTS_ALLOC");
+}
+
+static
+bool _alloc_filter_capacity_alloc(const char *tag) {
+  return 0 != strcmp(tag, "HASHMAP_CAPACITY_ALLOC");
+}
+
+/******************************************************************************
+ * TEST CONFIG
+ */
+
+class ConcurrentHashmap : public MemoryAwareTest {
+
+public:
+
+  rif_concurrent_hashmap_t chm;
+
+private:
+
+  virtual void SetUp() {
+    MemoryAwareTest::SetUp();
+    rif_concurrent_hashmap_init(&chm, 0, 0);
+  }
+
+  virtual void TearDown() {
+    rif_concurrent_hashmap_release(&chm);
+    MemoryAwareTest::TearDown();
+  }
+
+};
+
+/******************************************************************************
+ * TEST THREADS
+ */
+
+/*
+ * Each thread owns the keys equal to its index modulo `NUM_THREADS`, and puts, replaces, reads and removes them.
+ */
+static
+void _rif_concurrent_hashmap_test_owned_keys(rif_concurrent_hashmap_t *chm_ptr, uint32_t thread) {
+  for (uint32_t n = thread; n < NUM_ELEMENTS; n += NUM_THREADS) {
+    rif_int_t *key = rif_int_new(n);
+    ASSERT_EQ(RIF_OK, rif_concurrent_hashmap_put(chm_ptr, rif_val(key), rif_val(rif_null)));
+    ASSERT_EQ(RIF_OK, rif_concurrent_hashmap_put(chm_ptr, rif_val(key), rif_val(key)));
+    ASSERT_EQ(rif_val(key), rif_concurrent_hashmap_get(chm_ptr, rif_val(key)));
+    rif_val_release(key);
+  }
+  for (uint32_t n = thread; n < NUM_ELEMENTS; n += 2 * NUM_THREADS) {
+    rif_int_t *key = rif_int_new(n);
+    ASSERT_EQ(RIF_OK, rif_concurrent_hashmap_remove(chm_ptr, rif_val(key)));
+    ASSERT_FALSE(rif_concurrent_hashmap_exists(chm_ptr, rif_val(key)));
+    rif_val_release(key);
+  }
+}
+
+/*
+ * Every thread replaces and reads the same few keys.
+ */
+static
+void _rif_concurrent_hashmap_test_shared_keys(rif_concurrent_hashmap_t *chm_ptr, uint32_t thread) {
+  for (uint32_t n = 0; n < NUM_ELEMENTS; ++n) {
+    rif_int_t *key = rif_int_new(n % 16);
+    rif_int_t *val = rif_int_new(thread);
+    ASSERT_EQ(RIF_OK, rif_concurrent_hashmap_put(chm_ptr, rif_val(key), rif_val(val)));
+    rif_val_release(val);
+    rif_val_t *read = rif_concurrent_hashmap_get_retained(chm_ptr, rif_val(key));
+    if (read) {
+      ASSERT_LT(rif_int_get(rif_int_fromval(read)), NUM_THREADS);
+      rif_val_release(read);
+    }
+    if (n % 3 == 0) {
+      ASSERT_EQ(RIF_OK, rif_concurrent_hashmap_remove(chm_ptr, rif_val(key)));
+    }
+    rif_val_release(key);
+  }
+}
+
+/******************************************************************************
+ * INIT TESTS
+ */
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_init_should_return_null_with_null_ptr) {
+  ASSERT_EQ(NULL, rif_concurrent_hashmap_init(NULL, 0, 0));
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_init_should_use_default_concurrency) {
+  EXPECT_EQ(RIF_CONCURRENT_HASHMAP_DEFAULT_CONCURRENCY, chm.segment_count);
+  EXPECT_EQ(0, rif_concurrent_hashmap_size(&chm));
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_init_should_round_concurrency_to_a_power_of_two) {
+  rif_concurrent_hashmap_t map;
+  ASSERT_TRUE(NULL != rif_concurrent_hashmap_init(&map, 0, 5));
+  EXPECT_EQ(8, map.segment_count);
+  rif_concurrent_hashmap_release(&map);
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_init_should_spread_capacity_over_segments) {
+  rif_concurrent_hashmap_t map;
+  ASSERT_TRUE(NULL != rif_concurrent_hashmap_init(&map, 1000, 4));
+  for (uint32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(rif_hashmap_capacity_helper(250, RIF_HASHMAP_DEFAULT_MAX_LOAD_FACTOR),
+              rif_hashmap_capacity(&map.segments[i].map));
+  }
+  rif_concurrent_hashmap_release(&map);
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_init_should_return_null_on_failing_segments_alloc) {
+  rif_alloc_set_filter(_alloc_filter_segments_alloc);
+  rif_concurrent_hashmap_t map;
+  ASSERT_TRUE(NULL == rif_concurrent_hashmap_init(&map, 0, 0));
+  rif_alloc_set_filter(NULL);
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_init_should_return_null_on_failing_capacity_alloc) {
+  rif_alloc_set_filter(_alloc_filter_capacity_alloc);
+  rif_concurrent_hashmap_t map;
+  ASSERT_TRUE(NULL == rif_concurrent_hashmap_init(&map, 1000, 0));
+  rif_alloc_set_filter(NULL);
+}
+
+/******************************************************************************
+ * ELEMENT TESTS
+ */
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_get_retained_should_retain_element) {
+  rif_int_t *val = rif_int_new(1000);
+  rif_concurrent_hashmap_put(&chm, rif_val(rif_true), rif_val(val));
+  rif_val_t *read = rif_concurrent_hashmap_get_retained(&chm, rif_val(rif_true));
+  EXPECT_EQ(rif_val(val), read);
+  EXPECT_EQ(3, rif_val_reference_count(val));
+  rif_concurrent_hashmap_remove(&chm, rif_val(rif_true));
+  EXPECT_EQ(2, rif_val_reference_count(val));
+  rif_val_release(read);
+  rif_val_release(val);
+  EXPECT_EQ(NULL, rif_concurrent_hashmap_get_retained(&chm, rif_val(rif_true)));
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_put_should_handle_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_capacity_alloc);
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_concurrent_hashmap_put(&chm, rif_val(rif_true), rif_val(rif_null)));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(0, rif_concurrent_hashmap_size(&chm));
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_putifabsent_should_keep_existing_element) {
+  rif_int_t *first = rif_int_new(1);
+  rif_int_t *second = rif_int_new(2);
+  EXPECT_EQ(rif_val(first), rif_concurrent_hashmap_putifabsent(&chm, rif_val(rif_true), rif_val(first)));
+  EXPECT_EQ(1, rif_concurrent_hashmap_size(&chm));
+  EXPECT_EQ(3, rif_val_reference_count(first));
+  EXPECT_EQ(rif_val(first), rif_concurrent_hashmap_putifabsent(&chm, rif_val(rif_true), rif_val(second)));
+  EXPECT_EQ(1, rif_concurrent_hashmap_size(&chm));
+  EXPECT_EQ(4, rif_val_reference_count(first));
+  EXPECT_EQ(1, rif_val_reference_count(second));
+  rif_val_release(first);
+  rif_val_release(first);
+  rif_val_release(first);
+  rif_val_release(second);
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_putifabsent_should_accept_static_values) {
+  EXPECT_EQ(rif_val(rif_true), rif_concurrent_hashmap_putifabsent(&chm, rif_val(rif_false), rif_val(rif_true)));
+  EXPECT_EQ(rif_val(rif_true), rif_concurrent_hashmap_get(&chm, rif_val(rif_false)));
+  EXPECT_EQ(1, rif_concurrent_hashmap_size(&chm));
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_putifabsent_should_accept_immediate_values) {
+  rif_val_t *key_ptr = rif_val(rif_int_new_immediate(42));
+  rif_val_t *val_ptr = rif_val(rif_int_new_immediate(7));
+  EXPECT_EQ(val_ptr, rif_concurrent_hashmap_putifabsent(&chm, key_ptr, val_ptr));
+  EXPECT_EQ(val_ptr, rif_concurrent_hashmap_putifabsent(&chm, key_ptr, rif_val(rif_int_new_immediate(8))));
+  EXPECT_EQ(val_ptr, rif_concurrent_hashmap_get(&chm, key_ptr));
+  EXPECT_EQ(1, rif_concurrent_hashmap_size(&chm));
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_putifabsent_should_handle_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_capacity_alloc);
+  EXPECT_EQ(NULL, rif_concurrent_hashmap_putifabsent(&chm, rif_val(rif_true), rif_val(rif_null)));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(0, rif_concurrent_hashmap_size(&chm));
+}
+
+/******************************************************************************
+ * STRESS TESTS
+ */
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_should_handle_concurrent_writers_of_distinct_keys) {
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < NUM_THREADS; ++i) {
+    threads.push_back(std::thread(_rif_concurrent_hashmap_test_owned_keys, &chm, i));
+  }
+  for (uint32_t i = 0; i < NUM_THREADS; ++i) {
+    threads[i].join();
+  }
+  EXPECT_EQ(NUM_ELEMENTS / 2, rif_concurrent_hashmap_size(&chm));
+  for (uint32_t n = 0; n < NUM_ELEMENTS; ++n) {
+    rif_int_t *key = rif_int_new(n);
+    EXPECT_EQ((n / NUM_THREADS) % 2 != 0, rif_concurrent_hashmap_exists(&chm, rif_val(key)));
+    rif_val_release(key);
+  }
+}
+
+TEST_F(ConcurrentHashmap, rif_concurrent_hashmap_should_handle_concurrent_writers_of_shared_keys) {
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < NUM_THREADS; ++i) {
+    threads.push_back(std::thread(_rif_concurrent_hashmap_test_shared_keys, &chm, i));
+  }
+  for (uint32_t i = 0; i < NUM_THREADS; ++i) {
+    threads[i].join();
+  }
+  uint32_t found = 0;
+  rif_concurrent_hashmap_iterator_t it;
+  rif_pair_t pair;
+  rif_concurrent_hashmap_iterator_init(&it, &chm, &pair);
+  while (rif_concurrent_hashmap_iterator_hasnext(&it)) {
+    EXPECT_TRUE(NULL != rif_concurrent_hashmap_iterator_next(&it));
+    ++found;
+  }
+  rif_iterator_destroy((rif_iterator_t *) &it);
+  EXPECT_EQ(rif_concurrent_hashmap_size(&chm), found);
+  EXPECT_LE(found, 16);
+}
+
+/******************************************************************************
+ * CONFORMITY
+ */
+
+static
+rif_map_t *_rif_concurrent_hashmap_init() {
+  rif_concurrent_hashmap_t *map_ptr = (rif_concurrent_hashmap_t *) rif_malloc(sizeof(rif_concurrent_hashmap_t));
+  return (rif_map_t *) rif_concurrent_hashmap_init(map_ptr, 0, 4);
+}
+
+static
+void _rif_concurrent_hashmap_destroy(rif_map_t *map_ptr) {
+  rif_val_release(map_ptr);
+  rif_free(map_ptr);
+}
+
+static rif_map_conformity_generator_t rif_concurrent_hashmap_generator = {
+    .init = _rif_concurrent_hashmap_init,
+    .destroy = _rif_concurrent_hashmap_destroy
+};
+
+INSTANTIATE_TEST_CASE_P(ConcurrentHashmap, MapConformity, ::testing::Values(&rif_concurrent_hashmap_generator));
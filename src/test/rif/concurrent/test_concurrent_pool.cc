@@ -17,7 +17,9 @@
  * License along with this library.
  */
 
+#include <algorithm>
 #include <thread>
+#include <vector>
 
 #include "../test_internal.h"
 
@@ -35,6 +37,38 @@ bool _alloc_filter(const char *tag) {
   return 0 != strcmp(tag, "RIF_POOL_ALLOC");
 }
 
+static
+bool _alloc_filter_node_alloc(const char *tag) {
+  return 0 != strcmp(tag, "RIF_CONCURRENT_POOL_ALLOC");
+}
+
+static
+bool _alloc_filter_magazine_alloc(const char *tag) {
+  return 0 != strcmp(tag, "RIF_CONCURRENT_POOL_MAGAZINE_ALLOC");
+}
+
+static
+uint32_t _shared_count(rif_concurrent_pool_t *pool) {
+  uint32_t count = 0;
+  rif_concurrent_pool_node_t *chain = (rif_concurrent_pool_node_t *) atomic_load(&pool->free_queue.first);
+  while (chain) {
+    for (rif_concurrent_pool_node_t *node = chain; node; node = *(rif_concurrent_pool_node_t **) node->element) {
+      ++count;
+    }
+    chain = (rif_concurrent_pool_node_t *) atomic_load(&chain->_.succ);
+  }
+  return count;
+}
+
+static
+uint32_t _magazine_count(rif_concurrent_pool_t *pool) {
+  uint32_t count = 0;
+  for (rif_concurrent_pool_magazine_t *magazine = pool->first_magazine; magazine; magazine = magazine->next) {
+    ++count;
+  }
+  return count;
+}
+
 /******************************************************************************
  * TEST CONFIG
  */
@@ -78,10 +112,177 @@ void _rif_concurrent_pool_test_worker(rif_concurrent_pool_t *pool) {
   }
 }
 
+static
+void _rif_concurrent_pool_test_borrow(rif_concurrent_pool_t *pool, std::vector<void *> *blocks) {
+  for (uint32_t i = 0; i < blocks->size(); ++i) {
+    (*blocks)[i] = rif_concurrent_pool_borrow(pool);
+  }
+}
+
+static
+void _rif_concurrent_pool_test_return(rif_concurrent_pool_t *pool, std::vector<void *> *blocks) {
+  for (uint32_t i = 0; i < blocks->size(); ++i) {
+    rif_concurrent_pool_return(pool, (*blocks)[i]);
+  }
+}
+
 /******************************************************************************
  * TESTS
  */
 
+TEST_F(ConcurrentPool, rif_concurrent_pool_return_should_keep_elements_in_the_thread_magazine) {
+  ASSERT_TRUE(this->pool.magazines);
+  void *block = rif_concurrent_pool_borrow(&this->pool);
+  ASSERT_FALSE(NULL == block);
+  rif_concurrent_pool_return(&this->pool, block);
+  EXPECT_EQ(0, _shared_count(&this->pool));
+  EXPECT_EQ(1, _magazine_count(&this->pool));
+  EXPECT_EQ(block, rif_concurrent_pool_borrow(&this->pool));
+  rif_concurrent_pool_return(&this->pool, block);
+}
+
+TEST_F(ConcurrentPool, rif_concurrent_pool_return_should_spill_whole_batches) {
+  std::vector<void *> blocks(4 * RIF_CONCURRENT_POOL_MAGAZINE_SIZE);
+  _rif_concurrent_pool_test_borrow(&this->pool, &blocks);
+  uint32_t shared = _shared_count(&this->pool);
+  _rif_concurrent_pool_test_return(&this->pool, &blocks);
+  EXPECT_EQ(shared + 2 * RIF_CONCURRENT_POOL_MAGAZINE_SIZE, _shared_count(&this->pool));
+  EXPECT_EQ(2 * RIF_CONCURRENT_POOL_MAGAZINE_SIZE,
+            this->pool.first_magazine->loaded.count + this->pool.first_magazine->previous.count);
+
+  // Everything can be borrowed back without allocating
+  rif_alloc_set_filter(_alloc_filter_node_alloc);
+  _rif_concurrent_pool_test_borrow(&this->pool, &blocks);
+  rif_alloc_set_filter(NULL);
+  for (uint32_t i = 0; i < blocks.size(); ++i) {
+    ASSERT_FALSE(NULL == blocks[i]);
+  }
+  EXPECT_EQ(shared, _shared_count(&this->pool));
+  _rif_concurrent_pool_test_return(&this->pool, &blocks);
+}
+
+TEST_F(ConcurrentPool, rif_concurrent_pool_borrow_should_return_null_on_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_node_alloc);
+  EXPECT_EQ(NULL, rif_concurrent_pool_borrow(&this->pool));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(0, rif_concurrent_pool_slab_count(&this->pool));
+  EXPECT_EQ(0, (uint32_t) atomic_load(&this->pool.node_count));
+}
+
+TEST_F(ConcurrentPool, rif_concurrent_pool_should_use_the_shared_stack_without_magazine) {
+  rif_alloc_set_filter(_alloc_filter_magazine_alloc);
+  std::vector<void *> blocks(NUM_ELEMENTS);
+  _rif_concurrent_pool_test_borrow(&this->pool, &blocks);
+  EXPECT_EQ(NUM_ELEMENTS, rif_concurrent_pool_live_count(&this->pool));
+  _rif_concurrent_pool_test_return(&this->pool, &blocks);
+  EXPECT_EQ(0, _magazine_count(&this->pool));
+  EXPECT_EQ((uint32_t) atomic_load(&this->pool.node_count), _shared_count(&this->pool));
+  EXPECT_EQ(0, rif_concurrent_pool_live_count(&this->pool));
+  rif_alloc_set_filter(NULL);
+}
+
+TEST_F(ConcurrentPool, rif_concurrent_pool_should_handle_cross_thread_returns) {
+  std::vector<void *> blocks(10 * RIF_CONCURRENT_POOL_MAGAZINE_SIZE + 3);
+
+  // Borrow on a thread, return on another one, and let both exit
+  std::thread(_rif_concurrent_pool_test_borrow, &this->pool, &blocks).join();
+  EXPECT_EQ(blocks.size(), rif_concurrent_pool_live_count(&this->pool));
+  std::thread(_rif_concurrent_pool_test_return, &this->pool, &blocks).join();
+  EXPECT_EQ(0, _magazine_count(&this->pool));
+  EXPECT_EQ((uint32_t) atomic_load(&this->pool.node_count), _shared_count(&this->pool));
+  EXPECT_EQ(0, rif_concurrent_pool_live_count(&this->pool));
+
+  // Another thread borrows as many elements without allocating
+  uint32_t slab_count = rif_concurrent_pool_slab_count(&this->pool);
+  std::vector<void *> borrowed(blocks.size());
+  rif_alloc_set_filter(_alloc_filter_node_alloc);
+  std::thread(_rif_concurrent_pool_test_borrow, &this->pool, &borrowed).join();
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(slab_count, rif_concurrent_pool_slab_count(&this->pool));
+  std::sort(borrowed.begin(), borrowed.end());
+  EXPECT_TRUE(NULL != borrowed[0]);
+  EXPECT_TRUE(std::adjacent_find(borrowed.begin(), borrowed.end()) == borrowed.end());
+  _rif_concurrent_pool_test_return(&this->pool, &borrowed);
+}
+
+TEST_F(ConcurrentPool, rif_concurrent_pool_borrow_should_carve_aligned_nodes_from_slabs) {
+  std::vector<void *> blocks(RIF_CONCURRENT_POOL_MAGAZINE_SIZE);
+  _rif_concurrent_pool_test_borrow(&this->pool, &blocks);
+  EXPECT_EQ(1, rif_concurrent_pool_slab_count(&this->pool));
+  for (uint32_t i = 0; i < blocks.size(); ++i) {
+    EXPECT_EQ(0, ((uintptr_t) blocks[i]) % (2 * sizeof(void *)));
+    if (i) {
+      EXPECT_EQ(this->pool.node_stride, (char *) blocks[i] - (char *) blocks[i - 1]);
+    }
+  }
+  EXPECT_EQ(RIF_CONCURRENT_POOL_MAGAZINE_SIZE, rif_concurrent_pool_live_count(&this->pool));
+  EXPECT_EQ(0, rif_concurrent_pool_free_count(&this->pool));
+
+  // The next slab is larger
+  void *block = rif_concurrent_pool_borrow(&this->pool);
+  EXPECT_EQ(2, rif_concurrent_pool_slab_count(&this->pool));
+  EXPECT_EQ(3 * RIF_CONCURRENT_POOL_MAGAZINE_SIZE, (uint32_t) atomic_load(&this->pool.node_count));
+  rif_concurrent_pool_return(&this->pool, block);
+  _rif_concurrent_pool_test_return(&this->pool, &blocks);
+  EXPECT_EQ(3 * RIF_CONCURRENT_POOL_MAGAZINE_SIZE, rif_concurrent_pool_free_count(&this->pool));
+}
+
+TEST_F(ConcurrentPool, rif_concurrent_pool_reserve_should_preallocate_nodes) {
+  ASSERT_EQ(RIF_OK, rif_concurrent_pool_reserve(&this->pool, 1000));
+  EXPECT_EQ(1, rif_concurrent_pool_slab_count(&this->pool));
+  EXPECT_EQ(1000, rif_concurrent_pool_free_count(&this->pool));
+  ASSERT_EQ(RIF_OK, rif_concurrent_pool_reserve(&this->pool, 500));
+  EXPECT_EQ(1, rif_concurrent_pool_slab_count(&this->pool));
+
+  // Reserved nodes are borrowed without allocating
+  std::vector<void *> blocks(1000);
+  rif_alloc_set_filter(_alloc_filter_node_alloc);
+  _rif_concurrent_pool_test_borrow(&this->pool, &blocks);
+  rif_alloc_set_filter(NULL);
+  for (uint32_t i = 0; i < blocks.size(); ++i) {
+    ASSERT_FALSE(NULL == blocks[i]);
+  }
+  EXPECT_EQ(1000, rif_concurrent_pool_live_count(&this->pool));
+  _rif_concurrent_pool_test_return(&this->pool, &blocks);
+}
+
+TEST_F(ConcurrentPool, rif_concurrent_pool_reserve_should_handle_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_node_alloc);
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_concurrent_pool_reserve(&this->pool, 1000));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(0, (uint32_t) atomic_load(&this->pool.node_count));
+}
+
+TEST_F(ConcurrentPool, rif_concurrent_pool_borrow_should_fail_beyond_max_nodes) {
+  rif_concurrent_pool_set_max_nodes(&this->pool, 100);
+  EXPECT_EQ(RIF_ERR_CAPACITY, rif_concurrent_pool_reserve(&this->pool, 101));
+  std::vector<void *> blocks(100);
+  _rif_concurrent_pool_test_borrow(&this->pool, &blocks);
+  for (uint32_t i = 0; i < blocks.size(); ++i) {
+    ASSERT_FALSE(NULL == blocks[i]);
+  }
+  EXPECT_EQ(NULL, rif_concurrent_pool_borrow(&this->pool));
+  EXPECT_EQ(100, (uint32_t) atomic_load(&this->pool.node_count));
+  EXPECT_EQ(100, rif_concurrent_pool_live_count(&this->pool));
+
+  // Returned nodes can be borrowed again
+  rif_concurrent_pool_return(&this->pool, blocks[0]);
+  blocks[0] = rif_concurrent_pool_borrow(&this->pool);
+  EXPECT_FALSE(NULL == blocks[0]);
+  _rif_concurrent_pool_test_return(&this->pool, &blocks);
+  EXPECT_EQ(100, rif_concurrent_pool_free_count(&this->pool));
+}
+
+TEST_F(ConcurrentPool, rif_concurrent_pool_destroy_should_release_live_magazines) {
+  rif_concurrent_pool_t pool_tmp;
+  rif_concurrent_pool_init(&pool_tmp, 1);
+  std::vector<void *> blocks(3 * RIF_CONCURRENT_POOL_MAGAZINE_SIZE);
+  _rif_concurrent_pool_test_borrow(&pool_tmp, &blocks);
+  _rif_concurrent_pool_test_return(&pool_tmp, &blocks);
+  EXPECT_EQ(1, _magazine_count(&pool_tmp));
+  rif_concurrent_pool_destroy(&pool_tmp);
+}
+
 TEST_F(ConcurrentPool, rif_paged_pool_init_should_work_concurrently) {
   std::thread threads[NUM_THREADS];
   for (uint32_t i = 0; i < NUM_THREADS; ++i) {
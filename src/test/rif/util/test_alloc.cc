@@ -44,6 +44,14 @@ void _test_free(void *ptr) {
   ++_free_counter;
 }
 
+static void *_freed_ptr = NULL;
+
+static
+void _recording_free(void *ptr) {
+  _freed_ptr = ptr;
+  free(ptr);
+}
+
 static
 void * _test_malloc_calloc(size_t size) {
   void *ptr = malloc(size);
@@ -122,6 +130,26 @@ TEST_F(Alloc, rif_calloc_should_set_bytes_to_0) {
   rif_free(ptr);
 }
 
+TEST_F(Alloc, rif_set_allocators_should_track_whether_system_allocators_are_used) {
+  EXPECT_TRUE(_rif_allocators.system_allocators);
+  rif_set_allocators(NULL, NULL, _recording_free);
+  EXPECT_FALSE(_rif_allocators.system_allocators);
+  rif_set_allocators(NULL, NULL, free);
+  EXPECT_TRUE(_rif_allocators.system_allocators);
+  rif_set_allocators(NULL, _test_realloc, NULL);
+  EXPECT_FALSE(_rif_allocators.system_allocators);
+}
+
+TEST_F(Alloc, rif_aligned_alloc_should_free_through_a_custom_free) {
+  rif_set_allocators(NULL, NULL, _recording_free);
+  void *ptr = rif_aligned_alloc(64, 100);
+  ASSERT_TRUE(NULL != ptr);
+  EXPECT_EQ(0, (uintptr_t) ptr % 64);
+  void *raw_ptr = ((void **) ptr)[-1];
+  rif_aligned_free(ptr);
+  EXPECT_EQ(raw_ptr, _freed_ptr);
+}
+
 TEST_F(Alloc, rif_strdup_should_work) {
   const char *test = "foo";
   char *test_dup = rif_strdup(test);
@@ -0,0 +1,305 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "../test_internal.h"
+
+/******************************************************************************
+ * TEST FIXTURES
+ */
+
+static uint32_t _heap_allocs = 0;
+static uint32_t _heap_frees = 0;
+
+static
+void * _counting_malloc(size_t size) {
+  ++_heap_allocs;
+  return malloc(size);
+}
+
+static
+void * _counting_realloc(void *ptr, size_t size) {
+  ++_heap_allocs;
+  return realloc(ptr, size);
+}
+
+static
+void _counting_free(void *ptr) {
+  _heap_frees += NULL != ptr;
+  free(ptr);
+}
+
+static
+bool _alloc_filter_chunk_alloc(const char *tag) {
+  return 0 != strcmp(tag, "RIF_ARENA_CHUNK_ALLOC");
+}
+
+/******************************************************************************
+ * TEST CONFIG
+ */
+
+class Arena : public MemoryAwareTest {
+
+public:
+
+  rif_arena_t arena;
+
+private:
+
+  virtual void SetUp() {
+    MemoryAwareTest::SetUp();
+    rif_arena_init(&arena, 4096);
+    _heap_allocs = 0;
+    _heap_frees = 0;
+  }
+
+  virtual void TearDown() {
+    rif_arena_set_current(NULL);
+    rif_set_allocators(f_malloc, f_realloc, f_free);
+    rif_arena_destroy(&arena);
+    MemoryAwareTest::TearDown();
+  }
+
+};
+
+/******************************************************************************
+ * INIT TESTS
+ */
+
+TEST_F(Arena, rif_arena_init_should_return_null_with_null_ptr) {
+  EXPECT_EQ(NULL, rif_arena_init(NULL, 0));
+}
+
+TEST_F(Arena, rif_arena_init_should_not_allocate_memory) {
+  rif_arena_t arena_tmp;
+  ASSERT_TRUE(NULL != rif_arena_init(&arena_tmp, 0));
+  EXPECT_EQ(RIF_ARENA_DEFAULT_CHUNK_SIZE, arena_tmp.chunk_size);
+  EXPECT_EQ(0, rif_arena_chunk_count(&arena_tmp));
+  rif_arena_destroy(&arena_tmp);
+}
+
+/******************************************************************************
+ * ALLOCATION TESTS
+ */
+
+TEST_F(Arena, rif_arena_alloc_should_return_aligned_contiguous_memory) {
+  char *ptr_1 = (char *) rif_arena_alloc(&arena, 10);
+  char *ptr_2 = (char *) rif_arena_alloc(&arena, 20);
+  ASSERT_TRUE(NULL != ptr_1);
+  ASSERT_TRUE(NULL != ptr_2);
+  EXPECT_EQ(0, (uintptr_t) ptr_1 % RIF_ARENA_ALIGNMENT);
+  EXPECT_EQ(0, (uintptr_t) ptr_2 % RIF_ARENA_ALIGNMENT);
+  EXPECT_EQ(ptr_1 + 16, ptr_2);
+  EXPECT_EQ(1, rif_arena_chunk_count(&arena));
+  memset(ptr_1, 1, 10);
+  memset(ptr_2, 2, 20);
+  EXPECT_EQ(1, ptr_1[9]);
+}
+
+TEST_F(Arena, rif_arena_aligned_alloc_should_honor_alignment) {
+  rif_arena_alloc(&arena, 1);
+  void *ptr = rif_arena_aligned_alloc(&arena, 256, 10);
+  EXPECT_EQ(0, (uintptr_t) ptr % 256);
+  EXPECT_TRUE(rif_arena_owns(&arena, ptr));
+}
+
+TEST_F(Arena, rif_arena_alloc_should_chain_chunks) {
+  for (uint32_t i = 0; i < 1000; ++i) {
+    uint64_t *ptr = (uint64_t *) rif_arena_alloc(&arena, 64);
+    ASSERT_TRUE(NULL != ptr);
+    *ptr = i;
+  }
+  EXPECT_LE(16, rif_arena_chunk_count(&arena));
+}
+
+TEST_F(Arena, rif_arena_alloc_should_keep_the_current_chunk_on_large_allocations) {
+  char *ptr_1 = (char *) rif_arena_alloc(&arena, 16);
+  char *large = (char *) rif_arena_alloc(&arena, 10000);
+  char *ptr_2 = (char *) rif_arena_alloc(&arena, 16);
+  ASSERT_TRUE(NULL != large);
+  memset(large, 0, 10000);
+  EXPECT_EQ(2, rif_arena_chunk_count(&arena));
+  EXPECT_EQ(ptr_1 + 16, ptr_2);
+  EXPECT_TRUE(rif_arena_owns(&arena, large + 9999));
+}
+
+TEST_F(Arena, rif_arena_alloc_should_return_null_on_failing_alloc) {
+  rif_alloc_set_filter(_alloc_filter_chunk_alloc);
+  EXPECT_EQ(NULL, rif_arena_alloc(&arena, 16));
+  EXPECT_EQ(NULL, rif_arena_alloc(&arena, 100000));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(0, rif_arena_chunk_count(&arena));
+}
+
+TEST_F(Arena, rif_arena_realloc_should_grow_the_last_allocation_in_place) {
+  char *ptr = (char *) rif_arena_alloc(&arena, 16);
+  strcpy(ptr, "foo");
+  EXPECT_EQ(ptr, rif_arena_realloc(&arena, ptr, 1024));
+  EXPECT_STREQ("foo", ptr);
+  char *next = (char *) rif_arena_alloc(&arena, 16);
+  EXPECT_EQ(ptr + 1024, next);
+}
+
+TEST_F(Arena, rif_arena_realloc_should_move_other_allocations) {
+  char *ptr = (char *) rif_arena_alloc(&arena, 16);
+  strcpy(ptr, "foo");
+  rif_arena_alloc(&arena, 16);
+  char *moved = (char *) rif_arena_realloc(&arena, ptr, 64);
+  EXPECT_NE(ptr, moved);
+  EXPECT_STREQ("foo", moved);
+  moved = (char *) rif_arena_realloc(&arena, moved, 8000);
+  EXPECT_STREQ("foo", moved);
+  EXPECT_TRUE(rif_arena_owns(&arena, moved));
+}
+
+TEST_F(Arena, rif_arena_free_should_reclaim_the_last_allocation_only) {
+  char *ptr_1 = (char *) rif_arena_alloc(&arena, 16);
+  char *ptr_2 = (char *) rif_arena_alloc(&arena, 16);
+  rif_arena_free(&arena, ptr_1);
+  rif_arena_free(&arena, ptr_2);
+  EXPECT_EQ(ptr_2, rif_arena_alloc(&arena, 16));
+}
+
+TEST_F(Arena, rif_arena_owns_should_find_every_chunk) {
+  std::vector<char *> ptrs;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    ptrs.push_back((char *) rif_arena_alloc(&arena, i % 10 ? 1000 : 5000));
+  }
+  char *heap_ptr = (char *) malloc(64);
+  EXPECT_LE(250, rif_arena_chunk_count(&arena));
+  for (uint32_t i = 0; i < ptrs.size(); ++i) {
+    EXPECT_TRUE(rif_arena_owns(&arena, ptrs[i]));
+    EXPECT_TRUE(rif_arena_owns(&arena, ptrs[i] + 999));
+  }
+  EXPECT_FALSE(rif_arena_owns(&arena, heap_ptr));
+  EXPECT_FALSE(rif_arena_owns(&arena, NULL));
+  free(heap_ptr);
+  rif_arena_reset(&arena);
+  EXPECT_FALSE(rif_arena_owns(&arena, ptrs[999]) && rif_arena_owns(&arena, ptrs[0]));
+  EXPECT_TRUE(rif_arena_owns(&arena, rif_arena_alloc(&arena, 16)));
+}
+
+/******************************************************************************
+ * RESET TESTS
+ */
+
+TEST_F(Arena, rif_arena_reset_should_keep_a_single_chunk) {
+  char *first = (char *) rif_arena_alloc(&arena, 16);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    rif_arena_alloc(&arena, 64);
+  }
+  rif_arena_alloc(&arena, 100000);
+  rif_arena_reset(&arena);
+  EXPECT_EQ(1, rif_arena_chunk_count(&arena));
+  EXPECT_FALSE(rif_arena_owns(&arena, first) && rif_arena_owns(&arena, first + 8192));
+  char *ptr = (char *) rif_arena_alloc(&arena, 16);
+  EXPECT_TRUE(rif_arena_owns(&arena, ptr));
+}
+
+/******************************************************************************
+ * VALUE TESTS
+ */
+
+TEST_F(Arena, rif_arena_new_should_build_values_in_place) {
+  rif_set_allocators(_counting_malloc, _counting_realloc, _counting_free);
+  rif_int_t *int_ptr = rif_int_init(rif_arena_new(&arena, rif_int_t), 42);
+  rif_pair_t *pair_ptr = rif_pair_init(rif_arena_new(&arena, rif_pair_t), rif_val(int_ptr), rif_val(int_ptr));
+  EXPECT_EQ(42, rif_int_get(int_ptr));
+  EXPECT_TRUE(rif_arena_owns(&arena, pair_ptr));
+  rif_val_release(pair_ptr);
+  rif_val_release(int_ptr);
+  EXPECT_EQ(1, _heap_allocs);
+  EXPECT_EQ(0, _heap_frees);
+}
+
+/******************************************************************************
+ * SCOPE TESTS
+ */
+
+TEST_F(Arena, rif_arena_set_current_should_serve_every_allocation) {
+  rif_set_allocators(_counting_malloc, _counting_realloc, _counting_free);
+  EXPECT_EQ(NULL, rif_arena_set_current(&arena));
+  EXPECT_EQ(&arena, rif_arena_current());
+
+  rif_arraylist_t *al_ptr = (rif_arraylist_t *) rif_malloc(sizeof(rif_arraylist_t));
+  rif_arraylist_init(al_ptr, 0, 0);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    rif_int_t *int_ptr = rif_int_new(i);
+    rif_string_t *str_ptr = rif_string_new_dup("foo");
+    rif_pair_t *pair_ptr = rif_pair_new(rif_val(int_ptr), rif_val(str_ptr));
+    ASSERT_EQ(RIF_OK, rif_arraylist_append(al_ptr, rif_val(pair_ptr)));
+    rif_val_release(pair_ptr);
+    rif_val_release(str_ptr);
+    rif_val_release(int_ptr);
+  }
+  EXPECT_EQ(1000, rif_arraylist_size(al_ptr));
+  EXPECT_TRUE(rif_arena_owns(&arena, rif_arraylist_get(al_ptr, 999)));
+
+  // Only arena chunks come from the heap, and the whole graph goes at once
+  uint32_t chunks = rif_arena_chunk_count(&arena);
+  EXPECT_EQ(chunks, _heap_allocs);
+  rif_arena_reset(&arena);
+  EXPECT_EQ(chunks - 1, _heap_frees);
+  EXPECT_EQ(&arena, rif_arena_set_current(NULL));
+}
+
+TEST_F(Arena, rif_arena_set_current_should_free_heap_memory_to_the_heap) {
+  rif_set_allocators(_counting_malloc, _counting_realloc, _counting_free);
+  void *heap_ptr = rif_malloc(32);
+  char *heap_str = rif_strdup("foo");
+  rif_arena_set_current(&arena);
+  rif_free(heap_ptr);
+  heap_str = (char *) rif_realloc(heap_str, 100);
+  EXPECT_FALSE(rif_arena_owns(&arena, heap_str));
+  EXPECT_STREQ("foo", heap_str);
+  rif_free(heap_str);
+  rif_arena_set_current(NULL);
+  EXPECT_EQ(2, _heap_frees);
+}
+
+TEST_F(Arena, rif_arena_set_current_should_nest) {
+  rif_arena_t inner;
+  rif_arena_init(&inner, 0);
+  rif_arena_t *outer = rif_arena_set_current(&arena);
+  void *ptr_1 = rif_malloc(16);
+  rif_arena_t *previous = rif_arena_set_current(&inner);
+  void *ptr_2 = rif_calloc(4, 4);
+  rif_arena_set_current(previous);
+  void *ptr_3 = rif_malloc(16);
+  rif_arena_set_current(outer);
+  EXPECT_TRUE(rif_arena_owns(&arena, ptr_1));
+  EXPECT_TRUE(rif_arena_owns(&inner, ptr_2));
+  EXPECT_TRUE(rif_arena_owns(&arena, ptr_3));
+  EXPECT_EQ(NULL, rif_arena_current());
+  rif_arena_destroy(&inner);
+}
+
+TEST_F(Arena, rif_arena_set_current_should_only_affect_the_calling_thread) {
+  rif_arena_set_current(&arena);
+  void *ptr = NULL;
+  std::thread([&ptr] {
+    EXPECT_EQ(NULL, rif_arena_current());
+    ptr = rif_malloc(16);
+  }).join();
+  EXPECT_FALSE(rif_arena_owns(&arena, ptr));
+  rif_arena_set_current(NULL);
+  rif_free(ptr);
+}
@@ -0,0 +1,214 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "../test_internal.h"
+
+/******************************************************************************
+ * TEST FIXTURES
+ */
+
+static
+bool _alloc_filter_slab_alloc(const char *tag) {
+  return 0 != strcmp(tag, "RIF_SLAB_ALLOC");
+}
+
+/******************************************************************************
+ * TEST CONFIG
+ */
+
+class Slab : public MemoryAwareTest {
+
+  virtual void SetUp() {
+    MemoryAwareTest::SetUp();
+  }
+
+  virtual void TearDown() {
+    rif_alloc_set_filter(NULL);
+    rif_slab_set_enabled(true);
+    rif_slab_set_batch_size(0);
+    MemoryAwareTest::TearDown();
+  }
+
+};
+
+/******************************************************************************
+ * ALLOCATION TESTS
+ */
+
+TEST_F(Slab, rif_slab_alloc_should_map_sizes_to_classes) {
+  size_t sizes[] = {1, RIF_SLAB_MIN_SIZE, RIF_SLAB_MIN_SIZE + 1, RIF_SLAB_MAX_SIZE, RIF_SLAB_MAX_SIZE + 1};
+  uint8_t expected[] = {1, 1, 2, RIF_SLAB_CLASS_COUNT, 0};
+  for (uint32_t i = 0; i < 5; ++i) {
+    uint8_t size_class;
+    void *ptr = rif_slab_alloc(sizes[i], &size_class);
+    ASSERT_TRUE(NULL != ptr);
+    EXPECT_EQ(expected[i], size_class);
+    if (size_class) {
+      rif_slab_free(ptr, size_class);
+    } else {
+      rif_free(ptr);
+    }
+  }
+}
+
+TEST_F(Slab, rif_val_new_should_allocate_small_values_from_the_caches) {
+  rif_int_t *int_ptr = rif_int_new(42);
+  rif_double_t *double_ptr = rif_double_new(4.2);
+  rif_string_t *str_ptr = rif_string_new_dup("foo");
+  rif_pair_t *pair_ptr = rif_pair_new(rif_val(int_ptr), rif_val(str_ptr));
+  EXPECT_NE(0, rif_val(int_ptr)->size_class);
+  EXPECT_NE(0, rif_val(double_ptr)->size_class);
+  EXPECT_NE(0, rif_val(str_ptr)->size_class);
+  EXPECT_NE(0, rif_val(pair_ptr)->size_class);
+  rif_val_release(pair_ptr);
+  rif_val_release(str_ptr);
+  rif_val_release(double_ptr);
+  rif_val_release(int_ptr);
+
+  // Released values are reused right away
+  EXPECT_EQ(int_ptr, rif_int_new(1));
+  rif_val_release(int_ptr);
+}
+
+TEST_F(Slab, rif_val_release_should_return_batches_to_the_depot) {
+  rif_slab_set_batch_size(16);
+  std::vector<rif_int_t *> ints(1000);
+  for (uint32_t i = 0; i < ints.size(); ++i) {
+    ints[i] = rif_int_new(i);
+  }
+  uint8_t size_class = rif_val(ints[0])->size_class;
+  for (uint32_t i = 0; i < ints.size(); ++i) {
+    rif_val_release(ints[i]);
+  }
+  EXPECT_LE(_rif_slab_cache.loaded[size_class - 1].count, 16);
+  EXPECT_LE(_rif_slab_cache.previous[size_class - 1].count, 16);
+
+  // Every value comes back from the caches, without carving new slabs
+  uint32_t slab_count = rif_slab_count();
+  rif_alloc_set_filter(_alloc_filter_slab_alloc);
+  for (uint32_t i = 0; i < ints.size(); ++i) {
+    ints[i] = rif_int_new(i);
+    ASSERT_TRUE(NULL != ints[i]);
+  }
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(slab_count, rif_slab_count());
+  for (uint32_t i = 0; i < ints.size(); ++i) {
+    rif_val_release(ints[i]);
+  }
+}
+
+TEST_F(Slab, rif_slab_alloc_should_return_null_on_failing_alloc) {
+  std::thread([] {
+    // Cached objects are still handed out, until a new slab is needed
+    uint32_t slab_count = rif_slab_count();
+    std::vector<void *> ptrs;
+    uint8_t size_class;
+    rif_alloc_set_filter(_alloc_filter_slab_alloc);
+    void *ptr;
+    while (ptrs.size() <= (slab_count + 1) * RIF_SLAB_BYTES / RIF_SLAB_MAX_SIZE) {
+      ptr = rif_slab_alloc(RIF_SLAB_MAX_SIZE, &size_class);
+      if (!ptr) {
+        break;
+      }
+      ptrs.push_back(ptr);
+    }
+    rif_alloc_set_filter(NULL);
+    EXPECT_EQ(NULL, ptr);
+    EXPECT_EQ(slab_count, rif_slab_count());
+    for (uint32_t i = 0; i < ptrs.size(); ++i) {
+      rif_slab_free(ptrs[i], size_class);
+    }
+  }).join();
+}
+
+/******************************************************************************
+ * SETTINGS TESTS
+ */
+
+TEST_F(Slab, rif_slab_set_enabled_should_switch_to_the_heap_allocators) {
+  rif_int_t *cached = rif_int_new(1);
+  rif_slab_set_enabled(false);
+  EXPECT_FALSE(rif_slab_enabled());
+  rif_int_t *heap = rif_int_new(2);
+  EXPECT_EQ(0, rif_val(heap)->size_class);
+  EXPECT_NE(0, rif_val(cached)->size_class);
+  rif_val_release(cached);
+  rif_val_release(heap);
+  rif_slab_set_enabled(true);
+  EXPECT_TRUE(rif_slab_enabled());
+}
+
+TEST_F(Slab, rif_val_new_should_allocate_from_the_current_arena) {
+  rif_arena_t arena;
+  rif_arena_init(&arena, 0);
+  rif_arena_set_current(&arena);
+  rif_int_t *int_ptr = rif_int_new(1);
+  rif_arena_set_current(NULL);
+  EXPECT_EQ(0, rif_val(int_ptr)->size_class);
+  EXPECT_TRUE(rif_arena_owns(&arena, int_ptr));
+  rif_arena_destroy(&arena);
+}
+
+/******************************************************************************
+ * THREAD TESTS
+ */
+
+static
+void _test_slab_new_pairs(std::vector<rif_pair_t *> *pairs) {
+  for (uint32_t i = 0; i < pairs->size(); ++i) {
+    rif_int_t *int_ptr = rif_int_new(i);
+    (*pairs)[i] = rif_pair_new(rif_val(int_ptr), rif_val(int_ptr));
+    rif_val_release(int_ptr);
+  }
+}
+
+static
+void _test_slab_release_pairs(std::vector<rif_pair_t *> *pairs) {
+  for (uint32_t i = 0; i < pairs->size(); ++i) {
+    EXPECT_EQ(i, rif_int_get(rif_int_fromval(rif_pair_1((*pairs)[i]))));
+    rif_val_release((*pairs)[i]);
+  }
+}
+
+TEST_F(Slab, rif_val_release_should_handle_cross_thread_releases) {
+  std::vector<rif_pair_t *> pairs(5000);
+  for (uint32_t round = 0; round < 4; ++round) {
+    std::thread(_test_slab_new_pairs, &pairs).join();
+    std::thread(_test_slab_release_pairs, &pairs).join();
+  }
+}
+
+TEST_F(Slab, rif_val_new_should_work_concurrently) {
+  std::vector<std::thread> threads;
+  std::vector<std::vector<rif_pair_t *> > pairs(8, std::vector<rif_pair_t *>(2000));
+  for (uint32_t i = 0; i < pairs.size(); ++i) {
+    threads.push_back(std::thread([&pairs, i] {
+      for (uint32_t round = 0; round < 10; ++round) {
+        _test_slab_new_pairs(&pairs[i]);
+        _test_slab_release_pairs(&pairs[i]);
+      }
+    }));
+  }
+  for (uint32_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+}
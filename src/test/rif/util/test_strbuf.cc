@@ -0,0 +1,218 @@
+/*
+ * This file is part of Rif.
+ *
+ * Copyright 2017 Ironmelt Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ */
+
+#include <fcntl.h>
+#include <string>
+
+#include "../test_internal.h"
+
+/******************************************************************************
+ * TEST FIXTURES
+ */
+
+static
+bool _alloc_filter_strbuf_grow(const char *tag) {
+  return 0 != strcmp(tag, "RIF_STRBUF_GROW");
+}
+
+/*
+ * Reads back everything written to a temporary file.
+ */
+static
+std::string _read_all(FILE *file) {
+  std::string content;
+  char buf[4096];
+  fflush(file);
+  rewind(file);
+  size_t count;
+  while ((count = fread(buf, 1, sizeof(buf), file)) > 0) {
+    content.append(buf, count);
+  }
+  return content;
+}
+
+/******************************************************************************
+ * TEST CONFIG
+ */
+
+class Strbuf : public MemoryAwareTest {
+
+public:
+
+  rif_strbuf_t sb;
+
+private:
+
+  virtual void SetUp() {
+    MemoryAwareTest::SetUp();
+    rif_strbuf_init(&sb, 0);
+  }
+
+  virtual void TearDown() {
+    rif_alloc_set_filter(NULL);
+    rif_strbuf_destroy(&sb);
+    MemoryAwareTest::TearDown();
+  }
+
+};
+
+/******************************************************************************
+ * INIT TESTS
+ */
+
+TEST_F(Strbuf, rif_strbuf_init_should_return_null_with_null_ptr) {
+  EXPECT_EQ(NULL, rif_strbuf_init(NULL, 0));
+  EXPECT_EQ(NULL, rif_strbuf_init_fd(NULL, 1, 0));
+}
+
+TEST_F(Strbuf, rif_strbuf_init_should_create_empty_buffer) {
+  EXPECT_EQ(RIF_OK, rif_strbuf_status(&sb));
+  EXPECT_EQ(0, rif_strbuf_length(&sb));
+  char *str = rif_strbuf_detach(&sb);
+  EXPECT_STREQ("", str);
+  rif_free(str);
+}
+
+/******************************************************************************
+ * APPEND TESTS
+ */
+
+TEST_F(Strbuf, rif_strbuf_append_should_concatenate_text) {
+  EXPECT_EQ(RIF_OK, rif_strbuf_append(&sb, "foobar", 3));
+  EXPECT_EQ(RIF_OK, rif_strbuf_append_char(&sb, '-'));
+  EXPECT_EQ(RIF_OK, rif_strbuf_append_str(&sb, "bar"));
+  EXPECT_EQ(RIF_OK, rif_strbuf_appendf(&sb, "-%d-%s", 42, "baz"));
+  EXPECT_EQ(14, rif_strbuf_length(&sb));
+  char *str = rif_strbuf_detach(&sb);
+  EXPECT_STREQ("foo-bar-42-baz", str);
+  rif_free(str);
+  EXPECT_EQ(0, rif_strbuf_length(&sb));
+}
+
+TEST_F(Strbuf, rif_strbuf_append_should_grow_storage) {
+  std::string expected;
+  for (uint32_t i = 0; i < 10000; ++i) {
+    ASSERT_EQ(RIF_OK, rif_strbuf_appendf(&sb, "%u,", i));
+    expected += std::to_string(i) + ",";
+  }
+  char *str = rif_strbuf_detach(&sb);
+  EXPECT_EQ(expected, str);
+  rif_free(str);
+}
+
+TEST_F(Strbuf, rif_strbuf_appendf_should_format_long_text) {
+  std::string long_str(1000, 'x');
+  EXPECT_EQ(RIF_OK, rif_strbuf_appendf(&sb, "<%s>", long_str.c_str()));
+  char *str = rif_strbuf_detach(&sb);
+  EXPECT_EQ("<" + long_str + ">", str);
+  rif_free(str);
+}
+
+TEST_F(Strbuf, rif_strbuf_append_should_keep_failure_status) {
+  rif_alloc_set_filter(_alloc_filter_strbuf_grow);
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_strbuf_append_str(&sb, "foo"));
+  rif_alloc_set_filter(NULL);
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_strbuf_append_str(&sb, "bar"));
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_strbuf_append_char(&sb, 'x'));
+  EXPECT_EQ(RIF_ERR_MEMORY, rif_strbuf_status(&sb));
+  EXPECT_EQ(NULL, rif_strbuf_detach(&sb));
+}
+
+/******************************************************************************
+ * FILE DESCRIPTOR TESTS
+ */
+
+TEST_F(Strbuf, rif_strbuf_init_fd_should_stream_in_chunks) {
+  FILE *file = tmpfile();
+  ASSERT_TRUE(NULL != file);
+  rif_strbuf_t fd_sb;
+  ASSERT_TRUE(NULL != rif_strbuf_init_fd(&fd_sb, fileno(file), 16));
+  std::string expected;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(RIF_OK, rif_strbuf_appendf(&fd_sb, "%u,", i));
+    expected += std::to_string(i) + ",";
+  }
+  std::string large(100, 'x');
+  ASSERT_EQ(RIF_OK, rif_strbuf_append_str(&fd_sb, large.c_str()));
+  ASSERT_EQ(RIF_OK, rif_strbuf_append_char(&fd_sb, '.'));
+  expected += large + ".";
+  EXPECT_GT(expected.size(), _read_all(file).size());
+  EXPECT_EQ(RIF_OK, rif_strbuf_flush(&fd_sb));
+  EXPECT_EQ(expected, _read_all(file));
+  EXPECT_EQ(expected.size(), rif_strbuf_length(&fd_sb));
+  EXPECT_EQ(NULL, rif_strbuf_detach(&fd_sb));
+  rif_strbuf_destroy(&fd_sb);
+  fclose(file);
+}
+
+TEST_F(Strbuf, rif_strbuf_flush_should_fail_with_read_only_fd) {
+  int fd = open("/dev/null", O_RDONLY);
+  ASSERT_LE(0, fd);
+  rif_strbuf_t fd_sb;
+  ASSERT_TRUE(NULL != rif_strbuf_init_fd(&fd_sb, fd, 0));
+  EXPECT_EQ(RIF_OK, rif_strbuf_append_str(&fd_sb, "foo"));
+  EXPECT_EQ(RIF_ERR_IO, rif_strbuf_flush(&fd_sb));
+  EXPECT_EQ(RIF_ERR_IO, rif_strbuf_append_str(&fd_sb, "bar"));
+  rif_strbuf_destroy(&fd_sb);
+  close(fd);
+}
+
+/******************************************************************************
+ * VALUE TESTS
+ */
+
+TEST_F(Strbuf, rif_val_write_should_append_string_representation) {
+  rif_arraylist_t *al_ptr = rif_arraylist_new(0, 0);
+  rif_arraylist_append_steal(al_ptr, rif_val(rif_int_new(1)));
+  rif_arraylist_append_steal(al_ptr, rif_val(rif_string_new((char *) "foo", false)));
+  rif_arraylist_append(al_ptr, rif_val(rif_null));
+  rif_strbuf_append_str(&sb, "list: ");
+  EXPECT_EQ(RIF_OK, rif_val_write(al_ptr, &sb));
+  EXPECT_EQ(RIF_OK, rif_val_write(NULL, &sb));
+  char *str = rif_strbuf_detach(&sb);
+  EXPECT_STREQ("list: [1, \"foo\", NULL][UNDEF]", str);
+  rif_free(str);
+  rif_val_release(al_ptr);
+}
+
+TEST_F(Strbuf, rif_val_write_should_fail_for_undefined_values) {
+  rif_val_t undef;
+  rif_val_init(&undef, RIF_UNDEF, false);
+  EXPECT_EQ(RIF_ERR_UNSUPPORTED, rif_val_write(&undef, &sb));
+  EXPECT_EQ(NULL, rif_val_tostring(&undef));
+}
+
+TEST_F(Strbuf, rif_val_write_fd_should_write_large_collections) {
+  FILE *file = tmpfile();
+  ASSERT_TRUE(NULL != file);
+  rif_arraylist_t *al_ptr = rif_arraylist_new(0, 0);
+  std::string expected = "[";
+  for (int64_t i = 0; i < 100000; ++i) {
+    rif_arraylist_append_steal(al_ptr, rif_val(rif_int_new(i)));
+    expected += (i ? ", " : "") + std::to_string(i);
+  }
+  expected += "]";
+  EXPECT_EQ(RIF_OK, rif_val_write_fd(al_ptr, fileno(file)));
+  EXPECT_EQ(expected, _read_all(file));
+  char *str = rif_val_tostring(al_ptr);
+  EXPECT_EQ(expected, str);
+  rif_free(str);
+  rif_val_release(al_ptr);
+  fclose(file);
+}
\ No newline at end of file